@@ -0,0 +1,742 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Benchmarks for the hot paths of the runtime and of the code generators.
+// Usage:
+//
+//   PB2JSONBenchmarks [--results=FILE] [--proto_path=DIR] [FILTER]
+//
+// runs every benchmark whose name contains FILTER (all of them by default)
+// and prints the time per iteration, the throughput in bytes and in items
+// (varints, tags, messages, lines or files, depending on the benchmark) and
+// the heap allocations per iteration.  --results also writes them to FILE
+// as a JSON array, for comparing runs.  The MockCase benchmarks read
+// TargetResponse.proto and what it imports from DIR, the current directory
+// by default, and are skipped if it isn't there.
+//
+// To measure the plain versions of the SIMD kernels, build with
+// GOOGLE_PROTOBUF_NO_SIMD defined.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/compiler/importer.h>
+#include <google/protobuf/compiler/objectivec/objectivec_generator.h>
+#include <google/protobuf/compiler/parser.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/json_reader.h>
+#include <google/protobuf/io/json_writer.h>
+#include <google/protobuf/io/printer.h>
+#include <google/protobuf/io/tokenizer.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/text_format.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "allocation_counter.h"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+// Each benchmark runs its operation the given number of times and returns
+// the number of bytes processed, for the throughput.
+typedef int64 BenchmarkFunction(int iterations);
+
+struct Benchmark {
+  const char* name;
+  BenchmarkFunction* function;
+  int items_per_iteration;
+};
+
+struct BenchmarkResult {
+  const char* name;
+  int iterations;
+  double seconds;
+  int64 bytes;
+  int64 items;
+  int64 allocations;
+};
+
+// Where the MockCase benchmarks find TargetResponse.proto.
+string proto_path = ".";
+
+double Now() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// Keeps the compiler from optimizing away results.
+volatile int benchmark_sink;
+
+// -------------------------------------------------------------------
+// Inputs.  These are generated rather than read from files so that every
+// run measures the same thing.
+
+// Mostly-ASCII text like the string fields in our responses, with a
+// character needing escaping every escape_interval bytes (never if 0).
+string MakeText(int size, int escape_interval) {
+  const char kWords[] = "the quick brown fox jumps over the lazy dog ";
+  const char kEscapes[] = "\"\\\n\t";
+  string text;
+  text.reserve(size);
+  for (int i = 0; i < size; i++) {
+    if (escape_interval > 0 && i % escape_interval == escape_interval - 1) {
+      text.push_back(kEscapes[(i / escape_interval) % 4]);
+    } else {
+      text.push_back(kWords[i % (sizeof(kWords) - 1)]);
+    }
+  }
+  return text;
+}
+
+// Pseudo-random bytes, like an audio blob in a bytes field.
+string MakeBlob(int size) {
+  string blob(size, '\0');
+  uint32 state = 12345;
+  for (int i = 0; i < size; i++) {
+    state = state * 1103515245 + 12345;
+    blob[i] = static_cast<char>(state >> 16);
+  }
+  return blob;
+}
+
+const int kTextSize = 4096;
+const int kBlobSize = 16384;
+
+// Generous enough for the escaped or encoded forms of the inputs above.
+char output_buffer[kBlobSize * 2];
+
+// -------------------------------------------------------------------
+
+int64 WriteString(const string& text, int iterations) {
+  for (int i = 0; i < iterations; i++) {
+    io::ArrayOutputStream output(output_buffer, sizeof(output_buffer));
+    io::JsonWriter writer(&output);
+    writer.String(text);
+  }
+  benchmark_sink = output_buffer[0];
+  return static_cast<int64>(text.size()) * iterations;
+}
+
+int64 BM_WriteCleanString(int iterations) {
+  static const string text = MakeText(kTextSize, 0);
+  return WriteString(text, iterations);
+}
+
+int64 BM_WriteEscapedString(int iterations) {
+  static const string text = MakeText(kTextSize, 64);
+  return WriteString(text, iterations);
+}
+
+int64 BM_WriteBytes(int iterations) {
+  static const string blob = MakeBlob(kBlobSize);
+  for (int i = 0; i < iterations; i++) {
+    io::ArrayOutputStream output(output_buffer, sizeof(output_buffer));
+    io::JsonWriter writer(&output);
+    writer.Bytes(blob.data(), blob.size());
+  }
+  benchmark_sink = output_buffer[0];
+  return static_cast<int64>(blob.size()) * iterations;
+}
+
+// Returns a value as the JsonWriter would write it.
+string ToJson(const string& value, bool is_bytes) {
+  string json;
+  {
+    io::StringOutputStream output(&json);
+    io::JsonWriter writer(&output);
+    if (is_bytes) {
+      writer.Bytes(value.data(), value.size());
+    } else {
+      writer.String(value);
+    }
+  }
+  return json;
+}
+
+int64 ReadString(const string& json, int iterations) {
+  string value;
+  for (int i = 0; i < iterations; i++) {
+    io::JsonReader reader(json.data(), json.size());
+    if (!reader.ReadString(&value)) abort();
+  }
+  benchmark_sink = value.size();
+  return static_cast<int64>(json.size()) * iterations;
+}
+
+int64 BM_ReadCleanString(int iterations) {
+  static const string json = ToJson(MakeText(kTextSize, 0), false);
+  return ReadString(json, iterations);
+}
+
+int64 BM_ReadEscapedString(int iterations) {
+  static const string json = ToJson(MakeText(kTextSize, 64), false);
+  return ReadString(json, iterations);
+}
+
+// An object holding arrays of objects with strings and numbers in them,
+// like a member the reader doesn't know and skips.
+string MakeNestedJson() {
+  string json;
+  {
+    io::StringOutputStream output(&json);
+    io::JsonWriter writer(&output);
+    writer.BeginObject();
+    for (int i = 0; i < 64; i++) {
+      writer.Name("list" + SimpleItoa(i));
+      writer.BeginArray();
+      for (int j = 0; j < 4; j++) {
+        writer.BeginObject();
+        writer.Name("id");
+        writer.Int32(i * 4 + j);
+        writer.Name("title");
+        writer.String(MakeText(32 + 16 * j, j == 3 ? 16 : 0));
+        writer.Name("tags");
+        writer.BeginArray();
+        writer.String("new");
+        writer.String("free");
+        writer.EndArray();
+        writer.EndObject();
+      }
+      writer.EndArray();
+    }
+    writer.EndObject();
+  }
+  return json;
+}
+
+int64 SkipObject(int iterations, bool structural) {
+  static const string json = MakeNestedJson();
+  for (int i = 0; i < iterations; i++) {
+    io::JsonReader reader(json.data(), json.size());
+    reader.SetStructuralSkip(structural);
+    if (!reader.SkipValue()) abort();
+  }
+  return static_cast<int64>(json.size()) * iterations;
+}
+
+int64 BM_SkipObject(int iterations) {
+  return SkipObject(iterations, false);
+}
+
+int64 BM_SkipObjectStructural(int iterations) {
+  return SkipObject(iterations, true);
+}
+
+int64 BM_ReadBytes(int iterations) {
+  static const string json = ToJson(MakeBlob(kBlobSize), true);
+  string value;
+  for (int i = 0; i < iterations; i++) {
+    io::JsonReader reader(json.data(), json.size());
+    if (!reader.ReadBytes(&value)) abort();
+  }
+  benchmark_sink = value.size();
+  return static_cast<int64>(json.size()) * iterations;
+}
+
+// -------------------------------------------------------------------
+// CodedInputStream.
+
+const int kVarintCount = 4096;
+
+// Varints of every size from one to five bytes, most of them short like
+// field values usually are.
+string MakeVarints() {
+  string data;
+  {
+    io::StringOutputStream output(&data);
+    io::CodedOutputStream coded(&output);
+    uint32 state = 12345;
+    for (int i = 0; i < kVarintCount; i++) {
+      state = state * 1103515245 + 12345;
+      coded.WriteVarint32(state >> (state % 32));
+    }
+  }
+  return data;
+}
+
+// Tags of the first 40 field numbers with their usual wire types, so that
+// most take one byte and some two.
+string MakeTags() {
+  string data;
+  {
+    io::StringOutputStream output(&data);
+    io::CodedOutputStream coded(&output);
+    for (int i = 0; i < kVarintCount; i++) {
+      int number = 1 + i % 40;
+      coded.WriteTag(internal::WireFormatLite::MakeTag(
+          number, number % 3 == 0 ?
+              internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED :
+              internal::WireFormatLite::WIRETYPE_VARINT));
+    }
+  }
+  return data;
+}
+
+int64 BM_ReadVarint32(int iterations) {
+  static const string data = MakeVarints();
+  uint32 sum = 0;
+  for (int i = 0; i < iterations; i++) {
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                               data.size());
+    for (int j = 0; j < kVarintCount; j++) {
+      uint32 value;
+      if (!input.ReadVarint32(&value)) abort();
+      sum += value;
+    }
+  }
+  benchmark_sink = sum;
+  return static_cast<int64>(data.size()) * iterations;
+}
+
+int64 BM_ReadTag(int iterations) {
+  static const string data = MakeTags();
+  uint32 sum = 0;
+  for (int i = 0; i < iterations; i++) {
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                               data.size());
+    for (int j = 0; j < kVarintCount; j++) {
+      sum += input.ReadTag();
+    }
+  }
+  benchmark_sink = sum;
+  return static_cast<int64>(data.size()) * iterations;
+}
+
+// -------------------------------------------------------------------
+// WireFormat and TextFormat, on a DynamicMessage.
+
+// descriptor.proto's own FileDescriptorProto as a DynamicMessage.  It has
+// the nesting and the mix of strings, numbers and repeated fields of a
+// real response.
+struct Payload {
+  DynamicMessageFactory factory;
+  const Message* prototype;
+  scoped_ptr<Message> message;
+  string wire;
+  string text;
+};
+
+const Payload& GetPayload() {
+  static Payload* payload = NULL;
+  if (payload == NULL) {
+    payload = new Payload;
+    FileDescriptorProto file;
+    FileDescriptorProto::descriptor()->file()->CopyTo(&file);
+    file.SerializeToString(&payload->wire);
+    payload->prototype =
+        payload->factory.GetPrototype(FileDescriptorProto::descriptor());
+    payload->message.reset(payload->prototype->New());
+    if (!payload->message->ParseFromString(payload->wire) ||
+        !TextFormat::PrintToString(*payload->message, &payload->text)) {
+      abort();
+    }
+  }
+  return *payload;
+}
+
+int64 BM_WireFormatParse(int iterations) {
+  const Payload& payload = GetPayload();
+  for (int i = 0; i < iterations; i++) {
+    scoped_ptr<Message> message(payload.prototype->New());
+    io::CodedInputStream input(
+        reinterpret_cast<const uint8*>(payload.wire.data()),
+        payload.wire.size());
+    if (!internal::WireFormat::ParseAndMergePartial(&input, message.get())) {
+      abort();
+    }
+  }
+  return static_cast<int64>(payload.wire.size()) * iterations;
+}
+
+int64 BM_WireFormatSerialize(int iterations) {
+  const Payload& payload = GetPayload();
+  string buffer(payload.wire.size(), '\0');
+  for (int i = 0; i < iterations; i++) {
+    io::ArrayOutputStream output(&buffer[0], buffer.size());
+    io::CodedOutputStream coded(&output);
+    int size = internal::WireFormat::ByteSize(*payload.message);
+    internal::WireFormat::SerializeWithCachedSizes(*payload.message, size,
+                                                   &coded);
+    if (coded.HadError()) abort();
+  }
+  benchmark_sink = buffer[0];
+  return static_cast<int64>(buffer.size()) * iterations;
+}
+
+int64 BM_TextFormatPrint(int iterations) {
+  const Payload& payload = GetPayload();
+  string text;
+  for (int i = 0; i < iterations; i++) {
+    text.clear();
+    if (!TextFormat::PrintToString(*payload.message, &text)) abort();
+  }
+  benchmark_sink = text.size();
+  return static_cast<int64>(payload.text.size()) * iterations;
+}
+
+int64 BM_TextFormatParse(int iterations) {
+  const Payload& payload = GetPayload();
+  for (int i = 0; i < iterations; i++) {
+    scoped_ptr<Message> message(payload.prototype->New());
+    if (!TextFormat::ParseFromString(payload.text, message.get())) abort();
+  }
+  return static_cast<int64>(payload.text.size()) * iterations;
+}
+
+// -------------------------------------------------------------------
+// io::Printer, as the generators drive it.
+
+const int kPrinterLines = 256;
+
+int64 BM_PrinterSubstitution(int iterations) {
+  map<string, string> variables;
+  variables["label"] = "optional";
+  variables["type"] = "CgiF2FPaySucPageResp";
+  variables["name"] = "exposure_info";
+  variables["number"] = "12";
+  variables["comment"] = "Set by the server.";
+  int64 bytes = 0;
+  for (int i = 0; i < iterations; i++) {
+    io::ArrayOutputStream output(output_buffer, sizeof(output_buffer));
+    {
+      io::Printer printer(&output, '$');
+      printer.Indent();
+      for (int j = 0; j < kPrinterLines; j++) {
+        printer.Print(variables,
+                      "$label$ $type$ $name$ = $number$;  // $comment$\n");
+      }
+      if (printer.failed()) abort();
+    }
+    bytes += output.ByteCount();
+  }
+  benchmark_sink = output_buffer[0];
+  return bytes;
+}
+
+// -------------------------------------------------------------------
+// Tokenizer and Parser.
+
+const int kProtoMessages = 200;
+
+// A .proto with kProtoMessages messages, each with an enum, options,
+// defaults and a field of the message before it.
+string MakeProtoFile() {
+  string text = "package bench;\n\n";
+  for (int i = 0; i < kProtoMessages; i++) {
+    string name = "Message" + SimpleItoa(i);
+    text += "// Comment for " + name + ".\n";
+    text += "message " + name + " {\n";
+    text += "  enum Kind { KIND_NONE = 0; KIND_TEXT = 1; KIND_IMAGE = 2; }\n";
+    text += "  optional int32 id = 1;\n";
+    text += "  optional string name = 2 [default = \"unnamed\"];\n";
+    text += "  optional Kind kind = 3 [default = KIND_TEXT];\n";
+    text += "  repeated int64 values = 4 [packed = true];\n";
+    text += "  optional double ratio = 5 [default = 0.5];\n";
+    text += "  optional bytes data = 6;\n";
+    text += "  optional bool enabled = 7;\n";
+    text += "  repeated string tags = 8;\n";
+    if (i > 0) {
+      text += "  repeated Message" + SimpleItoa(i - 1) + " children = 9;\n";
+    }
+    text += "}\n\n";
+  }
+  return text;
+}
+
+class AbortingErrorCollector : public io::ErrorCollector {
+ public:
+  void AddError(int line, int column, const string& message) {
+    fprintf(stderr, "%d:%d: %s\n", line + 1, column + 1, message.c_str());
+    abort();
+  }
+};
+
+int64 BM_ParseProto(int iterations) {
+  static const string text = MakeProtoFile();
+  AbortingErrorCollector error_collector;
+  for (int i = 0; i < iterations; i++) {
+    io::ArrayInputStream input(text.data(), text.size());
+    io::Tokenizer tokenizer(&input, &error_collector);
+    compiler::Parser parser;
+    parser.RecordErrorsTo(&error_collector);
+    FileDescriptorProto file;
+    if (!parser.Parse(&tokenizer, &file)) abort();
+    benchmark_sink = file.message_type_size();
+  }
+  return static_cast<int64>(text.size()) * iterations;
+}
+
+// -------------------------------------------------------------------
+// UTF-8 validation, which every string field of a parsed message goes
+// through.
+
+int64 ValidateUTF8(const string& text, int iterations) {
+  int valid = 0;
+  for (int i = 0; i < iterations; i++) {
+    valid += internal::IsStructurallyValidUTF8(text.data(), text.size());
+  }
+  if (valid != iterations) abort();
+  return static_cast<int64>(text.size()) * iterations;
+}
+
+int64 BM_Utf8Ascii(int iterations) {
+  static const string text = MakeText(kBlobSize, 0);
+  return ValidateUTF8(text, iterations);
+}
+
+// Chinese with some ASCII, like the display strings of our responses.
+int64 BM_Utf8Chinese(int iterations) {
+  static string text;
+  if (text.empty()) {
+    const char* kWords[] = {
+      "\xe6\x94\xaf\xe4\xbb\x98", "\xe6\x88\x90\xe5\x8a\x9f", " ", "ok",
+      "\xe7\xba\xa2\xe5\x8c\x85", ", "
+    };
+    for (int i = 0; text.size() < kBlobSize; i++) {
+      text += kWords[i % 6];
+    }
+  }
+  return ValidateUTF8(text, iterations);
+}
+
+// -------------------------------------------------------------------
+// Mock case generation, from the .proto on disk to the script, as
+// --mockcase_out does it.
+
+class StringOutputDirectory : public compiler::OutputDirectory {
+ public:
+  io::ZeroCopyOutputStream* Open(const string& filename) {
+    return new io::StringOutputStream(&files_[filename]);
+  }
+
+  int64 TotalSize() const {
+    int64 size = 0;
+    for (map<string, string>::const_iterator iter = files_.begin();
+         iter != files_.end(); ++iter) {
+      size += iter->second.size();
+    }
+    return size;
+  }
+
+ private:
+  map<string, string> files_;
+};
+
+class AbortingMultiFileErrorCollector
+    : public compiler::MultiFileErrorCollector {
+ public:
+  void AddError(const string& filename, int line, int column,
+                const string& message) {
+    fprintf(stderr, "%s:%d:%d: %s\n", filename.c_str(), line + 1, column + 1,
+            message.c_str());
+    abort();
+  }
+};
+
+int64 BM_MockCase(int iterations) {
+  compiler::objectivec::ObjectiveCGenerator generator;
+  AbortingMultiFileErrorCollector error_collector;
+  int64 bytes = 0;
+  for (int i = 0; i < iterations; i++) {
+    compiler::DiskSourceTree source_tree;
+    source_tree.MapPath("", proto_path);
+    compiler::Importer importer(&source_tree, &error_collector);
+    const FileDescriptor* file = importer.Import("TargetResponse.proto");
+    if (file == NULL) abort();
+    vector<const FileDescriptor*> parsed_files(1, file);
+    StringOutputDirectory output_directory;
+    string error;
+    if (!generator.GenerateForTarget("CgiF2FPaySucPageResp", "1234", "0",
+                                     parsed_files, "", &output_directory,
+                                     &error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      abort();
+    }
+    bytes += output_directory.TotalSize();
+  }
+  return bytes;
+}
+
+const Benchmark kBenchmarks[] = {
+  { "JsonWriter/CleanString",        &BM_WriteCleanString,    1             },
+  { "JsonWriter/EscapedString",      &BM_WriteEscapedString,  1             },
+  { "JsonWriter/Bytes",              &BM_WriteBytes,          1             },
+  { "JsonReader/CleanString",        &BM_ReadCleanString,     1             },
+  { "JsonReader/EscapedString",      &BM_ReadEscapedString,   1             },
+  { "JsonReader/Bytes",              &BM_ReadBytes,           1             },
+  { "JsonReader/SkipObject",         &BM_SkipObject,          1             },
+  { "JsonReader/SkipObjectStructural", &BM_SkipObjectStructural, 1           },
+  { "CodedInputStream/Varint32",     &BM_ReadVarint32,        kVarintCount  },
+  { "CodedInputStream/Tag",          &BM_ReadTag,             kVarintCount  },
+  { "WireFormat/ParseDynamic",       &BM_WireFormatParse,     1             },
+  { "WireFormat/SerializeDynamic",   &BM_WireFormatSerialize, 1             },
+  { "TextFormat/Print",              &BM_TextFormatPrint,     1             },
+  { "TextFormat/Parse",              &BM_TextFormatParse,     1             },
+  { "Printer/Substitution",          &BM_PrinterSubstitution, kPrinterLines },
+  { "Parser/LargeProto",             &BM_ParseProto,          1             },
+  { "UTF8/Ascii",                    &BM_Utf8Ascii,           1             },
+  { "UTF8/Chinese",                  &BM_Utf8Chinese,         1             },
+  { "MockCase/CgiF2FPaySucPageResp", &BM_MockCase,            1             },
+};
+
+// -------------------------------------------------------------------
+
+// Doubles the iteration count until a run takes long enough to time, then
+// reports that run.
+BenchmarkResult RunBenchmark(const Benchmark& benchmark) {
+  const double kMinSeconds = 0.5;
+  // Once untimed, so that inputs built on first use aren't counted.
+  benchmark.function(1);
+  int iterations = 1;
+  while (true) {
+    int64 allocations = allocation_count;
+    double start = Now();
+    int64 bytes = benchmark.function(iterations);
+    double seconds = Now() - start;
+    if (seconds >= kMinSeconds || iterations >= (1 << 30)) {
+      BenchmarkResult result;
+      result.name = benchmark.name;
+      result.iterations = iterations;
+      result.seconds = seconds;
+      result.bytes = bytes;
+      result.items =
+          static_cast<int64>(benchmark.items_per_iteration) * iterations;
+      result.allocations = allocation_count - allocations;
+      printf("%-32s %12.1f ns/iter %10.1f MB/s %14.0f items/s "
+             "%10.1f allocs/iter\n", result.name,
+             seconds * 1e9 / iterations, bytes / seconds / (1 << 20),
+             result.items / seconds,
+             static_cast<double>(result.allocations) / iterations);
+      fflush(stdout);
+      return result;
+    }
+    iterations *= 2;
+  }
+}
+
+bool WriteResults(const vector<BenchmarkResult>& results,
+                  const string& filename) {
+  int file = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (file < 0) {
+    fprintf(stderr, "%s: %s\n", filename.c_str(), strerror(errno));
+    return false;
+  }
+  io::FileOutputStream output(file);
+  {
+    io::JsonWriter writer(&output);
+    writer.BeginArray();
+    for (int i = 0; i < results.size(); i++) {
+      const BenchmarkResult& result = results[i];
+      writer.BeginObject();
+      writer.Name("name");
+      writer.String(result.name);
+      writer.Name("iterations");
+      writer.Int32(result.iterations);
+      writer.Name("nsPerIteration");
+      writer.Double(result.seconds * 1e9 / result.iterations);
+      writer.Name("bytesPerSecond");
+      writer.Double(result.bytes / result.seconds);
+      writer.Name("itemsPerSecond");
+      writer.Double(result.items / result.seconds);
+      writer.Name("allocationsPerIteration");
+      writer.Double(static_cast<double>(result.allocations) /
+                    result.iterations);
+      writer.EndObject();
+    }
+    writer.EndArray();
+  }
+  if (!output.Close()) {
+    fprintf(stderr, "%s: %s\n", filename.c_str(),
+            strerror(output.GetErrno()));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  using google::protobuf::kBenchmarks;
+  const char* filter = "";
+  std::string results_name;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--results=", 10) == 0) {
+      results_name = argv[i] + 10;
+    } else if (strncmp(argv[i], "--proto_path=", 13) == 0) {
+      google::protobuf::proto_path = argv[i] + 13;
+    } else {
+      filter = argv[i];
+    }
+  }
+
+  std::string target_proto =
+      google::protobuf::proto_path + "/TargetResponse.proto";
+  bool have_target = access(target_proto.c_str(), R_OK) == 0;
+
+  std::vector<google::protobuf::BenchmarkResult> results;
+  int count = sizeof(kBenchmarks) / sizeof(kBenchmarks[0]);
+  for (int i = 0; i < count; i++) {
+    if (strstr(kBenchmarks[i].name, filter) == NULL) continue;
+    if (strncmp(kBenchmarks[i].name, "MockCase/", 9) == 0 && !have_target) {
+      fprintf(stderr, "%s: skipped, %s not found.\n", kBenchmarks[i].name,
+              target_proto.c_str());
+      continue;
+    }
+    results.push_back(google::protobuf::RunBenchmark(kBenchmarks[i]));
+  }
+
+  if (!results_name.empty() &&
+      !google::protobuf::WriteResults(results, results_name)) {
+    return 1;
+  }
+  return 0;
+}
@@ -43,6 +43,22 @@ namespace compiler {
 CodeGenerator::~CodeGenerator() {}
 OutputDirectory::~OutputDirectory() {}
 
+bool CodeGenerator::GenerateForTarget(
+    const string& target_message,
+    const string& cgi_number,
+    const string& is_update_from_svr,
+    const vector<const FileDescriptor*>& parsed_files,
+    const string& parameter,
+    OutputDirectory* output_directory,
+    string* error) const {
+  for (int i = 0; i < parsed_files.size(); i++) {
+    if (!Generate(parsed_files[i], parameter, output_directory, error)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Parses a set of comma-delimited name/value pairs.
 void ParseGeneratorParameter(const string& text,
 			     vector<pair<string, string> >* output) {
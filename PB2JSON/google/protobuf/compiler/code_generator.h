@@ -78,10 +78,19 @@ class LIBPROTOC_EXPORT CodeGenerator {
                         const string& parameter,
                         OutputDirectory* output_directory,
                         string* error) const = 0;
-    
-    //virtual bool GenerateMockCase(const string target_message,vector<const FileDescriptor*> parsed_files, const string& parameter,
-    //                              OutputDirectory* output_directory,
-    //                              string* error) const;
+
+  // PB2JSON generators work from one message type, named by --target, and
+  // everything it references, rather than from each input file.  cgi_number
+  // and is_update_from_svr are the values of --cgiNumber and
+  // --isUpdateFromSvr, for the generators which use them.  The default
+  // implementation ignores all three and calls Generate() on each file.
+  virtual bool GenerateForTarget(const string& target_message,
+                                 const string& cgi_number,
+                                 const string& is_update_from_svr,
+                                 const vector<const FileDescriptor*>& parsed_files,
+                                 const string& parameter,
+                                 OutputDirectory* output_directory,
+                                 string* error) const;
 
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(CodeGenerator);
@@ -45,17 +45,35 @@
 #include <errno.h>
 #include <iostream>
 #include <ctype.h>
+#include <algorithm>
 
 #include <google/protobuf/compiler/command_line_interface.h>
 #include <google/protobuf/compiler/importer.h>
 #include <google/protobuf/compiler/code_generator.h>
+#include <google/protobuf/compiler/mock_bundle.h>
+#include <google/protobuf/compiler/mock_server.h>
+#include <google/protobuf/compiler/mock_shard.h>
+#include <google/protobuf/compiler/payload_generator.h>
+#include <google/protobuf/compiler/payload_profile.h>
+#include <google/protobuf/compiler/symbol_index.h>
+#include <google/protobuf/compiler/symbol_scanner.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/text_format.h>
+#include <google/protobuf/trace.h>
 #include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/field_projection.h>
+#include <google/protobuf/json_parser.h>
+#include <google/protobuf/json_transcoder.h>
+#include <google/protobuf/memory_report.h>
+#include <google/protobuf/schema_image.h>
+#include <google/protobuf/stats.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/json_reader.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/strutil.h>
-#include <google/protobuf/compiler/objectivec/objectivec_generator.h>
 
 
 namespace google {
@@ -93,6 +111,12 @@ static const char* kPathSeparator = ";";
 static const char* kPathSeparator = ":";
 #endif
 
+// Where --serve_mock_bundle listens if --listen isn't given.
+static const char* kDefaultListenAddress = "127.0.0.1:8080";
+
+// --synthesize writes megabytes at a time, so write to stdout in big blocks.
+static const int kSynthesizeBufferSize = 1 << 20;
+
 // Returns true if the text looks like a Windows-style absolute path, starting
 // with a drive letter.  Example:  "C:\foo".  TODO(kenton):  Share this with
 // copy in importer.cc?
@@ -107,6 +131,16 @@ static bool IsWindowsAbsolutePath(const string& text) {
 #endif
 }
 
+// Used to pick how many threads scan for the symbol index.
+int ProcessorCount() {
+#ifdef _WIN32
+  return 1;
+#else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count < 1 ? 1 : min(count, 16L);
+#endif
+}
+
 void SetFdToTextMode(int fd) {
 #ifdef _WIN32
   if (_setmode(fd, _O_TEXT) == -1) {
@@ -127,6 +161,126 @@ void SetFdToBinaryMode(int fd) {
   // (Text and binary are the same on non-Windows platforms.)
 }
 
+// --decode_json streams, but holds back up to this much output (and keeps up
+// to this much input) so that out-of-order input can still be handled.
+static const int kDecodeHoldLimit = 1 << 20;
+
+// Passes reads through from another stream, keeping a copy of everything read
+// until the copy would grow past a limit.
+class RecordingInputStream : public io::ZeroCopyInputStream {
+ public:
+  RecordingInputStream(io::ZeroCopyInputStream* input, int limit)
+    : input_(input), limit_(limit), complete_(true) {}
+
+  // The bytes read so far.  Only meaningful if complete() is true.
+  const string& recorded() const { return recorded_; }
+  // False once the input grew past the limit and the copy was dropped.
+  bool complete() const { return complete_; }
+
+  // implements ZeroCopyInputStream ----------------------------------
+  bool Next(const void** data, int* size) {
+    if (!input_->Next(data, size)) return false;
+    if (complete_) {
+      if (recorded_.size() + *size > static_cast<size_t>(limit_)) {
+        complete_ = false;
+        string().swap(recorded_);
+      } else {
+        recorded_.append(reinterpret_cast<const char*>(*data), *size);
+      }
+    }
+    return true;
+  }
+  void BackUp(int count) {
+    input_->BackUp(count);
+    if (complete_) recorded_.resize(recorded_.size() - count);
+  }
+  bool Skip(int count) {
+    // Skipped bytes have to be recorded too, so read them.
+    const void* data;
+    int size;
+    while (count > 0) {
+      if (!Next(&data, &size)) return false;
+      if (size > count) {
+        BackUp(size - count);
+        size = count;
+      }
+      count -= size;
+    }
+    return true;
+  }
+  int64 ByteCount() const { return input_->ByteCount(); }
+
+ private:
+  io::ZeroCopyInputStream* input_;
+  int limit_;
+  bool complete_;
+  string recorded_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(RecordingInputStream);
+};
+
+// Holds written data in memory until it grows past a limit, then writes it
+// to another stream and passes everything after that straight through.
+class HeldOutputStream : public io::ZeroCopyOutputStream {
+ public:
+  HeldOutputStream(io::ZeroCopyOutputStream* output, int limit)
+    : output_(output), held_output_(&held_), limit_(limit),
+      released_(false) {}
+
+  // True once anything has been passed on to the underlying stream.
+  bool released() const { return released_; }
+
+  // Writes out everything held so far.
+  bool Release() {
+    released_ = true;
+    const char* data = held_.data();
+    int remaining = held_.size();
+    while (remaining > 0) {
+      void* buffer;
+      int size;
+      if (!output_->Next(&buffer, &size)) return false;
+      if (size > remaining) {
+        output_->BackUp(size - remaining);
+        size = remaining;
+      }
+      memcpy(buffer, data, size);
+      data += size;
+      remaining -= size;
+    }
+    string().swap(held_);
+    return true;
+  }
+
+  // implements ZeroCopyOutputStream ---------------------------------
+  bool Next(void** data, int* size) {
+    if (released_) return output_->Next(data, size);
+    // Everything returned by earlier calls has been written by now.
+    if (held_.size() >= static_cast<size_t>(limit_)) {
+      return Release() && output_->Next(data, size);
+    }
+    return held_output_.Next(data, size);
+  }
+  void BackUp(int count) {
+    if (released_) {
+      output_->BackUp(count);
+    } else {
+      held_output_.BackUp(count);
+    }
+  }
+  int64 ByteCount() const {
+    return released_ ? output_->ByteCount() : held_output_.ByteCount();
+  }
+
+ private:
+  io::ZeroCopyOutputStream* output_;
+  string held_;
+  io::StringOutputStream held_output_;
+  int limit_;
+  bool released_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(HeldOutputStream);
+};
+
 }  // namespace
 
 // A MultiFileErrorCollector that prints errors to stderr.
@@ -245,6 +399,8 @@ bool CommandLineInterface::DiskOutputDirectory::VerifyExistence() {
 
 io::ZeroCopyOutputStream* CommandLineInterface::DiskOutputDirectory::Open(
     const string& filename) {
+  TraceSpan span("CreateFile", filename);
+
   // Recursively create parent directories to the output file.
   vector<string> parts;
   SplitStringUsing(filename, "/", &parts);
@@ -292,6 +448,10 @@ CommandLineInterface::ErrorReportingFileOutput::ErrorReportingFileOutput(
     directory_(directory) {}
 
 CommandLineInterface::ErrorReportingFileOutput::~ErrorReportingFileOutput() {
+  // Generated files are usually smaller than the stream's buffer, so this is
+  // when they are written.
+  TraceSpan span("WriteFile", filename_);
+
   // Check if we had any errors while writing.
   if (file_stream_->GetErrno() != 0) {
     cerr << filename_ << ": " << strerror(file_stream_->GetErrno()) << endl;
@@ -312,6 +472,13 @@ CommandLineInterface::CommandLineInterface()
     error_format_(ERROR_FORMAT_GCC),
     imports_in_descriptor_set_(false),
     disallow_services_(false),
+    lazy_import_(false),
+    shard_index_(0),
+    shard_count_(1),
+    synthesize_count_(0),
+    synthesize_seed_(0),
+    synthesize_json_(false),
+    synthesize_threads_(0),
     inputs_are_proto_path_relative_(false) {}
 CommandLineInterface::~CommandLineInterface() {}
 
@@ -327,6 +494,85 @@ void CommandLineInterface::RegisterGenerator(const string& flag_name,
 int CommandLineInterface::Run(int argc, const char* const argv[]) {
   Clear();
   if (!ParseArguments(argc, argv)) return 1;
+  if (!stats_format_.empty()) EnableStats(true);
+  if (!trace_out_name_.empty()) StartTracing();
+
+  int result;
+  {
+    TraceSpan span("Run");
+    result = Execute();
+  }
+
+  if (!stats_format_.empty()) {
+    StatsSnapshot snapshot;
+    SnapshotStats(&snapshot);
+    string text;
+    if (stats_format_ == "json") {
+      StatsToJson(snapshot, &text);
+      text.push_back('\n');
+    } else {
+      StatsToText(snapshot, &text);
+    }
+    cerr << text;
+  }
+  if (!trace_out_name_.empty() && !WriteTrace()) return 1;
+  return result;
+}
+
+bool CommandLineInterface::WriteTrace() {
+  int file_descriptor;
+  do {
+    file_descriptor = open(trace_out_name_.c_str(),
+                           O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666);
+  } while (file_descriptor < 0 && errno == EINTR);
+  if (file_descriptor < 0) {
+    cerr << trace_out_name_ << ": " << strerror(errno) << endl;
+    StopTracing(NULL);
+    return false;
+  }
+  io::FileOutputStream output(file_descriptor);
+  if (!StopTracing(&output) || !output.Close()) {
+    cerr << trace_out_name_ << ": " << strerror(output.GetErrno()) << endl;
+    return false;
+  }
+  return true;
+}
+
+int CommandLineInterface::Execute() {
+  // --merge_mock_shards doesn't look at any .proto files.  The shards are
+  // either --mockcase_out directories or --mock_bundle_out files.
+  if (!merge_bundle_name_.empty()) {
+    struct stat info;
+    bool bundles = stat(input_files_[0].c_str(), &info) == 0 &&
+                   !S_ISDIR(info.st_mode);
+    string error;
+    if (bundles ?
+        !MergeMockBundles(input_files_, merge_bundle_name_, &error) :
+        !MergeMockShards(input_files_, merge_bundle_name_, &error)) {
+      cerr << error << endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  // Nor does --serve_mock_bundle, which runs until killed.
+  if (!serve_bundle_name_.empty()) {
+    MockServer server;
+    string error;
+    if (!server.Start(serve_bundle_name_, listen_address_, &error) ||
+        !server.Run(&error)) {
+      cerr << error << endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  // --decode_json with --schema_image takes the types from the image
+  // instead.
+  if (!schema_image_name_.empty()) {
+    TraceSpan span("DecodeJson", codec_type_);
+    return DecodeToJsonWithImage() ? 0 : 1;
+  }
 
   // Set up the source tree.
   DiskSourceTree source_tree;
@@ -345,23 +591,51 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
   ErrorPrinter error_collector(error_format_);
   Importer importer(&source_tree, &error_collector);
 
+  // Bring the --symbol_index up to date with the proto_path.  Only files
+  // which changed since the last run are read.
+  SymbolIndex symbol_index;
+  if (!symbol_index_name_.empty()) {
+    TraceSpan span("UpdateSymbolIndex", symbol_index_name_);
+    symbol_index.Load(symbol_index_name_);
+    symbol_index.Update(proto_path_, ProcessorCount());
+    if (symbol_index.modified() && !symbol_index.Save(symbol_index_name_)) {
+      cerr << symbol_index_name_ << ": warning: could not save symbol index."
+           << endl;
+    }
+    importer.UseSymbolIndex(&symbol_index);
+  }
+
+  if (!manifest_name_.empty()) {
+    return GenerateMockShard(&source_tree, symbol_index, &importer) ? 0 : 1;
+  }
+
+  // With --symbol_index or --lazy_import, only import the file defining the
+  // type we need; the Importer then brings in just its dependencies.  If
+  // neither can find the type, import everything as usual so the error is
+  // the same.
+  vector<string> files_to_import;
+  const string& lazy_type =
+      mode_ == MODE_COMPILE || mode_ == MODE_SYNTHESIZE ||
+      mode_ == MODE_PROFILE || mode_ == MODE_MEMORY_REPORT ?
+      target_message_ : codec_type_;
+  string defining_file;
+  if (!lazy_type.empty() &&
+      ((!symbol_index_name_.empty() &&
+        FindIndexedFileDefining(symbol_index, lazy_type, &defining_file,
+                                NULL)) ||
+       (lazy_import_ &&
+        FindInputDefining(&source_tree, lazy_type, &defining_file)))) {
+    files_to_import.push_back(defining_file);
+  } else {
+    files_to_import = input_files_;
+  }
+
   vector<const FileDescriptor*> parsed_files;
 
   // Parse each file and generate output.
-  for (int i = 0; i < input_files_.size(); i++) {
+  for (int i = 0; i < files_to_import.size(); i++) {
     // Import the file.
-    const FileDescriptor* parsed_file = importer.Import(input_files_[i]);
-    
-      //printf("parsedfile_name:%s\n \
-             parsefile_count:%d\n \
-             parsefile_dependency_count:%d\n ", parsed_file->name().c_str(),parsed_file->message_type_count(), parsed_file->dependency_count());
-      if (strcmp(parsed_file->name().c_str(), "BaseResponse.proto") == 0 ) {
-          const Descriptor *messageType = parsed_file->FindMessageTypeByName("BaseResponse");
-          if (messageType != NULL) {
-              printf("messageTypeName:%s\n", messageType->name().c_str());
-          }
-      }
-      
+    const FileDescriptor* parsed_file = importer.Import(files_to_import[i]);
     if (parsed_file == NULL) return 1;
     parsed_files.push_back(parsed_file);
 
@@ -378,12 +652,26 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
         //PB2JSON Generate output files.
         const string target_message = target_message_;
         for (int i = 0; i < output_directives_.size(); i++) {
-            if (!PB2JSONGenerateOutput(parsed_files, output_directives_[i])) {
+            if (!PB2JSONGenerateOutput(target_message_, cgi_number_,
+                                       isUpdateFromSvr_, parsed_files,
+                                       output_directives_[i])) {
                 return 1;
             }
         }
     }
 
+  if (!schema_image_out_name_.empty()) {
+    TraceSpan span("WriteSchemaImage", schema_image_out_name_);
+    SchemaImageWriter writer;
+    for (int i = 0; i < parsed_files.size(); i++) {
+      writer.AddFile(parsed_files[i]);
+    }
+    string error;
+    if (!writer.Write(schema_image_out_name_, &error)) {
+      cerr << error << endl;
+      return 1;
+    }
+  }
     
   /*
   if (!descriptor_set_name_.empty()) {
@@ -391,8 +679,10 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
       return 1;
     }
   }
+   */
 
   if (mode_ == MODE_ENCODE || mode_ == MODE_DECODE) {
+    TraceSpan span(mode_ == MODE_ENCODE ? "Encode" : "Decode", codec_type_);
     if (codec_type_.empty()) {
       // HACK:  Define an EmptyMessage type to use for decoding.
       DescriptorPool pool;
@@ -410,7 +700,41 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
       }
     }
   }
-   */
+
+  if (mode_ == MODE_DECODE_JSON) {
+    TraceSpan span("DecodeJson", codec_type_);
+    if (!DecodeToJson(importer.pool())) {
+      return 1;
+    }
+  }
+
+  if (mode_ == MODE_ENCODE_JSON) {
+    TraceSpan span("EncodeJson", codec_type_);
+    if (!EncodeFromJson(importer.pool())) {
+      return 1;
+    }
+  }
+
+  if (mode_ == MODE_SYNTHESIZE) {
+    TraceSpan span("Synthesize", target_message_);
+    if (!Synthesize(parsed_files, importer.pool())) {
+      return 1;
+    }
+  }
+
+  if (mode_ == MODE_PROFILE) {
+    TraceSpan span("ProfileCorpus", corpus_name_);
+    if (!ProfileCapture(parsed_files, importer.pool())) {
+      return 1;
+    }
+  }
+
+  if (mode_ == MODE_MEMORY_REPORT) {
+    TraceSpan span("ReportMemory", corpus_name_);
+    if (!ReportMemory(parsed_files, importer.pool())) {
+      return 1;
+    }
+  }
     
   return 0;
 }
@@ -423,11 +747,226 @@ void CommandLineInterface::Clear() {
   input_files_.clear();
   output_directives_.clear();
   codec_type_.clear();
+  codec_fields_.clear();
   descriptor_set_name_.clear();
 
   mode_ = MODE_COMPILE;
   imports_in_descriptor_set_ = false;
   disallow_services_ = false;
+  lazy_import_ = false;
+  symbol_index_name_.clear();
+  manifest_name_.clear();
+  shard_index_ = 0;
+  shard_count_ = 1;
+  merge_bundle_name_.clear();
+  mock_bundle_name_.clear();
+  serve_bundle_name_.clear();
+  listen_address_ = kDefaultListenAddress;
+  synthesize_count_ = 0;
+  synthesize_seed_ = 0;
+  synthesize_json_ = false;
+  synthesize_threads_ = 0;
+  synthesize_profile_name_.clear();
+  corpus_name_.clear();
+  profile_out_name_.clear();
+  memory_report_json_ = false;
+  encode_json_ndjson_ = false;
+  schema_image_out_name_.clear();
+  schema_image_name_.clear();
+  trace_out_name_.clear();
+  stats_format_.clear();
+}
+
+bool CommandLineInterface::FindIndexedFileDefining(
+    const SymbolIndex& symbol_index, const string& type_name,
+    string* file, string* full_name) {
+  vector<SymbolIndex::Location> locations;
+  if (!symbol_index.Find(type_name, &locations)) return false;
+
+  // If the name is defined more than once, prefer the last input file, as
+  // the generators do, and otherwise the first on the proto_path.
+  int chosen = 0;
+  for (int i = locations.size() - 1; i >= 0; i--) {
+    if (find(input_files_.begin(), input_files_.end(), locations[i].file) !=
+        input_files_.end()) {
+      chosen = i;
+      break;
+    }
+  }
+  *file = locations[chosen].file;
+  if (full_name != NULL) *full_name = locations[chosen].full_name;
+  return true;
+}
+
+bool CommandLineInterface::ResolveMockTargets(
+    SourceTree* source_tree, const SymbolIndex& symbol_index,
+    vector<MockTarget>* targets) {
+  // Without an index, skim every input once up front, rather than once per
+  // target as --lazy_import does.  Maps the plain names of top-level
+  // messages to (file, full name); later files win, as in the generators.
+  map<string, pair<string, string> > inputs_by_name;
+  if (symbol_index_name_.empty()) {
+    ScannedProtoFile scanned;
+    string contents;
+    for (int i = 0; i < input_files_.size(); i++) {
+      scoped_ptr<io::ZeroCopyInputStream> input(
+          source_tree->Open(input_files_[i]));
+      if (input == NULL) continue;
+      ReadWholeStream(input.get(), &contents);
+      ScanProtoSymbols(contents.data(), contents.size(), &scanned);
+
+      int prefix_size = scanned.package.empty() ? 0 :
+                        scanned.package.size() + 1;
+      for (int j = 0; j < scanned.symbols.size(); j++) {
+        if (!scanned.is_top_level_message[j]) continue;
+        inputs_by_name[scanned.symbols[j].substr(prefix_size)] =
+            make_pair(input_files_[i], scanned.symbols[j]);
+      }
+    }
+  }
+
+  for (int i = 0; i < targets->size(); i++) {
+    MockTarget* target = &(*targets)[i];
+    if (symbol_index_name_.empty()) {
+      map<string, pair<string, string> >::const_iterator iter =
+          inputs_by_name.find(target->message);
+      if (iter != inputs_by_name.end()) {
+        target->file = iter->second.first;
+        target->full_name = iter->second.second;
+      }
+    } else {
+      FindIndexedFileDefining(symbol_index, target->message, &target->file,
+                              &target->full_name);
+    }
+    if (target->file.empty()) {
+      cerr << manifest_name_ << ": " << target->message
+           << ": message type not found." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CommandLineInterface::GenerateMockShard(SourceTree* source_tree,
+                                             const SymbolIndex& symbol_index,
+                                             Importer* importer) {
+  vector<MockTarget> targets;
+  string error;
+  if (!ReadMockManifest(manifest_name_, &targets, &error)) {
+    cerr << error << endl;
+    return false;
+  }
+  if (!ResolveMockTargets(source_tree, symbol_index, &targets)) {
+    return false;
+  }
+
+  DynamicMessageFactory dynamic_factory(importer->pool());
+  MockBundleWriter bundle_writer;
+  string wire, json;
+
+  // Only this shard's targets are imported, so it only pays for their
+  // dependencies.
+  for (int i = 0; i < targets.size(); i++) {
+    const MockTarget& target = targets[i];
+    if (MockShardOf(target.full_name, shard_count_) != shard_index_) continue;
+
+    const FileDescriptor* parsed_file = importer->Import(target.file);
+    if (parsed_file == NULL) return false;
+    vector<const FileDescriptor*> parsed_files(1, parsed_file);
+    for (int j = 0; j < output_directives_.size(); j++) {
+      if (!PB2JSONGenerateOutput(target.message, target.cgi_number,
+                                 target.is_update_from_svr, parsed_files,
+                                 output_directives_[j])) {
+        return false;
+      }
+    }
+
+    if (!mock_bundle_name_.empty()) {
+      uint32 cgi_number;
+      bool is_update_from_svr;
+      if (!ParseMockKey(target, &cgi_number, &is_update_from_svr)) {
+        return false;
+      }
+      const Descriptor* type =
+          importer->pool()->FindMessageTypeByName(target.full_name);
+      if (type == NULL) {
+        cerr << manifest_name_ << ": " << target.message
+             << ": message type not found." << endl;
+        return false;
+      }
+      TraceSpan span("BuildMockResponse", target.full_name);
+      BuildMockResponse(type, &dynamic_factory, &wire, &json);
+      if (!bundle_writer.Add(cgi_number, is_update_from_svr, type->full_name(),
+                             json, wire)) {
+        cerr << manifest_name_ << ": " << target.message << ": cgiNumber "
+             << cgi_number << ", isUpdateFromSvr " << is_update_from_svr
+             << " is already taken." << endl;
+        return false;
+      }
+    }
+  }
+
+  if (!mock_bundle_name_.empty()) {
+    TraceSpan span("WriteMockBundle", mock_bundle_name_);
+    if (!bundle_writer.Write(mock_bundle_name_, &error)) {
+      cerr << error << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CommandLineInterface::ParseMockKey(const MockTarget& target,
+                                        uint32* cgi_number,
+                                        bool* is_update_from_svr) {
+  uint64 number;
+  const string& flag = target.is_update_from_svr;
+  if (!ParseUnsignedDigits(target.cgi_number.data(),
+                           target.cgi_number.data() + target.cgi_number.size(),
+                           10, kuint32max, &number)) {
+    cerr << manifest_name_ << ": " << target.message << ": cgiNumber must be "
+            "a 32-bit unsigned integer to go in a bundle." << endl;
+    return false;
+  }
+  *cgi_number = number;
+  if (flag == "1" || flag == "true") {
+    *is_update_from_svr = true;
+  } else if (flag == "0" || flag == "false") {
+    *is_update_from_svr = false;
+  } else {
+    cerr << manifest_name_ << ": " << target.message << ": isUpdateFromSvr "
+            "must be 0, 1, true or false to go in a bundle." << endl;
+    return false;
+  }
+  return true;
+}
+
+bool CommandLineInterface::FindInputDefining(SourceTree* source_tree,
+                                             const string& type_name,
+                                             string* input_file) {
+  // Go backwards, since when several files define the same name the
+  // generators use the last one.
+  ScannedProtoFile scanned;
+  string contents;
+  for (int i = input_files_.size() - 1; i >= 0; i--) {
+    scoped_ptr<io::ZeroCopyInputStream> input(
+        source_tree->Open(input_files_[i]));
+    if (input == NULL) continue;
+    ReadWholeStream(input.get(), &contents);
+    ScanProtoSymbols(contents.data(), contents.size(), &scanned);
+
+    string relative_name = scanned.package.empty() ?
+        type_name : scanned.package + "." + type_name;
+    for (int j = 0; j < scanned.symbols.size(); j++) {
+      if (scanned.symbols[j] == type_name ||
+          (scanned.is_top_level_message[j] &&
+           scanned.symbols[j] == relative_name)) {
+        *input_file = input_files_[i];
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
 bool CommandLineInterface::MakeInputsBeProtoPathRelative(
@@ -499,15 +1038,106 @@ bool CommandLineInterface::ParseArguments(int argc, const char* const argv[]) {
   if (decoding_raw && !input_files_.empty()) {
     cerr << "When using --decode_raw, no input files should be given." << endl;
     return false;
-  } else if (!decoding_raw && input_files_.empty()) {
+  } else if (!decoding_raw && input_files_.empty() &&
+             symbol_index_name_.empty() && serve_bundle_name_.empty() &&
+             schema_image_name_.empty()) {
     cerr << "Missing input file." << endl;
     return false;
   }
+  if (!serve_bundle_name_.empty()) {
+    if (mode_ != MODE_COMPILE || !output_directives_.empty() ||
+        !manifest_name_.empty() || !merge_bundle_name_.empty() ||
+        !input_files_.empty() || !trace_out_name_.empty() ||
+        !stats_format_.empty()) {
+      cerr << "--serve_mock_bundle can't be combined with other work."
+           << endl;
+      return false;
+    }
+    return true;
+  }
+  if (!merge_bundle_name_.empty()) {
+    if (mode_ != MODE_COMPILE || !output_directives_.empty() ||
+        !manifest_name_.empty()) {
+      cerr << "--merge_mock_shards can't be combined with generating or "
+              "decoding." << endl;
+      return false;
+    }
+    return true;
+  }
+  if (!schema_image_name_.empty()) {
+    if (mode_ != MODE_DECODE_JSON || !input_files_.empty()) {
+      cerr << "--schema_image replaces PROTO_FILES, and can only be used "
+              "with --decode_json." << endl;
+      return false;
+    }
+    if (!codec_fields_.empty()) {
+      cerr << "--fields can't be used with --schema_image." << endl;
+      return false;
+    }
+  }
+  if (!schema_image_out_name_.empty() && mode_ != MODE_COMPILE) {
+    cerr << "Cannot use --encode or --decode and write a schema image at the "
+            "same time." << endl;
+    return false;
+  }
   if (mode_ == MODE_COMPILE && output_directives_.empty() &&
-      descriptor_set_name_.empty()) {
+      descriptor_set_name_.empty() && mock_bundle_name_.empty() &&
+      schema_image_out_name_.empty()) {
     cerr << "Missing output directives." << endl;
     return false;
   }
+  if (!codec_fields_.empty() &&
+      ((mode_ != MODE_DECODE && mode_ != MODE_DECODE_JSON) || decoding_raw)) {
+    cerr << "--fields can only be used with --decode or --decode_json."
+         << endl;
+    return false;
+  }
+  if (!manifest_name_.empty() &&
+      (mode_ != MODE_COMPILE || !target_message_.empty())) {
+    cerr << "--manifest replaces --target, and can't be used with --encode "
+            "or --decode." << endl;
+    return false;
+  }
+  if (!mock_bundle_name_.empty() && manifest_name_.empty()) {
+    cerr << "--mock_bundle_out requires --manifest." << endl;
+    return false;
+  }
+  if ((mode_ == MODE_SYNTHESIZE || mode_ == MODE_PROFILE ||
+       mode_ == MODE_MEMORY_REPORT) &&
+      target_message_.empty()) {
+    cerr << (mode_ == MODE_SYNTHESIZE ? "--synthesize" :
+             mode_ == MODE_PROFILE ? "--profile_corpus" : "--memory_report")
+         << " requires --target." << endl;
+    return false;
+  }
+  if (mode_ != MODE_MEMORY_REPORT && memory_report_json_) {
+    cerr << "--memory_report_format requires --memory_report." << endl;
+    return false;
+  }
+  if (mode_ != MODE_ENCODE_JSON && encode_json_ndjson_) {
+    cerr << "--encode_json_format requires --encode_json." << endl;
+    return false;
+  }
+  if (mode_ != MODE_SYNTHESIZE &&
+      (synthesize_seed_ != 0 || synthesize_json_ || synthesize_threads_ != 0 ||
+       !synthesize_profile_name_.empty())) {
+    cerr << "--synthesize_seed, --synthesize_format, --synthesize_threads "
+            "and --synthesize_profile require --synthesize." << endl;
+    return false;
+  }
+  if ((mode_ == MODE_PROFILE) != !profile_out_name_.empty()) {
+    cerr << "--profile_corpus and --profile_out must be used together."
+         << endl;
+    return false;
+  }
+  if (shard_count_ != 1 && manifest_name_.empty()) {
+    cerr << "--shard_count requires --manifest." << endl;
+    return false;
+  }
+  if (shard_index_ >= shard_count_) {
+    cerr << "--shard_index must be less than --shard_count." << endl;
+    return false;
+  }
   if (imports_in_descriptor_set_ && descriptor_set_name_.empty()) {
     cerr << "--include_imports only makes sense when combined with "
             "--descriptor_set_out." << endl;
@@ -563,6 +1193,7 @@ bool CommandLineInterface::ParseArgument(const char* arg,
   if (*name == "-h" || *name == "--help" ||
       *name == "--disallow_services" ||
       *name == "--include_imports" ||
+      *name == "--lazy_import" ||
       *name == "--version" ||
       *name == "--decode_raw") {
     // HACK:  These are the only flags that don't take a value.
@@ -662,10 +1293,180 @@ bool CommandLineInterface::InterpretArgument(const string& name,
   } else if (name == "--disallow_services") {
     disallow_services_ = true;
 
+  } else if (name == "--lazy_import") {
+    lazy_import_ = true;
+
+  } else if (name == "--symbol_index") {
+    if (!symbol_index_name_.empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return false;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return false;
+    }
+    symbol_index_name_ = value;
+
+  } else if (name == "--manifest" || name == "--merge_mock_shards" ||
+             name == "--mock_bundle_out" || name == "--serve_mock_bundle") {
+    string* target = name == "--manifest" ? &manifest_name_ :
+                     name == "--merge_mock_shards" ? &merge_bundle_name_ :
+                     name == "--mock_bundle_out" ? &mock_bundle_name_ :
+                     &serve_bundle_name_;
+    if (!target->empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return false;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return false;
+    }
+    *target = value;
+
+  } else if (name == "--stats") {
+    if (value != "text" && value != "json") {
+      cerr << name << " must be text or json." << endl;
+      return false;
+    }
+    stats_format_ = value;
+
+  } else if (name == "--listen") {
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return false;
+    }
+    listen_address_ = value;
+
+  } else if (name == "--shard_index" || name == "--shard_count") {
+    char* end;
+    int32 number = strto32(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' ||
+        number < (name == "--shard_index" ? 0 : 1)) {
+      cerr << name << " requires a "
+           << (name == "--shard_index" ? "non-negative" : "positive")
+           << " integer." << endl;
+      return false;
+    }
+    if (name == "--shard_index") {
+      shard_index_ = number;
+    } else {
+      shard_count_ = number;
+    }
+
+  } else if (name == "--synthesize" || name == "--profile_corpus" ||
+             name == "--memory_report") {
+    if (mode_ != MODE_COMPILE) {
+      cerr << "Only one of --encode, --decode, --encode_json, --decode_json, "
+              "--synthesize, --profile_corpus and --memory_report can be "
+              "specified."
+           << endl;
+      return false;
+    }
+    if (!output_directives_.empty() || !descriptor_set_name_.empty()) {
+      cerr << "Cannot use " << name
+           << " and generate code or descriptors at the same time." << endl;
+      return false;
+    }
+    if (name == "--profile_corpus" || name == "--memory_report") {
+      if (value.empty()) {
+        cerr << name << " requires a non-empty value." << endl;
+        return false;
+      }
+      corpus_name_ = value;
+      mode_ = name == "--profile_corpus" ? MODE_PROFILE : MODE_MEMORY_REPORT;
+      return true;
+    }
+    char* end;
+    synthesize_count_ = strto64(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || synthesize_count_ < 0) {
+      cerr << name << " requires a non-negative integer." << endl;
+      return false;
+    }
+    mode_ = MODE_SYNTHESIZE;
+
+  } else if (name == "--synthesize_profile" || name == "--profile_out" ||
+             name == "--trace_out") {
+    string* target = name == "--synthesize_profile" ?
+                     &synthesize_profile_name_ :
+                     name == "--profile_out" ? &profile_out_name_ :
+                     &trace_out_name_;
+    if (!target->empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return false;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return false;
+    }
+    *target = value;
+
+  } else if (name == "--synthesize_seed") {
+    char* end;
+    synthesize_seed_ = strtou64(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0') {
+      cerr << name << " requires a non-negative integer." << endl;
+      return false;
+    }
+
+  } else if (name == "--memory_report_format") {
+    if (value == "json") {
+      memory_report_json_ = true;
+    } else if (value == "text") {
+      memory_report_json_ = false;
+    } else {
+      cerr << name << " must be text or json." << endl;
+      return false;
+    }
+
+  } else if (name == "--encode_json_format") {
+    if (value == "ndjson") {
+      encode_json_ndjson_ = true;
+    } else if (value == "message") {
+      encode_json_ndjson_ = false;
+    } else {
+      cerr << name << " must be message or ndjson." << endl;
+      return false;
+    }
+
+  } else if (name == "--schema_image_out" || name == "--schema_image") {
+    string* image_name = name == "--schema_image_out" ?
+                         &schema_image_out_name_ : &schema_image_name_;
+    if (!image_name->empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return false;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return false;
+    }
+    *image_name = value;
+
+  } else if (name == "--synthesize_format") {
+    if (value == "json") {
+      synthesize_json_ = true;
+    } else if (value == "wire") {
+      synthesize_json_ = false;
+    } else {
+      cerr << name << " must be json or wire." << endl;
+      return false;
+    }
+
+  } else if (name == "--synthesize_threads") {
+    char* end;
+    synthesize_threads_ = strto32(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || synthesize_threads_ < 0) {
+      cerr << name << " requires a non-negative integer." << endl;
+      return false;
+    }
+
   } else if (name == "--encode" || name == "--decode" ||
-             name == "--decode_raw") {
+             name == "--decode_raw" || name == "--encode_json" ||
+             name == "--decode_json") {
     if (mode_ != MODE_COMPILE) {
-      cerr << "Only one of --encode and --decode can be specified." << endl;
+      cerr << "Only one of --encode, --decode, --encode_json, --decode_json, "
+              "--synthesize, --profile_corpus and --memory_report can be "
+              "specified."
+           << endl;
       return false;
     }
     if (!output_directives_.empty() || !descriptor_set_name_.empty()) {
@@ -674,11 +1475,19 @@ bool CommandLineInterface::InterpretArgument(const string& name,
       return false;
     }
 
-    mode_ = (name == "--encode") ? MODE_ENCODE : MODE_DECODE;
+    if (name == "--encode") {
+      mode_ = MODE_ENCODE;
+    } else if (name == "--encode_json") {
+      mode_ = MODE_ENCODE_JSON;
+    } else if (name == "--decode_json") {
+      mode_ = MODE_DECODE_JSON;
+    } else {
+      mode_ = MODE_DECODE;
+    }
 
     if (value.empty() && name != "--decode_raw") {
       cerr << "Type name for " << name << " cannot be blank." << endl;
-      if (name == "--decode") {
+      if (name == "--decode" || name == "--decode_json") {
         cerr << "To decode an unknown message, use --decode_raw." << endl;
       }
       return false;
@@ -689,6 +1498,17 @@ bool CommandLineInterface::InterpretArgument(const string& name,
 
     codec_type_ = value;
 
+  } else if (name == "--fields") {
+    if (!codec_fields_.empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return false;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return false;
+    }
+    codec_fields_ = value;
+
   } else if (name == "--target") {
       if (value.empty()) {
           cerr << "target value can not be null." << endl;
@@ -778,12 +1598,101 @@ void CommandLineInterface::PrintHelpText() {
 "                              pairs in text format to standard output.  No\n"
 "                              PROTO_FILES should be given when using this\n"
 "                              flag.\n"
+"  --decode_json=MESSAGE_TYPE  Like --decode, but write the message as JSON,\n"
+"                              with field names in the same lowerCamelCase\n"
+"                              as mock cases.\n"
+"  --encode_json=MESSAGE_TYPE  Like --encode, but read the message as JSON,\n"
+"                              with field names as --decode_json writes them\n"
+"                              or as in the .proto file.\n"
+"  --encode_json_format=FMT    'message' (the default) reads one JSON\n"
+"                              object; 'ndjson' reads any number, one per\n"
+"                              line as --synthesize_format=json writes\n"
+"                              them, and writes each message preceded by\n"
+"                              its size as a varint.  Required fields are\n"
+"                              not checked.\n"
+"  --fields=PATH,...           With --decode or --decode_json, only decode\n"
+"                              the given fields.  Each PATH is a dot-\n"
+"                              separated list of field names, e.g.\n"
+"                              baseResponse.Ret.  Everything else is\n"
+"                              skipped without being parsed.\n"
+"  --synthesize=N              Write N generated messages of the --target\n"
+"                              type to standard output, with values guessed\n"
+"                              from field names.  The same seed always\n"
+"                              gives the same messages.\n"
+"  --synthesize_seed=SEED      Seed for --synthesize.  Default is 0.\n"
+"  --synthesize_format=FORMAT  'wire' (the default) writes each message\n"
+"                              preceded by its size as a varint; 'json'\n"
+"                              writes one JSON object per line.\n"
+"  --synthesize_threads=N      Threads for --synthesize.  Default is one\n"
+"                              per processor.\n"
+"  --synthesize_profile=FILE   Shape --synthesize messages like the corpus\n"
+"                              profiled in FILE by --profile_corpus.\n"
+"  --profile_corpus=CAPTURE    Read a capture of --target messages, each\n"
+"                              preceded by its size as a varint, and write\n"
+"                              statistics on presence, lengths, counts and\n"
+"                              values of every field to --profile_out.\n"
+"  --profile_out=FILE          Where --profile_corpus writes its profile.\n"
+"  --memory_report=CAPTURE     Decode a capture of --target messages, each\n"
+"                              preceded by its size as a varint, and write\n"
+"                              how much memory the messages and the\n"
+"                              descriptors hold, by type and field.\n"
+"  --memory_report_format=FMT  'text' (the default) or 'json'.\n"
 "  -oFILE,                     Writes a FileDescriptorSet (a protocol buffer,\n"
 "    --descriptor_set_out=FILE defined in descriptor.proto) containing all of\n"
 "                              the input files to FILE.\n"
+"  --schema_image_out=FILE     Write the message and enum types of the input\n"
+"                              files, and those they use, to FILE as a\n"
+"                              schema image, which --schema_image can decode\n"
+"                              with without parsing any .proto files.\n"
+"  --schema_image=FILE         With --decode_json, take the type from the\n"
+"                              schema image FILE instead of PROTO_FILES,\n"
+"                              which must be omitted.\n"
 "  --include_imports           When using --descriptor_set_out, also include\n"
 "                              all dependencies of the input files in the\n"
 "                              set, so that the set is self-contained.\n"
+"  --lazy_import               With --target, --encode or --decode, skim\n"
+"                              PROTO_FILES for the one defining the type\n"
+"                              and only import it and its dependencies,\n"
+"                              instead of every file.\n"
+"  --symbol_index=FILE         Keep an index of the types defined by every\n"
+"                              .proto file on the proto_path in FILE, and\n"
+"                              use it to find the file to import for\n"
+"                              --target, --encode or --decode.  The index\n"
+"                              is created if missing and updated for files\n"
+"                              which changed.  PROTO_FILES may be omitted.\n"
+"  --manifest=FILE             Generate a mock case for every line of FILE,\n"
+"                              each \"MessageName cgiNumber isUpdateFromSvr\",\n"
+"                              instead of for --target.\n"
+"  --shard_index=I             With --manifest, only generate the mock\n"
+"    --shard_count=N           cases of the messages whose full names hash\n"
+"                              to shard I of N, importing only what they\n"
+"                              need.  Every machine agrees on the split.\n"
+"  --mock_bundle_out=FILE      With --manifest, also write the response of\n"
+"                              each mock case, as JSON and wire bytes, to\n"
+"                              the bundle FILE, indexed by cgiNumber and\n"
+"                              isUpdateFromSvr for mock servers.\n"
+"  --merge_mock_shards=FILE    Instead of parsing .proto files, combine the\n"
+"                              mock cases in the directories given as\n"
+"                              arguments, e.g. each shard's --mockcase_out,\n"
+"                              into the single script FILE.  If the\n"
+"                              arguments are --mock_bundle_out files,\n"
+"                              merge them into the bundle FILE instead.\n"
+"  --serve_mock_bundle=FILE    Instead of parsing .proto files, serve the\n"
+"                              mocks in the bundle FILE over HTTP, as\n"
+"                              GET /cgiNumber[?isUpdateFromSvr=1]\n"
+"                              [&format=wire], reloading FILE whenever it\n"
+"                              is replaced.\n"
+"  --listen=ADDRESS            Where --serve_mock_bundle listens:  [HOST:]PORT\n"
+"                              or unix:PATH.  Default is 127.0.0.1:8080.\n"
+"  --trace_out=FILE            Time the phases of the run (source lookup,\n"
+"                              parsing, descriptor building, generation,\n"
+"                              file writes) per file and per target, and\n"
+"                              write them to FILE in the Chrome trace-event\n"
+"                              format, for chrome://tracing or Perfetto.\n"
+"  --stats=text|json           When done, print counters from the parsing\n"
+"                              hot paths (bytes and fields read, dynamic\n"
+"                              messages built, descriptor lookups) to\n"
+"                              stderr.\n"
 "  --error_format=FORMAT       Set the format in which to print errors.\n"
 "                              FORMAT may be 'gcc' (the default) or 'msvs'\n"
 "                              (Microsoft Visual Studio format)." << endl;
@@ -799,7 +1708,9 @@ void CommandLineInterface::PrintHelpText() {
   }
 }
 
-    bool CommandLineInterface::PB2JSONGenerateOutput(vector<const FileDescriptor*> parsed_files, const OutputDirective& output_directive) {
+    bool CommandLineInterface::PB2JSONGenerateOutput(const string& target_message, const string& cgi_number, const string& is_update_from_svr, vector<const FileDescriptor*> parsed_files, const OutputDirective& output_directive) {
+        TraceSpan span("Generate", target_message);
+
         // Create the output directory.
         DiskOutputDirectory output_directory(output_directive.output_location);
         if (!output_directory.VerifyExistence()) {
@@ -807,10 +1718,9 @@ void CommandLineInterface::PrintHelpText() {
         }
         
         string error;
-        google::protobuf::compiler::objectivec::ObjectiveCGenerator *const generator = (google::protobuf::compiler::objectivec::ObjectiveCGenerator *const)output_directive.generator;
-        if (!generator->GenerateMockCase(target_message_, cgi_number_, isUpdateFromSvr_, parsed_files, output_directive.parameter, &output_directory, &error)) {
+        if (!output_directive.generator->GenerateForTarget(target_message, cgi_number, is_update_from_svr, parsed_files, output_directive.parameter, &output_directory, &error)) {
             // Generator returned an error.
-            
+            cerr << output_directive.name << ": " << error << endl;
             return false;
         }
         
@@ -857,6 +1767,17 @@ bool CommandLineInterface::EncodeOrDecode(const DescriptorPool* pool) {
   DynamicMessageFactory dynamic_factory(pool);
   scoped_ptr<Message> message(dynamic_factory.GetPrototype(type)->New());
 
+  scoped_ptr<FieldProjection> projection;
+  if (!codec_fields_.empty()) {
+    projection.reset(new FieldProjection(type));
+    string bad_path;
+    if (!projection->AddPaths(codec_fields_, &bad_path)) {
+      cerr << "--fields: \"" << bad_path << "\" does not name a field of "
+           << type->full_name() << "." << endl;
+      return false;
+    }
+  }
+
   if (mode_ == MODE_ENCODE) {
     SetFdToTextMode(STDIN_FILENO);
     SetFdToBinaryMode(STDOUT_FILENO);
@@ -881,13 +1802,16 @@ bool CommandLineInterface::EncodeOrDecode(const DescriptorPool* pool) {
     }
   } else {
     // Input is binary.
-    if (!message->ParsePartialFromZeroCopyStream(&in)) {
+    io::CodedInputStream coded_in(&in);
+    if (!internal::WireFormat::ParseAndMergePartial(&coded_in, message.get(),
+                                                    projection.get()) ||
+        !coded_in.ConsumedEntireMessage()) {
       cerr << "Failed to parse input." << endl;
       return false;
     }
   }
 
-  if (!message->IsInitialized()) {
+  if (projection == NULL && !message->IsInitialized()) {
     cerr << "warning:  Input message is missing required fields:  "
          << message->InitializationErrorString() << endl;
   }
@@ -909,6 +1833,429 @@ bool CommandLineInterface::EncodeOrDecode(const DescriptorPool* pool) {
   return true;
 }
 
+bool CommandLineInterface::DecodeToJson(const DescriptorPool* pool) {
+  // Look up the type.
+  const Descriptor* type = pool->FindMessageTypeByName(codec_type_);
+  if (type == NULL) {
+    cerr << "Type not defined: " << codec_type_ << endl;
+    return false;
+  }
+
+  scoped_ptr<FieldProjection> projection;
+  if (!codec_fields_.empty()) {
+    projection.reset(new FieldProjection(type));
+    string bad_path;
+    if (!projection->AddPaths(codec_fields_, &bad_path)) {
+      cerr << "--fields: \"" << bad_path << "\" does not name a field of "
+           << type->full_name() << "." << endl;
+      return false;
+    }
+  }
+
+  SetFdToBinaryMode(STDIN_FILENO);
+  SetFdToTextMode(STDOUT_FILENO);
+
+  // Stream stdin straight to stdout.  If the input turns out to be out of
+  // order it has to be re-ordered and transcoded again, which is only
+  // possible while none of the output has been written yet, so the first
+  // kDecodeHoldLimit bytes of output are held back.  The input can then be
+  // re-read from the recorded copy, or from stdin itself if it is seekable.
+  off_t input_start = lseek(STDIN_FILENO, 0, SEEK_CUR);
+
+  JsonTranscoder transcoder(type);
+  transcoder.SetProjection(projection.get());
+
+  io::FileOutputStream out(STDOUT_FILENO);
+  HeldOutputStream held_out(&out, kDecodeHoldLimit);
+  string recorded;
+  bool recorded_complete = false;
+  bool success;
+  {
+    io::FileInputStream in(STDIN_FILENO);
+    RecordingInputStream recording_in(&in, kDecodeHoldLimit);
+    {
+      io::CodedInputStream coded_in(&recording_in);
+      coded_in.SetTotalBytesLimit(kint32max, -1);
+      success = transcoder.Transcode(&coded_in, &held_out);
+    }
+    if (!success && transcoder.out_of_order() && !held_out.released()) {
+      // The transcoder stopped part way, so the recording only has what it
+      // read.  It is only a copy of the whole input if the rest fits too.
+      const void* data;
+      int size;
+      while (recording_in.complete() && recording_in.Next(&data, &size)) {}
+      recorded_complete = recording_in.complete() && in.GetErrno() == 0;
+      if (recorded_complete) recorded = recording_in.recorded();
+    }
+  }
+
+  if (!success && transcoder.out_of_order() && !held_out.released()) {
+    // The input is valid but can't be streamed.  Put it in canonical order
+    // by parsing and re-serializing it, then try again.  Unknown fields are
+    // only copied back out, so they are kept as raw bytes rather than
+    // decoded.
+    DynamicMessageFactory dynamic_factory(pool);
+    scoped_ptr<Message> message(dynamic_factory.GetPrototype(type)->New());
+    bool parsed;
+    if (recorded_complete) {
+      io::CodedInputStream coded_in(
+        reinterpret_cast<const uint8*>(recorded.data()), recorded.size());
+      coded_in.SetTotalBytesLimit(kint32max, -1);
+      coded_in.SetLazyUnknownFields(true);
+      parsed = message->MergePartialFromCodedStream(&coded_in) &&
+               coded_in.ConsumedEntireMessage();
+    } else if (input_start >= 0 &&
+               lseek(STDIN_FILENO, input_start, SEEK_SET) == input_start) {
+      io::FileInputStream in(STDIN_FILENO);
+      io::CodedInputStream coded_in(&in);
+      coded_in.SetTotalBytesLimit(kint32max, -1);
+      coded_in.SetLazyUnknownFields(true);
+      parsed = message->MergePartialFromCodedStream(&coded_in) &&
+               coded_in.ConsumedEntireMessage();
+    } else {
+      cerr << "Input has fields out of order and is too large to re-order "
+              "from a pipe; redirect it from a file instead." << endl;
+      return false;
+    }
+
+    if (parsed) {
+      string input;
+      message->SerializePartialToString(&input);
+      message.reset();
+
+      HeldOutputStream reordered_out(&out, kDecodeHoldLimit);
+      io::CodedInputStream coded_in(
+        reinterpret_cast<const uint8*>(input.data()), input.size());
+      coded_in.SetTotalBytesLimit(kint32max, -1);
+      success = transcoder.Transcode(&coded_in, &reordered_out) &&
+                reordered_out.Release();
+    }
+  } else if (success) {
+    success = held_out.Release();
+  } else if (transcoder.out_of_order()) {
+    cerr << "Input has fields out of order, which was found only after "
+            "output had been written." << endl;
+    return false;
+  }
+
+  if (!success) {
+    if (out.GetErrno() != 0) {
+      cerr << "output: I/O error." << endl;
+    } else {
+      cerr << "Failed to parse input." << endl;
+    }
+    return false;
+  }
+
+  {
+    io::CodedOutputStream coded_out(&out);
+    coded_out.WriteRaw("\n", 1);
+    success = !coded_out.HadError();
+  }
+  if (!success || !out.Flush()) {
+    cerr << "output: I/O error." << endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool CommandLineInterface::EncodeFromJson(const DescriptorPool* pool) {
+  // Look up the type.
+  const Descriptor* type = pool->FindMessageTypeByName(codec_type_);
+  if (type == NULL) {
+    cerr << "Type not defined: " << codec_type_ << endl;
+    return false;
+  }
+
+  SetFdToTextMode(STDIN_FILENO);
+  SetFdToBinaryMode(STDOUT_FILENO);
+
+  // JsonReader needs the whole document in memory.
+  string input;
+  {
+    io::FileInputStream in(STDIN_FILENO);
+    const void* data;
+    int size;
+    while (in.Next(&data, &size)) {
+      input.append(reinterpret_cast<const char*>(data), size);
+    }
+  }
+
+  JsonParser parser(type);
+  io::JsonReader reader(input.data(), input.size());
+
+  if (encode_json_ndjson_) {
+    // Any whitespace may separate the objects, not just newlines.  Each is
+    // written as it is read, without building a message.  Bulk input is
+    // where skipping unknown members quickly pays, so their contents are
+    // only checked for balanced brackets.
+    reader.SetStructuralSkip(true);
+    io::FileOutputStream out(STDOUT_FILENO);
+    {
+      io::CodedOutputStream coded_out(&out);
+      string message;
+      while (!reader.AtEnd()) {
+        message.clear();
+        if (!parser.ParseToWire(&reader, &message)) {
+          cerr << "Failed to parse input: " << parser.error() << endl;
+          return false;
+        }
+        coded_out.WriteVarint32(message.size());
+        coded_out.WriteString(message);
+      }
+      if (coded_out.HadError()) {
+        cerr << "output: I/O error." << endl;
+        return false;
+      }
+    }
+    if (!out.Flush()) {
+      cerr << "output: I/O error." << endl;
+      return false;
+    }
+    return true;
+  }
+
+  DynamicMessageFactory dynamic_factory(pool);
+  scoped_ptr<Message> message(dynamic_factory.GetPrototype(type)->New());
+
+  if (!parser.Parse(&reader, message.get())) {
+    cerr << "Failed to parse input: " << parser.error() << endl;
+    return false;
+  }
+  if (!reader.ExpectAtEnd()) {
+    cerr << "Failed to parse input: " << reader.error() << endl;
+    return false;
+  }
+
+  if (!message->IsInitialized()) {
+    cerr << "warning:  Input message is missing required fields:  "
+         << message->InitializationErrorString() << endl;
+  }
+
+  io::FileOutputStream out(STDOUT_FILENO);
+  if (!message->SerializePartialToZeroCopyStream(&out) || !out.Flush()) {
+    cerr << "output: I/O error." << endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool CommandLineInterface::DecodeToJsonWithImage() {
+  SchemaImage image;
+  string error;
+  if (!image.Open(schema_image_name_, &error)) {
+    cerr << error << endl;
+    return false;
+  }
+  int type = image.FindMessage(codec_type_);
+  if (type < 0) {
+    cerr << "Type not defined: " << codec_type_ << endl;
+    return false;
+  }
+
+  SetFdToBinaryMode(STDIN_FILENO);
+  SetFdToTextMode(STDOUT_FILENO);
+
+  string input;
+  {
+    io::FileInputStream in(STDIN_FILENO);
+    const void* data;
+    int size;
+    while (in.Next(&data, &size)) {
+      input.append(reinterpret_cast<const char*>(data), size);
+    }
+  }
+
+  SchemaImageTranscoder transcoder(&image, type);
+  string json;
+  bool success;
+  {
+    io::CodedInputStream coded_in(
+      reinterpret_cast<const uint8*>(input.data()), input.size());
+    io::StringOutputStream json_out(&json);
+    success = transcoder.Transcode(&coded_in, &json_out);
+  }
+
+  if (!success) {
+    // Without descriptors the input can't be put in canonical order, as
+    // DecodeToJson() does.
+    if (transcoder.out_of_order()) {
+      cerr << "Input has fields out of order or repeated; decode it with "
+              "the .proto files instead of --schema_image." << endl;
+    } else {
+      cerr << "Failed to parse input." << endl;
+    }
+    return false;
+  }
+
+  json.push_back('\n');
+  io::FileOutputStream out(STDOUT_FILENO);
+  {
+    io::CodedOutputStream coded_out(&out);
+    coded_out.WriteString(json);
+    success = !coded_out.HadError();
+  }
+  if (!success || !out.Flush()) {
+    cerr << "output: I/O error." << endl;
+    return false;
+  }
+
+  return true;
+}
+
+const Descriptor* CommandLineInterface::FindTargetType(
+    const vector<const FileDescriptor*>& parsed_files,
+    const DescriptorPool* pool) {
+  // --target may be a full name or, like for the generators, the plain name
+  // of a top-level message, in which case the last file defining it wins.
+  const Descriptor* type = pool->FindMessageTypeByName(target_message_);
+  for (int i = parsed_files.size() - 1; type == NULL && i >= 0; i--) {
+    for (int j = 0; j < parsed_files[i]->message_type_count(); j++) {
+      if (parsed_files[i]->message_type(j)->name() == target_message_) {
+        type = parsed_files[i]->message_type(j);
+        break;
+      }
+    }
+  }
+  if (type == NULL) {
+    cerr << "Type not defined: " << target_message_ << endl;
+  }
+  return type;
+}
+
+bool CommandLineInterface::Synthesize(
+    const vector<const FileDescriptor*>& parsed_files,
+    const DescriptorPool* pool) {
+  const Descriptor* type = FindTargetType(parsed_files, pool);
+  if (type == NULL) return false;
+
+  PayloadOptions options;
+  PayloadProfile profile;
+  if (!synthesize_profile_name_.empty()) {
+    string error;
+    if (!profile.Read(synthesize_profile_name_, &error)) {
+      cerr << error << endl;
+      return false;
+    }
+    options.profile = &profile;
+  }
+
+  if (synthesize_json_) {
+    SetFdToTextMode(STDOUT_FILENO);
+  } else {
+    SetFdToBinaryMode(STDOUT_FILENO);
+  }
+
+  PayloadGenerator generator(type, options);
+  io::FileOutputStream out(STDOUT_FILENO, kSynthesizeBufferSize);
+  if (!generator.Write(synthesize_seed_, synthesize_count_,
+                       synthesize_json_ ? PayloadGenerator::JSON :
+                                          PayloadGenerator::WIRE,
+                       synthesize_threads_ > 0 ? synthesize_threads_ :
+                                                 ProcessorCount(),
+                       &out) ||
+      !out.Flush()) {
+    cerr << "output: I/O error." << endl;
+    return false;
+  }
+  return true;
+}
+
+bool CommandLineInterface::ProfileCapture(
+    const vector<const FileDescriptor*>& parsed_files,
+    const DescriptorPool* pool) {
+  const Descriptor* type = FindTargetType(parsed_files, pool);
+  if (type == NULL) return false;
+
+  PayloadProfile profile;
+  string error;
+  if (!ProfileCorpus(type, corpus_name_, ProcessorCount(), &profile,
+                     &error) ||
+      !profile.Write(profile_out_name_, &error)) {
+    cerr << error << endl;
+    return false;
+  }
+  return true;
+}
+
+bool CommandLineInterface::ReportMemory(
+    const vector<const FileDescriptor*>& parsed_files,
+    const DescriptorPool* pool) {
+  const Descriptor* type = FindTargetType(parsed_files, pool);
+  if (type == NULL) return false;
+
+  int file_descriptor;
+  do {
+    file_descriptor = open(corpus_name_.c_str(), O_RDONLY | O_BINARY);
+  } while (file_descriptor < 0 && errno == EINTR);
+  if (file_descriptor < 0) {
+    cerr << corpus_name_ << ": " << strerror(errno) << endl;
+    return false;
+  }
+  io::FileInputStream in(file_descriptor);
+  in.SetCloseOnDelete(true);
+
+  // Each message is decoded into an object of its own, as a cache would
+  // hold it, and dropped once it has been added to the report.
+  DynamicMessageFactory dynamic_factory(pool);
+  const Message* prototype = dynamic_factory.GetPrototype(type);
+  MemoryReport report;
+  report.AddPool(pool);
+  while (true) {
+    const void* data;
+    int size;
+    if (!in.Next(&data, &size)) break;
+    in.BackUp(size);
+
+    int64 offset = in.ByteCount();
+    io::CodedInputStream coded_in(&in);
+    uint32 length;
+    scoped_ptr<Message> message(prototype->New());
+    bool parsed = false;
+    if (coded_in.ReadVarint32(&length)) {
+      io::CodedInputStream::Limit limit = coded_in.PushLimit(length);
+      parsed = message->ParsePartialFromCodedStream(&coded_in) &&
+               coded_in.ConsumedEntireMessage() &&
+               coded_in.BytesUntilLimit() == 0;
+      coded_in.PopLimit(limit);
+    }
+    if (!parsed) {
+      cerr << corpus_name_ << ": message " << report.message_count() + 1
+           << " at offset " << offset << ": not a valid "
+           << type->full_name() << "." << endl;
+      return false;
+    }
+    report.AddMessage(*message);
+  }
+  if (in.GetErrno() != 0) {
+    cerr << corpus_name_ << ": " << strerror(in.GetErrno()) << endl;
+    return false;
+  }
+
+  string text;
+  if (memory_report_json_) {
+    report.ToJson(&text);
+    text.push_back('\n');
+  } else {
+    report.ToText(&text);
+  }
+  SetFdToTextMode(STDOUT_FILENO);
+  io::FileOutputStream out(STDOUT_FILENO);
+  bool success;
+  {
+    io::CodedOutputStream coded_out(&out);
+    coded_out.WriteString(text);
+    success = !coded_out.HadError();
+  }
+  if (!success || !out.Flush()) {
+    cerr << "output: I/O error." << endl;
+    return false;
+  }
+  return true;
+}
+
 bool CommandLineInterface::WriteDescriptorSet(
     const vector<const FileDescriptor*> parsed_files) {
   FileDescriptorSet file_set;
@@ -50,11 +50,16 @@ namespace protobuf {
 
 class FileDescriptor;        // descriptor.h
 class DescriptorPool;        // descriptor.h
+class Descriptor;            // descriptor.h
 
 namespace compiler {
 
 class CodeGenerator;        // code_generator.h
 class DiskSourceTree;       // importer.h
+class SourceTree;           // importer.h
+class SymbolIndex;          // symbol_index.h
+class Importer;             // importer.h
+struct MockTarget;          // mock_shard.h
 
 // This class implements the command-line interface to the protocol compiler.
 // It is designed to make it very easy to create a custom protocol compiler
@@ -146,12 +151,48 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   // Clear state from previous Run().
   void Clear();
 
+  // Does the work of Run() once the arguments are parsed.
+  int Execute();
+
+  // Implements --trace_out, once the run is done.
+  bool WriteTrace();
+
   // Remaps each file in input_files_ so that it is relative to one of the
   // directories in proto_path_.  Returns false if an error occurred.  This
   // is only used if inputs_are_proto_path_relative_ is false.
   bool MakeInputsBeProtoPathRelative(
     DiskSourceTree* source_tree);
 
+  // Scans input_files_ for the last one which defines the given type, by
+  // full name or, for a top-level message, by plain name.  Used by
+  // --lazy_import.
+  bool FindInputDefining(SourceTree* source_tree, const string& type_name,
+                         string* input_file);
+
+  // Looks up the file defining the given type, named the same way, in the
+  // --symbol_index.  Also returns the type's full name if full_name isn't
+  // NULL.
+  bool FindIndexedFileDefining(const SymbolIndex& symbol_index,
+                               const string& type_name, string* file,
+                               string* full_name);
+
+  // Fills in the file and full name of each --manifest target.  Returns
+  // false, after printing an error, if one isn't found.
+  bool ResolveMockTargets(SourceTree* source_tree,
+                          const SymbolIndex& symbol_index,
+                          vector<MockTarget>* targets);
+
+  // Implements --manifest, --shard_index, --shard_count and
+  // --mock_bundle_out.
+  bool GenerateMockShard(SourceTree* source_tree,
+                         const SymbolIndex& symbol_index,
+                         Importer* importer);
+
+  // Converts a --manifest target's cgiNumber and isUpdateFromSvr to a
+  // bundle key.  Returns false, after printing an error, if they don't fit.
+  bool ParseMockKey(const MockTarget& target, uint32* cgi_number,
+                    bool* is_update_from_svr);
+
   // Parse all command-line arguments.
   bool ParseArguments(int argc, const char* const argv[]);
 
@@ -178,11 +219,38 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   struct OutputDirective;  // see below
   bool GenerateOutput(const FileDescriptor* proto_file,
                       const OutputDirective& output_directive);
-    bool PB2JSONGenerateOutput(vector<const FileDescriptor*> parsed_files, const OutputDirective& output_directive);
+    bool PB2JSONGenerateOutput(const string& target_message, const string& cgi_number, const string& is_update_from_svr, vector<const FileDescriptor*> parsed_files, const OutputDirective& output_directive);
 
   // Implements --encode and --decode.
   bool EncodeOrDecode(const DescriptorPool* pool);
 
+  // Implements --decode_json.
+  bool DecodeToJson(const DescriptorPool* pool);
+
+  // Implements --decode_json with --schema_image.
+  bool DecodeToJsonWithImage();
+
+  // Implements --encode_json.
+  bool EncodeFromJson(const DescriptorPool* pool);
+
+  // Looks up --target for --synthesize and --profile_corpus.  Prints an
+  // error and returns NULL if it isn't defined.
+  const Descriptor* FindTargetType(
+      const vector<const FileDescriptor*>& parsed_files,
+      const DescriptorPool* pool);
+
+  // Implements --synthesize.
+  bool Synthesize(const vector<const FileDescriptor*>& parsed_files,
+                  const DescriptorPool* pool);
+
+  // Implements --profile_corpus.
+  bool ProfileCapture(const vector<const FileDescriptor*>& parsed_files,
+                      const DescriptorPool* pool);
+
+  // Implements --memory_report.
+  bool ReportMemory(const vector<const FileDescriptor*>& parsed_files,
+                    const DescriptorPool* pool);
+
   // Implements the --descriptor_set_out option.
   bool WriteDescriptorSet(const vector<const FileDescriptor*> parsed_files);
 
@@ -206,7 +274,17 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   enum Mode {
     MODE_COMPILE,  // Normal mode:  parse .proto files and compile them.
     MODE_ENCODE,   // --encode:  read text from stdin, write binary to stdout.
-    MODE_DECODE    // --decode:  read binary from stdin, write text to stdout.
+    MODE_DECODE,   // --decode:  read binary from stdin, write text to stdout.
+    MODE_DECODE_JSON,  // --decode_json:  read binary from stdin, write JSON
+                       // to stdout.
+    MODE_ENCODE_JSON,  // --encode_json:  read JSON from stdin, write binary
+                       // to stdout.
+    MODE_SYNTHESIZE,   // --synthesize:  write generated messages of the
+                       // --target type to stdout.
+    MODE_PROFILE,      // --profile_corpus:  gather statistics on a capture
+                       // of --target messages.
+    MODE_MEMORY_REPORT // --memory_report:  report the memory held by a
+                       // capture of --target messages once decoded.
   };
 
   Mode mode_;
@@ -233,10 +311,14 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   };
   vector<OutputDirective> output_directives_;
 
-  // When using --encode or --decode, this names the type we are encoding or
-  // decoding.  (Empty string indicates --decode_raw.)
+  // When using --encode, --decode or --decode_json, this names the type we
+  // are encoding or decoding.  (Empty string indicates --decode_raw.)
   string codec_type_;
 
+  // If --fields was given with --decode or --decode_json, the comma-separated field paths to
+  // decode.  Otherwise, empty.
+  string codec_fields_;
+
   // If --descriptor_set_out was given, this is the filename to which the
   // FileDescriptorSet should be written.  Otherwise, empty.
   string descriptor_set_name_;
@@ -249,6 +331,75 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   // Was the --disallow_services flag used?
   bool disallow_services_;
 
+  // Was the --lazy_import flag used?
+  bool lazy_import_;
+
+  // If --symbol_index was given, the file holding the index.  Otherwise,
+  // empty.
+  string symbol_index_name_;
+
+  // If --manifest was given, the file listing the mock cases to generate.
+  // Otherwise, empty.
+  string manifest_name_;
+
+  // --shard_index and --shard_count.  Only the manifest's targets for which
+  // MockShardOf() returns shard_index_ are generated.
+  int shard_index_;
+  int shard_count_;
+
+  // If --merge_mock_shards was given, the script to write.  input_files_
+  // then holds the shard output directories.  Otherwise, empty.
+  string merge_bundle_name_;
+
+  // If --mock_bundle_out was given, the bundle to write the manifest's mock
+  // cases to.  Otherwise, empty.
+  string mock_bundle_name_;
+
+  // If --serve_mock_bundle was given, the bundle to serve, on
+  // listen_address_ (--listen).  Otherwise, empty.
+  string serve_bundle_name_;
+  string listen_address_;
+
+  // With --synthesize, how many messages to write (--synthesize), the seed
+  // (--synthesize_seed), whether to write JSON rather than wire bytes
+  // (--synthesize_format) and how many threads to use
+  // (--synthesize_threads, 0 meaning one per processor).
+  int64 synthesize_count_;
+  uint64 synthesize_seed_;
+  bool synthesize_json_;
+  int synthesize_threads_;
+
+  // If --synthesize_profile was given, the profile to shape the messages
+  // by.  Otherwise, empty.
+  string synthesize_profile_name_;
+
+  // If --profile_corpus was given, the capture to read and the profile to
+  // write (--profile_out).  Otherwise, empty.  --memory_report also sets
+  // corpus_name_.
+  string corpus_name_;
+  string profile_out_name_;
+
+  // True if --memory_report_format=json was given.
+  bool memory_report_json_;
+
+  // True if --encode_json_format=ndjson was given.
+  bool encode_json_ndjson_;
+
+  // If --schema_image_out was given, the file to write the schema image of
+  // the input files to.  Otherwise, empty.
+  string schema_image_out_name_;
+
+  // If --schema_image was given, the schema image to take --decode_json's
+  // type from.  Otherwise, empty.
+  string schema_image_name_;
+
+  // If --trace_out was given, the file to write the trace of the run to.
+  // Otherwise, empty.
+  string trace_out_name_;
+
+  // If --stats was given, "text" or "json".  Otherwise, empty.
+  string stats_format_;
+
   // See SetInputsAreProtoPathRelative().
   bool inputs_are_proto_path_relative_;
 
@@ -47,9 +47,11 @@
 #include <google/protobuf/compiler/importer.h>
 
 #include <google/protobuf/compiler/parser.h>
+#include <google/protobuf/compiler/symbol_index.h>
 #include <google/protobuf/io/tokenizer.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/trace.h>
 
 namespace google {
 namespace protobuf {
@@ -113,6 +115,7 @@ SourceTreeDescriptorDatabase::SourceTreeDescriptorDatabase(
     SourceTree* source_tree)
   : source_tree_(source_tree),
     error_collector_(NULL),
+    symbol_index_(NULL),
     using_validation_error_collector_(false),
     validation_error_collector_(this) {}
 
@@ -120,7 +123,11 @@ SourceTreeDescriptorDatabase::~SourceTreeDescriptorDatabase() {}
 
 bool SourceTreeDescriptorDatabase::FindFileByName(
     const string& filename, FileDescriptorProto* output) {
-  scoped_ptr<io::ZeroCopyInputStream> input(source_tree_->Open(filename));
+  scoped_ptr<io::ZeroCopyInputStream> input;
+  {
+    TraceSpan span("Open", filename);
+    input.reset(source_tree_->Open(filename));
+  }
   if (input == NULL) {
     if (error_collector_ != NULL) {
       error_collector_->AddError(filename, -1, 0, "File not found.");
@@ -140,7 +147,9 @@ bool SourceTreeDescriptorDatabase::FindFileByName(
     parser.RecordSourceLocationsTo(&source_locations_);
   }
 
-  // Parse it.
+  // Parse it.  The parser pulls tokens as it goes, so this includes the
+  // tokenizing and the reading.
+  TraceSpan span("Parse", filename);
   output->set_name(filename);
   return parser.Parse(&tokenizer, output) &&
          !file_error_collector.had_errors();
@@ -148,7 +157,12 @@ bool SourceTreeDescriptorDatabase::FindFileByName(
 
 bool SourceTreeDescriptorDatabase::FindFileContainingSymbol(
     const string& symbol_name, FileDescriptorProto* output) {
-  return false;
+  string filename;
+  if (symbol_index_ == NULL ||
+      !symbol_index_->FindFileContainingSymbol(symbol_name, &filename)) {
+    return false;
+  }
+  return FindFileByName(filename, output);
 }
 
 bool SourceTreeDescriptorDatabase::FindFileContainingExtension(
@@ -191,6 +205,7 @@ Importer::Importer(SourceTree* source_tree,
 Importer::~Importer() {}
 
 const FileDescriptor* Importer::Import(const string& filename) {
+  TraceSpan span("Import", filename);
   return pool_.FindFileByName(filename);
 }
 
@@ -58,6 +58,8 @@ class MultiFileErrorCollector;
 class SourceTree;
 class DiskSourceTree;
 
+class SymbolIndex;  // symbol_index.h
+
 // TODO(kenton):  Move all SourceTree stuff to a separate file?
 
 // An implementation of DescriptorDatabase which loads files from a SourceTree
@@ -71,8 +73,9 @@ class DiskSourceTree;
 //   multiple DescriptorPools wrapping the same SourceTreeDescriptorDatabase
 //   and use them from multiple threads.
 //
-// Note:  This class does not implement FindFileContainingSymbol() or
-//   FindFileContainingExtension(); these will always return false.
+// Note:  FindFileContainingSymbol() only works after UseSymbolIndex(), and
+//   FindFileContainingExtension() is not implemented; otherwise these will
+//   always return false.
 class LIBPROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabase {
  public:
   SourceTreeDescriptorDatabase(SourceTree* source_tree);
@@ -95,6 +98,12 @@ class LIBPROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabas
     return &validation_error_collector_;
   }
 
+  // Uses the given index, which must cover the source tree, to implement
+  // FindFileContainingSymbol().  The index must outlive this object.
+  void UseSymbolIndex(const SymbolIndex* symbol_index) {
+    symbol_index_ = symbol_index;
+  }
+
   // implements DescriptorDatabase -----------------------------------
   bool FindFileByName(const string& filename, FileDescriptorProto* output);
   bool FindFileContainingSymbol(const string& symbol_name,
@@ -108,6 +117,7 @@ class LIBPROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabas
 
   SourceTree* source_tree_;
   MultiFileErrorCollector* error_collector_;
+  const SymbolIndex* symbol_index_;
 
   class LIBPROTOBUF_EXPORT ValidationErrorCollector : public DescriptorPool::ErrorCollector {
    public:
@@ -160,6 +170,13 @@ class LIBPROTOBUF_EXPORT Importer {
   // DescriptorPool so that they can be cross-linked).
   const FileDescriptor* Import(const string& filename);
 
+  // Lets pool() find types in files which haven't been imported, by looking
+  // them up in the given index.  See
+  // SourceTreeDescriptorDatabase::UseSymbolIndex().
+  void UseSymbolIndex(const SymbolIndex* symbol_index) {
+    database_.UseSymbolIndex(symbol_index);
+  }
+
   // The DescriptorPool in which all imported FileDescriptors and their
   // contents are stored.
   inline const DescriptorPool* pool() const {
@@ -0,0 +1,485 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <google/protobuf/compiler/json_codec/json_codec_generator.h>
+#include <google/protobuf/compiler/cpp/cpp_helpers.h>
+#include <google/protobuf/compiler/objectivec/objectivec_helpers.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/printer.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace json_codec {
+
+using cpp::ClassName;
+using cpp::FieldName;
+
+namespace {
+
+// Finds the --target type the same way the mock case generator does, by
+// the name of a top-level message in one of the input files.  A fully
+// qualified name works too.
+const Descriptor* FindTarget(const string& target_message,
+                             const vector<const FileDescriptor*>& files) {
+  for (int i = 0; i < files.size(); i++) {
+    for (int j = 0; j < files[i]->message_type_count(); j++) {
+      if (files[i]->message_type(j)->name() == target_message) {
+        return files[i]->message_type(j);
+      }
+    }
+  }
+  for (int i = 0; i < files.size(); i++) {
+    const Descriptor* type =
+      files[i]->pool()->FindMessageTypeByName(target_message);
+    if (type != NULL) return type;
+  }
+  return NULL;
+}
+
+// Adds the given type and every message type reachable through its fields
+// to *types, each once.
+void CollectTypes(const Descriptor* type, set<const Descriptor*>* seen,
+                  vector<const Descriptor*>* types) {
+  if (!seen->insert(type).second) return;
+  types->push_back(type);
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      CollectTypes(field->message_type(), seen, types);
+    }
+  }
+}
+
+// The suffix of the io::JsonWriter and io::JsonReader methods for the
+// given non-message type.
+const char* JsonMethodName(FieldDescriptor::Type type) {
+  switch (type) {
+    case FieldDescriptor::TYPE_INT32   : return "Int32";
+    case FieldDescriptor::TYPE_SINT32  : return "Int32";
+    case FieldDescriptor::TYPE_SFIXED32: return "Int32";
+    case FieldDescriptor::TYPE_ENUM    : return "Int32";
+    case FieldDescriptor::TYPE_INT64   : return "Int64";
+    case FieldDescriptor::TYPE_SINT64  : return "Int64";
+    case FieldDescriptor::TYPE_SFIXED64: return "Int64";
+    case FieldDescriptor::TYPE_UINT32  : return "UInt32";
+    case FieldDescriptor::TYPE_FIXED32 : return "UInt32";
+    case FieldDescriptor::TYPE_UINT64  : return "UInt64";
+    case FieldDescriptor::TYPE_FIXED64 : return "UInt64";
+    case FieldDescriptor::TYPE_FLOAT   : return "Float";
+    case FieldDescriptor::TYPE_DOUBLE  : return "Double";
+    case FieldDescriptor::TYPE_BOOL    : return "Bool";
+    case FieldDescriptor::TYPE_STRING  : return "String";
+    case FieldDescriptor::TYPE_BYTES   : return "Bytes";
+
+    case FieldDescriptor::TYPE_GROUP   :
+    case FieldDescriptor::TYPE_MESSAGE :
+      break;
+  }
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return NULL;
+}
+
+string TableName(const Descriptor* type) {
+  return "k" + StringReplace(type->full_name(), ".", "_", true) +
+         "_json_names";
+}
+
+void SetFieldVariables(const FieldDescriptor* field,
+                       map<string, string>* variables) {
+  string json_name = objectivec::UnderscoresToCamelCase(field);
+  (*variables)["name"] = FieldName(field);
+  (*variables)["json_name"] = CEscape(json_name);
+  (*variables)["json_name_size"] = SimpleItoa(json_name.size());
+  (*variables)["index"] = SimpleItoa(field->index());
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    (*variables)["type"] = ClassName(field->message_type(), true);
+  } else {
+    (*variables)["method"] = JsonMethodName(field->type());
+  }
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+    (*variables)["type"] = ClassName(field->enum_type(), true);
+  }
+}
+
+// -------------------------------------------------------------------
+
+void GenerateDeclaration(const Descriptor* type, io::Printer* printer) {
+  printer->Print(
+    "template <>\n"
+    "struct JsonCodec< $classname$> {\n"
+    "  static void Write(const $classname$& message, io::JsonWriter* writer);\n"
+    "  static bool Read(io::JsonReader* reader, $classname$* message);\n"
+    "};\n"
+    "\n",
+    "classname", ClassName(type, true));
+}
+
+void GenerateNameTable(const Descriptor* type, io::Printer* printer) {
+  if (type->field_count() == 0) return;
+
+  // Accept the .proto names as well as the ones we write.
+  map<string, int> names;
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    names[objectivec::UnderscoresToCamelCase(field)] = i;
+    names[field->name()] = i;
+  }
+
+  // constexpr, so that the table is laid out by the compiler and can never
+  // be read before it is initialized.  The generated code is C++11.
+  printer->Print("constexpr internal::JsonFieldName $table$[] = {\n",
+                 "table", TableName(type));
+  printer->Indent();
+  for (map<string, int>::const_iterator iter = names.begin();
+       iter != names.end(); ++iter) {
+    map<string, string> variables;
+    variables["name"] = CEscape(iter->first);
+    variables["size"] = SimpleItoa(iter->first.size());
+    variables["index"] = SimpleItoa(iter->second);
+    printer->Print(variables, "{ \"$name$\", $size$, $index$ },\n");
+  }
+  printer->Outdent();
+  printer->Print("};\n\n");
+}
+
+void GenerateWriteValue(const FieldDescriptor* field,
+                        map<string, string>* variables,
+                        const string& value, io::Printer* printer) {
+  (*variables)["value"] = value;
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    printer->Print(*variables, "JsonCodec< $type$>::Write($value$, writer);\n");
+  } else if (field->type() == FieldDescriptor::TYPE_BYTES) {
+    printer->Print(*variables,
+      "writer->Bytes($value$.data(), $value$.size());\n");
+  } else {
+    printer->Print(*variables, "writer->$method$($value$);\n");
+  }
+}
+
+void GenerateWrite(const Descriptor* type, io::Printer* printer) {
+  printer->Print(
+    "void JsonCodec< $classname$>::Write(\n"
+    "    const $classname$& message, io::JsonWriter* writer) {\n"
+    "  writer->BeginObject();\n",
+    "classname", ClassName(type, true));
+  printer->Indent();
+
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    map<string, string> variables;
+    SetFieldVariables(field, &variables);
+
+    if (field->is_repeated()) {
+      printer->Print(variables,
+        "if (message.$name$_size() > 0) {\n"
+        "  writer->Name(\"$json_name$\", $json_name_size$);\n"
+        "  writer->BeginArray();\n"
+        "  for (int i = 0; i < message.$name$_size(); i++) {\n");
+      printer->Indent();
+      printer->Indent();
+      GenerateWriteValue(field, &variables, "message." + variables["name"] +
+                         "(i)", printer);
+      printer->Outdent();
+      printer->Outdent();
+      printer->Print(
+        "  }\n"
+        "  writer->EndArray();\n"
+        "}\n");
+    } else {
+      printer->Print(variables,
+        "if (message.has_$name$()) {\n"
+        "  writer->Name(\"$json_name$\", $json_name_size$);\n");
+      printer->Indent();
+      GenerateWriteValue(field, &variables, "message." + variables["name"] +
+                         "()", printer);
+      printer->Outdent();
+      printer->Print("}\n");
+    }
+  }
+
+  printer->Outdent();
+  printer->Print(
+    "  writer->EndObject();\n"
+    "}\n"
+    "\n");
+}
+
+// Generates code to read one value of the field, passing it to the
+// accessor named by $accessor$ ("set_foo", "add_foo", "mutable_foo" ...).
+void GenerateReadValue(const FieldDescriptor* field,
+                       map<string, string>* variables,
+                       const string& accessor, io::Printer* printer) {
+  (*variables)["accessor"] = accessor;
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      printer->Print(*variables,
+        "if (!JsonCodec< $type$>::Read(reader, message->$accessor$())) {\n"
+        "  return false;\n"
+        "}\n");
+      break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      printer->Print(*variables,
+        "if (!reader->Read$method$(message->$accessor$())) return false;\n");
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      // Like the wire format parser, drop numbers the enum doesn't define.
+      printer->Print(*variables,
+        "::google::protobuf::int32 value;\n"
+        "if (!reader->ReadInt32(&value)) return false;\n"
+        "if ($type$_IsValid(value)) {\n"
+        "  message->$accessor$(static_cast< $type$>(value));\n"
+        "}\n");
+      break;
+    default:
+      (*variables)["cpp_type"] = cpp::PrimitiveTypeName(field->cpp_type());
+      printer->Print(*variables,
+        "$cpp_type$ value;\n"
+        "if (!reader->Read$method$(&value)) return false;\n"
+        "message->$accessor$(value);\n");
+      break;
+  }
+}
+
+void GenerateRead(const Descriptor* type, io::Printer* printer) {
+  printer->Print(
+    "bool JsonCodec< $classname$>::Read(\n"
+    "    io::JsonReader* reader, $classname$* message) {\n"
+    "  if (!reader->BeginObject()) return false;\n"
+    "  const char* name;\n"
+    "  int name_size;\n"
+    "  while (reader->NextName(&name, &name_size)) {\n",
+    "classname", ClassName(type, true));
+
+  if (type->field_count() == 0) {
+    printer->Print(
+      "    if (!reader->SkipValue()) return false;\n"
+      "  }\n"
+      "  return !reader->failed();\n"
+      "}\n"
+      "\n");
+    return;
+  }
+
+  printer->Print(
+    "    // A null member is the same as a missing one.\n"
+    "    if (reader->ReadNull()) continue;\n"
+    "    switch (internal::FindJsonField($table$,\n"
+    "        GOOGLE_ARRAYSIZE($table$), name, name_size)) {\n",
+    "table", TableName(type));
+  printer->Indent();
+  printer->Indent();
+
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    map<string, string> variables;
+    SetFieldVariables(field, &variables);
+
+    printer->Print(variables, "case $index$: {  // $json_name$\n");
+    printer->Indent();
+    if (field->is_repeated()) {
+      printer->Print(
+        "if (!reader->BeginArray()) return false;\n"
+        "while (reader->NextElement()) {\n");
+      printer->Indent();
+      GenerateReadValue(field, &variables, "add_" + variables["name"],
+                        printer);
+      printer->Outdent();
+      printer->Print(
+        "}\n"
+        "if (reader->failed()) return false;\n");
+    } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ||
+               field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+      GenerateReadValue(field, &variables, "mutable_" + variables["name"],
+                        printer);
+    } else {
+      GenerateReadValue(field, &variables, "set_" + variables["name"],
+                        printer);
+    }
+    printer->Print("break;\n");
+    printer->Outdent();
+    printer->Print("}\n");
+  }
+
+  printer->Print(
+    "default:\n"
+    "  if (!reader->SkipValue()) return false;\n"
+    "  break;\n");
+  printer->Outdent();
+  printer->Outdent();
+  printer->Print(
+    "    }\n"
+    "  }\n"
+    "  return !reader->failed();\n"
+    "}\n"
+    "\n");
+}
+
+}  // namespace
+
+// ===================================================================
+
+JsonCodecGenerator::JsonCodecGenerator() {}
+JsonCodecGenerator::~JsonCodecGenerator() {}
+
+bool JsonCodecGenerator::Generate(const FileDescriptor* file,
+                                  const string& parameter,
+                                  OutputDirectory* output_directory,
+                                  string* error) const {
+  *error = "The JSON codec generator only works with --target.";
+  return false;
+}
+
+bool JsonCodecGenerator::GenerateForTarget(
+    const string& target_message,
+    const string& cgi_number,
+    const string& is_update_from_svr,
+    const vector<const FileDescriptor*>& parsed_files,
+    const string& parameter,
+    OutputDirectory* output_directory,
+    string* error) const {
+  vector<pair<string, string> > options;
+  ParseGeneratorParameter(parameter, &options);
+  if (!options.empty()) {
+    *error = "Unknown generator option: " + options[0].first;
+    return false;
+  }
+
+  const Descriptor* target = FindTarget(target_message, parsed_files);
+  if (target == NULL) {
+    *error = "cannot find target message type " + target_message;
+    return false;
+  }
+
+  set<const Descriptor*> seen;
+  vector<const Descriptor*> types;
+  CollectTypes(target, &seen, &types);
+
+  // The .pb.h files defining those types, in order of first use.
+  vector<const FileDescriptor*> files;
+  for (int i = 0; i < types.size(); i++) {
+    if (find(files.begin(), files.end(), types[i]->file()) == files.end()) {
+      files.push_back(types[i]->file());
+    }
+  }
+
+  string guard = "PB2JSON_" + target->name() + "_JSON_H__";
+  UpperString(&guard);
+
+  // Generate header.
+  {
+    scoped_ptr<io::ZeroCopyOutputStream> output(
+      output_directory->Open(target->name() + ".json.h"));
+    io::Printer printer(output.get(), '$');
+
+    printer.Print(
+      "// Generated by the PB2JSON JSON codec generator.  DO NOT EDIT!\n"
+      "// target: $target$\n"
+      "\n"
+      "#ifndef $guard$\n"
+      "#define $guard$\n"
+      "\n"
+      "#include <google/protobuf/json_codec.h>\n",
+      "target", target->full_name(),
+      "guard", guard);
+    for (int i = 0; i < files.size(); i++) {
+      printer.Print("#include \"$header$.pb.h\"\n",
+                    "header", cpp::StripProto(files[i]->name()));
+    }
+    printer.Print(
+      "\n"
+      "namespace google {\n"
+      "namespace protobuf {\n"
+      "\n");
+    for (int i = 0; i < types.size(); i++) {
+      GenerateDeclaration(types[i], &printer);
+    }
+    printer.Print(
+      "}  // namespace protobuf\n"
+      "}  // namespace google\n"
+      "\n"
+      "#endif  // $guard$\n",
+      "guard", guard);
+  }
+
+  // Generate cc file.
+  {
+    scoped_ptr<io::ZeroCopyOutputStream> output(
+      output_directory->Open(target->name() + ".json.cc"));
+    io::Printer printer(output.get(), '$');
+
+    printer.Print(
+      "// Generated by the PB2JSON JSON codec generator.  DO NOT EDIT!\n"
+      "// target: $target$\n"
+      "\n"
+      "#include \"$target_name$.json.h\"\n"
+      "\n"
+      "namespace google {\n"
+      "namespace protobuf {\n"
+      "\n"
+      "namespace {\n"
+      "\n",
+      "target", target->full_name(),
+      "target_name", target->name());
+    for (int i = 0; i < types.size(); i++) {
+      GenerateNameTable(types[i], &printer);
+    }
+    printer.Print("}  // namespace\n\n");
+
+    for (int i = 0; i < types.size(); i++) {
+      printer.Print("// $separator$\n// $full_name$\n\n",
+                    "separator", string(67, '-'),
+                    "full_name", types[i]->full_name());
+      GenerateWrite(types[i], &printer);
+      GenerateRead(types[i], &printer);
+    }
+
+    printer.Print(
+      "}  // namespace protobuf\n"
+      "}  // namespace google\n");
+  }
+
+  return true;
+}
+
+}  // namespace json_codec
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,85 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Generates C++ code which converts messages to and from JSON without
+// reflection.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_JSON_CODEC_GENERATOR_H__
+#define GOOGLE_PROTOBUF_COMPILER_JSON_CODEC_GENERATOR_H__
+
+#include <string>
+#include <google/protobuf/compiler/code_generator.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace json_codec {
+
+// CodeGenerator implementation for --json_codec_out.  For the --target
+// message type and every message type it references, generates a
+// specialization of JsonCodec<> (see google/protobuf/json_codec.h) in
+// TARGET.json.h and TARGET.json.cc.  The generated code uses the classes
+// generated by the C++ generator for the same files.
+//
+// Field names, accessors and the dispatch on member names are all fixed in
+// the generated code, so encoding is a straight-line sequence of calls to
+// io::JsonWriter, and decoding a binary search in a static table followed by
+// a switch.
+class LIBPROTOC_EXPORT JsonCodecGenerator : public CodeGenerator {
+ public:
+  JsonCodecGenerator();
+  ~JsonCodecGenerator();
+
+  // implements CodeGenerator ----------------------------------------
+  bool Generate(const FileDescriptor* file,
+                const string& parameter,
+                OutputDirectory* output_directory,
+                string* error) const;
+  bool GenerateForTarget(const string& target_message,
+                         const string& cgi_number,
+                         const string& is_update_from_svr,
+                         const vector<const FileDescriptor*>& parsed_files,
+                         const string& parameter,
+                         OutputDirectory* output_directory,
+                         string* error) const;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(JsonCodecGenerator);
+};
+
+}  // namespace json_codec
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_JSON_CODEC_GENERATOR_H__
@@ -0,0 +1,526 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#include <algorithm>
+
+#include <google/protobuf/compiler/mock_bundle.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/json_transcoder.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/hash_util.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+#ifndef O_BINARY
+#ifdef _O_BINARY
+#define O_BINARY _O_BINARY
+#else
+#define O_BINARY 0     // If this isn't defined, the platform doesn't need it.
+#endif
+#endif
+
+using internal::BuildPerfectHash;
+using internal::SplitMix64;
+
+namespace {
+
+// The layout of a bundle:
+//
+//   header          kHeaderSize bytes:  kMagic, then as uint32s the
+//                   version, mock count, slot count and bucket count, then
+//                   eight bytes of zeros
+//   displacements   a uint32 per bucket, padded with zeros to a multiple
+//                   of 8 bytes
+//   slots           kSlotSize bytes each:  the key as a uint64 (kEmptyKey
+//                   for an empty slot), then as uint32s the offset and size
+//                   of the message name, the JSON and the wire bytes
+//   data            the names, JSON and wire bytes
+//
+// Offsets are from the start of the file.  A key hashes to a bucket, and
+// the bucket's displacement picks its slot (see SlotOf()); the writer
+// chooses displacements so that no two keys share a slot.
+const char kMagic[8] = { 'P', 'B', '2', 'J', 'M', 'O', 'C', 'K' };
+const uint32 kVersion = 1;
+const int kHeaderSize = 32;
+const int kSlotSize = 32;
+const uint64 kEmptyKey = ~GOOGLE_ULONGLONG(0);
+
+inline uint64 MakeKey(uint32 cgi_number, bool is_update_from_svr) {
+  return (static_cast<uint64>(cgi_number) << 1) | (is_update_from_svr ? 1 : 0);
+}
+
+inline uint32 BucketOf(uint64 key, uint32 bucket_count) {
+  return SplitMix64(key) % bucket_count;
+}
+
+// slot_count is a power of two and the step is odd, so as the displacement
+// goes from 0 to slot_count - 1 a key visits every slot.
+inline uint32 SlotOf(uint64 key, uint32 displacement, uint32 slot_count) {
+  uint64 start = SplitMix64(key ^ GOOGLE_ULONGLONG(0x9e3779b97f4a7c15));
+  uint64 step = SplitMix64(key ^ GOOGLE_ULONGLONG(0xc2b2ae3d27d4eb4f)) | 1;
+  return (start + displacement * step) & (slot_count - 1);
+}
+
+inline uint32 ReadLittleEndian32(const char* ptr) {
+  const uint8* bytes = reinterpret_cast<const uint8*>(ptr);
+  return static_cast<uint32>(bytes[0]) |
+         (static_cast<uint32>(bytes[1]) << 8) |
+         (static_cast<uint32>(bytes[2]) << 16) |
+         (static_cast<uint32>(bytes[3]) << 24);
+}
+
+inline uint64 ReadLittleEndian64(const char* ptr) {
+  return static_cast<uint64>(ReadLittleEndian32(ptr)) |
+         (static_cast<uint64>(ReadLittleEndian32(ptr + 4)) << 32);
+}
+
+void SetToDefault(Message* message, const FieldDescriptor* field) {
+  const Reflection* reflection = message->GetReflection();
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      reflection->SetInt32(message, field, field->default_value_int32());
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      reflection->SetInt64(message, field, field->default_value_int64());
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      reflection->SetUInt32(message, field, field->default_value_uint32());
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      reflection->SetUInt64(message, field, field->default_value_uint64());
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      reflection->SetDouble(message, field, field->default_value_double());
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      reflection->SetFloat(message, field, field->default_value_float());
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      reflection->SetBool(message, field, field->default_value_bool());
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      reflection->SetEnum(message, field, field->default_value_enum());
+      break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      reflection->SetString(message, field, field->default_value_string());
+      break;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      GOOGLE_LOG(FATAL) << "Can't get here.";
+      break;
+  }
+}
+
+// path holds the types being filled in, outermost first.
+void FillSkeleton(Message* message, vector<const Descriptor*>* path) {
+  const Descriptor* type = message->GetDescriptor();
+  const Reflection* reflection = message->GetReflection();
+  path->push_back(type);
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      if (find(path->begin(), path->end(), field->message_type()) !=
+          path->end()) {
+        continue;
+      }
+      FillSkeleton(field->is_repeated() ?
+                       reflection->AddMessage(message, field) :
+                       reflection->MutableMessage(message, field),
+                   path);
+    } else if (!field->is_repeated()) {
+      SetToDefault(message, field);
+    }
+  }
+  path->pop_back();
+}
+
+}  // namespace
+
+void BuildMockResponse(const Descriptor* type, DynamicMessageFactory* factory,
+                       string* wire, string* json) {
+  scoped_ptr<Message> message(factory->GetPrototype(type)->New());
+  vector<const Descriptor*> path;
+  FillSkeleton(message.get(), &path);
+
+  wire->clear();
+  message->SerializePartialToString(wire);
+
+  // The message was just serialized in field order, so it can always be
+  // streamed.
+  json->clear();
+  JsonTranscoder transcoder(type);
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(wire->data()),
+                             wire->size());
+  io::StringOutputStream output(json);
+  GOOGLE_CHECK(transcoder.Transcode(&input, &output));
+}
+
+// ===================================================================
+
+MockBundleWriter::MockBundleWriter() {}
+MockBundleWriter::~MockBundleWriter() {}
+
+bool MockBundleWriter::Add(uint32 cgi_number, bool is_update_from_svr,
+                           const string& message_name, const string& json,
+                           const string& wire) {
+  uint64 key = MakeKey(cgi_number, is_update_from_svr);
+  if (!keys_.insert(key).second) return false;
+  mocks_.push_back(Mock());
+  Mock* mock = &mocks_.back();
+  mock->key = key;
+  mock->message_name = message_name;
+  mock->json = json;
+  mock->wire = wire;
+  return true;
+}
+
+bool MockBundleWriter::Write(const string& filename, string* error) const {
+  // Work on the mocks in key order so that the file doesn't depend on the
+  // order they were added in.
+  vector<pair<uint64, int> > keys;
+  for (int i = 0; i < mocks_.size(); i++) {
+    keys.push_back(make_pair(mocks_[i].key, i));
+  }
+  sort(keys.begin(), keys.end());
+
+  // Pick displacements so that no two keys share a slot.
+  vector<uint64> sorted_keys;
+  for (int i = 0; i < keys.size(); i++) {
+    sorted_keys.push_back(keys[i].first);
+  }
+  vector<uint32> displacements;
+  vector<int> slots;  // Index into keys, or -1.
+  BuildPerfectHash(sorted_keys, &BucketOf, &SlotOf, &displacements, &slots);
+  uint32 bucket_count = displacements.size();
+  uint32 slot_count = slots.size();
+
+  // Lay out the data.
+  uint64 displacements_size = (bucket_count * 4 + 7) / 8 * 8;
+  uint64 data_start = kHeaderSize + displacements_size +
+                      static_cast<uint64>(slot_count) * kSlotSize;
+  uint64 data_size = 0;
+  for (int i = 0; i < mocks_.size(); i++) {
+    data_size += mocks_[i].message_name.size() + mocks_[i].json.size() +
+                 mocks_[i].wire.size();
+  }
+  if (data_start + data_size > kuint32max) {
+    *error = filename + ": mock bundles are limited to 4GB.";
+    return false;
+  }
+
+  // Write to a temporary file and rename it, so that a server reloading
+  // the bundle never maps half of one.
+  string temp_filename = filename + ".tmp";
+  int fd;
+  do {
+    fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,
+              0666);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    *error = temp_filename + ": " + strerror(errno);
+    return false;
+  }
+
+  io::FileOutputStream file_output(fd);
+  bool ok;
+  {
+    io::CodedOutputStream output(&file_output);
+    output.WriteRaw(kMagic, sizeof(kMagic));
+    output.WriteLittleEndian32(kVersion);
+    output.WriteLittleEndian32(keys.size());
+    output.WriteLittleEndian32(slot_count);
+    output.WriteLittleEndian32(bucket_count);
+    output.WriteLittleEndian64(0);
+    for (uint32 i = 0; i < bucket_count; i++) {
+      output.WriteLittleEndian32(displacements[i]);
+    }
+    if (bucket_count % 2 != 0) output.WriteLittleEndian32(0);
+
+    uint32 offset = data_start;
+    for (uint32 i = 0; i < slot_count; i++) {
+      if (slots[i] == -1) {
+        output.WriteLittleEndian64(kEmptyKey);
+        for (int j = 0; j < 6; j++) output.WriteLittleEndian32(0);
+        continue;
+      }
+      const Mock& mock = mocks_[keys[slots[i]].second];
+      output.WriteLittleEndian64(mock.key);
+      const string* parts[] = { &mock.message_name, &mock.json, &mock.wire };
+      for (int j = 0; j < 3; j++) {
+        output.WriteLittleEndian32(offset);
+        output.WriteLittleEndian32(parts[j]->size());
+        offset += parts[j]->size();
+      }
+    }
+
+    for (uint32 i = 0; i < slot_count; i++) {
+      if (slots[i] == -1) continue;
+      const Mock& mock = mocks_[keys[slots[i]].second];
+      output.WriteString(mock.message_name);
+      output.WriteString(mock.json);
+      output.WriteString(mock.wire);
+    }
+    ok = !output.HadError();
+  }
+
+  if (!file_output.Close() && ok) {
+    *error = temp_filename + ": " + strerror(file_output.GetErrno());
+    ok = false;
+  } else if (!ok) {
+    *error = temp_filename + ": " + strerror(file_output.GetErrno());
+  }
+  if (ok) {
+#ifdef _WIN32
+    // rename() won't replace an existing file on Windows.
+    remove(filename.c_str());
+#endif
+    if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+      *error = filename + ": " + strerror(errno);
+      ok = false;
+    }
+  }
+  if (!ok) remove(temp_filename.c_str());
+  return ok;
+}
+
+// ===================================================================
+
+MockBundle::MockBundle()
+  : data_(NULL),
+    size_(0),
+    mapped_(false),
+    mock_count_(0),
+    slot_count_(0),
+    bucket_count_(0),
+    displacements_(NULL),
+    slots_(NULL) {
+}
+
+MockBundle::~MockBundle() {
+  Close();
+}
+
+void MockBundle::Close() {
+  if (data_ != NULL) {
+#ifndef _WIN32
+    if (mapped_) {
+      munmap(const_cast<char*>(data_), size_);
+    } else {
+      delete [] data_;
+    }
+#else
+    delete [] data_;
+#endif
+  }
+  data_ = NULL;
+  size_ = 0;
+  mapped_ = false;
+  mock_count_ = 0;
+  slot_count_ = 0;
+  bucket_count_ = 0;
+  displacements_ = NULL;
+  slots_ = NULL;
+}
+
+bool MockBundle::Open(const string& filename, string* error) {
+  Close();
+
+  int fd;
+  do {
+    fd = open(filename.c_str(), O_RDONLY | O_BINARY);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    *error = filename + ": " + strerror(errno);
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    *error = filename + ": " + strerror(errno);
+    close(fd);
+    return false;
+  }
+  size_ = info.st_size;
+  if (size_ < kHeaderSize) {
+    *error = filename + ": not a mock bundle.";
+    close(fd);
+    return false;
+  }
+
+#ifndef _WIN32
+  void* mapped = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapped != MAP_FAILED) {
+    data_ = static_cast<const char*>(mapped);
+    mapped_ = true;
+  }
+#endif
+  if (data_ == NULL) {
+    // No mmap(); read it instead.
+    char* buffer = new char[size_];
+    data_ = buffer;
+    for (int64 done = 0; done < size_; ) {
+      int bytes = read(fd, buffer + done, min<int64>(size_ - done, 1 << 20));
+      if (bytes <= 0 && !(bytes < 0 && errno == EINTR)) {
+        *error = filename + ": " +
+                 (bytes < 0 ? strerror(errno) : "unexpected end of file");
+        close(fd);
+        Close();
+        return false;
+      }
+      if (bytes > 0) done += bytes;
+    }
+  }
+  close(fd);
+
+  // Check everything Find() and GetSlot() rely on, so that a damaged file
+  // can't make them read outside the mapping.
+  bool valid = memcmp(data_, kMagic, sizeof(kMagic)) == 0 &&
+               ReadLittleEndian32(data_ + 8) == kVersion;
+  uint32 mock_count = 0, slot_count = 0, bucket_count = 0;
+  if (valid) {
+    mock_count = ReadLittleEndian32(data_ + 12);
+    slot_count = ReadLittleEndian32(data_ + 16);
+    bucket_count = ReadLittleEndian32(data_ + 20);
+    valid = slot_count > 0 && (slot_count & (slot_count - 1)) == 0 &&
+            bucket_count > 0 && mock_count <= slot_count &&
+            kHeaderSize + (static_cast<uint64>(bucket_count) * 4 + 7) / 8 * 8 +
+                static_cast<uint64>(slot_count) * kSlotSize <= size_;
+  }
+  if (valid) {
+    displacements_ = data_ + kHeaderSize;
+    slots_ = displacements_ + (static_cast<uint64>(bucket_count) * 4 + 7) / 8 * 8;
+    slot_count_ = slot_count;
+    bucket_count_ = bucket_count;
+
+    uint32 found = 0;
+    for (uint32 i = 0; i < slot_count && valid; i++) {
+      const char* slot = slots_ + i * kSlotSize;
+      uint64 key = ReadLittleEndian64(slot);
+      if (key == kEmptyKey) continue;
+      ++found;
+      for (int j = 0; j < 3 && valid; j++) {
+        uint64 offset = ReadLittleEndian32(slot + 8 + j * 8);
+        uint64 size = ReadLittleEndian32(slot + 12 + j * 8);
+        valid = offset + size <= size_ && size <= kint32max;
+      }
+    }
+    valid = valid && found == mock_count;
+  }
+  if (!valid) {
+    *error = filename + ": not a mock bundle, or damaged.";
+    Close();
+    return false;
+  }
+
+  mock_count_ = mock_count;
+  return true;
+}
+
+bool MockBundle::GetSlot(int slot, Mock* mock) const {
+  const char* ptr = slots_ + slot * kSlotSize;
+  uint64 key = ReadLittleEndian64(ptr);
+  if (key == kEmptyKey) return false;
+
+  mock->cgi_number = key >> 1;
+  mock->is_update_from_svr = (key & 1) != 0;
+  mock->message_name = data_ + ReadLittleEndian32(ptr + 8);
+  mock->message_name_size = ReadLittleEndian32(ptr + 12);
+  mock->json = data_ + ReadLittleEndian32(ptr + 16);
+  mock->json_size = ReadLittleEndian32(ptr + 20);
+  mock->wire = data_ + ReadLittleEndian32(ptr + 24);
+  mock->wire_size = ReadLittleEndian32(ptr + 28);
+  return true;
+}
+
+bool MockBundle::Find(uint32 cgi_number, bool is_update_from_svr,
+                      Mock* mock) const {
+  if (slot_count_ == 0) return false;
+  uint64 key = MakeKey(cgi_number, is_update_from_svr);
+  uint32 displacement = ReadLittleEndian32(
+      displacements_ + BucketOf(key, bucket_count_) * 4);
+  uint32 slot = SlotOf(key, displacement, slot_count_);
+  // The slot may hold another key, or none, if this one isn't in the
+  // bundle.
+  return ReadLittleEndian64(slots_ + slot * kSlotSize) == key &&
+         GetSlot(slot, mock);
+}
+
+// ===================================================================
+
+bool MergeMockBundles(const vector<string>& bundle_names,
+                      const string& output_name, string* error) {
+  MockBundleWriter writer;
+  MockBundle bundle;
+  MockBundle::Mock mock;
+  for (int i = 0; i < bundle_names.size(); i++) {
+    if (!bundle.Open(bundle_names[i], error)) return false;
+    for (int j = 0; j < bundle.slot_count(); j++) {
+      if (!bundle.GetSlot(j, &mock)) continue;
+      if (!writer.Add(mock.cgi_number, mock.is_update_from_svr,
+                      string(mock.message_name, mock.message_name_size),
+                      string(mock.json, mock.json_size),
+                      string(mock.wire, mock.wire_size))) {
+        *error = bundle_names[i] + ": there is already a mock for cgiNumber " +
+                 SimpleItoa(mock.cgi_number) + ", isUpdateFromSvr " +
+                 (mock.is_update_from_svr ? "1" : "0") + ".";
+        return false;
+      }
+    }
+  }
+  bundle.Close();
+  return writer.Write(output_name, error);
+}
+
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
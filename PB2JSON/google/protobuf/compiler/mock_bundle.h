@@ -0,0 +1,160 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// A single file holding the responses of many mock cases, indexed by
+// cgiNumber, for mock servers which would otherwise have to load and run a
+// script per mock case.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_MOCK_BUNDLE_H__
+#define GOOGLE_PROTOBUF_COMPILER_MOCK_BUNDLE_H__
+
+#include <set>
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class Descriptor;              // descriptor.h
+class DynamicMessageFactory;   // dynamic_message.h
+
+namespace compiler {
+
+// Builds the response a mock case stands for:  the same skeleton as
+// MessageGenerator::GenerateMockCase() writes, i.e. every singular field set
+// to its default, every repeated message field holding one such element and
+// every other repeated field empty.  A message type which contains itself is
+// only expanded once per path.  Fills in *wire with the serialized message
+// and *json with the same as JsonTranscoder writes it.
+LIBPROTOC_EXPORT void BuildMockResponse(const Descriptor* type,
+                                        DynamicMessageFactory* factory,
+                                        string* wire, string* json);
+
+// Collects mock cases and writes them as a bundle.  A bundle is one file
+// holding, after a small header, a perfect hash table from (cgiNumber,
+// isUpdateFromSvr) to each mock's message name, JSON and wire bytes, so it
+// can be used straight from an mmap() by MockBundle.  All numbers are
+// little-endian.
+class LIBPROTOC_EXPORT MockBundleWriter {
+ public:
+  MockBundleWriter();
+  ~MockBundleWriter();
+
+  // Adds a mock case.  Returns false if one with the same key was already
+  // added.
+  bool Add(uint32 cgi_number, bool is_update_from_svr,
+           const string& message_name, const string& json,
+           const string& wire);
+
+  int size() const { return mocks_.size(); }
+
+  // Writes the bundle.  The file is the same whatever order the mocks were
+  // added in.  Returns false and sets *error on I/O errors, or if the
+  // bundle would exceed 4GB.
+  bool Write(const string& filename, string* error) const;
+
+ private:
+  struct Mock {
+    uint64 key;
+    string message_name;
+    string json;
+    string wire;
+  };
+  vector<Mock> mocks_;
+  set<uint64> keys_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MockBundleWriter);
+};
+
+// A bundle written by MockBundleWriter, mapped into memory.  Find() hashes
+// the key once and looks at a single slot.
+class LIBPROTOC_EXPORT MockBundle {
+ public:
+  MockBundle();
+  ~MockBundle();
+
+  // A mock case.  The pointers point into the mapped file and stay valid
+  // until the bundle is closed.
+  struct Mock {
+    uint32 cgi_number;
+    bool is_update_from_svr;
+    const char* message_name;
+    int message_name_size;
+    const char* json;
+    int json_size;
+    const char* wire;
+    int wire_size;
+  };
+
+  // Maps the given bundle, closing the current one if any.  Returns false
+  // and sets *error if the file can't be mapped or isn't a valid bundle, in
+  // which case the bundle is left closed.
+  bool Open(const string& filename, string* error);
+  void Close();
+
+  // Looks up a mock case.  Returns false if there is none for the key.
+  bool Find(uint32 cgi_number, bool is_update_from_svr, Mock* mock) const;
+
+  // Iterates over the mocks:  fills in *mock and returns true if the given
+  // slot, from 0 to slot_count() - 1, holds one.
+  int slot_count() const { return slot_count_; }
+  bool GetSlot(int slot, Mock* mock) const;
+
+  int size() const { return mock_count_; }
+
+ private:
+  const char* data_;
+  int64 size_;
+  bool mapped_;  // False if data_ was read into memory instead.
+
+  int mock_count_;
+  int slot_count_;
+  int bucket_count_;
+  const char* displacements_;
+  const char* slots_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MockBundle);
+};
+
+// Merges the given bundles into one.  Returns false and sets *error on I/O
+// errors or if two bundles have a mock for the same key.
+LIBPROTOC_EXPORT bool MergeMockBundles(const vector<string>& bundle_names,
+                                       const string& output_name,
+                                       string* error);
+
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_MOCK_BUNDLE_H__
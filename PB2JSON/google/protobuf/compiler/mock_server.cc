@@ -0,0 +1,776 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <google/protobuf/compiler/mock_server.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#endif
+#include <algorithm>
+
+#include <google/protobuf/compiler/mock_bundle.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+#ifndef _WIN32
+
+namespace {
+
+// Requests whose headers or bodies are bigger than this get an error and
+// the connection is closed.  Mock clients send small requests.
+const int kMaxHeaderSize = 64 << 10;
+const int kMaxBodySize = 16 << 20;
+
+// The most iovecs passed to one writev().
+const int kMaxSegmentsPerWrite = 64;
+
+// Identifies a version of the bundle file.
+struct FileVersion {
+  int64 inode;
+  int64 size;
+  int64 modification_time;
+
+  bool operator==(const FileVersion& other) const {
+    return inode == other.inode && size == other.size &&
+           modification_time == other.modification_time;
+  }
+};
+
+bool GetFileVersion(const string& filename, FileVersion* version) {
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0) return false;
+  version->inode = info.st_ino;
+  version->size = info.st_size;
+  version->modification_time = info.st_mtime;
+  return true;
+}
+
+bool SetNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+inline bool EqualsIgnoringCase(const char* begin, const char* end,
+                               const char* lowercase) {
+  for (; begin < end; ++begin, ++lowercase) {
+    if (*lowercase == '\0' || tolower(*begin) != *lowercase) return false;
+  }
+  return *lowercase == '\0';
+}
+
+// Trims spaces and tabs from both ends of [*begin, *end).
+void TrimSpace(const char** begin, const char** end) {
+  while (*begin < *end && (**begin == ' ' || **begin == '\t')) ++*begin;
+  while (*end > *begin && ((*end)[-1] == ' ' || (*end)[-1] == '\t')) --*end;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------
+
+// A loaded version of the bundle.
+struct MockServer::Generation {
+  MockBundle bundle;
+  FileVersion version;
+
+  // Connections with responses from this generation still to write, plus
+  // one while it is the current generation.
+  int references;
+};
+
+struct MockServer::Connection {
+  int fd;
+
+  // What has been read but not yet answered.
+  string input;
+  bool peer_closed;
+
+  // Responses waiting to be written.  Status lines and headers are
+  // formatted into headers; bodies point into the bundle.
+  struct Segment {
+    const char* data;  // NULL if in headers.
+    int offset;        // Into headers, if data is NULL.
+    int size;
+  };
+  string headers;
+  vector<Segment> output;
+  int next_segment;      // The first segment not completely written.
+  int segment_written;   // How much of it has been.
+  Generation* generation;  // Which output's bodies point into, or NULL.
+  bool close_after_output;
+
+  // What the poller is watching for.
+  bool watching_writable;
+};
+
+// Waits for sockets to become readable or writable, using epoll() on Linux
+// and poll() elsewhere.  Level-triggered in both cases.
+class MockServer::Poller {
+ public:
+  struct Event {
+    int fd;
+    bool readable;  // Also set on errors and hangups, so that read() sees
+                    // them.
+    bool writable;
+  };
+
+#ifdef __linux__
+  Poller() : epoll_fd_(epoll_create(1024)) {}
+  ~Poller() { if (epoll_fd_ >= 0) close(epoll_fd_); }
+
+  bool ok() const { return epoll_fd_ >= 0; }
+
+  void Add(int fd, bool readable, bool writable) {
+    Control(EPOLL_CTL_ADD, fd, readable, writable);
+  }
+  void Modify(int fd, bool readable, bool writable) {
+    Control(EPOLL_CTL_MOD, fd, readable, writable);
+  }
+  void Remove(int fd) {
+    struct epoll_event event;  // Ignored, but must not be NULL on old kernels.
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+  }
+
+  // Returns false on errors other than interruption.
+  bool Wait(int timeout_ms, vector<Event>* events) {
+    events->clear();
+    struct epoll_event ready[256];
+    int count = epoll_wait(epoll_fd_, ready, 256, timeout_ms);
+    if (count < 0) return errno == EINTR;
+    for (int i = 0; i < count; i++) {
+      Event event;
+      event.fd = ready[i].data.fd;
+      event.readable = (ready[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0;
+      event.writable = (ready[i].events & EPOLLOUT) != 0;
+      events->push_back(event);
+    }
+    return true;
+  }
+
+ private:
+  void Control(int operation, int fd, bool readable, bool writable) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = 0;
+    if (readable) event.events |= EPOLLIN;
+    if (writable) event.events |= EPOLLOUT;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd_, operation, fd, &event);
+  }
+
+  int epoll_fd_;
+#else
+  Poller() {}
+  ~Poller() {}
+
+  bool ok() const { return true; }
+
+  void Add(int fd, bool readable, bool writable) {
+    if (fd >= index_.size()) index_.resize(fd + 1, -1);
+    index_[fd] = fds_.size();
+    struct pollfd entry;
+    entry.fd = fd;
+    entry.events = 0;
+    entry.revents = 0;
+    fds_.push_back(entry);
+    Modify(fd, readable, writable);
+  }
+  void Modify(int fd, bool readable, bool writable) {
+    short events = 0;
+    if (readable) events |= POLLIN;
+    if (writable) events |= POLLOUT;
+    fds_[index_[fd]].events = events;
+  }
+  void Remove(int fd) {
+    // Move the last entry into the hole.
+    int hole = index_[fd];
+    fds_[hole] = fds_.back();
+    index_[fds_[hole].fd] = hole;
+    fds_.pop_back();
+    index_[fd] = -1;
+  }
+
+  bool Wait(int timeout_ms, vector<Event>* events) {
+    events->clear();
+    int count = poll(&fds_[0], fds_.size(), timeout_ms);
+    if (count < 0) return errno == EINTR;
+    for (int i = 0; i < fds_.size() && events->size() < count; i++) {
+      if (fds_[i].revents == 0) continue;
+      Event event;
+      event.fd = fds_[i].fd;
+      event.readable = (fds_[i].revents & (POLLIN | POLLERR | POLLHUP)) != 0;
+      event.writable = (fds_[i].revents & POLLOUT) != 0;
+      events->push_back(event);
+    }
+    return true;
+  }
+
+ private:
+  vector<struct pollfd> fds_;
+  vector<int> index_;  // Into fds_, by file descriptor.
+#endif
+};
+
+// ===================================================================
+
+MockServer::MockServer()
+  : listen_fd_(-1),
+    current_(NULL),
+    poller_(new Poller) {
+}
+
+MockServer::~MockServer() {
+  for (int i = 0; i < connections_.size(); i++) {
+    if (connections_[i] != NULL) CloseConnection(connections_[i]);
+  }
+  if (listen_fd_ >= 0) close(listen_fd_);
+  if (!unix_socket_path_.empty()) unlink(unix_socket_path_.c_str());
+  delete current_;
+  for (int i = 0; i < retired_.size(); i++) {
+    delete retired_[i];
+  }
+}
+
+bool MockServer::Start(const string& bundle_name, const string& address,
+                       string* error) {
+  if (!poller_->ok()) {
+    *error = string("Can't create poller: ") + strerror(errno);
+    return false;
+  }
+
+  bundle_name_ = bundle_name;
+  current_ = new Generation;
+  current_->references = 1;
+  if (!GetFileVersion(bundle_name, &current_->version)) {
+    *error = bundle_name + ": " + strerror(errno);
+    return false;
+  }
+  if (!current_->bundle.Open(bundle_name, error)) return false;
+
+  if (HasPrefixString(address, "unix:")) {
+    string path = address.substr(5);
+    struct sockaddr_un unix_address;
+    memset(&unix_address, 0, sizeof(unix_address));
+    if (path.empty() || path.size() >= sizeof(unix_address.sun_path)) {
+      *error = address + ": bad socket path.";
+      return false;
+    }
+    unix_address.sun_family = AF_UNIX;
+    strcpy(unix_address.sun_path, path.c_str());
+
+    // A socket left behind by an earlier server would make bind() fail.
+    unlink(path.c_str());
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0 ||
+        bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&unix_address),
+             sizeof(unix_address)) != 0) {
+      *error = address + ": " + strerror(errno);
+      return false;
+    }
+    unix_socket_path_ = path;
+  } else {
+    string::size_type colon = address.find_last_of(':');
+    string host = colon == string::npos ? "" : address.substr(0, colon);
+    string port = colon == string::npos ? address : address.substr(colon + 1);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    struct addrinfo* addresses;
+    int result = getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(),
+                             &hints, &addresses);
+    if (result != 0) {
+      *error = address + ": " + gai_strerror(result);
+      return false;
+    }
+    for (struct addrinfo* info = addresses; info != NULL;
+         info = info->ai_next) {
+      listen_fd_ = socket(info->ai_family, info->ai_socktype,
+                          info->ai_protocol);
+      if (listen_fd_ < 0) continue;
+      int one = 1;
+      setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      if (bind(listen_fd_, info->ai_addr, info->ai_addrlen) == 0) break;
+      close(listen_fd_);
+      listen_fd_ = -1;
+    }
+    freeaddrinfo(addresses);
+    if (listen_fd_ < 0) {
+      *error = address + ": " + strerror(errno);
+      return false;
+    }
+  }
+
+  if (listen(listen_fd_, 1024) != 0 || !SetNonBlocking(listen_fd_)) {
+    *error = address + ": " + strerror(errno);
+    return false;
+  }
+  poller_->Add(listen_fd_, true, false);
+  return true;
+}
+
+bool MockServer::Run(string* error) {
+  // A client hanging up mid-response should only end its connection.
+  signal(SIGPIPE, SIG_IGN);
+
+  vector<Poller::Event> events;
+  time_t last_check = time(NULL);
+  while (true) {
+    if (!poller_->Wait(1000, &events)) {
+      *error = string("Waiting for connections: ") + strerror(errno);
+      return false;
+    }
+    for (int i = 0; i < events.size(); i++) {
+      const Poller::Event& event = events[i];
+      if (event.fd == listen_fd_) {
+        Accept();
+        continue;
+      }
+      Connection* connection =
+          event.fd < connections_.size() ? connections_[event.fd] : NULL;
+      if (connection == NULL) continue;
+      bool keep = true;
+      if (event.writable) keep = HandleWritable(connection);
+      if (keep && event.readable) keep = HandleReadable(connection);
+      if (!keep) CloseConnection(connection);
+    }
+
+    time_t now = time(NULL);
+    if (now != last_check) {
+      last_check = now;
+      ReloadIfChanged();
+    }
+  }
+}
+
+// -------------------------------------------------------------------
+
+void MockServer::ReloadIfChanged() {
+  FileVersion version;
+  if (!GetFileVersion(bundle_name_, &version) ||
+      version == current_->version) {
+    return;
+  }
+
+  Generation* generation = new Generation;
+  generation->version = version;
+  generation->references = 1;
+  string error;
+  if (!generation->bundle.Open(bundle_name_, &error)) {
+    GOOGLE_LOG(WARNING) << error << "  Still serving the previous bundle.";
+    // Don't try the same file again.
+    current_->version = version;
+    delete generation;
+    return;
+  }
+
+  GOOGLE_LOG(INFO) << "Reloaded " << bundle_name_ << " ("
+                   << generation->bundle.size() << " mocks).";
+  Generation* previous = current_;
+  current_ = generation;
+  if (--previous->references == 0) {
+    delete previous;
+  } else {
+    retired_.push_back(previous);
+  }
+}
+
+void MockServer::Release(Generation* generation) {
+  if (--generation->references > 0) return;
+  retired_.erase(find(retired_.begin(), retired_.end(), generation));
+  delete generation;
+}
+
+// -------------------------------------------------------------------
+
+void MockServer::Accept() {
+  while (true) {
+    int fd = accept(listen_fd_, NULL, NULL);
+    if (fd < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR &&
+          errno != ECONNABORTED) {
+        GOOGLE_LOG(WARNING) << "accept(): " << strerror(errno);
+      }
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      return;
+    }
+    if (!SetNonBlocking(fd)) {
+      close(fd);
+      continue;
+    }
+    // Fails harmlessly on Unix domain sockets.
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    Connection* connection = new Connection;
+    connection->fd = fd;
+    connection->peer_closed = false;
+    connection->next_segment = 0;
+    connection->segment_written = 0;
+    connection->generation = NULL;
+    connection->close_after_output = false;
+    connection->watching_writable = false;
+    if (fd >= connections_.size()) connections_.resize(fd + 1, NULL);
+    connections_[fd] = connection;
+    poller_->Add(fd, true, false);
+  }
+}
+
+void MockServer::CloseConnection(Connection* connection) {
+  poller_->Remove(connection->fd);
+  close(connection->fd);
+  connections_[connection->fd] = NULL;
+  if (connection->generation != NULL) Release(connection->generation);
+  delete connection;
+}
+
+void MockServer::UpdateInterest(Connection* connection) {
+  // Only read more once everything asked for so far has been written.
+  bool writing = !connection->output.empty();
+  if (writing != connection->watching_writable) {
+    poller_->Modify(connection->fd, !writing, writing);
+    connection->watching_writable = writing;
+  }
+}
+
+bool MockServer::HandleReadable(Connection* connection) {
+  if (!connection->output.empty()) return true;
+
+  char buffer[16 << 10];
+  while (true) {
+    ssize_t size = read(connection->fd, buffer, sizeof(buffer));
+    if (size > 0) {
+      connection->input.append(buffer, size);
+      if (size < sizeof(buffer)) break;
+    } else if (size == 0) {
+      connection->peer_closed = true;
+      break;
+    } else if (errno == EINTR) {
+      continue;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      break;
+    } else {
+      return false;
+    }
+  }
+
+  if (!ProcessRequests(connection)) return false;
+  if (connection->output.empty()) {
+    // Nothing to answer yet; close if nothing more can come.
+    return !connection->peer_closed && !connection->close_after_output;
+  }
+  // Most responses fit in the socket buffer, so try now rather than
+  // waiting for the poller to say so.
+  return HandleWritable(connection);
+}
+
+bool MockServer::HandleWritable(Connection* connection) {
+  while (!connection->output.empty()) {
+    struct iovec vectors[kMaxSegmentsPerWrite];
+    int count = 0;
+    for (int i = connection->next_segment;
+         i < connection->output.size() && count < kMaxSegmentsPerWrite;
+         i++, count++) {
+      const Connection::Segment& segment = connection->output[i];
+      const char* data = segment.data != NULL ?
+          segment.data : connection->headers.data() + segment.offset;
+      int skip = i == connection->next_segment ?
+          connection->segment_written : 0;
+      vectors[count].iov_base = const_cast<char*>(data) + skip;
+      vectors[count].iov_len = segment.size - skip;
+    }
+
+    ssize_t written = writev(connection->fd, vectors, count);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      return false;
+    }
+
+    // Advance past what was written.
+    while (written > 0) {
+      const Connection::Segment& segment =
+          connection->output[connection->next_segment];
+      int left = segment.size - connection->segment_written;
+      if (written < left) {
+        connection->segment_written += written;
+        break;
+      }
+      written -= left;
+      ++connection->next_segment;
+      connection->segment_written = 0;
+    }
+
+    if (connection->next_segment == connection->output.size()) {
+      connection->output.clear();
+      connection->headers.clear();
+      connection->next_segment = 0;
+      if (connection->generation != NULL) {
+        Release(connection->generation);
+        connection->generation = NULL;
+      }
+      if (connection->close_after_output) return false;
+      // Answer any requests which were pipelined behind these.
+      if (!ProcessRequests(connection)) return false;
+      if (connection->output.empty() && connection->peer_closed) {
+        return false;
+      }
+    }
+  }
+
+  UpdateInterest(connection);
+  return true;
+}
+
+// -------------------------------------------------------------------
+
+bool MockServer::ProcessRequests(Connection* connection) {
+  const string& input = connection->input;
+  int consumed = 0;
+  while (!connection->close_after_output) {
+    string::size_type header_end = input.find("\r\n\r\n", consumed);
+    if (header_end == string::npos) {
+      if (input.size() - consumed > kMaxHeaderSize) {
+        QueueError(connection, 431, "Request Header Fields Too Large", false);
+      }
+      break;
+    }
+
+    // The request line:  METHOD TARGET VERSION
+    const char* line = input.data() + consumed;
+    const char* line_end = line + input.find("\r\n", consumed) - consumed;
+    const char* target = static_cast<const char*>(
+        memchr(line, ' ', line_end - line));
+    const char* version = target == NULL ? NULL : static_cast<const char*>(
+        memchr(target + 1, ' ', line_end - target - 1));
+    if (version == NULL) {
+      QueueError(connection, 400, "Bad Request", false);
+      break;
+    }
+    ++target;
+    ++version;
+    bool keep_alive = EqualsIgnoringCase(version, line_end, "http/1.1");
+
+    // The headers which matter here.
+    int64 content_length = 0;
+    bool bad_length = false;
+    bool chunked = false;
+    // Each line ends at a "\r\n", which the search can't run past because
+    // the headers end with one.  A lone '\r' is just part of a line.
+    const char* headers_end = input.data() + header_end + 2;
+    for (const char* header = line_end + 2; header < headers_end; ) {
+      const char* end =
+          input.data() + input.find("\r\n", header - input.data());
+      const char* colon = static_cast<const char*>(
+          memchr(header, ':', end - header));
+      if (colon != NULL) {
+        const char* value = colon + 1;
+        const char* value_end = end;
+        TrimSpace(&value, &value_end);
+        if (EqualsIgnoringCase(header, colon, "content-length")) {
+          uint64 length;
+          bad_length = !ParseUnsignedDigits(value, value_end, 10, kint32max,
+                                            &length);
+          if (!bad_length) content_length = length;
+        } else if (EqualsIgnoringCase(header, colon, "transfer-encoding")) {
+          chunked = true;
+        } else if (EqualsIgnoringCase(header, colon, "connection")) {
+          if (EqualsIgnoringCase(value, value_end, "close")) {
+            keep_alive = false;
+          } else if (EqualsIgnoringCase(value, value_end, "keep-alive")) {
+            keep_alive = true;
+          }
+        }
+      }
+      header = end + 2;
+    }
+
+    if (bad_length) {
+      QueueError(connection, 400, "Bad Request", false);
+      break;
+    }
+    if (chunked) {
+      QueueError(connection, 501, "Not Implemented", false);
+      break;
+    }
+    if (content_length > kMaxBodySize) {
+      QueueError(connection, 413, "Payload Too Large", false);
+      break;
+    }
+    int request_end = header_end + 4 + content_length;
+    if (input.size() < request_end) break;  // Wait for the rest of the body.
+
+    if (connection->peer_closed) keep_alive = false;
+    QueueResponse(connection, string(target, version - 1), keep_alive);
+    consumed = request_end;
+  }
+
+  connection->input.erase(0, consumed);
+  return true;
+}
+
+void MockServer::QueueResponse(Connection* connection, const string& target,
+                               bool keep_alive) {
+  // /<cgiNumber>[?name=value&...]
+  string::size_type question = target.find('?');
+  string path = target.substr(0, question);
+  uint64 cgi_number;
+  if (path.size() < 2 || path[0] != '/' ||
+      !ParseUnsignedDigits(path.data() + 1, path.data() + path.size(), 10,
+                           kuint32max, &cgi_number)) {
+    QueueError(connection, 404, "Not Found", keep_alive);
+    return;
+  }
+
+  bool is_update_from_svr = false;
+  bool wire = false;
+  if (question != string::npos) {
+    vector<string> parameters;
+    SplitStringUsing(target.substr(question + 1), "&", &parameters);
+    for (int i = 0; i < parameters.size(); i++) {
+      const string& parameter = parameters[i];
+      if (parameter == "isUpdateFromSvr=1" ||
+          parameter == "isUpdateFromSvr=true") {
+        is_update_from_svr = true;
+      } else if (parameter == "isUpdateFromSvr=0" ||
+                 parameter == "isUpdateFromSvr=false") {
+        is_update_from_svr = false;
+      } else if (parameter == "format=wire") {
+        wire = true;
+      } else if (parameter == "format=json") {
+        wire = false;
+      } else {
+        QueueError(connection, 400, "Bad Request", keep_alive);
+        return;
+      }
+    }
+  }
+
+  MockBundle::Mock mock;
+  if (!current_->bundle.Find(cgi_number, is_update_from_svr, &mock)) {
+    QueueError(connection, 404, "Not Found", keep_alive);
+    return;
+  }
+
+  if (connection->generation == NULL) {
+    connection->generation = current_;
+    ++current_->references;
+  }
+
+  Connection::Segment segment;
+  segment.data = NULL;
+  segment.offset = connection->headers.size();
+  connection->headers += "HTTP/1.1 200 OK\r\nContent-Type: ";
+  connection->headers += wire ? "application/x-protobuf" : "application/json";
+  connection->headers += "\r\nContent-Length: ";
+  connection->headers += SimpleItoa(wire ? mock.wire_size : mock.json_size);
+  connection->headers += "\r\nX-Mock-Message: ";
+  connection->headers.append(mock.message_name, mock.message_name_size);
+  connection->headers += keep_alive ? "\r\n\r\n"
+                                    : "\r\nConnection: close\r\n\r\n";
+  segment.size = connection->headers.size() - segment.offset;
+  connection->output.push_back(segment);
+
+  segment.data = wire ? mock.wire : mock.json;
+  segment.offset = 0;
+  segment.size = wire ? mock.wire_size : mock.json_size;
+  if (segment.size > 0) connection->output.push_back(segment);
+
+  if (!keep_alive) connection->close_after_output = true;
+}
+
+void MockServer::QueueError(Connection* connection, int status,
+                            const char* reason, bool keep_alive) {
+  string body = string(reason) + "\n";
+  Connection::Segment segment;
+  segment.data = NULL;
+  segment.offset = connection->headers.size();
+  connection->headers += "HTTP/1.1 " + SimpleItoa(status) + " " + reason +
+                         "\r\nContent-Type: text/plain\r\nContent-Length: " +
+                         SimpleItoa(body.size()) +
+                         (keep_alive ? "\r\n\r\n"
+                                     : "\r\nConnection: close\r\n\r\n") +
+                         body;
+  segment.size = connection->headers.size() - segment.offset;
+  connection->output.push_back(segment);
+  if (!keep_alive) connection->close_after_output = true;
+}
+
+#else  // _WIN32
+
+struct MockServer::Generation {};
+struct MockServer::Connection {};
+class MockServer::Poller {};
+
+MockServer::MockServer() : listen_fd_(-1), current_(NULL) {}
+MockServer::~MockServer() {}
+
+bool MockServer::Start(const string& bundle_name, const string& address,
+                       string* error) {
+  *error = "The mock server is not available on Windows.";
+  return false;
+}
+
+bool MockServer::Run(string* error) {
+  *error = "The mock server is not available on Windows.";
+  return false;
+}
+
+#endif  // _WIN32
+
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,132 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Serves the responses in a mock bundle over HTTP.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_MOCK_SERVER_H__
+#define GOOGLE_PROTOBUF_COMPILER_MOCK_SERVER_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+// A single-threaded HTTP/1.1 server answering
+//
+//   GET /<cgiNumber>[?isUpdateFromSvr=1][&format=wire]
+//
+// (any method will do; request bodies are skipped) with the matching
+// response from a bundle written by MockBundleWriter:  the JSON by default,
+// or the wire bytes with format=wire.  isUpdateFromSvr defaults to 0.
+// Unknown keys get a 404.
+//
+// The server uses epoll() on Linux and poll() elsewhere, with non-blocking
+// sockets and keep-alive.  Responses are written with writev() straight
+// from the mapped bundle, with only the status line and headers formatted
+// per request.  A connection isn't read from again until everything it
+// asked for has been written, so a slow client can't make the server
+// buffer without bound.
+//
+// About once a second the server checks whether the bundle file has been
+// replaced (MockBundleWriter renames a complete file into place) and if so
+// loads the new one.  Responses already being written keep the old mapping
+// until they finish.  If the new file can't be loaded, the server says so
+// and keeps serving the old one.  Replace a served bundle by renaming a
+// new file over it; rewriting it in place changes pages still mapped by
+// in-flight responses.
+//
+// Not available on Windows.
+class LIBPROTOC_EXPORT MockServer {
+ public:
+  MockServer();
+  ~MockServer();
+
+  // Loads the bundle and starts listening on the given address, which is
+  // either "unix:PATH" for a Unix domain socket or "[HOST:]PORT" for TCP
+  // (HOST defaults to all interfaces).  Returns false and sets *error on
+  // failure.
+  bool Start(const string& bundle_name, const string& address,
+             string* error);
+
+  // Serves requests until an unrecoverable error, which is returned in
+  // *error.
+  bool Run(string* error);
+
+ private:
+  struct Generation;
+  struct Connection;
+  class Poller;
+
+  // Loads the bundle if it has changed since the current generation was
+  // loaded.
+  void ReloadIfChanged();
+
+  void Accept();
+  // Reads what the client has sent and queues responses.  Returns false if
+  // the connection should be closed.
+  bool HandleReadable(Connection* connection);
+  bool HandleWritable(Connection* connection);
+  // Answers the complete requests in the connection's input buffer.
+  // Returns false if the connection should be closed.
+  bool ProcessRequests(Connection* connection);
+  void QueueResponse(Connection* connection, const string& target,
+                     bool keep_alive);
+  void QueueError(Connection* connection, int status, const char* reason,
+                  bool keep_alive);
+  void UpdateInterest(Connection* connection);
+  void CloseConnection(Connection* connection);
+  void Release(Generation* generation);
+
+  string bundle_name_;
+  string unix_socket_path_;  // To remove when done, if listening on one.
+  int listen_fd_;
+
+  Generation* current_;
+  // Older generations which connections still reference.
+  vector<Generation*> retired_;
+
+  // Indexed by file descriptor.
+  vector<Connection*> connections_;
+  scoped_ptr<Poller> poller_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MockServer);
+};
+
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_MOCK_SERVER_H__
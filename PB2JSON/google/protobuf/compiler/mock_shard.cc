@@ -0,0 +1,194 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <map>
+#include <set>
+
+#include <google/protobuf/compiler/mock_shard.h>
+#include <google/protobuf/compiler/symbol_scanner.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/stubs/hash_util.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+#ifndef O_BINARY
+#ifdef _O_BINARY
+#define O_BINARY _O_BINARY
+#else
+#define O_BINARY 0     // If this isn't defined, the platform doesn't need it.
+#endif
+#endif
+
+namespace {
+
+bool ReadFileContents(const string& filename, string* contents,
+                      string* error) {
+  int fd;
+  do {
+    fd = open(filename.c_str(), O_RDONLY | O_BINARY);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    *error = filename + ": " + strerror(errno);
+    return false;
+  }
+
+  io::FileInputStream input(fd);
+  input.SetCloseOnDelete(true);
+  ReadWholeStream(&input, contents);
+  if (input.GetErrno() != 0) {
+    *error = filename + ": " + strerror(input.GetErrno());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ReadMockManifest(const string& filename, vector<MockTarget>* targets,
+                      string* error) {
+  string contents;
+  if (!ReadFileContents(filename, &contents, error)) return false;
+
+  vector<string> lines;
+  SplitStringUsing(contents, "\n", &lines);
+  set<string> seen;
+  for (int i = 0; i < lines.size(); i++) {
+    if (lines[i][0] == '#') continue;
+
+    vector<string> fields;
+    SplitStringUsing(lines[i], " \t\r", &fields);
+    if (fields.empty()) continue;
+    if (fields.size() != 3) {
+      *error = filename + ": expected \"MessageName cgiNumber "
+               "isUpdateFromSvr\": " + lines[i];
+      return false;
+    }
+    if (!seen.insert(fields[0]).second) {
+      *error = filename + ": " + fields[0] + " is listed more than once.";
+      return false;
+    }
+
+    targets->push_back(MockTarget());
+    MockTarget* target = &targets->back();
+    target->message = fields[0];
+    target->cgi_number = fields[1];
+    target->is_update_from_svr = fields[2];
+  }
+  return true;
+}
+
+int MockShardOf(const string& full_name, int shard_count) {
+  return internal::Fnv1a64(full_name.data(), full_name.size()) % shard_count;
+}
+
+bool MergeMockShards(const vector<string>& directories,
+                     const string& bundle_name, string* error) {
+  // Collect the scripts as (file name, directory), sorted by file name.
+  map<string, string> scripts;
+  for (int i = 0; i < directories.size(); i++) {
+    struct stat info;
+    if (stat(directories[i].c_str(), &info) != 0) {
+      *error = directories[i] + ": " + strerror(errno);
+      return false;
+    }
+
+    vector<string> names;
+    ListDirectory(directories[i], &names);
+    for (int j = 0; j < names.size(); j++) {
+      if (!HasSuffixString(names[j], ".js")) continue;
+      pair<map<string, string>::iterator, bool> inserted =
+          scripts.insert(make_pair(names[j], directories[i]));
+      if (!inserted.second) {
+        *error = names[j] + " is in both " + inserted.first->second +
+                 " and " + directories[i] + ".";
+        return false;
+      }
+    }
+  }
+
+  int fd;
+  do {
+    fd = open(bundle_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,
+              0666);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    *error = bundle_name + ": " + strerror(errno);
+    return false;
+  }
+
+  // Each script declares its response with "var", so they can simply be
+  // run one after the other.
+  io::FileOutputStream output(fd);
+  bool read_ok = true;
+  {
+    io::CodedOutputStream coded_output(&output);
+    string contents;
+    for (map<string, string>::const_iterator iter = scripts.begin();
+         iter != scripts.end(); ++iter) {
+      if (!ReadFileContents(iter->second + "/" + iter->first, &contents,
+                            error)) {
+        read_ok = false;
+        break;
+      }
+      if (!contents.empty() && contents[contents.size() - 1] != '\n') {
+        contents += '\n';
+      }
+      coded_output.WriteString("// " + iter->first + "\n");
+      coded_output.WriteString(contents);
+    }
+  }
+
+  if (!output.Close() && read_ok) {
+    *error = bundle_name + ": " + strerror(output.GetErrno());
+    return false;
+  }
+  return read_ok;
+}
+
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
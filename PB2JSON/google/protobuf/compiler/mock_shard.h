@@ -0,0 +1,90 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Lets several machines split the mock cases of a manifest between them
+// without talking to each other, and puts their output back together.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_MOCK_SHARD_H__
+#define GOOGLE_PROTOBUF_COMPILER_MOCK_SHARD_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+// One line of a --manifest.
+struct LIBPROTOC_EXPORT MockTarget {
+  // As passed to --target, --cgiNumber and --isUpdateFromSvr.
+  string message;
+  string cgi_number;
+  string is_update_from_svr;
+
+  // Filled in by the caller once the message has been found.
+  string full_name;
+  string file;
+};
+
+// Reads a manifest, which lists one mock case per line as
+//
+//   MessageName cgiNumber isUpdateFromSvr
+//
+// separated by spaces or tabs.  Blank lines and lines starting with '#'
+// are ignored.  Returns false and sets *error if the file can't be read, a
+// line is malformed, or a message is listed twice (each message's mock
+// case goes to its own file, so the second would overwrite the first).
+LIBPROTOC_EXPORT bool ReadMockManifest(const string& filename,
+                                       vector<MockTarget>* targets,
+                                       string* error);
+
+// Returns which of shard_count shards generates the mock case for the
+// message with the given full name.  This is a fixed function of the name
+// (FNV-1a, not hash<string>), so every machine, build and platform agrees
+// on it, and the order of the manifest doesn't matter.
+LIBPROTOC_EXPORT int MockShardOf(const string& full_name, int shard_count);
+
+// Concatenates the mock case scripts (*.js) in the given shard output
+// directories into a single script, in order of file name, so that the
+// bundle doesn't depend on how the targets were sharded.  Returns false and
+// sets *error on I/O errors or if two shards produced the same file.
+LIBPROTOC_EXPORT bool MergeMockShards(const vector<string>& directories,
+                                      const string& bundle_name,
+                                      string* error);
+
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_MOCK_SHARD_H__
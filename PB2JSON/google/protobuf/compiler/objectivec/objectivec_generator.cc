@@ -111,6 +111,18 @@ namespace google { namespace protobuf { namespace compiler { namespace objective
         return true;
     }
     
+  bool ObjectiveCGenerator::GenerateForTarget(
+      const string& target_message,
+      const string& cgi_number,
+      const string& is_update_from_svr,
+      const vector<const FileDescriptor*>& parsed_files,
+      const string& parameter,
+      OutputDirectory* output_directory,
+      string* error) const {
+    return GenerateMockCase(target_message, cgi_number, is_update_from_svr,
+                            parsed_files, parameter, output_directory, error);
+  }
+
   bool ObjectiveCGenerator::Generate(const FileDescriptor* file,
     const string& parameter,
     OutputDirectory* output_directory,
@@ -45,6 +45,15 @@ class LIBPROTOC_EXPORT ObjectiveCGenerator : public CodeGenerator {
                           OutputDirectory* output_directory,
                           string* error) const;
 
+  // Generates the mock case for the target.
+  bool GenerateForTarget(const string& target_message,
+                         const string& cgi_number,
+                         const string& is_update_from_svr,
+                         const vector<const FileDescriptor*>& parsed_files,
+                         const string& parameter,
+                         OutputDirectory* output_directory,
+                         string* error) const;
+
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ObjectiveCGenerator);
 };
@@ -30,6 +30,7 @@
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/wire_format_lite_inl.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/flat_schema.h>
 
 namespace google { namespace protobuf { namespace compiler { namespace objectivec {
     
@@ -339,45 +340,52 @@ namespace google { namespace protobuf { namespace compiler { namespace objective
     }
     
     void MessageGenerator::GenerateMessage(io::Printer *printer) {
-        for (int i = 0; i < descriptor_->field_count(); i++) {
-            const FieldDescriptor *pFieldDescriptor = descriptor_->field(i);
-            if (pFieldDescriptor->is_repeated()) {
-                if (pFieldDescriptor->type() == FieldDescriptor::TYPE_MESSAGE) {
-                    printer->Print("\"$variblename$\" : [\n ","variblename", UnderscoresToCamelCase(pFieldDescriptor));
+        FlatSchema schema;
+        GenerateMessage(schema, schema.AddMessage(descriptor_), printer);
+    }
+    
+    // Walks the flattened schema rather than the descriptors, so that the
+    // fields of each nested message are a run of consecutive indexes and
+    // their names are computed once, however often the message is repeated.
+    void MessageGenerator::GenerateMessage(const FlatSchema& schema, int message,
+                                           io::Printer *printer) {
+        int end = schema.first_field(message) + schema.field_count(message);
+        for (int i = schema.first_field(message); i < end; i++) {
+            int child = schema.message_type(i);
+            if (schema.is_repeated(i)) {
+                if (schema.type(i) == FieldDescriptor::TYPE_MESSAGE) {
+                    printer->Print("\"$variblename$\" : [\n ","variblename", schema.json_name(i));
                     printer->Indent();
                     printer->Print("{\n");
                     printer->Indent();
                     {
-                        //printer->Print("$name$","name", ClassName(pFieldDescriptor->message_type()));
-                        const Descriptor *pD = pFieldDescriptor->message_type();
-                        if (pD == nullptr) {
+                        if (child == -1) {
                             printer->Print("Error occurs: repeated->null message type.");
                             return;
                         }
-                        MessageGenerator(pD).GenerateMessage(printer);
+                        GenerateMessage(schema, child, printer);
                     }
                     printer->Outdent();
                     printer->Print("},\n");
                     printer->Outdent();
                     printer->Print("],\n");
                 } else {
-                    printer->Print("\"$variblename$\" : [ ],\n","variblename", UnderscoresToCamelCase(pFieldDescriptor));
+                    printer->Print("\"$variblename$\" : [ ],\n","variblename", schema.json_name(i));
                 }
             } else {
-                ObjectiveCType objcType = GetObjectiveCType(pFieldDescriptor->type());
+                ObjectiveCType objcType = GetObjectiveCType(schema.type(i));
                 if (IsPrimitiveType(objcType)) {
-                    printer->Print("\"$variblename$\" : ,\n","variblename", UnderscoresToCamelCase(pFieldDescriptor));
-                } else if (pFieldDescriptor->type() == FieldDescriptor::TYPE_STRING || pFieldDescriptor->type() == FieldDescriptor::TYPE_BYTES || pFieldDescriptor->message_type()->name() == "SKBuiltinString_t") {
-                    printer->Print("\"$variblename$\" : \"\" ,\n","variblename", UnderscoresToCamelCase(pFieldDescriptor));
-                } else if (pFieldDescriptor->type() == FieldDescriptor::TYPE_MESSAGE) {
-                    const Descriptor *pD = pFieldDescriptor->message_type();
-                    if (pD == nullptr) {
+                    printer->Print("\"$variblename$\" : ,\n","variblename", schema.json_name(i));
+                } else if (schema.type(i) == FieldDescriptor::TYPE_STRING || schema.type(i) == FieldDescriptor::TYPE_BYTES || schema.message_descriptor(child)->name() == "SKBuiltinString_t") {
+                    printer->Print("\"$variblename$\" : \"\" ,\n","variblename", schema.json_name(i));
+                } else if (schema.type(i) == FieldDescriptor::TYPE_MESSAGE) {
+                    if (child == -1) {
                         printer->Print("Error occurs: not repeated->null message type.");
                         return;
                     }
-                    printer->Print("\"$variblename$\" : {\n","variblename", UnderscoresToCamelCase(pFieldDescriptor));
+                    printer->Print("\"$variblename$\" : {\n","variblename", schema.json_name(i));
                     printer->Indent();
-                    MessageGenerator(pD).GenerateMessage(printer);
+                    GenerateMessage(schema, child, printer);
                     printer->Outdent();
                     printer->Print("},\n");
                 }
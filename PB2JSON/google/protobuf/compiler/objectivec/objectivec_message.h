@@ -31,6 +31,7 @@ namespace google {
         namespace io {
             class Printer;             // printer.h
         }
+        class FlatSchema;              // flat_schema.h
     }
     
     namespace protobuf {
@@ -59,6 +60,8 @@ namespace google {
                     
                 private:
                     //bool IsPrimitiveType(FieldDescriptor::Type);
+                    static void GenerateMessage(const FlatSchema& schema, int message,
+                                                io::Printer *printer);
                     void GenerateMessageSerializationMethodsHeader(io::Printer* printer);
                     void GenerateParseFromMethodsHeader(io::Printer* printer);
                     void GenerateSerializeOneFieldHeader(io::Printer* printer,
@@ -0,0 +1,1041 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <math.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include <algorithm>
+#include <deque>
+
+#include <google/protobuf/compiler/payload_generator.h>
+#include <google/protobuf/compiler/payload_profile.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/json_transcoder.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/hash_util.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+using internal::SplitMix64;
+using internal::WireFormatLite;
+
+namespace {
+
+// Messages are generated and written in chunks of this many.
+const int kMessagesPerChunk = 1024;
+
+// Message fields nested deeper than this are left empty even if required,
+// which only matters for a type which requires itself.  Matches the
+// default recursion limit of CodedInputStream.
+const int kMaxNestingDepth = 64;
+
+// How many times a message type may appear on the path from the root to
+// any field.  A type which contains itself would otherwise be expanded
+// down to max_depth, multiplying the message's size at each level.
+const int kMaxTimesOnPath = 2;
+
+// splitmix64.  Only integer arithmetic is used, so every platform generates
+// the same values.
+class Random {
+ public:
+  Random() : state_(0) {}
+
+  void Reset(uint64 seed) { state_ = seed; }
+
+  uint64 Next() {
+    state_ += GOOGLE_ULONGLONG(0x9e3779b97f4a7c15);
+    return SplitMix64(state_);
+  }
+
+  // Returns a number from 0 to n - 1.
+  uint32 Uniform(uint32 n) {
+    return static_cast<uint32>(((Next() >> 32) * n) >> 32);
+  }
+
+  bool Percent(int percent) {
+    return Uniform(100) < static_cast<uint32>(percent);
+  }
+
+  // Returns a number from 0 to n - 1, or any number if n is 0.
+  uint64 Below(uint64 n) {
+    return n == 0 ? Next() : Next() % n;
+  }
+
+  // Returns an index into the given cumulative weights, each as likely as
+  // its weight.  The total weight must be positive.
+  int Weighted(const vector<int64>& weights) {
+    int64 point = Below(weights.back());
+    return upper_bound(weights.begin(), weights.end(), point) -
+           weights.begin();
+  }
+
+  // Returns a value from a histogram with a bucket per power of two (see
+  // PayloadProfile::BucketOf()) and cumulative weights.
+  int64 FromHistogram(const vector<int64>& weights) {
+    int bucket = Weighted(weights);
+    if (bucket == 0) return 0;
+    int64 low = GOOGLE_LONGLONG(1) << (bucket - 1);
+    return low + Below(low);
+  }
+
+  // Returns a number from 0 to 2 * mean, likeliest near the mean, capped
+  // at max.
+  int Triangular(int mean, int max) {
+    int value = Uniform(mean + 1) + Uniform(mean + 1);
+    return value < max ? value : max;
+  }
+
+ private:
+  uint64 state_;
+};
+
+// Words for text fields.  Some are Chinese, so that consumers see multi-byte
+// UTF-8 the way they would in production.
+const char* const kWords[] = {
+  "award", "button", "click", "coupon", "discount", "free", "gift", "go",
+  "lucky", "more", "new", "now", "offer", "open", "pay", "prize", "red",
+  "reward", "scratch", "shake", "today", "try", "view", "win",
+  "\xe7\xba\xa2\xe5\x8c\x85",              // Red packet.
+  "\xe6\x8a\xbd\xe5\xa5\x96",              // Lottery.
+  "\xe7\xab\x8b\xe5\x8d\xb3",              // At once.
+  "\xe9\xa2\x86\xe5\x8f\x96",              // Claim.
+  "\xe4\xbc\x98\xe6\x83\xa0\xe5\x88\xb8",  // Coupon.
+  "\xe6\x94\xaf\xe4\xbb\x98",              // Payment.
+  "\xe6\x88\x90\xe5\x8a\x9f",              // Success.
+  "\xe6\x9f\xa5\xe7\x9c\x8b",              // View.
+};
+const int kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+const int kAsciiWordCount = 24;  // For URLs and email addresses.
+
+const char* const kHosts[] = {
+  "example.com", "m.example.com", "static.example.com", "cdn.example.net",
+};
+const int kHostCount = sizeof(kHosts) / sizeof(kHosts[0]);
+
+const char kHexDigits[] = "0123456789abcdef";
+const char kTokenChars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// 2020-01-01 and ten years after, in seconds.
+const int64 kFirstTimestamp = 1577836800;
+const int64 kTimestampRange = 315360000;
+
+inline void AppendVarint(uint64 value, string* output) {
+  char buffer[10];
+  int size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  buffer[size++] = static_cast<char>(value);
+  output->append(buffer, size);
+}
+
+inline void AppendLittleEndian32(uint32 value, string* output) {
+  char buffer[4];
+  for (int i = 0; i < 4; i++) buffer[i] = static_cast<char>(value >> (8 * i));
+  output->append(buffer, 4);
+}
+
+inline void AppendLittleEndian64(uint64 value, string* output) {
+  char buffer[8];
+  for (int i = 0; i < 8; i++) buffer[i] = static_cast<char>(value >> (8 * i));
+  output->append(buffer, 8);
+}
+
+inline void AppendHex(Random* random, int digits, string* output) {
+  uint64 bits = 0;
+  for (int i = 0; i < digits; i++) {
+    if (i % 16 == 0) bits = random->Next();
+    output->push_back(kHexDigits[bits & 15]);
+    bits >>= 4;
+  }
+}
+
+inline void AppendDecimal(int64 value, string* output) {
+  char buffer[kFastToBufferSize];
+  output->append(buffer, FastInt64ToBufferLeft(value, buffer) - buffer);
+}
+
+void AppendWords(Random* random, int count, int max_size, string* output) {
+  for (int i = 0; i < count; i++) {
+    const char* word = kWords[random->Uniform(kWordCount)];
+    int size = strlen(word);
+    if (output->size() + size + 1 > static_cast<string::size_type>(max_size)) {
+      break;
+    }
+    if (i > 0) output->push_back(' ');
+    output->append(word, size);
+  }
+}
+
+bool WriteBytes(const string& data, io::ZeroCopyOutputStream* output) {
+  const char* next = data.data();
+  int remaining = data.size();
+  while (remaining > 0) {
+    void* buffer;
+    int size;
+    if (!output->Next(&buffer, &size)) return false;
+    int n = min(size, remaining);
+    memcpy(buffer, next, n);
+    next += n;
+    remaining -= n;
+    if (n < size) output->BackUp(size - n);
+  }
+  return true;
+}
+
+// Splits a field name into lower-case words at underscores and at
+// lowerCamelCase boundaries:  "btn_color" and "btnColor" both become
+// ["btn", "color"].
+void SplitFieldName(const string& name, vector<string>* words) {
+  words->clear();
+  string word;
+  for (int i = 0; i < name.size(); i++) {
+    char c = name[i];
+    if (c == '_' ||
+        (c >= 'A' && c <= 'Z' && i > 0 && name[i - 1] >= 'a' &&
+         name[i - 1] <= 'z')) {
+      if (!word.empty()) words->push_back(word);
+      word.clear();
+    }
+    if (c != '_') word.push_back(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+  }
+  if (!word.empty()) words->push_back(word);
+}
+
+bool IsOneOf(const string& word, const char* const* list) {
+  for (; *list != NULL; list++) {
+    if (word == *list) return true;
+  }
+  return false;
+}
+
+bool ContainsOneOf(const vector<string>& words, const char* const* list) {
+  for (int i = 0; i < words.size(); i++) {
+    if (IsOneOf(words[i], list)) return true;
+  }
+  return false;
+}
+
+const char* const kColorWords[] = { "color", "colour", NULL };
+const char* const kUrlWords[] = { "url", "uri", "link", "href", NULL };
+const char* const kImageWords[] = {
+  "img", "image", "logo", "icon", "pic", "picture", "avatar", "thumb", NULL
+};
+const char* const kEmailWords[] = { "email", "mail", NULL };
+const char* const kPhoneWords[] = { "phone", "mobile", "tel", NULL };
+const char* const kFlagWords[] = {
+  "is", "has", "need", "enable", "enabled", "can", "flag", "switch", NULL
+};
+const char* const kZeroNames[] = {
+  "ret", "retcode", "ret_code", "errcode", "err_code", "errorcode",
+  "error_code", NULL
+};
+const char* const kTimeWords[] = {
+  "time", "timestamp", "ts", "date", "expire", "expiry", NULL
+};
+const char* const kSmallWords[] = {
+  "type", "status", "state", "mode", "level", "op", "kind", "style", "scene",
+  "source", "version", "ver", NULL
+};
+const char* const kCountWords[] = {
+  "count", "cnt", "num", "number", "amount", "fee", "price", "total", "size",
+  "len", "length", "index", "idx", "seq", "limit", "offset", "duration",
+  NULL
+};
+const char* const kIdWords[] = {
+  "id", "ids", "uin", "uid", "uuid", "guid", "openid", "unionid", "appid",
+  "userid", NULL
+};
+const char* const kTokenWords[] = {
+  "param", "params", "token", "ticket", "key", "sign", "signature",
+  "session", "cookie", "secret", "ext", "extra", "buf", "buffer", "context",
+  "cursor", NULL
+};
+
+}  // namespace
+
+PayloadOptions::PayloadOptions()
+  : profile(NULL),
+    optional_percent(80),
+    mean_repeated_count(3),
+    max_repeated_count(16),
+    mean_string_length(16),
+    max_string_length(256),
+    max_depth(8) {}
+
+// ===================================================================
+
+// The per-thread part of generating:  the random number generator and
+// buffers which are reused from one message to the next.
+class PayloadGenerator::Builder {
+ public:
+  explicit Builder(const PayloadGenerator* generator)
+    : generator_(generator),
+      times_on_path_(generator->plans_.size(), 0) {}
+
+  void Generate(uint64 seed, uint64 index, string* output) {
+    random_.Reset(SplitMix64(seed + SplitMix64(index)));
+    WriteMessage(0, 0, output);
+  }
+
+  // Appends messages first to first + count - 1 in the given format.
+  void GenerateChunk(uint64 seed, uint64 first, int count, Format format,
+                     string* output) {
+    if (format == JSON && transcoder_ == NULL) {
+      transcoder_.reset(new JsonTranscoder(generator_->type_));
+    }
+    for (int i = 0; i < count; i++) {
+      message_.clear();
+      Generate(seed, first + i, &message_);
+      if (format == WIRE) {
+        AppendVarint(message_.size(), output);
+        output->append(message_);
+      } else {
+        // StringOutputStream fills all of a string's spare capacity each
+        // time it grows it, so transcode into a string the size of one
+        // message rather than straight onto the end of the chunk.
+        json_.clear();
+        io::CodedInputStream input(
+            reinterpret_cast<const uint8*>(message_.data()), message_.size());
+        {
+          io::StringOutputStream json(&json_);
+          GOOGLE_CHECK(transcoder_->Transcode(&input, &json));
+        }
+        output->append(json_);
+        output->push_back('\n');
+      }
+    }
+  }
+
+ private:
+  // Returns a buffer for the given nesting depth.  A deque, so that
+  // buffers already handed out stay put as it grows.
+  string* Scratch(int depth) {
+    while (scratch_.size() <= depth) scratch_.push_back(string());
+    string* buffer = &scratch_[depth];
+    buffer->clear();
+    return buffer;
+  }
+
+  void WriteMessage(int plan_index, int depth, string* output);
+  void WriteField(const FieldPlan& plan, int depth, string* output);
+  void WriteNumber(const FieldPlan& plan, string* output);
+  bool PickNumber(const FieldPlan& plan, uint64* bits);
+  void MakeString(const FieldPlan& plan, string* value);
+  int64 MakeInteger(const FieldPlan& plan);
+
+  const PayloadGenerator* generator_;
+  Random random_;
+  deque<string> scratch_;
+  vector<int> times_on_path_;  // Indexed like plans_.
+  string message_;
+  string json_;
+  string value_;
+  scoped_ptr<JsonTranscoder> transcoder_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Builder);
+};
+
+void PayloadGenerator::Builder::WriteMessage(int plan_index, int depth,
+                                             string* output) {
+  const PayloadOptions& options = generator_->options_;
+  const MessagePlan& plan = generator_->plans_[plan_index];
+  times_on_path_[plan_index]++;
+  for (int i = 0; i < plan.fields.size(); i++) {
+    const FieldPlan& field_plan = plan.fields[i];
+    const FieldDescriptor* field = field_plan.field;
+    const FieldShape* shape = field_plan.shape < 0 ? NULL :
+                              &generator_->shapes_[field_plan.shape];
+    if (field->is_required()) {
+      WriteField(field_plan, depth, output);
+    } else if (depth >= options.max_depth ||
+               (field_plan.message_plan >= 0 &&
+                times_on_path_[field_plan.message_plan] >= kMaxTimesOnPath)) {
+      continue;
+    } else if (field->is_optional()) {
+      if (shape != NULL ? (random_.Next() >> 32) < shape->presence :
+                          random_.Percent(options.optional_percent)) {
+        WriteField(field_plan, depth, output);
+      }
+    } else {
+      int64 count =
+          shape != NULL && !shape->counts.empty() ?
+          random_.FromHistogram(shape->counts) :
+          random_.Triangular(options.mean_repeated_count,
+                             options.max_repeated_count);
+      if (count == 0) continue;
+      if (field_plan.packed) {
+        string* payload = Scratch(depth + 1);
+        for (int j = 0; j < count; j++) WriteNumber(field_plan, payload);
+        AppendVarint(field_plan.tag, output);
+        AppendVarint(payload->size(), output);
+        output->append(*payload);
+      } else {
+        for (int j = 0; j < count; j++) {
+          WriteField(field_plan, depth, output);
+        }
+      }
+    }
+  }
+  times_on_path_[plan_index]--;
+}
+
+void PayloadGenerator::Builder::WriteField(const FieldPlan& plan, int depth,
+                                           string* output) {
+  const FieldDescriptor* field = plan.field;
+  AppendVarint(plan.tag, output);
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_MESSAGE: {
+      string* body = Scratch(depth + 1);
+      if (depth < kMaxNestingDepth) {
+        WriteMessage(plan.message_plan, depth + 1, body);
+      }
+      AppendVarint(body->size(), output);
+      output->append(*body);
+      break;
+    }
+    case FieldDescriptor::TYPE_GROUP:
+      if (depth < kMaxNestingDepth) {
+        WriteMessage(plan.message_plan, depth + 1, output);
+      }
+      AppendVarint(WireFormatLite::MakeTag(
+          field->number(), WireFormatLite::WIRETYPE_END_GROUP), output);
+      break;
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES:
+      value_.clear();
+      MakeString(plan, &value_);
+      AppendVarint(value_.size(), output);
+      output->append(value_);
+      break;
+    default:
+      WriteNumber(plan, output);
+      break;
+  }
+}
+
+void PayloadGenerator::Builder::WriteNumber(const FieldPlan& plan,
+                                            string* output) {
+  // Integers (and bools) as 64-bit patterns, floats and doubles as the bits
+  // of a double.
+  uint64 bits;
+  if (!PickNumber(plan, &bits)) {
+    if (plan.field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT ||
+        plan.field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE) {
+      bits = WireFormatLite::EncodeDouble(random_.Uniform(1000000) / 100.0);
+    } else if (plan.field->cpp_type() == FieldDescriptor::CPPTYPE_BOOL) {
+      bits = random_.Uniform(2);
+    } else {
+      bits = MakeInteger(plan);
+    }
+  }
+
+  switch (plan.field->type()) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT32:
+    case FieldDescriptor::TYPE_UINT64:
+    case FieldDescriptor::TYPE_ENUM:
+    case FieldDescriptor::TYPE_BOOL:
+      // Negative int32s are sign-extended to ten bytes, as the wire format
+      // requires.
+      AppendVarint(bits, output);
+      break;
+    case FieldDescriptor::TYPE_SINT32:
+      AppendVarint(WireFormatLite::ZigZagEncode32(bits), output);
+      break;
+    case FieldDescriptor::TYPE_SINT64:
+      AppendVarint(WireFormatLite::ZigZagEncode64(bits), output);
+      break;
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_SFIXED32:
+      AppendLittleEndian32(static_cast<uint32>(bits), output);
+      break;
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+      AppendLittleEndian64(bits, output);
+      break;
+    case FieldDescriptor::TYPE_FLOAT:
+      AppendLittleEndian32(WireFormatLite::EncodeFloat(
+          WireFormatLite::DecodeDouble(bits)), output);
+      break;
+    case FieldDescriptor::TYPE_DOUBLE:
+      AppendLittleEndian64(bits, output);
+      break;
+    default:
+      GOOGLE_LOG(FATAL) << "Can't get here.";
+      break;
+  }
+}
+
+// Picks a number the way the field's profile says.  Returns false if the
+// field has no profile or it has no values or range.
+bool PayloadGenerator::Builder::PickNumber(const FieldPlan& plan,
+                                           uint64* bits) {
+  if (plan.shape < 0) return false;
+  const FieldShape& shape = generator_->shapes_[plan.shape];
+  if (!shape.numbers.empty()) {
+    *bits = shape.numbers[random_.Weighted(shape.value_weights)];
+    return true;
+  }
+  // A range could include values an enum doesn't declare.
+  if (!shape.has_range ||
+      plan.field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+    return false;
+  }
+  if (plan.field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT ||
+      plan.field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE) {
+    double min = WireFormatLite::DecodeDouble(shape.min);
+    double max = WireFormatLite::DecodeDouble(shape.max);
+    *bits = WireFormatLite::EncodeDouble(
+        min + (max - min) * (random_.Next() >> 11) * (1.0 / (GOOGLE_LONGLONG(1) << 53)));
+  } else {
+    // Unsigned arithmetic works for signed ranges too.
+    *bits = shape.min + random_.Below(shape.max - shape.min + 1);
+  }
+  return true;
+}
+
+int64 PayloadGenerator::Builder::MakeInteger(const FieldPlan& plan) {
+  const FieldDescriptor* field = plan.field;
+  bool is_64_bit = field->cpp_type() == FieldDescriptor::CPPTYPE_INT64 ||
+                   field->cpp_type() == FieldDescriptor::CPPTYPE_UINT64 ||
+                   field->cpp_type() == FieldDescriptor::CPPTYPE_STRING;
+  bool is_signed = field->cpp_type() == FieldDescriptor::CPPTYPE_INT32 ||
+                   field->cpp_type() == FieldDescriptor::CPPTYPE_INT64;
+
+  switch (plan.kind) {
+    case KIND_FLAG:
+      return random_.Uniform(2);
+    case KIND_ZERO:
+      return 0;
+    case KIND_SMALL:
+      return 1 + random_.Uniform(9);
+    case KIND_COUNT:
+      return random_.Uniform(10000);
+    case KIND_COLOR:
+      return random_.Uniform(1 << 24);
+    case KIND_ID:
+      return is_64_bit ? static_cast<int64>(random_.Next() >> 1) :
+                         100000 + random_.Uniform(kint32max - 100000);
+    case KIND_TIMESTAMP:
+      return kFirstTimestamp + random_.Uniform(kTimestampRange);
+    case KIND_TIMESTAMP_MS:
+      return (kFirstTimestamp + random_.Uniform(kTimestampRange)) * 1000 +
+             random_.Uniform(1000);
+    case KIND_PHONE:
+      return GOOGLE_LONGLONG(13000000000) + random_.Uniform(999999999);
+    case KIND_ENUM:
+      return generator_->enum_values_[
+          plan.enum_values + random_.Uniform(plan.enum_value_count)];
+    default: {
+      // Every magnitude is equally likely, so most numbers are small.
+      int bits = random_.Uniform(is_64_bit || !is_signed ? 33 : 32);
+      if (is_64_bit) bits += random_.Uniform(31);
+      uint64 value = bits == 0 ? 0 :
+          random_.Next() & (~GOOGLE_ULONGLONG(0) >> (64 - bits));
+      if (is_signed && random_.Uniform(8) == 0) {
+        return -static_cast<int64>(value >> 1);
+      }
+      return is_signed ? static_cast<int64>(value >> 1) :
+                         static_cast<int64>(value);
+    }
+  }
+}
+
+void PayloadGenerator::Builder::MakeString(const FieldPlan& plan,
+                                           string* value) {
+  const PayloadOptions& options = generator_->options_;
+
+  // A profiled field takes the corpus's values if it had few, or else
+  // values as long as the corpus's where the kind allows.
+  int length = -1;
+  if (plan.shape >= 0) {
+    const FieldShape& shape = generator_->shapes_[plan.shape];
+    if (!shape.values.empty()) {
+      value->append(shape.values[random_.Weighted(shape.value_weights)]);
+      return;
+    }
+    if (!shape.lengths.empty()) {
+      length = min<int64>(random_.FromHistogram(shape.lengths), kint32max);
+    }
+  }
+
+  switch (plan.kind) {
+    case KIND_COLOR:
+      value->push_back('#');
+      AppendHex(&random_, 6, value);
+      break;
+    case KIND_URL:
+      value->append("https://");
+      value->append(kHosts[random_.Uniform(kHostCount)]);
+      for (int i = random_.Uniform(3); i >= 0; i--) {
+        value->push_back('/');
+        value->append(kWords[random_.Uniform(kAsciiWordCount)]);
+      }
+      if (random_.Percent(50)) {
+        value->append("?id=");
+        AppendDecimal(random_.Uniform(kint32max), value);
+      }
+      break;
+    case KIND_IMAGE_URL:
+      value->append("https://cdn.example.net/img/");
+      AppendHex(&random_, 32, value);
+      value->append(random_.Percent(50) ? ".png" : ".jpg");
+      break;
+    case KIND_EMAIL:
+      value->append(kWords[random_.Uniform(kAsciiWordCount)]);
+      AppendDecimal(random_.Uniform(10000), value);
+      value->append("@example.com");
+      break;
+    case KIND_ID:
+      AppendHex(&random_, 32, value);
+      break;
+    case KIND_TOKEN: {
+      int size = length >= 0 ? length :
+                 random_.Triangular(options.mean_string_length,
+                                    options.max_string_length);
+      for (int i = 0; i < size; i++) {
+        value->push_back(kTokenChars[random_.Uniform(64)]);
+      }
+      break;
+    }
+    case KIND_TEXT:
+      if (length >= 0) {
+        // Words up to the length, cut at a character boundary and made up
+        // to the exact length with ASCII letters.
+        while (value->size() < static_cast<string::size_type>(length)) {
+          if (!value->empty()) value->push_back(' ');
+          value->append(kWords[random_.Uniform(kWordCount)]);
+        }
+        int size = length;
+        while (size > 0 && size < value->size() &&
+               ((*value)[size] & 0xc0) == 0x80) {
+          size--;
+        }
+        value->resize(size);
+        while (value->size() < static_cast<string::size_type>(length)) {
+          value->push_back('a' + random_.Uniform(26));
+        }
+      } else {
+        AppendWords(&random_, 1 + random_.Triangular(3, 31),
+                    options.max_string_length, value);
+      }
+      break;
+    case KIND_BYTES: {
+      int size = length >= 0 ? length :
+                 random_.Triangular(options.mean_string_length,
+                                    options.max_string_length);
+      for (int i = 0; i < size; i++) {
+        value->push_back(static_cast<char>(random_.Uniform(256)));
+      }
+      break;
+    }
+    default:
+      AppendDecimal(MakeInteger(plan), value);
+      break;
+  }
+}
+
+// ===================================================================
+
+PayloadGenerator::PayloadGenerator(const Descriptor* type,
+                                   const PayloadOptions& options)
+  : type_(type),
+    options_(options) {
+  AddPlan(type);
+}
+
+PayloadGenerator::~PayloadGenerator() {}
+
+int PayloadGenerator::AddPlan(const Descriptor* type) {
+  hash_map<const Descriptor*, int>::const_iterator iter =
+      plan_index_.find(type);
+  if (iter != plan_index_.end()) return iter->second;
+
+  // Register the type before its fields, in case it contains itself.
+  int index = plans_.size();
+  plan_index_[type] = index;
+  plans_.push_back(MessagePlan());
+
+  vector<FieldPlan> fields(type->field_count());
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    FieldPlan* plan = &fields[i];
+    plan->field = field;
+    plan->packed = field->is_repeated() && field->options().packed();
+    plan->tag = plan->packed ?
+        WireFormatLite::MakeTag(field->number(),
+                                WireFormatLite::WIRETYPE_LENGTH_DELIMITED) :
+        WireFormatLite::MakeTag(field->number(),
+                                WireFormatLite::WireTypeForFieldType(
+                                    static_cast<WireFormatLite::FieldType>(
+                                        field->type())));
+    plan->kind = GuessKind(field);
+    plan->shape = AddShape(field);
+    plan->message_plan = -1;
+    plan->enum_values = 0;
+    plan->enum_value_count = 0;
+
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      plan->message_plan = AddPlan(field->message_type());
+    } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+      const EnumDescriptor* enum_type = field->enum_type();
+      plan->enum_values = enum_values_.size();
+      plan->enum_value_count = enum_type->value_count();
+      for (int j = 0; j < enum_type->value_count(); j++) {
+        enum_values_.push_back(enum_type->value(j)->number());
+      }
+    }
+  }
+
+  // AddPlan() may have grown plans_, so look the plan up again.
+  plans_[index].fields.swap(fields);
+  return index;
+}
+
+int PayloadGenerator::AddShape(const FieldDescriptor* field) {
+  if (options_.profile == NULL) return -1;
+  const PayloadProfile::Message* message =
+      options_.profile->FindMessage(field->containing_type());
+  const PayloadProfile::Field* profiled = options_.profile->FindField(field);
+  if (message == NULL || message->instances == 0 || profiled == NULL) {
+    return -1;
+  }
+
+  FieldShape shape;
+  shape.presence = static_cast<uint64>(
+      ldexp(static_cast<double>(profiled->present) / message->instances, 32));
+  shape.has_range = false;
+  shape.min = 0;
+  shape.max = 0;
+
+  int64 total = 0;
+  for (int i = 0; i < profiled->counts.size(); i++) {
+    shape.counts.push_back(total += profiled->counts[i]);
+  }
+  if (total == 0) shape.counts.clear();
+  total = 0;
+  for (int i = 0; i < profiled->lengths.size(); i++) {
+    shape.lengths.push_back(total += profiled->lengths[i]);
+  }
+  if (total == 0) shape.lengths.clear();
+
+  // Values which don't fit the field, e.g. because it changed type since
+  // the profile was made, are dropped.
+  bool is_string = field->cpp_type() == FieldDescriptor::CPPTYPE_STRING;
+  total = 0;
+  for (int i = 0; i < profiled->values.size(); i++) {
+    const pair<string, int64>& value = profiled->values[i];
+    uint64 bits = 0;
+    if (value.second <= 0 ||
+        (!is_string && !NumberFromText(field, value.first, &bits))) {
+      continue;
+    }
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM &&
+        field->enum_type()->FindValueByNumber(bits) == NULL) {
+      continue;
+    }
+    if (is_string) {
+      shape.values.push_back(value.first);
+    } else {
+      shape.numbers.push_back(bits);
+    }
+    shape.value_weights.push_back(total += value.second);
+  }
+
+  if (!is_string && !profiled->min.empty() &&
+      NumberFromText(field, profiled->min, &shape.min) &&
+      NumberFromText(field, profiled->max, &shape.max)) {
+    shape.has_range = true;
+  }
+
+  shapes_.push_back(shape);
+  return shapes_.size() - 1;
+}
+
+bool PayloadGenerator::NumberFromText(const FieldDescriptor* field,
+                                      const string& text, uint64* bits) {
+  if (text.empty()) return false;
+  const char* start = text.c_str();
+  char* end;
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+    case FieldDescriptor::CPPTYPE_ENUM: {
+      int32 value = strto32(start, &end, 10);
+      *bits = static_cast<uint64>(static_cast<int64>(value));
+      break;
+    }
+    case FieldDescriptor::CPPTYPE_INT64:
+      *bits = static_cast<uint64>(strto64(start, &end, 10));
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      *bits = strtou32(start, &end, 10);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      *bits = strtou64(start, &end, 10);
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      *bits = strtou32(start, &end, 10);
+      if (*bits > 1) return false;
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      *bits = WireFormatLite::EncodeDouble(NoLocaleStrtod(start, &end));
+      break;
+    default:
+      return false;
+  }
+  return *end == '\0';
+}
+
+PayloadGenerator::ValueKind PayloadGenerator::GuessKind(
+    const FieldDescriptor* field) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return KIND_BOOL;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return KIND_ENUM;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return KIND_FLOAT;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return KIND_NUMBER;  // Not used.
+    default:
+      break;
+  }
+
+  vector<string> words;
+  SplitFieldName(field->name(), &words);
+  if (words.empty()) words.push_back(string());
+  const string& last = words.back();
+  bool is_string = field->cpp_type() == FieldDescriptor::CPPTYPE_STRING;
+  bool is_bytes = field->type() == FieldDescriptor::TYPE_BYTES;
+  bool is_64_bit = field->cpp_type() == FieldDescriptor::CPPTYPE_INT64 ||
+                   field->cpp_type() == FieldDescriptor::CPPTYPE_UINT64;
+
+  // Names which say what a string holds.  Numeric fields with these names
+  // are just numbers, except for colors and phone numbers.
+  if (IsOneOf(last, kColorWords)) return KIND_COLOR;
+  if (is_string || is_64_bit) {
+    if (ContainsOneOf(words, kPhoneWords)) return KIND_PHONE;
+  }
+  if (is_string) {
+    if (IsOneOf(last, kUrlWords)) return KIND_URL;
+    if (ContainsOneOf(words, kImageWords)) return KIND_IMAGE_URL;
+    if (ContainsOneOf(words, kEmailWords)) return KIND_EMAIL;
+    if (IsOneOf(last, kTokenWords)) return KIND_TOKEN;
+  }
+
+  // Names which say what number a field holds.  Strings with these names
+  // usually hold the number in decimal.
+  if (IsOneOf(words[0], kFlagWords)) return KIND_FLAG;
+  if (IsOneOf(field->name(), kZeroNames) || IsOneOf(last, kZeroNames)) {
+    return KIND_ZERO;
+  }
+  if (ContainsOneOf(words, kTimeWords)) {
+    return is_64_bit && last == "ms" ? KIND_TIMESTAMP_MS : KIND_TIMESTAMP;
+  }
+  if (IsOneOf(last, kSmallWords)) return KIND_SMALL;
+  if (IsOneOf(last, kCountWords)) return KIND_COUNT;
+  if (IsOneOf(last, kIdWords)) return KIND_ID;
+
+  if (is_bytes) return KIND_BYTES;
+  if (is_string) return KIND_TEXT;
+  return KIND_NUMBER;
+}
+
+void PayloadGenerator::Generate(uint64 seed, uint64 index,
+                                string* output) const {
+  Builder builder(this);
+  builder.Generate(seed, index, output);
+}
+
+// ===================================================================
+
+// A chunk of output, handed from a worker to the writing thread.
+struct PayloadGenerator::Chunk {
+  string data;
+  bool ready;  // Generated but not yet written.
+
+  Chunk() : ready(false) {}
+};
+
+struct PayloadGenerator::WriteState {
+  const PayloadGenerator* generator;
+  uint64 seed;
+  int64 count;
+  Format format;
+  int thread_count;
+  int64 chunk_count;
+
+  // Chunk c goes in chunks[c % chunks.size()].  There are two per worker,
+  // so that each worker can fill one while the other is being written.
+  vector<Chunk> chunks;
+  int next_worker;
+  bool started;  // All workers have been created.
+  bool stopped;  // Writing failed, so workers should give up.
+
+#ifndef _WIN32
+  pthread_mutex_t mutex;
+  pthread_cond_t changed;
+#endif
+};
+
+void* PayloadGenerator::RunWorker(void* arg) {
+#ifndef _WIN32
+  WriteState* state = reinterpret_cast<WriteState*>(arg);
+  pthread_mutex_lock(&state->mutex);
+  while (!state->started) pthread_cond_wait(&state->changed, &state->mutex);
+  int worker = state->next_worker++;
+  pthread_mutex_unlock(&state->mutex);
+
+  Builder builder(state->generator);
+  for (int64 c = worker; c < state->chunk_count; c += state->thread_count) {
+    Chunk* chunk = &state->chunks[c % state->chunks.size()];
+    pthread_mutex_lock(&state->mutex);
+    while (chunk->ready && !state->stopped) {
+      pthread_cond_wait(&state->changed, &state->mutex);
+    }
+    bool stopped = state->stopped;
+    pthread_mutex_unlock(&state->mutex);
+    if (stopped) break;
+
+    // Until it's marked ready, the chunk is this worker's alone.
+    uint64 first = c * kMessagesPerChunk;
+    chunk->data.clear();
+    builder.GenerateChunk(state->seed, first,
+                          min<int64>(kMessagesPerChunk, state->count - first),
+                          state->format, &chunk->data);
+
+    pthread_mutex_lock(&state->mutex);
+    chunk->ready = true;
+    pthread_cond_broadcast(&state->changed);
+    pthread_mutex_unlock(&state->mutex);
+  }
+#endif
+  return NULL;
+}
+
+bool PayloadGenerator::Write(uint64 seed, int64 count, Format format,
+                             int thread_count,
+                             io::ZeroCopyOutputStream* output) const {
+  int64 chunk_count = (count + kMessagesPerChunk - 1) / kMessagesPerChunk;
+
+#ifndef _WIN32
+  if (thread_count > 1 && chunk_count > 1) {
+    WriteState state;
+    state.generator = this;
+    state.seed = seed;
+    state.count = count;
+    state.format = format;
+    state.chunk_count = chunk_count;
+    state.next_worker = 0;
+    state.started = false;
+    state.stopped = false;
+    pthread_mutex_init(&state.mutex, NULL);
+    pthread_cond_init(&state.changed, NULL);
+
+    vector<pthread_t> threads;
+    for (int i = 0; i < min<int64>(thread_count, chunk_count); i++) {
+      pthread_t thread;
+      if (pthread_create(&thread, NULL, &RunWorker, &state) == 0) {
+        threads.push_back(thread);
+      }
+    }
+
+    if (!threads.empty()) {
+      // Workers wait until they know how many of them there are, since
+      // that decides which chunks each one makes.
+      pthread_mutex_lock(&state.mutex);
+      state.thread_count = threads.size();
+      state.chunks.resize(2 * state.thread_count);
+      state.started = true;
+      pthread_cond_broadcast(&state.changed);
+      pthread_mutex_unlock(&state.mutex);
+
+      // Write the chunks in order as they become ready.
+      bool success = true;
+      for (int64 c = 0; c < chunk_count && success; c++) {
+        Chunk* chunk = &state.chunks[c % state.chunks.size()];
+        pthread_mutex_lock(&state.mutex);
+        while (!chunk->ready) pthread_cond_wait(&state.changed, &state.mutex);
+        pthread_mutex_unlock(&state.mutex);
+
+        success = WriteBytes(chunk->data, output);
+
+        pthread_mutex_lock(&state.mutex);
+        chunk->ready = false;
+        if (!success) state.stopped = true;
+        pthread_cond_broadcast(&state.changed);
+        pthread_mutex_unlock(&state.mutex);
+      }
+
+      for (int i = 0; i < threads.size(); i++) {
+        pthread_join(threads[i], NULL);
+      }
+    }
+    pthread_cond_destroy(&state.changed);
+    pthread_mutex_destroy(&state.mutex);
+    if (!threads.empty()) return !state.stopped;
+    // No thread could be created; do the work here instead.
+  }
+#endif
+
+  Builder builder(this);
+  string data;
+  for (int64 first = 0; first < count; first += kMessagesPerChunk) {
+    data.clear();
+    builder.GenerateChunk(seed, first,
+                          min<int64>(kMessagesPerChunk, count - first),
+                          format, &data);
+    if (!WriteBytes(data, output)) return false;
+  }
+  return true;
+}
+
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,206 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Generates populated messages of a given type, with values that look like
+// what real servers send, for load and fuzz testing.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_PAYLOAD_GENERATOR_H__
+#define GOOGLE_PROTOBUF_COMPILER_PAYLOAD_GENERATOR_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/hash.h>
+
+namespace google {
+namespace protobuf {
+
+class Descriptor;              // descriptor.h
+class EnumDescriptor;          // descriptor.h
+class FieldDescriptor;         // descriptor.h
+namespace io {
+  class ZeroCopyOutputStream;  // zero_copy_stream.h
+}
+
+namespace compiler {
+
+class PayloadProfile;          // payload_profile.h
+
+// How PayloadGenerator shapes its messages.  Lengths and counts are drawn
+// from a triangular distribution between 0 and twice the mean, then capped.
+struct LIBPROTOC_EXPORT PayloadOptions {
+  PayloadOptions();
+
+  // If not NULL, fields the profile has statistics for follow them instead
+  // of the settings below:  they are set as often as in the corpus, have
+  // as many elements and as long values, and take the corpus's values if
+  // it had few distinct ones or else numbers from its range.  Must outlive
+  // the PayloadGenerator.
+  const PayloadProfile* profile;
+
+  int optional_percent;      // Chance that an optional field is set.
+  int mean_repeated_count;   // Elements per repeated field.
+  int max_repeated_count;
+  int mean_string_length;    // Bytes per string or bytes field with no
+  int max_string_length;     //   better guess from its name.
+  int max_depth;             // Below this many nested messages, only
+                             //   required fields are set.
+};
+
+// Builds pseudo-random messages which are valid for their type:  every
+// required field is set, enum fields only hold declared values and strings
+// are valid UTF-8.  Values are guessed from field names, so that e.g.
+// "btn_color" gets "#rrggbb", "jump_url" a URL, "is_show_btn" 0 or 1,
+// "create_time" a plausible timestamp and "award_name" a few words.
+//
+// Each message depends only on the seed and its index, never on which
+// thread made it or in what order, so the same seed always gives the same
+// corpus.
+//
+// Messages are written straight to the wire format from a plan made once
+// per type, without building Message objects.
+//
+// Example:
+//   PayloadGenerator generator(CgiF2FPaySucPageResp::descriptor(),
+//                              PayloadOptions());
+//   io::FileOutputStream output(STDOUT_FILENO);
+//   generator.Write(42, 1000000, PayloadGenerator::WIRE, 8, &output);
+class LIBPROTOC_EXPORT PayloadGenerator {
+ public:
+  enum Format {
+    WIRE,  // Each message preceded by its size as a varint, as
+           //   writeDelimitedTo() in Java does.
+    JSON   // One JsonTranscoder object per line.
+  };
+
+  // The given type must outlive the PayloadGenerator.
+  PayloadGenerator(const Descriptor* type, const PayloadOptions& options);
+  ~PayloadGenerator();
+
+  // Appends the serialized message with the given index to *output.
+  void Generate(uint64 seed, uint64 index, string* output) const;
+
+  // Writes messages 0 to count - 1 in the given format, generating them on
+  // thread_count threads.  The output is the same for any thread count.
+  // Returns false if writing fails.
+  bool Write(uint64 seed, int64 count, Format format, int thread_count,
+             io::ZeroCopyOutputStream* output) const;
+
+ private:
+  class Builder;
+  struct Chunk;
+  struct WriteState;
+  static void* RunWorker(void* arg);
+
+  // What a field's values should look like, guessed from its type and name.
+  enum ValueKind {
+    KIND_NUMBER,      // Small numbers are likelier than large ones.
+    KIND_FLAG,        // 0 or 1.
+    KIND_ZERO,        // ret, retcode, errcode:  0, i.e. success.
+    KIND_SMALL,       // Types, statuses and modes:  1 to 9.
+    KIND_COUNT,       // Counts and amounts:  0 to 9999.
+    KIND_ID,          // Ids:  large positive numbers, or hex for strings.
+    KIND_TIMESTAMP,   // Seconds since the epoch.
+    KIND_TIMESTAMP_MS,  // Milliseconds, for 64-bit fields ending in "ms".
+    KIND_BOOL,
+    KIND_ENUM,
+    KIND_FLOAT,       // float and double:  0 to 9999.99.
+    KIND_TEXT,        // A few words.
+    KIND_COLOR,       // #rrggbb.
+    KIND_URL,
+    KIND_IMAGE_URL,
+    KIND_EMAIL,
+    KIND_PHONE,
+    KIND_TOKEN,       // Opaque parameters, tickets and keys.
+    KIND_BYTES        // Random bytes.
+  };
+
+  struct FieldPlan {
+    const FieldDescriptor* field;
+    uint32 tag;           // For packed fields, the length-delimited tag.
+    ValueKind kind;
+    bool packed;
+    int message_plan;     // Index into plans_ for message and group fields.
+    int shape;            // Index into shapes_, or -1 if not profiled.
+    int enum_values;      // Start of the field's values in enum_values_.
+    int enum_value_count;
+  };
+
+  struct MessagePlan {
+    vector<FieldPlan> fields;
+  };
+
+  // A field's statistics from options_.profile, ready for sampling.
+  // Weights are cumulative.
+  struct FieldShape {
+    uint64 presence;            // Chance of being set, out of 2^32.
+    vector<int64> counts;       // By PayloadProfile::BucketOf().
+    vector<int64> lengths;      // Likewise.
+    vector<int64> value_weights;
+    vector<string> values;      // For strings.
+    vector<uint64> numbers;     // For numbers, as 64-bit patterns:  see
+                                //   NumberFromText().
+    bool has_range;
+    uint64 min;
+    uint64 max;
+  };
+
+  // Makes the plan for the given type and everything it contains, and
+  // returns its index.
+  int AddPlan(const Descriptor* type);
+  static ValueKind GuessKind(const FieldDescriptor* field);
+
+  // Makes the shape for the given field from options_.profile and returns
+  // its index, or returns -1 if the profile has nothing on it.
+  int AddShape(const FieldDescriptor* field);
+
+  // Signed integers are sign-extended to 64 bits, and floats and doubles
+  // kept as the bits of a double.
+  static bool NumberFromText(const FieldDescriptor* field, const string& text,
+                             uint64* bits);
+
+  const Descriptor* type_;
+  PayloadOptions options_;
+  vector<MessagePlan> plans_;
+  hash_map<const Descriptor*, int> plan_index_;
+  vector<int> enum_values_;
+  vector<FieldShape> shapes_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(PayloadGenerator);
+};
+
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_PAYLOAD_GENERATOR_H__
@@ -0,0 +1,1057 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+#include <algorithm>
+#include <deque>
+
+#include <google/protobuf/compiler/payload_profile.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/stubs/hash.h>
+#include <google/protobuf/stubs/hash_util.h>
+#include <google/protobuf/stubs/stl_util-inl.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+using internal::SplitMix64;
+using internal::WireFormatLite;
+
+#ifndef O_BINARY
+#ifdef _O_BINARY
+#define O_BINARY _O_BINARY
+#else
+#define O_BINARY 0     // If this isn't defined, the platform doesn't need it.
+#endif
+#endif
+
+namespace {
+
+const char kProfileHeader[] = "PB2JSON payload profile 1";
+
+// Each thread takes about this many bytes of the capture at a time.
+const int kChunkSize = 1 << 20;
+
+// Nesting deeper than this is taken to be a malformed message, as
+// CodedInputStream does by default.
+const int kMaxDepth = 64;
+
+// Field numbers below this are looked up in a table; the rest, if any, by
+// FindFieldByNumber().
+const int kMaxDenseFieldNumber = 4096;
+
+// The number of distinct values is estimated with a HyperLogLog of
+// 2^kHllBits registers, for a standard error of about 3%.
+const int kHllBits = 10;
+const int kHllRegisters = 1 << kHllBits;
+
+// The number of histogram buckets a uint64 can need.
+const int kBucketCount = 65;
+
+uint64 HashBytes(const char* data, int size) {
+  uint64 hash = size;
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64 word;
+    memcpy(&word, data, 8);
+    hash = SplitMix64(hash ^ word);
+  }
+  uint64 word = 0;
+  memcpy(&word, data, size);
+  return SplitMix64(hash ^ word ^ GOOGLE_ULONGLONG(0x9e3779b97f4a7c15));
+}
+
+// Numbers are kept as 64-bit patterns:  signed integers sign-extended,
+// unsigned ones and bools as is, and floats and doubles as the bits of a
+// double.
+uint64 DoubleBits(double value) {
+  return WireFormatLite::EncodeDouble(value);
+}
+
+bool IsSigned(const FieldDescriptor* field) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+    case FieldDescriptor::CPPTYPE_INT64:
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsFloatingPoint(const FieldDescriptor* field) {
+  return field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT ||
+         field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE;
+}
+
+bool NumberLess(const FieldDescriptor* field, uint64 a, uint64 b) {
+  if (IsFloatingPoint(field)) {
+    return WireFormatLite::DecodeDouble(a) < WireFormatLite::DecodeDouble(b);
+  } else if (IsSigned(field)) {
+    return static_cast<int64>(a) < static_cast<int64>(b);
+  } else {
+    return a < b;
+  }
+}
+
+string FormatNumber(const FieldDescriptor* field, uint64 bits) {
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT) {
+    return SimpleFtoa(WireFormatLite::DecodeDouble(bits));
+  } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE) {
+    return SimpleDtoa(WireFormatLite::DecodeDouble(bits));
+  } else if (IsSigned(field)) {
+    return SimpleItoa(static_cast<int64>(bits));
+  } else {
+    return SimpleItoa(bits);
+  }
+}
+
+bool IsPackable(const FieldDescriptor* field) {
+  return field->is_repeated() &&
+         field->cpp_type() != FieldDescriptor::CPPTYPE_STRING &&
+         field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE;
+}
+
+// Reads a varint from [*pos, end).  Returns false if it runs past end or
+// is longer than ten bytes.
+bool ReadRawVarint(const char** pos, const char* end, uint64* value) {
+  *value = 0;
+  for (int shift = 0; shift < 70 && *pos < end; shift += 7) {
+    uint8 byte = static_cast<uint8>(*(*pos)++);
+    *value |= static_cast<uint64>(byte & 0x7f) << shift;
+    if (byte < 0x80) return true;
+  }
+  return false;
+}
+
+// -------------------------------------------------------------------
+// The types in a corpus, shared by the threads reading it.
+
+struct FieldInfo {
+  const FieldDescriptor* field;
+  int message_type;  // Index into Schema::types, or -1.
+};
+
+struct TypeInfo {
+  const Descriptor* type;
+  vector<FieldInfo> fields;      // By FieldDescriptor::index().
+  vector<int> field_by_number;   // Field indexes, or -1.
+};
+
+class Schema {
+ public:
+  explicit Schema(const Descriptor* root) { Add(root); }
+
+  int Add(const Descriptor* type) {
+    hash_map<const Descriptor*, int>::const_iterator iter = index_.find(type);
+    if (iter != index_.end()) return iter->second;
+
+    int index = types_.size();
+    index_[type] = index;
+    types_.push_back(TypeInfo());
+
+    vector<FieldInfo> fields(type->field_count());
+    int max_number = 0;
+    for (int i = 0; i < type->field_count(); i++) {
+      fields[i].field = type->field(i);
+      fields[i].message_type =
+          type->field(i)->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ?
+          Add(type->field(i)->message_type()) : -1;
+      max_number = max(max_number, type->field(i)->number());
+    }
+
+    // Add() may have grown types_, so look the type up again.
+    TypeInfo* info = &types_[index];
+    info->type = type;
+    info->fields.swap(fields);
+    info->field_by_number.resize(min(max_number + 1, kMaxDenseFieldNumber),
+                                 -1);
+    for (int i = 0; i < type->field_count(); i++) {
+      int number = type->field(i)->number();
+      if (number < info->field_by_number.size()) {
+        info->field_by_number[number] = i;
+      }
+    }
+    return index;
+  }
+
+  const TypeInfo& type(int index) const { return types_[index]; }
+  int type_count() const { return types_.size(); }
+
+  // Returns the index of the field with the given number, or -1.
+  int FieldIndex(const TypeInfo& info, int number) const {
+    if (number < info.field_by_number.size()) {
+      return info.field_by_number[number];
+    }
+    const FieldDescriptor* field = info.type->FindFieldByNumber(number);
+    return field == NULL ? -1 : field->index();
+  }
+
+ private:
+  vector<TypeInfo> types_;
+  hash_map<const Descriptor*, int> index_;
+};
+
+// -------------------------------------------------------------------
+// What one thread has seen.
+
+struct FieldCounts {
+  FieldCounts()
+    : present(0),
+      elements(0),
+      too_many_values(false),
+      has_range(false),
+      min(0),
+      max(0),
+      registers(kHllRegisters, 0) {
+    memset(counts, 0, sizeof(counts));
+    memset(lengths, 0, sizeof(lengths));
+  }
+
+  int64 present;
+  int64 elements;  // Values seen, counting each element of repeated fields.
+  int64 counts[kBucketCount];
+  int64 lengths[kBucketCount];
+
+  // Keyed by the bytes of strings, or the 64-bit pattern of numbers.
+  map<string, int64> values;
+  bool too_many_values;
+
+  bool has_range;
+  uint64 min;
+  uint64 max;
+
+  vector<uint8> registers;  // HyperLogLog.
+
+  void AddHash(uint64 hash) {
+    elements++;
+    uint32 index = hash >> (64 - kHllBits);
+    // The position of the first set bit after the index bits.  The sentinel
+    // bit caps it.
+    uint64 rest = (hash << kHllBits) | (GOOGLE_ULONGLONG(1) << (kHllBits - 1));
+    uint8 rank = 1;
+    while ((rest & (GOOGLE_ULONGLONG(1) << 63)) == 0) {
+      rest <<= 1;
+      rank++;
+    }
+    if (rank > registers[index]) registers[index] = rank;
+  }
+
+  void AddValue(const string& key) {
+    if (too_many_values) return;
+    values[key]++;
+    if (values.size() > PayloadProfile::kMaxValues) {
+      too_many_values = true;
+      values.clear();
+    }
+  }
+
+  void Merge(const FieldDescriptor* field, const FieldCounts& other) {
+    present += other.present;
+    elements += other.elements;
+    for (int i = 0; i < kBucketCount; i++) {
+      counts[i] += other.counts[i];
+      lengths[i] += other.lengths[i];
+    }
+    if (other.too_many_values) {
+      too_many_values = true;
+      values.clear();
+    } else {
+      for (map<string, int64>::const_iterator iter = other.values.begin();
+           iter != other.values.end() && !too_many_values; ++iter) {
+        values[iter->first] += iter->second;
+        if (values.size() > PayloadProfile::kMaxValues) {
+          too_many_values = true;
+          values.clear();
+        }
+      }
+    }
+    if (other.has_range) {
+      if (!has_range || NumberLess(field, other.min, min)) min = other.min;
+      if (!has_range || NumberLess(field, max, other.max)) max = other.max;
+      has_range = true;
+    }
+    for (int i = 0; i < kHllRegisters; i++) {
+      registers[i] = std::max(registers[i], other.registers[i]);
+    }
+  }
+
+  int64 EstimateDistinct() const {
+    if (!too_many_values) return values.size();
+    double sum = 0;
+    int zeros = 0;
+    for (int i = 0; i < kHllRegisters; i++) {
+      sum += ldexp(1.0, -registers[i]);
+      if (registers[i] == 0) zeros++;
+    }
+    double m = kHllRegisters;
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+      estimate = m * log(m / zeros);  // Linear counting for small sets.
+    }
+    // There were more than kMaxValues, and no more than the values seen,
+    // whatever the estimate says.
+    return std::min(std::max<int64>(static_cast<int64>(estimate + 0.5),
+                                    PayloadProfile::kMaxValues + 1),
+                    elements);
+  }
+};
+
+struct TypeCounts {
+  TypeCounts() : instances(0) {}
+
+  int64 instances;
+  vector<FieldCounts> fields;  // By FieldDescriptor::index().
+};
+
+PayloadProfile::Histogram MakeHistogram(const int64* buckets) {
+  int size = kBucketCount;
+  while (size > 0 && buckets[size - 1] == 0) size--;
+  return PayloadProfile::Histogram(buckets, buckets + size);
+}
+
+bool MoreFrequent(const pair<string, int64>& a, const pair<string, int64>& b) {
+  return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+// -------------------------------------------------------------------
+
+// Walks serialized messages at the wire level, counting into its own
+// TypeCounts.  Each thread has one.
+class Analyzer {
+ public:
+  explicit Analyzer(const Schema* schema)
+    : schema_(schema),
+      types_(schema->type_count()) {
+    for (int i = 0; i < types_.size(); i++) {
+      types_[i].fields.resize(schema->type(i).fields.size());
+    }
+  }
+
+  // Analyzes one message of the root type.  Returns false if it isn't
+  // valid.
+  bool Analyze(const char* data, int size) {
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(data), size);
+    input.SetTotalBytesLimit(kint32max, -1);
+    return AnalyzeMessage(0, 0, 0, &input) && input.ConsumedEntireMessage();
+  }
+
+  // Adds another thread's counts to these.
+  void Merge(const Analyzer& other) {
+    for (int i = 0; i < types_.size(); i++) {
+      types_[i].instances += other.types_[i].instances;
+      for (int j = 0; j < types_[i].fields.size(); j++) {
+        types_[i].fields[j].Merge(schema_->type(i).fields[j].field,
+                                  other.types_[i].fields[j]);
+      }
+    }
+  }
+
+  void MakeProfile(PayloadProfile* profile) const;
+
+ private:
+  bool AnalyzeMessage(int type_index, int depth, int group_number,
+                      io::CodedInputStream* input);
+  bool AnalyzeValue(const FieldInfo& info, FieldCounts* counts, int depth,
+                    io::CodedInputStream* input);
+
+  void AddNumber(const FieldDescriptor* field, FieldCounts* counts,
+                 uint64 bits) {
+    counts->AddHash(SplitMix64(bits));
+    if (!IsFloatingPoint(field) ||
+        !isnan(WireFormatLite::DecodeDouble(bits))) {
+      if (!counts->has_range || NumberLess(field, bits, counts->min)) {
+        counts->min = bits;
+      }
+      if (!counts->has_range || NumberLess(field, counts->max, bits)) {
+        counts->max = bits;
+      }
+      counts->has_range = true;
+    }
+    if (!counts->too_many_values) {
+      counts->AddValue(string(reinterpret_cast<const char*>(&bits),
+                              sizeof(bits)));
+    }
+  }
+
+  // Returns elements seen so far of each field of the message being
+  // analyzed at the given depth, zeroed.  A deque, so that the vectors
+  // handed out for shallower messages stay put as it grows.
+  vector<int>* Elements(int depth, int field_count) {
+    while (elements_.size() <= depth) elements_.push_back(vector<int>());
+    vector<int>* elements = &elements_[depth];
+    elements->assign(field_count, 0);
+    return elements;
+  }
+
+  const Schema* schema_;
+  vector<TypeCounts> types_;
+  deque<vector<int> > elements_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Analyzer);
+};
+
+bool Analyzer::AnalyzeMessage(int type_index, int depth, int group_number,
+                              io::CodedInputStream* input) {
+  if (depth > kMaxDepth) return false;
+  const TypeInfo& info = schema_->type(type_index);
+  TypeCounts* type_counts = &types_[type_index];
+  vector<int>* elements = Elements(depth, info.fields.size());
+
+  while (true) {
+    uint32 tag = input->ReadTag();
+    if (tag == 0) {
+      // The end of the input or of a length-delimited message.  Groups
+      // must end with an END_GROUP tag instead.
+      if (group_number != 0 || !input->ConsumedEntireMessage()) return false;
+      break;
+    }
+    int number = WireFormatLite::GetTagFieldNumber(tag);
+    WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+    if (wire_type == WireFormatLite::WIRETYPE_END_GROUP) {
+      if (number != group_number) return false;
+      break;
+    }
+
+    int index = schema_->FieldIndex(info, number);
+    const FieldDescriptor* field =
+        index < 0 ? NULL : info.fields[index].field;
+    WireFormatLite::WireType expected = field == NULL ?
+        wire_type :
+        WireFormatLite::WireTypeForFieldType(
+            static_cast<WireFormatLite::FieldType>(field->type()));
+
+    if (field != NULL && wire_type == expected) {
+      if (!AnalyzeValue(info.fields[index], &type_counts->fields[index],
+                        depth, input)) {
+        return false;
+      }
+      (*elements)[index]++;
+    } else if (field != NULL && IsPackable(field) &&
+               wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32 length;
+      if (!input->ReadVarint32(&length)) return false;
+      io::CodedInputStream::Limit limit = input->PushLimit(length);
+      while (input->BytesUntilLimit() > 0) {
+        if (!AnalyzeValue(info.fields[index], &type_counts->fields[index],
+                          depth, input)) {
+          return false;
+        }
+        (*elements)[index]++;
+      }
+      input->PopLimit(limit);
+    } else {
+      // Unknown fields, and known ones with the wrong wire type, which a
+      // parser would also keep as unknown.
+      if (!WireFormatLite::SkipField(input, tag)) return false;
+    }
+  }
+
+  // AnalyzeValue() may have grown elements_, but deque elements don't move.
+  type_counts->instances++;
+  for (int i = 0; i < info.fields.size(); i++) {
+    FieldCounts* counts = &type_counts->fields[i];
+    int count = (*elements)[i];
+    if (count > 0) counts->present++;
+    if (info.fields[i].field->is_repeated()) {
+      counts->counts[PayloadProfile::BucketOf(count)]++;
+    }
+  }
+  return true;
+}
+
+bool Analyzer::AnalyzeValue(const FieldInfo& info, FieldCounts* counts,
+                            int depth, io::CodedInputStream* input) {
+  const FieldDescriptor* field = info.field;
+  uint32 value32;
+  uint64 value64;
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_ENUM:
+      if (!input->ReadVarint64(&value64)) return false;
+      AddNumber(field, counts, static_cast<uint64>(static_cast<int64>(
+                                   static_cast<int32>(value64))));
+      return true;
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT64:
+      if (!input->ReadVarint64(&value64)) return false;
+      AddNumber(field, counts, value64);
+      return true;
+    case FieldDescriptor::TYPE_UINT32:
+      if (!input->ReadVarint64(&value64)) return false;
+      AddNumber(field, counts, static_cast<uint32>(value64));
+      return true;
+    case FieldDescriptor::TYPE_BOOL:
+      if (!input->ReadVarint64(&value64)) return false;
+      AddNumber(field, counts, value64 != 0 ? 1 : 0);
+      return true;
+    case FieldDescriptor::TYPE_SINT32:
+      if (!input->ReadVarint32(&value32)) return false;
+      AddNumber(field, counts, static_cast<uint64>(static_cast<int64>(
+                                   WireFormatLite::ZigZagDecode32(value32))));
+      return true;
+    case FieldDescriptor::TYPE_SINT64:
+      if (!input->ReadVarint64(&value64)) return false;
+      AddNumber(field, counts, static_cast<uint64>(
+                                   WireFormatLite::ZigZagDecode64(value64)));
+      return true;
+    case FieldDescriptor::TYPE_FIXED32:
+      if (!input->ReadLittleEndian32(&value32)) return false;
+      AddNumber(field, counts, value32);
+      return true;
+    case FieldDescriptor::TYPE_SFIXED32:
+      if (!input->ReadLittleEndian32(&value32)) return false;
+      AddNumber(field, counts, static_cast<uint64>(static_cast<int64>(
+                                   static_cast<int32>(value32))));
+      return true;
+    case FieldDescriptor::TYPE_FLOAT:
+      if (!input->ReadLittleEndian32(&value32)) return false;
+      AddNumber(field, counts,
+                DoubleBits(WireFormatLite::DecodeFloat(value32)));
+      return true;
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_DOUBLE:
+      if (!input->ReadLittleEndian64(&value64)) return false;
+      AddNumber(field, counts, value64);
+      return true;
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES: {
+      // The whole message is in one buffer, so the string can be looked at
+      // in place.  There's no buffer left to point at when an empty string
+      // ends the message, though.
+      if (!input->ReadVarint32(&value32)) return false;
+      const void* data = "";
+      int size = 0;
+      if (value32 > 0 &&
+          (!input->GetDirectBufferPointer(&data, &size) ||
+           static_cast<uint32>(size) < value32)) {
+        return false;
+      }
+      const char* bytes = static_cast<const char*>(data);
+      counts->lengths[PayloadProfile::BucketOf(value32)]++;
+      counts->AddHash(HashBytes(bytes, value32));
+      if (!counts->too_many_values) {
+        counts->AddValue(string(bytes, value32));
+      }
+      return input->Skip(value32);
+    }
+    case FieldDescriptor::TYPE_MESSAGE: {
+      if (!input->ReadVarint32(&value32)) return false;
+      io::CodedInputStream::Limit limit = input->PushLimit(value32);
+      if (!AnalyzeMessage(info.message_type, depth + 1, 0, input)) {
+        return false;
+      }
+      input->PopLimit(limit);
+      return true;
+    }
+    case FieldDescriptor::TYPE_GROUP:
+      return AnalyzeMessage(info.message_type, depth + 1, field->number(),
+                            input);
+  }
+  return false;
+}
+
+void Analyzer::MakeProfile(PayloadProfile* profile) const {
+  profile->messages.clear();
+  for (int i = 0; i < types_.size(); i++) {
+    const TypeInfo& info = schema_->type(i);
+    if (types_[i].instances == 0) continue;
+    PayloadProfile::Message* message =
+        &profile->messages[info.type->full_name()];
+    message->instances = types_[i].instances;
+
+    for (int j = 0; j < info.fields.size(); j++) {
+      const FieldDescriptor* field = info.fields[j].field;
+      const FieldCounts& counts = types_[i].fields[j];
+      PayloadProfile::Field* result = &message->fields[field->number()];
+      result->present = counts.present;
+      if (field->is_repeated()) result->counts = MakeHistogram(counts.counts);
+      result->lengths = MakeHistogram(counts.lengths);
+      result->distinct = counts.EstimateDistinct();
+      if (counts.has_range) {
+        result->min = FormatNumber(field, counts.min);
+        result->max = FormatNumber(field, counts.max);
+      }
+
+      bool is_number = field->cpp_type() != FieldDescriptor::CPPTYPE_STRING &&
+                       field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE;
+      for (map<string, int64>::const_iterator iter = counts.values.begin();
+           iter != counts.values.end(); ++iter) {
+        if (is_number) {
+          uint64 bits;
+          memcpy(&bits, iter->first.data(), sizeof(bits));
+          result->values.push_back(
+              make_pair(FormatNumber(field, bits), iter->second));
+        } else {
+          result->values.push_back(*iter);
+        }
+      }
+      sort(result->values.begin(), result->values.end(), MoreFrequent);
+    }
+  }
+}
+
+// -------------------------------------------------------------------
+
+// The capture, shared by the threads reading it.  Each takes the next
+// chunk of whole messages under the mutex, then analyzes it without.
+struct Corpus {
+  const char* data;
+  int64 size;
+  int64 next;           // Offset of the first message not yet taken.
+  int64 message_count;  // Messages taken so far.
+
+  // The first bad message found, by offset, so that the error doesn't
+  // depend on thread timing.  error_message counts from 0.
+  int64 error_offset;
+  int64 error_message;
+  string error;
+
+  const Descriptor* type;
+  vector<Analyzer*> analyzers;
+  int next_analyzer;
+
+#ifndef _WIN32
+  pthread_mutex_t mutex;
+#endif
+
+  void Lock() {
+#ifndef _WIN32
+    pthread_mutex_lock(&mutex);
+#endif
+  }
+  void Unlock() {
+#ifndef _WIN32
+    pthread_mutex_unlock(&mutex);
+#endif
+  }
+
+  // Must be called with the mutex held.
+  void SetError(int64 offset, int64 message, const string& text) {
+    if (error_offset < 0 || offset < error_offset) {
+      error_offset = offset;
+      error_message = message;
+      error = text;
+    }
+  }
+
+  static void* Run(void* arg);
+};
+
+void* Corpus::Run(void* arg) {
+  Corpus* corpus = reinterpret_cast<Corpus*>(arg);
+  corpus->Lock();
+  Analyzer* analyzer = corpus->analyzers[corpus->next_analyzer++];
+  corpus->Unlock();
+
+  while (true) {
+    // Take whole messages adding up to about kChunkSize, checking only
+    // their size prefixes.
+    corpus->Lock();
+    if (corpus->error_offset >= 0 || corpus->next >= corpus->size) {
+      corpus->Unlock();
+      break;
+    }
+    int64 start = corpus->next;
+    int64 first_message = corpus->message_count;
+    const char* pos = corpus->data + start;
+    const char* end = corpus->data + corpus->size;
+    const char* chunk_end = pos;
+    while (pos < end && pos - (corpus->data + start) < kChunkSize) {
+      uint64 size;
+      if (!ReadRawVarint(&pos, end, &size) ||
+          size > static_cast<uint64>(end - pos) || size > kint32max) {
+        corpus->SetError(chunk_end - corpus->data, corpus->message_count,
+                         "truncated message");
+        break;
+      }
+      pos += size;
+      chunk_end = pos;
+      corpus->message_count++;
+    }
+    corpus->next = chunk_end - corpus->data;
+    corpus->Unlock();
+
+    // Analyze them.
+    pos = corpus->data + start;
+    for (int64 message = first_message; pos < chunk_end; message++) {
+      const char* message_start = pos;
+      uint64 size;
+      ReadRawVarint(&pos, chunk_end, &size);
+      if (!analyzer->Analyze(pos, size)) {
+        corpus->Lock();
+        corpus->SetError(message_start - corpus->data, message,
+                         "not a valid " + corpus->type->full_name());
+        corpus->Unlock();
+        break;
+      }
+      pos += size;
+    }
+  }
+  return NULL;
+}
+
+}  // namespace
+
+// ===================================================================
+
+PayloadProfile::Field::Field() : present(0), distinct(0) {}
+
+PayloadProfile::PayloadProfile() {}
+PayloadProfile::~PayloadProfile() {}
+
+int PayloadProfile::BucketOf(uint64 value) {
+  int bucket = 0;
+  while (value != 0) {
+    bucket++;
+    value >>= 1;
+  }
+  return bucket;
+}
+
+const PayloadProfile::Message* PayloadProfile::FindMessage(
+    const Descriptor* type) const {
+  map<string, Message>::const_iterator iter =
+      messages.find(type->full_name());
+  return iter == messages.end() ? NULL : &iter->second;
+}
+
+const PayloadProfile::Field* PayloadProfile::FindField(
+    const FieldDescriptor* field) const {
+  const Message* message = FindMessage(field->containing_type());
+  if (message == NULL) return NULL;
+  map<int, Field>::const_iterator iter = message->fields.find(field->number());
+  return iter == message->fields.end() ? NULL : &iter->second;
+}
+
+namespace {
+
+void WriteHistogram(FILE* file, const char* name,
+                    const PayloadProfile::Histogram& histogram) {
+  if (histogram.empty()) return;
+  fputs(name, file);
+  for (int i = 0; i < histogram.size(); i++) {
+    if (histogram[i] == 0) continue;
+    fprintf(file, " %d:%s", i, SimpleItoa(histogram[i]).c_str());
+  }
+  fputc('\n', file);
+}
+
+bool ParseHistogram(const vector<string>& words,
+                    PayloadProfile::Histogram* histogram) {
+  histogram->clear();
+  for (int i = 1; i < words.size(); i++) {
+    string::size_type colon = words[i].find(':');
+    if (colon == string::npos) return false;
+    char* end;
+    int bucket = strto32(words[i].c_str(), &end, 10);
+    if (end != words[i].c_str() + colon || bucket < 0 ||
+        bucket >= kBucketCount) {
+      return false;
+    }
+    int64 count = strto64(words[i].c_str() + colon + 1, &end, 10);
+    if (*end != '\0' || count < 0) return false;
+    if (histogram->size() <= bucket) histogram->resize(bucket + 1, 0);
+    (*histogram)[bucket] = count;
+  }
+  return true;
+}
+
+bool ParseCount(const string& text, int64* count) {
+  char* end;
+  *count = strto64(text.c_str(), &end, 10);
+  return !text.empty() && *end == '\0' && *count >= 0;
+}
+
+}  // namespace
+
+bool PayloadProfile::Write(const string& filename, string* error) const {
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (file == NULL) {
+    *error = filename + ": " + strerror(errno);
+    return false;
+  }
+
+  fprintf(file, "%s\n", kProfileHeader);
+  for (map<string, Message>::const_iterator message = messages.begin();
+       message != messages.end(); ++message) {
+    fprintf(file, "message %s %s\n", message->first.c_str(),
+            SimpleItoa(message->second.instances).c_str());
+    for (map<int, Field>::const_iterator iter =
+             message->second.fields.begin();
+         iter != message->second.fields.end(); ++iter) {
+      const Field& field = iter->second;
+      fprintf(file, "field %d present %s distinct %s\n", iter->first,
+              SimpleItoa(field.present).c_str(),
+              SimpleItoa(field.distinct).c_str());
+      WriteHistogram(file, "counts", field.counts);
+      WriteHistogram(file, "lengths", field.lengths);
+      if (!field.min.empty()) {
+        fprintf(file, "range %s %s\n", field.min.c_str(), field.max.c_str());
+      }
+      for (int i = 0; i < field.values.size(); i++) {
+        fprintf(file, "value %s \"%s\"\n",
+                SimpleItoa(field.values[i].second).c_str(),
+                CEscape(field.values[i].first).c_str());
+      }
+    }
+  }
+
+  bool ok = !ferror(file);
+  if (fclose(file) != 0) ok = false;
+  if (!ok) *error = filename + ": " + strerror(errno);
+  return ok;
+}
+
+bool PayloadProfile::Read(const string& filename, string* error) {
+  messages.clear();
+
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (file == NULL) {
+    *error = filename + ": " + strerror(errno);
+    return false;
+  }
+  string contents;
+  char buffer[65536];
+  size_t size;
+  while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, size);
+  }
+  bool read_ok = !ferror(file);
+  fclose(file);
+  if (!read_ok) {
+    *error = filename + ": " + strerror(errno);
+    return false;
+  }
+
+  vector<string> lines;
+  SplitStringUsing(contents, "\n", &lines);
+  if (lines.empty() || lines[0] != kProfileHeader) {
+    *error = filename + ": not a payload profile.";
+    return false;
+  }
+
+  Message* message = NULL;
+  Field* field = NULL;
+  vector<string> words;
+  for (int i = 1; i < lines.size(); i++) {
+    const string& line = lines[i];
+    words.clear();
+    SplitStringUsing(line, " ", &words);
+    bool valid = !words.empty();
+
+    if (valid && words[0] == "message") {
+      valid = words.size() == 3;
+      if (valid) {
+        message = &messages[words[1]];
+        field = NULL;
+        valid = ParseCount(words[2], &message->instances);
+      }
+    } else if (valid && words[0] == "field") {
+      char* end;
+      int number = valid && words.size() == 6 ?
+                   strto32(words[1].c_str(), &end, 10) : 0;
+      valid = message != NULL && number > 0 && *end == '\0' &&
+              words[2] == "present" && words[4] == "distinct";
+      if (valid) {
+        field = &message->fields[number];
+        valid = ParseCount(words[3], &field->present) &&
+                ParseCount(words[5], &field->distinct);
+      }
+    } else if (valid && field == NULL) {
+      valid = false;
+    } else if (valid && words[0] == "counts") {
+      valid = ParseHistogram(words, &field->counts);
+    } else if (valid && words[0] == "lengths") {
+      valid = ParseHistogram(words, &field->lengths);
+    } else if (valid && words[0] == "range") {
+      valid = words.size() == 3;
+      if (valid) {
+        field->min = words[1];
+        field->max = words[2];
+      }
+    } else if (valid && words[0] == "value") {
+      // The value is quoted and C-escaped, so it may contain spaces.
+      string::size_type open = line.find('"');
+      int64 count;
+      valid = words.size() >= 3 && open != string::npos &&
+              line.size() >= open + 2 && line[line.size() - 1] == '"' &&
+              ParseCount(words[1], &count);
+      if (valid) {
+        field->values.push_back(make_pair(
+            UnescapeCEscapeString(
+                line.substr(open + 1, line.size() - open - 2)),
+            count));
+      }
+    } else {
+      valid = false;
+    }
+
+    if (!valid) {
+      *error = filename + ":" + SimpleItoa(i + 1) + ": invalid line.";
+      messages.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+// ===================================================================
+
+bool ProfileCorpus(const Descriptor* type, const string& capture_name,
+                   int thread_count, PayloadProfile* profile,
+                   string* error) {
+  int fd;
+  do {
+    fd = open(capture_name.c_str(), O_RDONLY | O_BINARY);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    *error = capture_name + ": " + strerror(errno);
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    *error = capture_name + ": " + strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  // Map the capture if possible, so that it's read once and in big reads.
+  const char* data = NULL;
+  int64 size = info.st_size;
+  bool mapped = false;
+#ifndef _WIN32
+  if (size > 0) {
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping != MAP_FAILED) {
+      data = static_cast<const char*>(mapping);
+      mapped = true;
+      madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+  }
+#endif
+  if (!mapped) {
+    char* buffer = new char[size];
+    data = buffer;
+    for (int64 done = 0; done < size; ) {
+      int bytes = read(fd, buffer + done, min<int64>(size - done, 1 << 20));
+      if (bytes <= 0 && !(bytes < 0 && errno == EINTR)) {
+        *error = capture_name + ": " +
+                 (bytes < 0 ? strerror(errno) : "unexpected end of file");
+        close(fd);
+        delete [] buffer;
+        return false;
+      }
+      if (bytes > 0) done += bytes;
+    }
+  }
+  close(fd);
+
+  Schema schema(type);
+  thread_count = max<int64>(1, min<int64>(thread_count,
+                                          size / kChunkSize + 1));
+  Corpus corpus;
+  corpus.data = data;
+  corpus.size = size;
+  corpus.next = 0;
+  corpus.message_count = 0;
+  corpus.error_offset = -1;
+  corpus.error_message = 0;
+  corpus.type = type;
+  corpus.next_analyzer = 0;
+  for (int i = 0; i < thread_count; i++) {
+    corpus.analyzers.push_back(new Analyzer(&schema));
+  }
+
+#ifndef _WIN32
+  pthread_mutex_init(&corpus.mutex, NULL);
+  vector<pthread_t> threads;
+  for (int i = 1; i < thread_count; i++) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, &Corpus::Run, &corpus) == 0) {
+      threads.push_back(thread);
+    }
+  }
+  Corpus::Run(&corpus);
+  for (int i = 0; i < threads.size(); i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&corpus.mutex);
+#else
+  Corpus::Run(&corpus);
+#endif
+
+#ifndef _WIN32
+  if (mapped) munmap(const_cast<char*>(data), size);
+#endif
+  if (!mapped) delete [] data;
+
+  bool success = corpus.error_offset < 0;
+  if (success) {
+    for (int i = 1; i < corpus.analyzers.size(); i++) {
+      corpus.analyzers[0]->Merge(*corpus.analyzers[i]);
+    }
+    corpus.analyzers[0]->MakeProfile(profile);
+  } else {
+    // Numbered from 1, as in --memory_report's errors.
+    *error = capture_name + ": message " +
+             SimpleItoa(corpus.error_message + 1) + " at offset " +
+             SimpleItoa(corpus.error_offset) + ": " + corpus.error;
+  }
+  STLDeleteElements(&corpus.analyzers);
+  return success;
+}
+
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,146 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Statistics about the shape of real messages, gathered from a capture so
+// that generated messages can have the same shape.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_PAYLOAD_PROFILE_H__
+#define GOOGLE_PROTOBUF_COMPILER_PAYLOAD_PROFILE_H__
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class Descriptor;            // descriptor.h
+class FieldDescriptor;       // descriptor.h
+
+namespace compiler {
+
+// Per-field statistics for every message type found in a corpus.  Written
+// to and read from a small text file, e.g.:
+//
+//   message CgiF2FPaySucPageResp 100000
+//   field 3 present 99870 distinct 12
+//   lengths 3:99870
+//   value 91210 "ok"
+//   ...
+//
+// Statistics are per type, not per path:  a type used in several places
+// has one set of statistics covering all of them.
+class LIBPROTOC_EXPORT PayloadProfile {
+ public:
+  PayloadProfile();
+  ~PayloadProfile();
+
+  // Histograms have a bucket per power of two:  bucket 0 counts zeros and
+  // bucket k counts values from 2^(k-1) to 2^k - 1.  Trailing empty
+  // buckets are dropped.
+  typedef vector<int64> Histogram;
+  static int BucketOf(uint64 value);
+
+  // At most this many distinct values are kept per field.
+  static const int kMaxValues = 32;
+
+  struct Field {
+    Field();
+
+    // Instances of the containing message in which the field was set or,
+    // if repeated, had at least one element.
+    int64 present;
+
+    // Repeated fields:  elements per instance of the containing message.
+    Histogram counts;
+
+    // Strings and bytes:  the size of each value.
+    Histogram lengths;
+
+    // The estimated number of distinct values.
+    int64 distinct;
+
+    // Each value seen and how often, most frequent first, if there were at
+    // most kMaxValues of them.  Otherwise empty.  Numbers are written in
+    // decimal, and floats and doubles as SimpleDtoa() writes them.
+    vector<pair<string, int64> > values;
+
+    // Numeric fields:  the smallest and largest values seen, written the
+    // same way.  Empty if there were none.
+    string min;
+    string max;
+  };
+
+  struct Message {
+    Message() : instances(0) {}
+
+    int64 instances;
+    map<int, Field> fields;  // By field number.
+  };
+
+  // Messages by full name.
+  map<string, Message> messages;
+
+  // Returns the statistics for the given type or field, or NULL if the
+  // profile has none.
+  const Message* FindMessage(const Descriptor* type) const;
+  const Field* FindField(const FieldDescriptor* field) const;
+
+  // Returns false and sets *error on I/O errors, or, for Read(), if the
+  // file isn't a valid profile.
+  bool Read(const string& filename, string* error);
+  bool Write(const string& filename, string* error) const;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(PayloadProfile);
+};
+
+// Reads a capture of messages of the given type, each preceded by its size
+// as a varint (as writeDelimitedTo() in Java and --synthesize write them),
+// and replaces *profile with statistics for the type and every type nested
+// in it.  The capture is split between thread_count threads.  Returns false
+// and sets *error on I/O errors or if the capture holds something which
+// isn't a message of the type.
+LIBPROTOC_EXPORT bool ProfileCorpus(const Descriptor* type,
+                                    const string& capture_name,
+                                    int thread_count,
+                                    PayloadProfile* profile,
+                                    string* error);
+
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_PAYLOAD_PROFILE_H__
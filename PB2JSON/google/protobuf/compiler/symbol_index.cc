@@ -0,0 +1,469 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include <algorithm>
+#include <set>
+
+#include <google/protobuf/compiler/symbol_index.h>
+#include <google/protobuf/compiler/symbol_scanner.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/hash.h>
+#include <google/protobuf/stubs/hash_util.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+namespace {
+
+// First line of a saved index.  Bump the version whenever the format or
+// the scanner's output changes, so that old indexes are rebuilt.
+const char kIndexHeader[] = "pb2json-symbol-index 1";
+
+// How many calls to Find() scan the symbols before it builds the name
+// tables.
+const int kLinearFindLimit = 50;
+
+bool ReadFile(const string& filename, string* contents) {
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (file == NULL) return false;
+  contents->clear();
+  char buffer[65536];
+  size_t size;
+  while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents->append(buffer, size);
+  }
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
+
+// Reads up to the next separator, which must exist, into *field and moves
+// *pos past it.
+bool NextField(const char** pos, const char* end, char separator,
+               string* field) {
+  const char* found = static_cast<const char*>(
+      memchr(*pos, separator, end - *pos));
+  if (found == NULL) return false;
+  field->assign(*pos, found - *pos);
+  *pos = found + 1;
+  return true;
+}
+
+// Is full_name the given plain name in some package?
+inline bool HasPlainName(const string& full_name, const string& name) {
+  return full_name.size() > name.size() &&
+         full_name[full_name.size() - name.size() - 1] == '.' &&
+         full_name.compare(full_name.size() - name.size(), name.size(),
+                           name) == 0;
+}
+
+}  // namespace
+
+// ===================================================================
+
+struct SymbolIndex::NameTables {
+  // Map names to (file index, symbol index) pairs, in order.
+  typedef hash_map<string, vector<pair<int, int> > > Map;
+
+  // Full names of every indexed type.
+  Map full_names;
+
+  // Plain names of top-level messages.
+  Map plain_names;
+};
+
+SymbolIndex::SymbolIndex()
+  : rescanned_file_count_(0),
+    modified_(false),
+    find_count_(0) {
+}
+
+SymbolIndex::~SymbolIndex() {}
+
+const SymbolIndex::NameTables& SymbolIndex::GetNameTables() const {
+  if (tables_ != NULL) return *tables_;
+  tables_.reset(new NameTables);
+  for (int i = 0; i < files_.size(); i++) {
+    const vector<Symbol>& symbols = files_[i].symbols;
+    for (int j = 0; j < symbols.size(); j++) {
+      const string& full_name = symbols[j].full_name;
+      tables_->full_names[full_name].push_back(make_pair(i, j));
+      if (symbols[j].is_top_level_message) {
+        string::size_type dot = full_name.find_last_of('.');
+        if (dot != string::npos) {
+          tables_->plain_names[full_name.substr(dot + 1)]
+              .push_back(make_pair(i, j));
+        }
+      }
+    }
+  }
+  return *tables_;
+}
+
+// -------------------------------------------------------------------
+
+bool SymbolIndex::Load(const string& filename) {
+  files_.clear();
+  rescanned_file_count_ = 0;
+  modified_ = true;
+  tables_.reset();
+
+  string contents;
+  if (!ReadFile(filename, &contents)) return false;
+
+  // Each file is a line of
+  //   virtual path, disk path, size, mtime, hash, symbol count
+  // followed by a line per symbol of
+  //   offset, 1 if a top-level message or 0 if not, full name
+  // with the fields separated by tabs.  Indexes of big trees run to
+  // hundreds of thousands of lines, so parse in place.
+  const char* pos = contents.data();
+  const char* end = pos + contents.size();
+  string field;
+  if (!NextField(&pos, end, '\n', &field) || field != kIndexHeader) {
+    return false;
+  }
+
+  vector<IndexedFile> files;
+  string fields[6];
+  while (pos < end) {
+    for (int i = 0; i < 6; i++) {
+      if (!NextField(&pos, end, i < 5 ? '\t' : '\n', &fields[i])) {
+        return false;
+      }
+    }
+
+    files.push_back(IndexedFile());
+    IndexedFile* file = &files.back();
+    file->virtual_path = fields[0];
+    file->disk_path = fields[1];
+    file->size = strto64(fields[2].c_str(), NULL, 10);
+    file->modification_time = strto64(fields[3].c_str(), NULL, 10);
+    file->content_hash = strtou64(fields[4].c_str(), NULL, 16);
+    int symbol_count = atoi(fields[5].c_str());
+    if (symbol_count < 0 || symbol_count > end - pos) return false;
+
+    file->symbols.resize(symbol_count);
+    for (int j = 0; j < symbol_count; j++) {
+      Symbol* symbol = &file->symbols[j];
+      if (!NextField(&pos, end, '\t', &fields[0]) ||
+          !NextField(&pos, end, '\t', &fields[1]) ||
+          !NextField(&pos, end, '\n', &symbol->full_name)) {
+        return false;
+      }
+      symbol->offset = atoi(fields[0].c_str());
+      symbol->is_top_level_message = fields[1] == "1";
+    }
+  }
+
+  files_.swap(files);
+  modified_ = false;
+  return true;
+}
+
+bool SymbolIndex::Save(const string& filename) const {
+  // Write to a temporary file and rename it, so that a concurrent run never
+  // sees half an index.
+  string temp_filename = filename + ".tmp";
+  FILE* file = fopen(temp_filename.c_str(), "wb");
+  if (file == NULL) return false;
+
+  fprintf(file, "%s\n", kIndexHeader);
+  for (int i = 0; i < files_.size(); i++) {
+    const IndexedFile& indexed = files_[i];
+    fprintf(file, "%s\t%s\t%s\t%s\t%016llx\t%d\n",
+            indexed.virtual_path.c_str(), indexed.disk_path.c_str(),
+            SimpleItoa(indexed.size).c_str(),
+            SimpleItoa(indexed.modification_time).c_str(),
+            static_cast<unsigned long long>(indexed.content_hash),
+            static_cast<int>(indexed.symbols.size()));
+    for (int j = 0; j < indexed.symbols.size(); j++) {
+      const Symbol& symbol = indexed.symbols[j];
+      fprintf(file, "%d\t%d\t%s\n", symbol.offset,
+              symbol.is_top_level_message ? 1 : 0, symbol.full_name.c_str());
+    }
+  }
+
+  bool ok = !ferror(file);
+  if (fclose(file) != 0) ok = false;
+  if (ok) {
+#ifdef _WIN32
+    // rename() won't replace an existing file on Windows.
+    remove(filename.c_str());
+#endif
+    ok = rename(temp_filename.c_str(), filename.c_str()) == 0;
+  }
+  if (!ok) remove(temp_filename.c_str());
+  return ok;
+}
+
+// -------------------------------------------------------------------
+
+// The files Update() has to read, shared by the scanning threads.
+struct SymbolIndex::ScanQueue {
+  const vector<IndexedFile>* previous_files;
+  vector<IndexedFile>* files;
+
+  // Indexes into files, each with the index of the file's previous entry
+  // in previous_files, or -1, in case its contents turn out not to have
+  // changed.
+  vector<pair<int, int> > jobs;
+
+  Mutex mutex;
+  int next_job;  // Guarded by mutex.
+
+  static void* Run(void* arg) {
+    ScanQueue* queue = static_cast<ScanQueue*>(arg);
+    ScannedProtoFile scanned;
+    string contents;
+    while (true) {
+      int job;
+      {
+        MutexLock lock(&queue->mutex);
+        if (queue->next_job >= queue->jobs.size()) break;
+        job = queue->next_job++;
+      }
+      IndexedFile* file = &(*queue->files)[queue->jobs[job].first];
+      int previous = queue->jobs[job].second;
+      queue->Scan(file, previous, &scanned, &contents);
+    }
+    return NULL;
+  }
+
+  void Scan(IndexedFile* file, int previous, ScannedProtoFile* scanned,
+            string* contents) {
+    file->symbols.clear();
+    if (!ReadFile(file->disk_path, contents)) {
+      // Gone or unreadable; index it as empty and retry next time.
+      file->content_hash = 0;
+      file->modification_time = -1;
+      return;
+    }
+    file->content_hash = internal::Fnv1a64(contents->data(), contents->size());
+
+    if (previous >= 0 &&
+        (*previous_files)[previous].content_hash == file->content_hash) {
+      // Touched but not changed.
+      file->symbols = (*previous_files)[previous].symbols;
+      return;
+    }
+
+    ScanProtoSymbols(contents->data(), contents->size(), scanned);
+    file->symbols.resize(scanned->symbols.size());
+    for (int i = 0; i < scanned->symbols.size(); i++) {
+      file->symbols[i].full_name = scanned->symbols[i];
+      file->symbols[i].offset = scanned->offsets[i];
+      file->symbols[i].is_top_level_message =
+          scanned->is_top_level_message[i];
+    }
+  }
+};
+
+void SymbolIndex::Update(const vector<pair<string, string> >& mappings,
+                         int thread_count) {
+  hash_map<string, int> previous_by_path;
+  for (int i = 0; i < files_.size(); i++) {
+    previous_by_path[files_[i].virtual_path] = i;
+  }
+
+  ScanQueue queue;
+  queue.previous_files = &files_;
+  queue.next_job = 0;
+  vector<IndexedFile> files;
+  queue.files = &files;
+
+  // Walk the mappings, depth first.  Each stack entry is a (virtual path,
+  // disk path) pair.
+  set<string> seen;
+  for (int i = 0; i < mappings.size(); i++) {
+    vector<pair<string, string> > stack;
+    stack.push_back(mappings[i]);
+    while (!stack.empty()) {
+      string virtual_path = stack.back().first;
+      string disk_path = stack.back().second;
+      stack.pop_back();
+
+      struct stat info;
+      if (stat(disk_path.c_str(), &info) != 0) continue;
+
+      if (S_ISDIR(info.st_mode)) {
+        vector<string> names;
+        ListDirectory(disk_path, &names);
+        // Push in reverse so that the walk visits names in order.
+        for (int j = names.size() - 1; j >= 0; j--) {
+          // Skip ".", ".." and hidden directories such as .git.
+          if (names[j].empty() || names[j][0] == '.') continue;
+          stack.push_back(make_pair(
+              virtual_path.empty() ? names[j] : virtual_path + "/" + names[j],
+              disk_path.empty() || disk_path[disk_path.size() - 1] == '/' ?
+                  disk_path + names[j] : disk_path + "/" + names[j]));
+        }
+        continue;
+      }
+
+      if (!HasSuffixString(virtual_path, ".proto") ||
+          !seen.insert(virtual_path).second) {
+        continue;
+      }
+
+      files.push_back(IndexedFile());
+      IndexedFile* file = &files.back();
+      file->virtual_path = virtual_path;
+      file->disk_path = disk_path;
+      file->size = info.st_size;
+      file->modification_time = info.st_mtime;
+
+      hash_map<string, int>::const_iterator previous =
+          previous_by_path.find(virtual_path);
+      if (previous != previous_by_path.end()) {
+        IndexedFile* old = &files_[previous->second];
+        if (old->disk_path == disk_path && old->size == file->size &&
+            old->modification_time == file->modification_time) {
+          // files_ is replaced below, so take the symbols rather than copy.
+          file->content_hash = old->content_hash;
+          file->symbols.swap(old->symbols);
+          continue;
+        }
+      }
+      queue.jobs.push_back(make_pair(
+          files.size() - 1,
+          previous == previous_by_path.end() ? -1 : previous->second));
+    }
+  }
+
+  // Scan what's left, in parallel.  Each thread only writes to the
+  // IndexedFiles of the jobs it takes.
+  thread_count = max(1, min(thread_count, static_cast<int>(queue.jobs.size())));
+#ifndef _WIN32
+  vector<pthread_t> threads;
+  for (int i = 1; i < thread_count; i++) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, &ScanQueue::Run, &queue) == 0) {
+      threads.push_back(thread);
+    }
+  }
+  ScanQueue::Run(&queue);
+  for (int i = 0; i < threads.size(); i++) {
+    pthread_join(threads[i], NULL);
+  }
+#else
+  ScanQueue::Run(&queue);
+#endif
+
+  rescanned_file_count_ = queue.jobs.size();
+  if (rescanned_file_count_ > 0 || files.size() != files_.size()) {
+    modified_ = true;
+  }
+  files_.swap(files);
+  tables_.reset();
+}
+
+// -------------------------------------------------------------------
+
+bool SymbolIndex::Find(const string& name,
+                       vector<Location>* locations) const {
+  locations->clear();
+
+  // Most runs look up a single type, and a pass over the symbols is much
+  // cheaper than building the name tables for it.  A pass costs about a
+  // hundredth of building them, so switch once it's clear there will be
+  // many lookups.
+  vector<pair<int, int> > matches;
+  if (tables_ == NULL && ++find_count_ <= kLinearFindLimit) {
+    for (int i = 0; i < files_.size(); i++) {
+      const vector<Symbol>& symbols = files_[i].symbols;
+      for (int j = 0; j < symbols.size(); j++) {
+        if (symbols[j].full_name == name ||
+            (symbols[j].is_top_level_message &&
+             HasPlainName(symbols[j].full_name, name))) {
+          matches.push_back(make_pair(i, j));
+        }
+      }
+    }
+  } else {
+    const NameTables& tables = GetNameTables();
+    NameTables::Map::const_iterator iter = tables.full_names.find(name);
+    if (iter != tables.full_names.end()) matches = iter->second;
+    iter = tables.plain_names.find(name);
+    if (iter != tables.plain_names.end()) {
+      matches.insert(matches.end(), iter->second.begin(), iter->second.end());
+    }
+    sort(matches.begin(), matches.end());
+  }
+
+  // Report the first definition in each file.
+  for (int i = 0; i < matches.size(); i++) {
+    if (i > 0 && matches[i].first == matches[i - 1].first) continue;
+    const IndexedFile& file = files_[matches[i].first];
+    const Symbol& symbol = file.symbols[matches[i].second];
+    Location location;
+    location.full_name = symbol.full_name;
+    location.file = file.virtual_path;
+    location.offset = symbol.offset;
+    location.content_hash = file.content_hash;
+    locations->push_back(location);
+  }
+  return !locations->empty();
+}
+
+bool SymbolIndex::FindFileContainingSymbol(const string& full_name,
+                                           string* file) const {
+  // The index only has types, so for a field, enum value or the like, find
+  // the type it is in.
+  const NameTables& tables = GetNameTables();
+  string name = full_name;
+  while (true) {
+    NameTables::Map::const_iterator iter = tables.full_names.find(name);
+    if (iter != tables.full_names.end()) {
+      *file = files_[iter->second.front().first].virtual_path;
+      return true;
+    }
+    string::size_type dot = name.find_last_of('.');
+    if (dot == string::npos) return false;
+    name.erase(dot);
+  }
+}
+
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,149 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// A persistent index of which .proto file defines each type, across whole
+// proto_path trees.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_SYMBOL_INDEX_H__
+#define GOOGLE_PROTOBUF_COMPILER_SYMBOL_INDEX_H__
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+// Maps type names to the files defining them, for every .proto file under
+// a set of directories.  Files are skimmed with ScanProtoSymbols() rather
+// than parsed, and the index is saved to disk so that later runs only need
+// to rescan files which changed.  Typical use:
+//
+//   SymbolIndex index;
+//   index.Load("protos.index");           // Fine if it doesn't exist yet.
+//   index.Update(proto_path, 8);
+//   index.Save("protos.index");
+//
+//   vector<SymbolIndex::Location> locations;
+//   index.Find("CgiF2FPaySucPageResp", &locations);
+//
+// Pass the index to Importer::UseSymbolIndex() to let its DescriptorPool
+// load files by symbol name.
+class LIBPROTOC_EXPORT SymbolIndex {
+ public:
+  SymbolIndex();
+  ~SymbolIndex();
+
+  // Where a type is defined.
+  struct Location {
+    string full_name;     // The type's full name.
+    string file;          // Virtual path, as passed to SourceTree::Open().
+    int offset;           // Byte offset of the type's name in the file.
+    uint64 content_hash;  // Hash of the file's contents when it was indexed.
+  };
+
+  // Replaces the contents of the index with those saved in the given file.
+  // Returns false, leaving the index empty, if the file is missing or isn't
+  // a saved index.
+  bool Load(const string& filename);
+
+  // Writes the index to the given file.  Returns false on I/O errors.
+  bool Save(const string& filename) const;
+
+  // True if Update() changed the index since it was loaded, i.e. it needs
+  // to be saved.
+  bool modified() const { return modified_; }
+
+  // Brings the index up to date with the .proto files under the given
+  // (virtual path, disk path) mappings, as passed to DiskSourceTree::MapPath().
+  // As with DiskSourceTree, where two mappings provide the same virtual
+  // file, the first wins.  Files whose size and modification time haven't
+  // changed since they were indexed are not read again.  The rest are read
+  // and scanned on up to thread_count threads.
+  void Update(const vector<pair<string, string> >& mappings,
+              int thread_count);
+
+  // Looks up a type by full name or, for a top-level message, by plain
+  // name, as --target uses.  Fills in *locations with every definition
+  // found, in mapping order, and returns true if there is at least one.
+  bool Find(const string& name, vector<Location>* locations) const;
+
+  // Like Find(), but returns only the file defining a full name.  Used by
+  // SourceTreeDescriptorDatabase::FindFileContainingSymbol().
+  bool FindFileContainingSymbol(const string& full_name, string* file) const;
+
+  // Statistics about the last Update().
+  int file_count() const { return files_.size(); }
+  int rescanned_file_count() const { return rescanned_file_count_; }
+
+ private:
+  struct Symbol {
+    string full_name;
+    int offset;
+    bool is_top_level_message;
+  };
+
+  struct IndexedFile {
+    string virtual_path;
+    string disk_path;
+    int64 size;
+    int64 modification_time;
+    uint64 content_hash;
+    vector<Symbol> symbols;
+  };
+
+  // Name tables for FindFileContainingSymbol(), which the DescriptorPool
+  // may call many times, and for Find() once it has been called often.
+  // Hashing every name in a big tree costs more than loading the index, so
+  // they are only built when needed.
+  struct NameTables;
+  const NameTables& GetNameTables() const;
+
+  struct ScanQueue;
+
+  vector<IndexedFile> files_;
+  int rescanned_file_count_;
+  bool modified_;
+  mutable scoped_ptr<NameTables> tables_;  // Built by GetNameTables().
+  mutable int find_count_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(SymbolIndex);
+};
+
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_SYMBOL_INDEX_H__
@@ -0,0 +1,244 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+#include <algorithm>
+
+#include <google/protobuf/compiler/symbol_scanner.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+
+namespace {
+
+inline bool IsIdentifierStart(char c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_';
+}
+
+inline bool IsIdentifierChar(char c) {
+  return IsIdentifierStart(c) || ('0' <= c && c <= '9') || c == '.';
+}
+
+// Splits the text into identifiers and single characters, dropping
+// whitespace, comments and string literals.  Numbers come out as runs of
+// single characters, which is fine since the scanner ignores them.
+class ProtoSkimmer {
+ public:
+  ProtoSkimmer(const char* data, int size)
+    : ptr_(data), end_(data + size) {}
+
+  // Returns false at the end of the input.  Otherwise, *start and *size are
+  // the token, which is an identifier if its first character is a letter or
+  // underscore.
+  bool Next(const char** start, int* size) {
+    while (ptr_ < end_) {
+      char c = *ptr_;
+      if (c == '/' && ptr_ + 1 < end_ && ptr_[1] == '/') {
+        const char* newline =
+            static_cast<const char*>(memchr(ptr_, '\n', end_ - ptr_));
+        ptr_ = newline == NULL ? end_ : newline + 1;
+      } else if (c == '/' && ptr_ + 1 < end_ && ptr_[1] == '*') {
+        ptr_ += 2;
+        while (ptr_ + 1 < end_ && !(ptr_[0] == '*' && ptr_[1] == '/')) ++ptr_;
+        ptr_ = ptr_ + 1 < end_ ? ptr_ + 2 : end_;
+      } else if (c == '"' || c == '\'') {
+        // String literals can't cross lines, so stop at one in case the
+        // quote is unterminated.
+        ++ptr_;
+        while (ptr_ < end_ && *ptr_ != c && *ptr_ != '\n') {
+          if (*ptr_ == '\\' && ptr_ + 1 < end_) ++ptr_;
+          ++ptr_;
+        }
+        if (ptr_ < end_) ++ptr_;
+      } else if (IsIdentifierStart(c)) {
+        *start = ptr_;
+        while (ptr_ < end_ && IsIdentifierChar(*ptr_)) ++ptr_;
+        *size = ptr_ - *start;
+        return true;
+      } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        ++ptr_;
+      } else {
+        *start = ptr_++;
+        *size = 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  const char* ptr_;
+  const char* end_;
+};
+
+inline bool TokenIs(const char* start, int size, const char* text) {
+  return size == static_cast<int>(strlen(text)) && memcmp(start, text, size) == 0;
+}
+
+}  // namespace
+
+void ScanProtoSymbols(const char* data, int size, ScannedProtoFile* result) {
+  result->package.clear();
+  result->symbols.clear();
+  result->is_top_level_message.clear();
+  result->offsets.clear();
+
+  // One entry per open brace:  the scope a message or group opened, or
+  // empty for anything else, such as an enum or an aggregate option.
+  vector<string> scopes;
+
+  // The type a "message", "enum" or "group" keyword and a name just
+  // declared, waiting for its opening brace.
+  enum { NONE, KEYWORD, NAMED } pending = NONE;
+  bool pending_is_enum = false;
+  string pending_name;
+  int pending_offset = 0;
+  int pending_option_depth = 0;  // Inside a group's "[...]" options.
+  bool expect_package = false;
+
+  ProtoSkimmer skimmer(data, size);
+  const char* token;
+  int token_size;
+  while (skimmer.Next(&token, &token_size)) {
+    bool is_identifier = IsIdentifierStart(*token);
+
+    if (expect_package) {
+      if (is_identifier) result->package.assign(token, token_size);
+      expect_package = false;
+      continue;
+    }
+
+    if (pending == KEYWORD) {
+      if (is_identifier) {
+        pending_name.assign(token, token_size);
+        pending_offset = token - data;
+        pending_option_depth = 0;
+        pending = NAMED;
+        continue;
+      }
+      pending = NONE;
+    } else if (pending == NAMED && !pending_is_enum) {
+      // A group's name is followed by "= number" and possibly a bracketed
+      // option list before the brace.  Nothing inside the brackets counts,
+      // not even braces.
+      if (pending_option_depth > 0) {
+        if (*token == '[') ++pending_option_depth;
+        if (*token == ']') --pending_option_depth;
+        continue;
+      }
+      if (*token == '[') {
+        pending_option_depth = 1;
+        continue;
+      }
+      if (*token == '=' || ('0' <= *token && *token <= '9')) continue;
+      if (*token != '{') pending = NONE;
+    }
+
+    if (*token == '{') {
+      if (pending == NAMED) {
+        string full_name;
+        if (!result->package.empty()) full_name = result->package + ".";
+        for (int i = 0; i < scopes.size(); i++) {
+          if (!scopes[i].empty()) full_name += scopes[i] + ".";
+        }
+        full_name += pending_name;
+        result->symbols.push_back(full_name);
+        result->is_top_level_message.push_back(
+            !pending_is_enum && scopes.empty());
+        result->offsets.push_back(pending_offset);
+        scopes.push_back(pending_is_enum ? string() : pending_name);
+      } else {
+        scopes.push_back(string());
+      }
+      pending = NONE;
+    } else if (*token == '}') {
+      if (!scopes.empty()) scopes.pop_back();
+      pending = NONE;
+    } else if (!is_identifier) {
+      pending = NONE;
+    } else if (TokenIs(token, token_size, "package") && scopes.empty()) {
+      expect_package = true;
+    } else if (TokenIs(token, token_size, "message") ||
+               TokenIs(token, token_size, "group")) {
+      pending = KEYWORD;
+      pending_is_enum = false;
+    } else if (TokenIs(token, token_size, "enum")) {
+      pending = KEYWORD;
+      pending_is_enum = true;
+    } else {
+      pending = NONE;
+    }
+  }
+}
+
+void ReadWholeStream(io::ZeroCopyInputStream* input, string* contents) {
+  contents->clear();
+  const void* data;
+  int size;
+  while (input->Next(&data, &size)) {
+    contents->append(static_cast<const char*>(data), size);
+  }
+}
+
+void ListDirectory(const string& path, vector<string>* names) {
+#ifdef _WIN32
+  struct _finddata_t data;
+  intptr_t handle = _findfirst((path + "/*").c_str(), &data);
+  if (handle == -1) return;
+  do {
+    names->push_back(data.name);
+  } while (_findnext(handle, &data) == 0);
+  _findclose(handle);
+#else
+  DIR* dir = opendir(path.c_str());
+  if (dir == NULL) return;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    names->push_back(entry->d_name);
+  }
+  closedir(dir);
+#endif
+  // readdir() order varies, and callers' output should not.
+  sort(names->begin(), names->end());
+}
+
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,87 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Finds the types a .proto file defines without parsing it.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_SYMBOL_SCANNER_H__
+#define GOOGLE_PROTOBUF_COMPILER_SYMBOL_SCANNER_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+namespace io { class ZeroCopyInputStream; }
+
+namespace compiler {
+
+// What ScanProtoSymbols() found in a file.
+struct LIBPROTOC_EXPORT ScannedProtoFile {
+  string package;
+
+  // Full names of the messages (including groups) and enums defined in the
+  // file, nested ones included, in the order they appear.
+  vector<string> symbols;
+
+  // Which of symbols are top-level messages.
+  vector<bool> is_top_level_message;
+
+  // The byte offset of each symbol's name in the text.
+  vector<int> offsets;
+};
+
+// Skims .proto source text for its package and the types it defines.  It
+// only tracks the package statement, braces and the "message", "enum" and
+// "group" keywords, skipping comments and string literals, so it is much
+// faster than Parser and builds no descriptors.  The price is that it
+// doesn't validate anything:  for a file which doesn't parse, the result is
+// a best guess.
+LIBPROTOC_EXPORT void ScanProtoSymbols(const char* data, int size,
+                                       ScannedProtoFile* result);
+
+// Replaces *contents with everything left in input.
+LIBPROTOC_EXPORT void ReadWholeStream(io::ZeroCopyInputStream* input,
+                                      string* contents);
+
+// Fills in *names with the entries of a directory, sorted, including "."
+// and "..".  Leaves *names empty if the directory can't be read.
+LIBPROTOC_EXPORT void ListDirectory(const string& path,
+                                    vector<string>* names);
+
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_SYMBOL_SCANNER_H__
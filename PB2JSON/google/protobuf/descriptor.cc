@@ -41,7 +41,10 @@
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor_database.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/stats.h>
 #include <google/protobuf/text_format.h>
+#include <google/protobuf/trace.h>
 #include <google/protobuf/unknown_field_set.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/io/coded_stream.h>
@@ -298,6 +301,19 @@ typedef hash_map<EnumIntPair, const EnumValueDescriptor*,
 typedef map<DescriptorIntPair, const FieldDescriptor*>
   ExtensionsGroupedByDescriptorMap;
 
+// MutexLockMaybe, counting the locks actually taken for the pool statistics
+// (stats.h).
+class CountingMutexLock {
+ public:
+  explicit CountingMutexLock(Mutex* mutex) : lock_(mutex) {
+    if (mutex != NULL) CountStat(STAT_DESCRIPTOR_POOL_LOCKS);
+  }
+
+ private:
+  MutexLockMaybe lock_;
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(CountingMutexLock);
+};
+
 }  // anonymous namespace
 
 // ===================================================================
@@ -392,8 +408,12 @@ class DescriptorPool::Tables {
   // Allocate a FileDescriptorTables object.
   FileDescriptorTables* AllocateFileTables();
 
+  // See DescriptorPool::GetSpaceUsage().
+  void GetSpaceUsage(SpaceUsage* usage) const;
+
  private:
   vector<string*> strings_;    // All strings in the pool.
+  int allocated_bytes_;        // Total size of allocations_.
   vector<Message*> messages_;  // All messages in the pool.
   vector<FileDescriptorTables*> file_tables_;  // All file tables in the pool.
   vector<void*> allocations_;  // All other memory allocated in the pool.
@@ -406,6 +426,7 @@ class DescriptorPool::Tables {
   int messages_before_checkpoint_;
   int file_tables_before_checkpoint_;
   int allocations_before_checkpoint_;
+  int allocated_bytes_before_checkpoint_;
   vector<const char*      > symbols_after_checkpoint_;
   vector<const char*      > files_after_checkpoint_;
   vector<DescriptorIntPair> extensions_after_checkpoint_;
@@ -469,6 +490,9 @@ class FileDescriptorTables {
   // fails because we allow duplicates; the first field by the name wins.
   void AddFieldByStylizedNames(const FieldDescriptor* field);
 
+  // Estimates the memory used by the tables.
+  int SpaceUsed() const;
+
  private:
   SymbolsByParentMap    symbols_by_parent_;
   FieldsByNameMap       fields_by_lowercase_name_;
@@ -478,9 +502,11 @@ class FileDescriptorTables {
 };
 
 DescriptorPool::Tables::Tables()
-  : strings_before_checkpoint_(0),
+  : allocated_bytes_(0),
+    strings_before_checkpoint_(0),
     messages_before_checkpoint_(0),
-    allocations_before_checkpoint_(0) {}
+    allocations_before_checkpoint_(0),
+    allocated_bytes_before_checkpoint_(0) {}
 
 DescriptorPool::Tables::~Tables() {
   // Note that the deletion order is important, since the destructors of some
@@ -503,6 +529,7 @@ void DescriptorPool::Tables::Checkpoint() {
   messages_before_checkpoint_ = messages_.size();
   file_tables_before_checkpoint_ = file_tables_.size();
   allocations_before_checkpoint_ = allocations_.size();
+  allocated_bytes_before_checkpoint_ = allocated_bytes_;
 
   symbols_after_checkpoint_.clear();
   files_after_checkpoint_.clear();
@@ -538,6 +565,7 @@ void DescriptorPool::Tables::Rollback() {
   messages_.resize(messages_before_checkpoint_);
   file_tables_.resize(file_tables_before_checkpoint_);
   allocations_.resize(allocations_before_checkpoint_);
+  allocated_bytes_ = allocated_bytes_before_checkpoint_;
 }
 
 // -------------------------------------------------------------------
@@ -571,7 +599,7 @@ inline Symbol FileDescriptorTables::FindNestedSymbolOfType(
 
 Symbol DescriptorPool::Tables::FindByNameHelper(
     const DescriptorPool* pool, const string& name) const {
-  MutexLockMaybe lock(pool->mutex_);
+  CountingMutexLock lock(pool->mutex_);
   Symbol result = FindSymbol(name);
 
   if (result.IsNull() && pool->underlay_ != NULL) {
@@ -739,9 +767,63 @@ void* DescriptorPool::Tables::AllocateBytes(int size) {
 
   void* result = operator new(size);
   allocations_.push_back(result);
+  allocated_bytes_ += size;
   return result;
 }
 
+namespace {
+
+// Estimates the memory used by a hash_map or hash_set:  a node holding each
+// entry and a link to the next, and about one bucket per entry.
+template <typename Collection>
+int HashTableSpaceUsed(const Collection& collection) {
+  return collection.size() *
+         (sizeof(typename Collection::value_type) + 2 * sizeof(void*));
+}
+
+template <typename Element>
+int VectorSpaceUsed(const vector<Element>& collection) {
+  return collection.capacity() * sizeof(Element);
+}
+
+}  // namespace
+
+void DescriptorPool::Tables::GetSpaceUsage(SpaceUsage* usage) const {
+  usage->descriptors = allocated_bytes_;
+
+  usage->strings = 0;
+  for (int i = 0; i < strings_.size(); i++) {
+    usage->strings += sizeof(string) +
+                      internal::StringSpaceUsedExcludingSelf(*strings_[i]);
+  }
+
+  usage->options = 0;
+  for (int i = 0; i < messages_.size(); i++) {
+    usage->options += messages_[i]->SpaceUsed();
+  }
+
+  usage->tables = HashTableSpaceUsed(symbols_by_name_) +
+                  HashTableSpaceUsed(files_by_name_) +
+                  HashTableSpaceUsed(extensions_) +
+                  HashTableSpaceUsed(known_bad_files_) +
+                  HashTableSpaceUsed(extensions_loaded_from_db_) +
+                  VectorSpaceUsed(strings_) + VectorSpaceUsed(messages_) +
+                  VectorSpaceUsed(file_tables_) +
+                  VectorSpaceUsed(allocations_);
+  for (int i = 0; i < file_tables_.size(); i++) {
+    usage->tables += sizeof(FileDescriptorTables) +
+                     file_tables_[i]->SpaceUsed();
+  }
+}
+
+int FileDescriptorTables::SpaceUsed() const {
+  return HashTableSpaceUsed(symbols_by_parent_) +
+         HashTableSpaceUsed(fields_by_lowercase_name_) +
+         HashTableSpaceUsed(fields_by_camelcase_name_) +
+         HashTableSpaceUsed(fields_by_number_) +
+         HashTableSpaceUsed(enum_values_by_number_);
+}
+
 // ===================================================================
 // DescriptorPool
 
@@ -787,8 +869,13 @@ void DescriptorPool::InternalDontEnforceDependencies() {
   enforce_dependencies_ = false;
 }
 
+void DescriptorPool::GetSpaceUsage(SpaceUsage* usage) const {
+  CountingMutexLock lock(mutex_);
+  tables_->GetSpaceUsage(usage);
+}
+
 bool DescriptorPool::InternalIsFileLoaded(const string& filename) const {
-  MutexLockMaybe lock(mutex_);
+  CountingMutexLock lock(mutex_);
   return tables_->FindFile(filename) != NULL;
 }
 
@@ -865,7 +952,8 @@ void DescriptorPool::InternalAddGeneratedFile(
 //   there's nothing more important to do (read: never).
 
 const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
-  MutexLockMaybe lock(mutex_);
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
+  CountingMutexLock lock(mutex_);
   const FileDescriptor* result = tables_->FindFile(name);
   if (result != NULL) return result;
   if (underlay_ != NULL) {
@@ -881,7 +969,8 @@ const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
 
 const FileDescriptor* DescriptorPool::FindFileContainingSymbol(
     const string& symbol_name) const {
-  MutexLockMaybe lock(mutex_);
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
+  CountingMutexLock lock(mutex_);
   Symbol result = tables_->FindSymbol(symbol_name);
   if (!result.IsNull()) return result.GetFile();
   if (underlay_ != NULL) {
@@ -898,12 +987,14 @@ const FileDescriptor* DescriptorPool::FindFileContainingSymbol(
 
 const Descriptor* DescriptorPool::FindMessageTypeByName(
     const string& name) const {
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
   Symbol result = tables_->FindByNameHelper(this, name);
   return (result.type == Symbol::MESSAGE) ? result.descriptor : NULL;
 }
 
 const FieldDescriptor* DescriptorPool::FindFieldByName(
     const string& name) const {
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
   Symbol result = tables_->FindByNameHelper(this, name);
   if (result.type == Symbol::FIELD &&
       !result.field_descriptor->is_extension()) {
@@ -915,6 +1006,7 @@ const FieldDescriptor* DescriptorPool::FindFieldByName(
 
 const FieldDescriptor* DescriptorPool::FindExtensionByName(
     const string& name) const {
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
   Symbol result = tables_->FindByNameHelper(this, name);
   if (result.type == Symbol::FIELD &&
       result.field_descriptor->is_extension()) {
@@ -926,12 +1018,14 @@ const FieldDescriptor* DescriptorPool::FindExtensionByName(
 
 const EnumDescriptor* DescriptorPool::FindEnumTypeByName(
     const string& name) const {
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
   Symbol result = tables_->FindByNameHelper(this, name);
   return (result.type == Symbol::ENUM) ? result.enum_descriptor : NULL;
 }
 
 const EnumValueDescriptor* DescriptorPool::FindEnumValueByName(
     const string& name) const {
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
   Symbol result = tables_->FindByNameHelper(this, name);
   return (result.type == Symbol::ENUM_VALUE) ?
     result.enum_value_descriptor : NULL;
@@ -939,19 +1033,22 @@ const EnumValueDescriptor* DescriptorPool::FindEnumValueByName(
 
 const ServiceDescriptor* DescriptorPool::FindServiceByName(
     const string& name) const {
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
   Symbol result = tables_->FindByNameHelper(this, name);
   return (result.type == Symbol::SERVICE) ? result.service_descriptor : NULL;
 }
 
 const MethodDescriptor* DescriptorPool::FindMethodByName(
     const string& name) const {
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
   Symbol result = tables_->FindByNameHelper(this, name);
   return (result.type == Symbol::METHOD) ? result.method_descriptor : NULL;
 }
 
 const FieldDescriptor* DescriptorPool::FindExtensionByNumber(
     const Descriptor* extendee, int number) const {
-  MutexLockMaybe lock(mutex_);
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
+  CountingMutexLock lock(mutex_);
   const FieldDescriptor* result = tables_->FindExtension(extendee, number);
   if (result != NULL) {
     return result;
@@ -972,7 +1069,8 @@ const FieldDescriptor* DescriptorPool::FindExtensionByNumber(
 
 void DescriptorPool::FindAllExtensions(
     const Descriptor* extendee, vector<const FieldDescriptor*>* out) const {
-  MutexLockMaybe lock(mutex_);
+  CountStat(STAT_DESCRIPTOR_POOL_LOOKUPS);
+  CountingMutexLock lock(mutex_);
 
   // Initialize tables_->extensions_ from the fallback database first
   // (but do this only once per descriptor).
@@ -2260,7 +2358,7 @@ Symbol DescriptorBuilder::FindSymbolNotEnforcingDeps(const string& name) {
   while (true) {
     // If we are looking at an underlay, we must lock its mutex_, since we are
     // accessing the underlay's tables_ dircetly.
-    MutexLockMaybe lock((pool == pool_) ? NULL : pool->mutex_);
+    CountingMutexLock lock((pool == pool_) ? NULL : pool->mutex_);
 
     // Note that we don't have to check fallback_database_ here because the
     // symbol has to be in one of its file's direct dependencies, and we have
@@ -2673,6 +2771,7 @@ template<class DescriptorT> void DescriptorBuilder::AllocateOptionsImpl(
 
 const FileDescriptor* DescriptorBuilder::BuildFile(
     const FileDescriptorProto& proto) {
+  TraceSpan span("BuildFile", proto.name());
   filename_ = proto.name();
 
   // Check if the file already exists and is identical to the one being built.
@@ -2721,6 +2820,7 @@ const FileDescriptor* DescriptorBuilder::BuildFile(
   // before checkpointing tables_.  This avoids confusion with recursive
   // checkpoints.
   if (pool_->fallback_database_ != NULL) {
+    TraceSpan span("LoadDependencies", proto.name());
     tables_->pending_files_.push_back(proto.name());
     for (int i = 0; i < proto.dependency_size(); i++) {
       if (tables_->FindFile(proto.dependency(i)) == NULL &&
@@ -2811,10 +2911,13 @@ const FileDescriptor* DescriptorBuilder::BuildFile(
   }
 
   // Convert children.
-  BUILD_ARRAY(proto, result, message_type, BuildMessage  , NULL);
-  BUILD_ARRAY(proto, result, enum_type   , BuildEnum     , NULL);
-  BUILD_ARRAY(proto, result, service     , BuildService  , NULL);
-  BUILD_ARRAY(proto, result, extension   , BuildExtension, NULL);
+  {
+    TraceSpan span("BuildDescriptors", proto.name());
+    BUILD_ARRAY(proto, result, message_type, BuildMessage  , NULL);
+    BUILD_ARRAY(proto, result, enum_type   , BuildEnum     , NULL);
+    BUILD_ARRAY(proto, result, service     , BuildService  , NULL);
+    BUILD_ARRAY(proto, result, extension   , BuildExtension, NULL);
+  }
 
   // Copy options.
   if (!proto.has_options()) {
@@ -2826,12 +2929,16 @@ const FileDescriptor* DescriptorBuilder::BuildFile(
   // Note that the following steps must occur in exactly the specified order.
 
   // Cross-link.
-  CrossLinkFile(result, proto);
+  {
+    TraceSpan span("CrossLink", proto.name());
+    CrossLinkFile(result, proto);
+  }
 
   // Interpret any remaining uninterpreted options gathered into
   // options_to_interpret_ during descriptor building.  Cross-linking has made
   // extension options known, so all interpretations should now succeed.
   if (!had_errors_) {
+    TraceSpan span("InterpretOptions", proto.name());
     OptionInterpreter option_interpreter(this);
     for (vector<OptionsToInterpret>::iterator iter =
              options_to_interpret_.begin();
@@ -2843,6 +2950,7 @@ const FileDescriptor* DescriptorBuilder::BuildFile(
 
   // Validate options.
   if (!had_errors_) {
+    TraceSpan span("ValidateOptions", proto.name());
     ValidateFileOptions(result, proto);
   }
 
@@ -1066,6 +1066,21 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
   // debugging purposes.
   void AllowUnknownDependencies() { allow_unknown_ = true; }
 
+  // Memory usage ----------------------------------------------------
+
+  // Estimated bytes held by a pool, by what they are for.
+  struct SpaceUsage {
+    int descriptors;  // The descriptor objects and the arrays of them.
+    int strings;      // Names, full names and default values.
+    int options;      // The *Options messages.
+    int tables;       // Lookup tables by name, number and parent.
+  };
+
+  // Fills in *usage for the files built in this pool.  Neither the underlay
+  // nor the fallback database is included.  The size of the lookup tables
+  // depends on the hash_map implementation, so it is only a rough guess.
+  void GetSpaceUsage(SpaceUsage* usage) const;
+
   // Internal stuff --------------------------------------------------
   // These methods MUST NOT be called from outside the proto2 library.
   // These methods may contain hidden pitfalls and may be removed in a
@@ -73,14 +73,18 @@
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/stats.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
 
 namespace google {
 namespace protobuf {
 
 using internal::WireFormat;
+using internal::WireFormatLite;
 using internal::ExtensionSet;
 using internal::GeneratedMessageReflection;
 
@@ -149,6 +153,9 @@ inline int AlignOffset(int offset) {
 
 #define bitsizeof(T) (sizeof(T) * 8)
 
+// Tags are varint32s, which take at most five bytes.
+static const int kMaxTagBytes = 5;
+
 }  // namespace
 
 // ===================================================================
@@ -166,6 +173,47 @@ class DynamicMessage : public Message {
     const DescriptorPool* pool;      // The factory's DescriptorPool.
     const Descriptor* type;          // Type of this DynamicMessage.
 
+    // Everything MergePartialFromCodedStream() needs to store a field's
+    // value directly into the message, without the Reflection.
+    struct FieldParseInfo {
+      uint32 tag;             // With the field's wire type.  0 if unused.
+      bool packed;
+      const FieldDescriptor* field;
+      int offset;
+      int has_bit_index;
+      const Message* sub_prototype;  // Message and group fields only.
+    };
+
+    // The parse table, indexed by field number.  Fields numbered
+    // parse_table_size or above, which only happens when numbering is very
+    // sparse, are in sparse_parse_table instead, sorted by number.
+    scoped_array<FieldParseInfo> parse_table;
+    int parse_table_size;
+    vector<FieldParseInfo> sparse_parse_table;
+
+    // One step of the serialization plan: either a field, or an extension
+    // range (field == NULL) whose extensions are written by the ExtensionSet.
+    struct FieldSerializeInfo {
+      const FieldDescriptor* field;
+      int offset;
+      int has_bit_index;
+      bool packed;
+      int fixed_size;        // Per-element size, if fixed; otherwise 0.
+
+      // The encoded tag, and for groups the encoded end tag.
+      uint8 tag[kMaxTagBytes];
+      int tag_size;
+      uint8 end_tag[kMaxTagBytes];
+      int end_tag_size;
+
+      int extension_start;   // Extension ranges only.
+      int extension_end;
+    };
+
+    // The serialization plan: every field and extension range, in field
+    // number order, which is the order WireFormat writes them in.
+    vector<FieldSerializeInfo> serialize_plan;
+
     // Warning:  The order in which the following pointers are defined is
     //   important (the prototype must be deleted *before* the offsets).
     scoped_array<int> offsets;
@@ -183,14 +231,79 @@ class DynamicMessage : public Message {
 
   Message* New() const;
 
+  void Clear();
+  bool MergePartialFromCodedStream(io::CodedInputStream* input);
+  int ByteSize() const;
+  void SerializeWithCachedSizes(io::CodedOutputStream* output) const;
+  uint8* SerializeWithCachedSizesToArray(uint8* target) const;
+
   int GetCachedSize() const;
   void SetCachedSize(int size) const;
 
+  const Reflection* GetReflection() const;
   Metadata GetMetadata() const;
 
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DynamicMessage);
 
+  // Serialization following type_info_->serialize_plan.  ByteSize() calls
+  // FieldByteSize() on each step and caches the total; the sizes of
+  // sub-messages are cached by their own ByteSize(), so that
+  // SerializeWithCachedSizes() only needs to recompute packed data sizes.
+  int FieldByteSize(const TypeInfo::FieldSerializeInfo& info) const;
+  int FieldCount(const TypeInfo::FieldSerializeInfo& info) const;
+  int FieldDataSize(const TypeInfo::FieldSerializeInfo& info,
+                    int count) const;
+  void SerializeField(const TypeInfo::FieldSerializeInfo& info,
+                      io::CodedOutputStream* output) const;
+
+  inline bool HasBit(int index) const {
+    const uint32* has_bits = reinterpret_cast<const uint32*>(
+      OffsetToPointer(type_info_->has_bits_offset));
+    return (has_bits[index / 32] & (1 << (index % 32))) != 0;
+  }
+
+  // Returns the parse table entry for the given tag, or NULL if the tag is
+  // not one of our (non-extension) fields with the expected wire type.
+  inline const TypeInfo::FieldParseInfo* FindParseInfo(uint32 tag) const;
+
+  // Reads one value of the field described by info and stores it, just like
+  // WireFormat::ParseAndMergeField() does through the Reflection.
+  bool ParseField(const TypeInfo::FieldParseInfo& info, bool lazy,
+                  io::CodedInputStream* input);
+
+  // Lazy parsing (see DynamicMessageFactory::SetLazyMessageParsing()).
+
+  // Wire-format bytes which have been merged into the message but not yet
+  // parsed.  Appending more bytes is equivalent to merging another message
+  // in, so multiple occurrences of a field just concatenate here.  The bytes
+  // are parsed by the first GetReflection(), which is const, so two threads
+  // may try at once; the mutex makes one of them do it while the other
+  // waits.
+  struct LazyBytes {
+    Mutex mutex;
+    string bytes;
+    // True until the bytes have been parsed.
+    bool pending;
+    // True if the message was empty when the bytes were read, so that they
+    // are its entire content.
+    bool whole;
+  };
+
+  // Reads a length-delimited message from the input and appends its bytes
+  // to the pending lazy bytes without parsing them.  empty says whether the
+  // message has no content apart from any pending lazy bytes.
+  bool ReadLazyMessage(io::CodedInputStream* input, bool empty);
+
+  // Parses the pending lazy bytes, if some other thread hasn't already.
+  // Called before anyone gets to look at the message's fields.
+  void ParseLazyBytes() const;
+
+  // If the pending lazy bytes are the message's entire content, in which
+  // case it can be serialized by copying them, returns their size.
+  // Otherwise, returns -1.
+  int LazyByteSize() const;
+
   inline bool is_prototype() const {
     return type_info_->prototype == this ||
            // If type_info_->prototype is NULL, then we must be constructing
@@ -209,11 +322,17 @@ class DynamicMessage : public Message {
 
   // TODO(kenton):  Make this an atomic<int> when C++ supports it.
   mutable int cached_byte_size_;
+
+  // NULL unless bytes have been lazily merged into the message since
+  // construction or the last Clear().  Only non-const methods change the
+  // pointer; the contents are guarded by lazy_->mutex.
+  LazyBytes* lazy_;
 };
 
 DynamicMessage::DynamicMessage(const TypeInfo* type_info)
   : type_info_(type_info),
-    cached_byte_size_(0) {
+    cached_byte_size_(0),
+    lazy_(NULL) {
   // We need to call constructors for various fields manually and set
   // default values where appropriate.  We use placement new to call
   // constructors.  If you haven't heard of placement new, I suggest Googling
@@ -223,6 +342,7 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
   // in practice that's not strictly necessary for types that don't have a
   // constructor.)
 
+  CountStat(STAT_DYNAMIC_INSTANCES);
   const Descriptor* descriptor = type_info_->type;
 
   new(OffsetToPointer(type_info_->unknown_fields_offset)) UnknownFieldSet;
@@ -292,6 +412,8 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
 DynamicMessage::~DynamicMessage() {
   const Descriptor* descriptor = type_info_->type;
 
+  delete lazy_;
+
   reinterpret_cast<UnknownFieldSet*>(
     OffsetToPointer(type_info_->unknown_fields_offset))->~UnknownFieldSet();
 
@@ -395,26 +517,676 @@ void DynamicMessage::SetCachedSize(int size) const {
   cached_byte_size_ = size;
 }
 
+namespace {
+
+// The message whose lazy bytes the calling thread is parsing.  The parse
+// calls that message's GetReflection(), which must not wait for itself.
+GOOGLE_PROTOBUF_THREAD_LOCAL const Message* lazy_bytes_being_parsed = NULL;
+
+}  // namespace
+
+const Reflection* DynamicMessage::GetReflection() const {
+  // Every read or write of a field goes through the Reflection, so this is
+  // the last moment at which pending bytes can be parsed.
+  if (lazy_ != NULL && lazy_bytes_being_parsed != this) ParseLazyBytes();
+  return type_info_->reflection.get();
+}
+
 Metadata DynamicMessage::GetMetadata() const {
+  // Unlike GetReflection(), this does not parse lazy bytes so that
+  // GetDescriptor() stays cheap.  Nothing uses the reflection from here.
   Metadata metadata;
   metadata.descriptor = type_info_->type;
   metadata.reflection = type_info_->reflection.get();
   return metadata;
 }
 
+void DynamicMessage::Clear() {
+  delete lazy_;
+  lazy_ = NULL;
+  Message::Clear();
+}
+
+inline const DynamicMessage::TypeInfo::FieldParseInfo*
+DynamicMessage::FindParseInfo(uint32 tag) const {
+  int field_number = WireFormatLite::GetTagFieldNumber(tag);
+  const TypeInfo::FieldParseInfo* info;
+
+  if (field_number < type_info_->parse_table_size) {
+    info = &type_info_->parse_table[field_number];
+  } else {
+    const vector<TypeInfo::FieldParseInfo>& sparse =
+      type_info_->sparse_parse_table;
+    int lo = 0, hi = sparse.size();
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (sparse[mid].field->number() < field_number) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (lo == sparse.size()) return NULL;
+    info = &sparse[lo];
+  }
+
+  return info->tag == tag ? info : NULL;
+}
+
+bool DynamicMessage::MergePartialFromCodedStream(
+    io::CodedInputStream* input) {
+  const Descriptor* descriptor = type_info_->type;
+  if (descriptor->options().message_set_wire_format()) {
+    return Message::MergePartialFromCodedStream(input);
+  }
+
+  // This also parses any bytes still pending from an earlier lazy merge,
+  // which must be applied before the new ones.
+  const Reflection* reflection = GetReflection();
+  bool lazy = type_info_->factory->lazy_message_parsing();
+
+  // Same as WireFormat::ParseAndMergePartial(), except that our own fields
+  // are handled by ParseField().
+  while (true) {
+    uint32 tag = input->ReadTag();
+    if (tag == 0 ||
+        WireFormatLite::GetTagWireType(tag) ==
+          WireFormatLite::WIRETYPE_END_GROUP) {
+      return true;
+    }
+
+    const TypeInfo::FieldParseInfo* info = FindParseInfo(tag);
+    if (info != NULL) {
+      if (!ParseField(*info, lazy, input)) return false;
+      continue;
+    }
+
+    // An extension, an unknown field, or a known field with the wrong wire
+    // type, all of which WireFormat knows how to deal with.
+    int field_number = WireFormatLite::GetTagFieldNumber(tag);
+    const FieldDescriptor* field = descriptor->FindFieldByNumber(field_number);
+    if (field == NULL && descriptor->IsExtensionNumber(field_number)) {
+      field = reflection->FindKnownExtensionByNumber(field_number);
+    }
+
+    if (!WireFormat::ParseAndMergeField(tag, field, this, input)) {
+      return false;
+    }
+  }
+}
+
+bool DynamicMessage::ParseField(const TypeInfo::FieldParseInfo& info,
+                                bool lazy, io::CodedInputStream* input) {
+  const FieldDescriptor* field = info.field;
+  void* field_ptr = OffsetToPointer(info.offset);
+  uint32* has_bits =
+    reinterpret_cast<uint32*>(OffsetToPointer(type_info_->has_bits_offset));
+
+  // Counted like WireFormat::ParseAndMergeField() counts.
+  CountStat(static_cast<StatsCounter>(
+      STAT_WIRE_FORMAT_DOUBLE_FIELDS +
+      (field->type() - FieldDescriptor::TYPE_DOUBLE)));
+
+  switch (field->type()) {
+#define HANDLE_TYPE(TYPE, TYPE_METHOD, CPPTYPE)                               \
+    case FieldDescriptor::TYPE_##TYPE: {                                      \
+      if (info.packed) {                                                      \
+        RepeatedField<CPPTYPE>* repeated =                                    \
+          reinterpret_cast<RepeatedField<CPPTYPE>*>(field_ptr);               \
+        uint32 length;                                                        \
+        if (!input->ReadVarint32(&length)) return false;                      \
+        io::CodedInputStream::Limit limit = input->PushLimit(length);         \
+        while (input->BytesUntilLimit() > 0) {                                \
+          CPPTYPE value;                                                      \
+          if (!WireFormatLite::Read##TYPE_METHOD(input, &value)) return false;\
+          repeated->Add(value);                                               \
+        }                                                                     \
+        input->PopLimit(limit);                                               \
+      } else if (field->is_repeated()) {                                      \
+        CPPTYPE value;                                                        \
+        if (!WireFormatLite::Read##TYPE_METHOD(input, &value)) return false;  \
+        reinterpret_cast<RepeatedField<CPPTYPE>*>(field_ptr)->Add(value);     \
+      } else {                                                                \
+        if (!WireFormatLite::Read##TYPE_METHOD(                               \
+                input, reinterpret_cast<CPPTYPE*>(field_ptr))) {              \
+          return false;                                                       \
+        }                                                                     \
+        has_bits[info.has_bit_index / 32] |= 1 << (info.has_bit_index % 32); \
+      }                                                                       \
+      return true;                                                            \
+    }
+
+    HANDLE_TYPE( INT32,  Int32,  int32)
+    HANDLE_TYPE( INT64,  Int64,  int64)
+    HANDLE_TYPE(SINT32, SInt32,  int32)
+    HANDLE_TYPE(SINT64, SInt64,  int64)
+    HANDLE_TYPE(UINT32, UInt32, uint32)
+    HANDLE_TYPE(UINT64, UInt64, uint64)
+
+    HANDLE_TYPE( FIXED32,  Fixed32, uint32)
+    HANDLE_TYPE( FIXED64,  Fixed64, uint64)
+    HANDLE_TYPE(SFIXED32, SFixed32,  int32)
+    HANDLE_TYPE(SFIXED64, SFixed64,  int64)
+
+    HANDLE_TYPE(FLOAT , Float , float )
+    HANDLE_TYPE(DOUBLE, Double, double)
+
+    HANDLE_TYPE(BOOL, Bool, bool)
+#undef HANDLE_TYPE
+
+    case FieldDescriptor::TYPE_ENUM: {
+      // Values the enum doesn't define are dropped if packed, or put in the
+      // UnknownFieldSet otherwise, as in WireFormat::ParseAndMergeField().
+      const EnumDescriptor* enum_type = field->enum_type();
+      if (info.packed) {
+        RepeatedField<int>* repeated =
+          reinterpret_cast<RepeatedField<int>*>(field_ptr);
+        uint32 length;
+        if (!input->ReadVarint32(&length)) return false;
+        io::CodedInputStream::Limit limit = input->PushLimit(length);
+        while (input->BytesUntilLimit() > 0) {
+          int value;
+          if (!WireFormatLite::ReadEnum(input, &value)) return false;
+          if (enum_type->FindValueByNumber(value) != NULL) {
+            repeated->Add(value);
+          }
+        }
+        input->PopLimit(limit);
+        return true;
+      }
+
+      int value;
+      if (!WireFormatLite::ReadEnum(input, &value)) return false;
+      if (enum_type->FindValueByNumber(value) == NULL) {
+        reinterpret_cast<UnknownFieldSet*>(
+          OffsetToPointer(type_info_->unknown_fields_offset))
+            ->AddVarint(field->number(), static_cast<int64>(value));
+      } else if (field->is_repeated()) {
+        reinterpret_cast<RepeatedField<int>*>(field_ptr)->Add(value);
+      } else {
+        *reinterpret_cast<int*>(field_ptr) = value;
+        has_bits[info.has_bit_index / 32] |= 1 << (info.has_bit_index % 32);
+      }
+      return true;
+    }
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES: {
+      string* value;
+      if (field->is_repeated()) {
+        value = reinterpret_cast<RepeatedPtrField<string>*>(field_ptr)->Add();
+      } else {
+        // Singular strings point at the default value until first set.
+        string** ptr = reinterpret_cast<string**>(field_ptr);
+        if (*ptr == &field->default_value_string()) {
+          *ptr = new string;
+        }
+        value = *ptr;
+        has_bits[info.has_bit_index / 32] |= 1 << (info.has_bit_index % 32);
+      }
+      return WireFormatLite::ReadString(input, value);
+    }
+
+    case FieldDescriptor::TYPE_GROUP:
+    case FieldDescriptor::TYPE_MESSAGE: {
+      // Mirrors GeneratedMessageReflection::AddMessage() and MutableMessage().
+      // A sub-message whose has-bit is clear, or a new element, is empty
+      // (repeated fields reuse only cleared elements).
+      Message* sub_message;
+      bool empty = true;
+      if (field->is_repeated()) {
+        RepeatedPtrField<Message>* repeated =
+          reinterpret_cast<RepeatedPtrField<Message>*>(field_ptr);
+        if (repeated->ClearedCount() > 0) {
+          sub_message = repeated->ReleaseCleared();
+        } else {
+          sub_message = info.sub_prototype->New();
+        }
+        repeated->AddAllocated(sub_message);
+      } else {
+        Message** ptr = reinterpret_cast<Message**>(field_ptr);
+        if (*ptr == NULL) {
+          *ptr = info.sub_prototype->New();
+        }
+        sub_message = *ptr;
+        empty = !HasBit(info.has_bit_index);
+        has_bits[info.has_bit_index / 32] |= 1 << (info.has_bit_index % 32);
+      }
+
+      if (field->type() == FieldDescriptor::TYPE_GROUP) {
+        return WireFormatLite::ReadGroup(field->number(), input, sub_message);
+      } else if (lazy) {
+        // Sub-messages of non-extension fields are always created from our
+        // factory's prototypes, so they are DynamicMessages too.
+        return down_cast<DynamicMessage*>(sub_message)->ReadLazyMessage(
+            input, empty);
+      } else {
+        return WireFormatLite::ReadMessage(input, sub_message);
+      }
+    }
+  }
+
+  GOOGLE_LOG(DFATAL) << "Can't get here.";
+  return false;
+}
+
+bool DynamicMessage::ReadLazyMessage(io::CodedInputStream* input,
+                                     bool empty) {
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+
+  // This is not const, so no other thread is looking at the message and
+  // lazy_ needs no locking.
+  if (lazy_ == NULL) {
+    lazy_ = new LazyBytes;
+    lazy_->pending = false;
+  }
+  if (!lazy_->pending) {
+    lazy_->pending = true;
+    lazy_->whole = empty;
+    return input->ReadString(&lazy_->bytes, length);
+  } else {
+    // Another occurrence of the same field.  Rare enough not to bother
+    // avoiding the copy.
+    string more;
+    if (!input->ReadString(&more, length)) return false;
+    lazy_->bytes.append(more);
+    return true;
+  }
+}
+
+void DynamicMessage::ParseLazyBytes() const {
+  MutexLock lock(&lazy_->mutex);
+  if (!lazy_->pending) return;
+  lazy_->pending = false;
+  string bytes;
+  bytes.swap(lazy_->bytes);
+
+  // Each level gets a fresh stream, so deeply nested data is parsed one level
+  // at a time rather than recursively, and the recursion limit never trips.
+  io::CodedInputStream input(
+    reinterpret_cast<const uint8*>(bytes.data()), bytes.size());
+  DynamicMessage* self = const_cast<DynamicMessage*>(this);
+  const Message* outer = lazy_bytes_being_parsed;
+  lazy_bytes_being_parsed = this;
+  if (!self->MergePartialFromCodedStream(&input) ||
+      !input.ConsumedEntireMessage()) {
+    GOOGLE_LOG(ERROR) << "Lazily-parsed message of type \""
+                      << type_info_->type->full_name()
+                      << "\" is malformed; keeping what could be parsed.";
+  }
+  lazy_bytes_being_parsed = outer;
+}
+
+int DynamicMessage::LazyByteSize() const {
+  if (lazy_ == NULL) return -1;
+  MutexLock lock(&lazy_->mutex);
+  return lazy_->pending && lazy_->whole ?
+         static_cast<int>(lazy_->bytes.size()) : -1;
+}
+
+int DynamicMessage::ByteSize() const {
+  int lazy_size = LazyByteSize();
+  if (lazy_size >= 0) {
+    SetCachedSize(lazy_size);
+    return lazy_size;
+  }
+  if (type_info_->type->options().message_set_wire_format()) {
+    return Message::ByteSize();
+  }
+
+  GetReflection();  // Parses any pending lazy bytes.
+
+  const vector<TypeInfo::FieldSerializeInfo>& plan =
+    type_info_->serialize_plan;
+  int size = 0;
+  for (int i = 0; i < plan.size(); i++) {
+    if (plan[i].field != NULL) size += FieldByteSize(plan[i]);
+  }
+
+  if (type_info_->extensions_offset != -1) {
+    size += reinterpret_cast<const ExtensionSet*>(
+      OffsetToPointer(type_info_->extensions_offset))->ByteSize();
+  }
+  size += WireFormat::ComputeUnknownFieldsSize(
+    *reinterpret_cast<const UnknownFieldSet*>(
+      OffsetToPointer(type_info_->unknown_fields_offset)));
+
+  SetCachedSize(size);
+  return size;
+}
+
+void DynamicMessage::SerializeWithCachedSizes(
+    io::CodedOutputStream* output) const {
+  if (lazy_ != NULL) {
+    MutexLock lock(&lazy_->mutex);
+    if (lazy_->pending && lazy_->whole) {
+      output->WriteString(lazy_->bytes);
+      return;
+    }
+  }
+  if (type_info_->type->options().message_set_wire_format()) {
+    Message::SerializeWithCachedSizes(output);
+    return;
+  }
+
+  // ByteSize() has already parsed any lazy bytes.
+  int expected_endpoint = output->ByteCount() + cached_byte_size_;
+
+  const vector<TypeInfo::FieldSerializeInfo>& plan =
+    type_info_->serialize_plan;
+  for (int i = 0; i < plan.size(); i++) {
+    if (plan[i].field != NULL) {
+      SerializeField(plan[i], output);
+    } else {
+      reinterpret_cast<const ExtensionSet*>(
+        OffsetToPointer(type_info_->extensions_offset))
+          ->SerializeWithCachedSizes(plan[i].extension_start,
+                                     plan[i].extension_end, output);
+    }
+  }
+
+  WireFormat::SerializeUnknownFields(
+    *reinterpret_cast<const UnknownFieldSet*>(
+      OffsetToPointer(type_info_->unknown_fields_offset)), output);
+
+  GOOGLE_CHECK_EQ(output->ByteCount(), expected_endpoint)
+    << ": Protocol message serialized to a size different from what was "
+       "originally expected.  Perhaps it was modified by another thread "
+       "during serialization?";
+}
+
+int DynamicMessage::FieldCount(
+    const TypeInfo::FieldSerializeInfo& info) const {
+  const FieldDescriptor* field = info.field;
+  if (!field->is_repeated()) {
+    return HasBit(info.has_bit_index) ? 1 : 0;
+  }
+
+  const void* field_ptr = OffsetToPointer(info.offset);
+  switch (field->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, TYPE)                                            \
+    case FieldDescriptor::CPPTYPE_##CPPTYPE:                                  \
+      return reinterpret_cast<const TYPE*>(field_ptr)->size();
+
+    HANDLE_TYPE( INT32, RepeatedField< int32>)
+    HANDLE_TYPE( INT64, RepeatedField< int64>)
+    HANDLE_TYPE(UINT32, RepeatedField<uint32>)
+    HANDLE_TYPE(UINT64, RepeatedField<uint64>)
+    HANDLE_TYPE(DOUBLE, RepeatedField<double>)
+    HANDLE_TYPE( FLOAT, RepeatedField< float>)
+    HANDLE_TYPE(  BOOL, RepeatedField<  bool>)
+    HANDLE_TYPE(  ENUM, RepeatedField<   int>)
+    HANDLE_TYPE(STRING, RepeatedPtrField<string>)
+    HANDLE_TYPE(MESSAGE, RepeatedPtrField<Message>)
+#undef HANDLE_TYPE
+  }
+
+  GOOGLE_LOG(DFATAL) << "Can't get here.";
+  return 0;
+}
+
+int DynamicMessage::FieldDataSize(
+    const TypeInfo::FieldSerializeInfo& info, int count) const {
+  // Like WireFormat::FieldDataOnlyByteSize(), this includes the length
+  // prefixes of strings and sub-messages, but not of packed fields.
+  const FieldDescriptor* field = info.field;
+  const void* field_ptr = OffsetToPointer(info.offset);
+  int data_size = 0;
+
+  switch (field->type()) {
+#define HANDLE_TYPE(TYPE, CPPTYPE, SIZE_METHOD)                               \
+    case FieldDescriptor::TYPE_##TYPE:                                        \
+      if (field->is_repeated()) {                                             \
+        const RepeatedField<CPPTYPE>& repeated =                              \
+          *reinterpret_cast<const RepeatedField<CPPTYPE>*>(field_ptr);        \
+        for (int j = 0; j < repeated.size(); j++) {                           \
+          data_size += WireFormatLite::SIZE_METHOD(repeated.Get(j));          \
+        }                                                                     \
+      } else {                                                                \
+        data_size = WireFormatLite::SIZE_METHOD(                              \
+          *reinterpret_cast<const CPPTYPE*>(field_ptr));                      \
+      }                                                                       \
+      break;
+
+    HANDLE_TYPE( INT32,  int32,  Int32Size)
+    HANDLE_TYPE( INT64,  int64,  Int64Size)
+    HANDLE_TYPE(SINT32,  int32, SInt32Size)
+    HANDLE_TYPE(SINT64,  int64, SInt64Size)
+    HANDLE_TYPE(UINT32, uint32, UInt32Size)
+    HANDLE_TYPE(UINT64, uint64, UInt64Size)
+    HANDLE_TYPE(  ENUM,    int,   EnumSize)
+#undef HANDLE_TYPE
+
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_FLOAT:
+    case FieldDescriptor::TYPE_DOUBLE:
+    case FieldDescriptor::TYPE_BOOL:
+      data_size = info.fixed_size * count;
+      break;
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES:
+      if (field->is_repeated()) {
+        const RepeatedPtrField<string>& repeated =
+          *reinterpret_cast<const RepeatedPtrField<string>*>(field_ptr);
+        for (int j = 0; j < repeated.size(); j++) {
+          data_size += WireFormatLite::StringSize(repeated.Get(j));
+        }
+      } else {
+        data_size = WireFormatLite::StringSize(
+          **reinterpret_cast<const string* const*>(field_ptr));
+      }
+      break;
+
+#define HANDLE_TYPE(TYPE, SIZE_METHOD)                                        \
+    case FieldDescriptor::TYPE_##TYPE:                                        \
+      if (field->is_repeated()) {                                             \
+        const RepeatedPtrField<Message>& repeated =                           \
+          *reinterpret_cast<const RepeatedPtrField<Message>*>(field_ptr);     \
+        for (int j = 0; j < repeated.size(); j++) {                           \
+          data_size += WireFormatLite::SIZE_METHOD(repeated.Get(j));          \
+        }                                                                     \
+      } else {                                                                \
+        data_size = WireFormatLite::SIZE_METHOD(                              \
+          **reinterpret_cast<const Message* const*>(field_ptr));              \
+      }                                                                       \
+      break;
+
+    HANDLE_TYPE(  GROUP,   GroupSize)
+    HANDLE_TYPE(MESSAGE, MessageSize)
+#undef HANDLE_TYPE
+  }
+
+  return data_size;
+}
+
+int DynamicMessage::FieldByteSize(
+    const TypeInfo::FieldSerializeInfo& info) const {
+  int count = FieldCount(info);
+  if (count == 0) return 0;
+
+  int data_size = FieldDataSize(info, count);
+  if (info.packed) {
+    return info.tag_size +
+           io::CodedOutputStream::VarintSize32(data_size) + data_size;
+  } else {
+    return count * (info.tag_size + info.end_tag_size) + data_size;
+  }
+}
+
+void DynamicMessage::SerializeField(const TypeInfo::FieldSerializeInfo& info,
+                                    io::CodedOutputStream* output) const {
+  const FieldDescriptor* field = info.field;
+  const void* field_ptr = OffsetToPointer(info.offset);
+
+  switch (field->type()) {
+#define HANDLE_TYPE(TYPE, TYPE_METHOD, CPPTYPE)                               \
+    case FieldDescriptor::TYPE_##TYPE:                                        \
+      if (field->is_repeated()) {                                             \
+        const RepeatedField<CPPTYPE>& repeated =                              \
+          *reinterpret_cast<const RepeatedField<CPPTYPE>*>(field_ptr);        \
+        if (info.packed) {                                                    \
+          if (repeated.size() == 0) break;                                    \
+          output->WriteRaw(info.tag, info.tag_size);                          \
+          output->WriteVarint32(                                              \
+            FieldDataSize(info, repeated.size()));                            \
+          for (int j = 0; j < repeated.size(); j++) {                         \
+            WireFormatLite::Write##TYPE_METHOD##NoTag(repeated.Get(j),        \
+                                                      output);                \
+          }                                                                   \
+        } else {                                                              \
+          for (int j = 0; j < repeated.size(); j++) {                         \
+            output->WriteRaw(info.tag, info.tag_size);                        \
+            WireFormatLite::Write##TYPE_METHOD##NoTag(repeated.Get(j),        \
+                                                      output);                \
+          }                                                                   \
+        }                                                                     \
+      } else if (HasBit(info.has_bit_index)) {                                \
+        output->WriteRaw(info.tag, info.tag_size);                            \
+        WireFormatLite::Write##TYPE_METHOD##NoTag(                            \
+          *reinterpret_cast<const CPPTYPE*>(field_ptr), output);              \
+      }                                                                       \
+      break;
+
+    HANDLE_TYPE( INT32,  Int32,  int32)
+    HANDLE_TYPE( INT64,  Int64,  int64)
+    HANDLE_TYPE(SINT32, SInt32,  int32)
+    HANDLE_TYPE(SINT64, SInt64,  int64)
+    HANDLE_TYPE(UINT32, UInt32, uint32)
+    HANDLE_TYPE(UINT64, UInt64, uint64)
+
+    HANDLE_TYPE( FIXED32,  Fixed32, uint32)
+    HANDLE_TYPE( FIXED64,  Fixed64, uint64)
+    HANDLE_TYPE(SFIXED32, SFixed32,  int32)
+    HANDLE_TYPE(SFIXED64, SFixed64,  int64)
+
+    HANDLE_TYPE(FLOAT , Float , float )
+    HANDLE_TYPE(DOUBLE, Double, double)
+
+    HANDLE_TYPE(BOOL, Bool, bool)
+    HANDLE_TYPE(ENUM, Enum, int )
+#undef HANDLE_TYPE
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES:
+      if (field->is_repeated()) {
+        const RepeatedPtrField<string>& repeated =
+          *reinterpret_cast<const RepeatedPtrField<string>*>(field_ptr);
+        for (int j = 0; j < repeated.size(); j++) {
+          output->WriteRaw(info.tag, info.tag_size);
+          output->WriteVarint32(repeated.Get(j).size());
+          output->WriteString(repeated.Get(j));
+        }
+      } else if (HasBit(info.has_bit_index)) {
+        const string& value = **reinterpret_cast<const string* const*>(
+          field_ptr);
+        output->WriteRaw(info.tag, info.tag_size);
+        output->WriteVarint32(value.size());
+        output->WriteString(value);
+      }
+      break;
+
+    case FieldDescriptor::TYPE_GROUP:
+    case FieldDescriptor::TYPE_MESSAGE: {
+      const Message* const* begin;
+      int count;
+      if (field->is_repeated()) {
+        const RepeatedPtrField<Message>& repeated =
+          *reinterpret_cast<const RepeatedPtrField<Message>*>(field_ptr);
+        if (repeated.size() == 0) break;
+        begin = repeated.data();
+        count = repeated.size();
+      } else {
+        if (!HasBit(info.has_bit_index)) break;
+        begin = reinterpret_cast<const Message* const*>(field_ptr);
+        count = 1;
+      }
+
+      // The sub-messages' ByteSize()s were called by our ByteSize().
+      for (int j = 0; j < count; j++) {
+        output->WriteRaw(info.tag, info.tag_size);
+        if (field->type() == FieldDescriptor::TYPE_GROUP) {
+          begin[j]->SerializeWithCachedSizes(output);
+          output->WriteRaw(info.end_tag, info.end_tag_size);
+        } else {
+          output->WriteVarint32(begin[j]->GetCachedSize());
+          begin[j]->SerializeWithCachedSizes(output);
+        }
+      }
+      break;
+    }
+  }
+}
+
+uint8* DynamicMessage::SerializeWithCachedSizesToArray(uint8* target) const {
+  if (lazy_ != NULL) {
+    MutexLock lock(&lazy_->mutex);
+    if (lazy_->pending && lazy_->whole) {
+      memcpy(target, lazy_->bytes.data(), lazy_->bytes.size());
+      return target + lazy_->bytes.size();
+    }
+  }
+  return Message::SerializeWithCachedSizesToArray(target);
+}
+
 // ===================================================================
 
+namespace {
+
+struct FieldParseInfoNumberLess {
+  inline bool operator()(
+      const DynamicMessage::TypeInfo::FieldParseInfo& a,
+      const DynamicMessage::TypeInfo::FieldParseInfo& b) const {
+    return a.field->number() < b.field->number();
+  }
+};
+
+struct FieldSerializeInfoNumberLess {
+  static inline int Number(
+      const DynamicMessage::TypeInfo::FieldSerializeInfo& info) {
+    return info.field != NULL ? info.field->number() : info.extension_start;
+  }
+  inline bool operator()(
+      const DynamicMessage::TypeInfo::FieldSerializeInfo& a,
+      const DynamicMessage::TypeInfo::FieldSerializeInfo& b) const {
+    return Number(a) < Number(b);
+  }
+};
+
+// Size of one element of a fixed-width field type, or 0 for varints and
+// length-delimited types.
+int FixedSizeOf(FieldDescriptor::Type type) {
+  switch (type) {
+    case FieldDescriptor::TYPE_FIXED32 : return WireFormatLite::kFixed32Size;
+    case FieldDescriptor::TYPE_FIXED64 : return WireFormatLite::kFixed64Size;
+    case FieldDescriptor::TYPE_SFIXED32: return WireFormatLite::kSFixed32Size;
+    case FieldDescriptor::TYPE_SFIXED64: return WireFormatLite::kSFixed64Size;
+    case FieldDescriptor::TYPE_FLOAT   : return WireFormatLite::kFloatSize;
+    case FieldDescriptor::TYPE_DOUBLE  : return WireFormatLite::kDoubleSize;
+    case FieldDescriptor::TYPE_BOOL    : return WireFormatLite::kBoolSize;
+    default                            : return 0;
+  }
+}
+
+}  // namespace
+
 struct DynamicMessageFactory::PrototypeMap {
   typedef hash_map<const Descriptor*, const DynamicMessage::TypeInfo*> Map;
   Map map_;
 };
 
 DynamicMessageFactory::DynamicMessageFactory()
-  : pool_(NULL), prototypes_(new PrototypeMap) {
+  : pool_(NULL), lazy_message_parsing_(false),
+    prototypes_(new PrototypeMap) {
 }
 
 DynamicMessageFactory::DynamicMessageFactory(const DescriptorPool* pool)
-  : pool_(pool), prototypes_(new PrototypeMap) {
+  : pool_(pool), lazy_message_parsing_(false),
+    prototypes_(new PrototypeMap) {
 }
 
 DynamicMessageFactory::~DynamicMessageFactory() {
@@ -432,6 +1204,7 @@ const Message* DynamicMessageFactory::GetPrototype(const Descriptor* type) {
     return (*target)->prototype.get();
   }
 
+  CountStat(STAT_DYNAMIC_TYPES_BUILT);
   DynamicMessage::TypeInfo* type_info = new DynamicMessage::TypeInfo;
   *target = type_info;
 
@@ -515,6 +1288,83 @@ const Message* DynamicMessageFactory::GetPrototype(const Descriptor* type) {
   // Cross link prototypes.
   prototype->CrossLinkPrototypes();
 
+  // Build the parse table.  Message fields need their types' prototypes, so
+  // this must come after the prototype is registered, in case the type is
+  // recursive.
+  int max_number = 0;
+  for (int i = 0; i < type->field_count(); i++) {
+    max_number = max(max_number, type->field(i)->number());
+  }
+  // Keep the table dense unless that would waste a lot of space.
+  type_info->parse_table_size =
+    min(max_number, 4 * type->field_count() + 64) + 1;
+  type_info->parse_table.reset(
+    new DynamicMessage::TypeInfo::FieldParseInfo[
+      type_info->parse_table_size]);
+  memset(type_info->parse_table.get(), 0,
+         type_info->parse_table_size *
+         sizeof(DynamicMessage::TypeInfo::FieldParseInfo));
+
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+
+    DynamicMessage::TypeInfo::FieldParseInfo info;
+    info.tag = WireFormatLite::MakeTag(field->number(),
+                                       WireFormat::WireTypeForField(field));
+    info.packed = field->options().packed();
+    info.field = field;
+    info.offset = offsets[i];
+    info.has_bit_index = field->index();
+    info.sub_prototype =
+      (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) ?
+        GetPrototype(field->message_type()) : NULL;
+
+    if (field->number() < type_info->parse_table_size) {
+      type_info->parse_table[field->number()] = info;
+    } else {
+      type_info->sparse_parse_table.push_back(info);
+    }
+  }
+  sort(type_info->sparse_parse_table.begin(),
+       type_info->sparse_parse_table.end(), FieldParseInfoNumberLess());
+
+  // Build the serialization plan.
+  vector<DynamicMessage::TypeInfo::FieldSerializeInfo>* plan =
+    &type_info->serialize_plan;
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+
+    DynamicMessage::TypeInfo::FieldSerializeInfo info;
+    memset(&info, 0, sizeof(info));
+    info.field = field;
+    info.offset = offsets[i];
+    info.has_bit_index = field->index();
+    info.packed = field->options().packed();
+    info.fixed_size = FixedSizeOf(field->type());
+
+    uint32 tag = WireFormatLite::MakeTag(field->number(),
+                                         WireFormat::WireTypeForField(field));
+    info.tag_size =
+      io::CodedOutputStream::WriteVarint32ToArray(tag, info.tag) - info.tag;
+    if (field->type() == FieldDescriptor::TYPE_GROUP) {
+      uint32 end_tag = WireFormatLite::MakeTag(
+        field->number(), WireFormatLite::WIRETYPE_END_GROUP);
+      info.end_tag_size =
+        io::CodedOutputStream::WriteVarint32ToArray(end_tag, info.end_tag) -
+        info.end_tag;
+    }
+
+    plan->push_back(info);
+  }
+  for (int i = 0; i < type->extension_range_count(); i++) {
+    DynamicMessage::TypeInfo::FieldSerializeInfo info;
+    memset(&info, 0, sizeof(info));
+    info.extension_start = type->extension_range(i)->start;
+    info.extension_end = type->extension_range(i)->end;
+    plan->push_back(info);
+  }
+  sort(plan->begin(), plan->end(), FieldSerializeInfoNumberLess());
+
   return prototype;
 }
 
@@ -98,8 +98,39 @@ class LIBPROTOBUF_EXPORT DynamicMessageFactory : public MessageFactory {
   // the returned objects are just as thread-safe as any other Message.
   const Message* GetPrototype(const Descriptor* type);
 
+  // Lazy sub-message parsing ----------------------------------------
+
+  // When enabled, parsing a message created by this factory does not parse
+  // its length-delimited sub-messages.  Their bytes are instead copied into
+  // the sub-message object and only parsed the first time the sub-message's
+  // Reflection is requested (which any field access, DebugString(), etc.
+  // will do).  A sub-message which is never inspected is never parsed, and
+  // is re-serialized by copying its bytes, so reading a handful of fields
+  // out of a large payload only costs as much as those fields.
+  //
+  // Caveats:
+  // * Use ParsePartialFrom*() rather than ParseFrom*().  The latter calls
+  //   IsInitialized(), which has to look at every sub-message and so parses
+  //   the whole tree anyway.
+  // * Malformed sub-message bytes are not detected by the initial parse.
+  //   They are reported with GOOGLE_LOG(ERROR) when the sub-message is first
+  //   accessed, and whatever could be parsed before the error is kept.
+  // * Always use the Reflection returned by the message being accessed
+  //   (as all of libprotobuf does); a Reflection obtained from another
+  //   instance of the same type will see unparsed fields as unset.
+  // * The first access to a lazily-parsed sub-message parses it, even
+  //   through a const reference.  That takes a lock, so threads may share
+  //   the message as usual, but a first access made between another
+  //   thread's ByteSize() and SerializeWithCachedSizes() changes the size
+  //   the latter writes.  Serialize such messages from one thread, or
+  //   access them once before sharing them.
+  // Groups and extensions are always parsed eagerly.  Default is false.
+  void SetLazyMessageParsing(bool enabled) { lazy_message_parsing_ = enabled; }
+  bool lazy_message_parsing() const { return lazy_message_parsing_; }
+
  private:
   const DescriptorPool* pool_;
+  bool lazy_message_parsing_;
 
   // This struct just contains a hash_map.  We can't #include <google/protobuf/stubs/hash.h> from
   // this header due to hacks needed for hash_map portability in the open source
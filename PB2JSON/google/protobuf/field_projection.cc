@@ -0,0 +1,135 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <google/protobuf/field_projection.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/stubs/stl_util-inl.h>
+
+namespace google {
+namespace protobuf {
+
+FieldProjection::FieldProjection(const Descriptor* type)
+  : type_(type),
+    selected_(type->field_count(), false),
+    children_(type->field_count(), NULL) {
+}
+
+FieldProjection::~FieldProjection() {
+  STLDeleteElements(&children_);
+}
+
+bool FieldProjection::AddPath(const string& path) {
+  vector<string> parts;
+  SplitStringUsing(path, ".", &parts);
+  if (parts.empty()) return false;
+
+  // Validate the whole path before changing anything.
+  vector<const FieldDescriptor*> fields;
+  const Descriptor* type = type_;
+  for (int i = 0; i < parts.size(); i++) {
+    if (type == NULL) return false;  // Previous part wasn't a message.
+    const FieldDescriptor* field = type->FindFieldByName(parts[i]);
+    if (field == NULL) return false;
+    fields.push_back(field);
+    type = field->message_type();
+  }
+
+  FieldProjection* projection = this;
+  for (int i = 0; i < fields.size(); i++) {
+    int index = fields[i]->index();
+    bool last = (i == fields.size() - 1);
+
+    if (last) {
+      // Selecting the whole field subsumes any partial selection.
+      projection->selected_[index] = true;
+      delete projection->children_[index];
+      projection->children_[index] = NULL;
+    } else if (projection->selected_[index] &&
+               projection->children_[index] == NULL) {
+      // Already selected as a whole.
+      return true;
+    } else {
+      projection->selected_[index] = true;
+      if (projection->children_[index] == NULL) {
+        projection->children_[index] =
+          new FieldProjection(fields[i]->message_type());
+      }
+      projection = projection->children_[index];
+    }
+  }
+
+  return true;
+}
+
+bool FieldProjection::AddPaths(const string& paths, string* error_path) {
+  vector<string> parts;
+  SplitStringUsing(paths, ",", &parts);
+  for (int i = 0; i < parts.size(); i++) {
+    if (!AddPath(parts[i])) {
+      if (error_path != NULL) *error_path = parts[i];
+      return false;
+    }
+  }
+  return true;
+}
+
+void FieldProjection::AddAll() {
+  for (int i = 0; i < selected_.size(); i++) {
+    selected_[i] = true;
+    delete children_[i];
+    children_[i] = NULL;
+  }
+}
+
+bool FieldProjection::Includes(const FieldDescriptor* field) const {
+  GOOGLE_DCHECK_EQ(field->containing_type(), type_);
+  return !field->is_extension() && selected_[field->index()];
+}
+
+const FieldProjection* FieldProjection::GetSubProjection(
+    const FieldDescriptor* field) const {
+  GOOGLE_DCHECK_EQ(field->containing_type(), type_);
+  if (field->is_extension()) return NULL;
+  return children_[field->index()];
+}
+
+bool FieldProjection::empty() const {
+  for (int i = 0; i < selected_.size(); i++) {
+    if (selected_[i]) return false;
+  }
+  return true;
+}
+
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,110 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// A FieldProjection selects a subset of a message type's fields by path,
+// e.g. "baseResponse.Ret" or "exposure_info".  Decoders which accept a
+// projection skip everything outside it at the wire level, without ever
+// building the unwanted sub-messages.
+
+#ifndef GOOGLE_PROTOBUF_FIELD_PROJECTION_H__
+#define GOOGLE_PROTOBUF_FIELD_PROJECTION_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class Descriptor;            // descriptor.h
+class FieldDescriptor;       // descriptor.h
+
+// A tree of selected fields rooted at some message type.  Selecting a
+// message field selects the whole sub-message; selecting one of its fields
+// ("a.b") selects only that part of it.  Extensions and unknown fields are
+// never selected.
+//
+// Example:
+//   FieldProjection projection(CgiF2FPaySucPageResp::descriptor());
+//   projection.AddPaths("baseResponse.Ret,exposure_info.is_show_btn");
+//   WireFormat::ParseAndMergePartial(&input, &message, &projection);
+class LIBPROTOBUF_EXPORT FieldProjection {
+ public:
+  // The given type must outlive the FieldProjection.
+  explicit FieldProjection(const Descriptor* type);
+  ~FieldProjection();
+
+  // The message type this projection applies to.
+  const Descriptor* type() const { return type_; }
+
+  // Selects the field named by the given dot-separated path of field names.
+  // Returns false and leaves the projection unchanged if some component is
+  // not a field of the enclosing type, or if a component other than the
+  // last is not a message-typed field.
+  bool AddPath(const string& path);
+
+  // Calls AddPath() for each entry of a comma-separated list.  On failure,
+  // the paths before the bad one will have been added, and the bad path is
+  // stored in *error_path if it is not NULL.
+  bool AddPaths(const string& paths, string* error_path);
+
+  // Selects every field.  Equivalent to there being no projection at all;
+  // mainly useful for building one up and then narrowing it elsewhere.
+  void AddAll();
+
+  // Is the given field, which must belong to type(), selected?
+  bool Includes(const FieldDescriptor* field) const;
+
+  // If the given message-typed field is selected only in part, returns the
+  // projection to apply to its contents.  Returns NULL if the field is
+  // either not selected or selected as a whole.
+  const FieldProjection* GetSubProjection(const FieldDescriptor* field) const;
+
+  // Is nothing selected?
+  bool empty() const;
+
+ private:
+  const Descriptor* type_;
+
+  // Indexed by FieldDescriptor::index().  NULL children are selected as a
+  // whole if the corresponding bit in selected_ is set.
+  vector<bool> selected_;
+  vector<FieldProjection*> children_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FieldProjection);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_FIELD_PROJECTION_H__
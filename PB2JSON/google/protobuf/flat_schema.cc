@@ -0,0 +1,274 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <google/protobuf/stubs/hash.h>
+#include <google/protobuf/stubs/hash_util.h>
+
+#include <google/protobuf/flat_schema.h>
+#include <google/protobuf/wire_format.h>
+
+namespace google {
+namespace protobuf {
+
+using internal::BuildPerfectHash;
+using internal::Fnv1a64;
+using internal::SplitMix64;
+using internal::WireFormat;
+using internal::WireFormatLite;
+
+namespace {
+
+// Groups are hacky:  The name of the field is just the lower-cased name
+// of the group type.  Like the mock case generator, we would like to retain
+// the original capitalization of the type name.
+const string& FieldName(const FieldDescriptor* field) {
+  if (field->type() == FieldDescriptor::TYPE_GROUP) {
+    return field->message_type()->name();
+  } else {
+    return field->name();
+  }
+}
+
+// Must produce the same names as the objectivec generator's
+// UnderscoresToCamelCase(), which names the keys of mock cases:  the name
+// is split into runs of digits, of upper-case letters optionally followed by
+// lower-case ones, and of lower-case letters.  Each run is capitalized, with
+// the rest of it lower-cased, and then the very first letter is lower-cased.
+// Other characters are dropped.  So "is_show_btn" becomes "isShowBtn" and
+// "URLPath" becomes "urlpath".
+string ToJsonName(const string& input) {
+  string result;
+  bool last_was_number = false;
+  bool last_was_lower = false;
+  bool last_was_upper = false;
+  for (int i = 0; i < input.size(); i++) {
+    char c = input[i];
+    bool starts_run;
+    if (c >= '0' && c <= '9') {
+      starts_run = !last_was_number;
+    } else if (c >= 'a' && c <= 'z') {
+      starts_run = !last_was_lower && !last_was_upper;
+    } else if (c >= 'A' && c <= 'Z') {
+      starts_run = !last_was_upper;
+    } else {
+      last_was_number = last_was_lower = last_was_upper = false;
+      continue;
+    }
+    last_was_number = (c >= '0' && c <= '9');
+    last_was_lower = (c >= 'a' && c <= 'z');
+    last_was_upper = (c >= 'A' && c <= 'Z');
+
+    if (starts_run && !result.empty()) {
+      result += toupper(c);
+    } else {
+      result += tolower(c);
+    }
+  }
+  return result;
+}
+
+struct FieldNumberLess {
+  explicit FieldNumberLess(const vector<int>* numbers) : numbers_(numbers) {}
+  bool operator()(int a, int b) const {
+    return (*numbers_)[a] < (*numbers_)[b];
+  }
+  const vector<int>* numbers_;
+};
+
+// FNV-1a, then the splitmix64 finalizer so that every bit of the result
+// depends on every byte of the name.
+inline uint64 HashName(const char* name, int size) {
+  return SplitMix64(Fnv1a64(name, size));
+}
+
+inline uint32 BucketOf(uint64 hash, uint32 bucket_count) {
+  return static_cast<uint32>(hash >> 32) % bucket_count;
+}
+
+// slot_count is a power of two and the step is odd, so as the displacement
+// goes from 0 to slot_count - 1 a name visits every slot.
+inline uint32 SlotOf(uint64 hash, uint32 displacement, uint32 slot_count) {
+  uint32 start = static_cast<uint32>(hash);
+  uint32 step = static_cast<uint32>(hash >> 16) | 1;
+  return (start + displacement * step) & (slot_count - 1);
+}
+
+}  // namespace
+
+struct FlatSchema::MessageMap {
+  typedef hash_map<const Descriptor*, int> Map;
+  Map map_;
+};
+
+FlatSchema::FlatSchema() : message_map_(new MessageMap) {}
+FlatSchema::~FlatSchema() {}
+
+string FlatSchema::JsonName(const FieldDescriptor* field) {
+  return ToJsonName(FieldName(field));
+}
+
+int FlatSchema::AddMessage(const Descriptor* type) {
+  int index = FindMessage(type);
+  if (index != -1) return index;
+
+  // Types are given their index when first seen and their fields when their
+  // turn in the queue comes, which keeps the fields of each type contiguous.
+  index = message_count();
+  message_map_->map_[type] = index;
+  message_descriptors_.push_back(type);
+
+  for (int next = index; next < message_count(); next++) {
+    const Descriptor* message = message_descriptors_[next];
+    int first = field_descriptors_.size();
+    first_fields_.push_back(first);
+    field_counts_.push_back(message->field_count());
+
+    for (int i = 0; i < message->field_count(); i++) {
+      const FieldDescriptor* field = message->field(i);
+      field_descriptors_.push_back(field);
+      numbers_.push_back(field->number());
+      tags_.push_back(WireFormatLite::MakeTag(
+          field->number(), WireFormat::WireTypeForFieldType(field->type())));
+      types_.push_back(field->type());
+      is_repeated_.push_back(field->is_repeated());
+      json_names_.push_back(JsonName(field));
+
+      int message_type = -1;
+      if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+        message_type = FindMessage(field->message_type());
+        if (message_type == -1) {
+          message_type = message_count();
+          message_map_->map_[field->message_type()] = message_type;
+          message_descriptors_.push_back(field->message_type());
+        }
+      }
+      message_types_.push_back(message_type);
+      by_number_.push_back(first + i);
+    }
+
+    sort(by_number_.begin() + first, by_number_.end(),
+         FieldNumberLess(&numbers_));
+    for (int i = first; i < by_number_.size(); i++) {
+      sorted_numbers_.push_back(numbers_[by_number_[i]]);
+    }
+  }
+
+  return index;
+}
+
+int FlatSchema::FindMessage(const Descriptor* type) const {
+  MessageMap::Map::const_iterator iter = message_map_->map_.find(type);
+  return iter == message_map_->map_.end() ? -1 : iter->second;
+}
+
+void FlatSchema::BuildNameTables() {
+  for (int i = first_buckets_.size(); i < message_count(); i++) {
+    BuildNameTable(i);
+  }
+}
+
+void FlatSchema::BuildNameTable(int message) {
+  // Later fields overwrite earlier ones, as in the generated tables.
+  map<string, int> names;
+  int end = first_field(message) + field_count(message);
+  for (int i = first_field(message); i < end; i++) {
+    names[json_name(i)] = i;
+    names[name(i)] = i;
+  }
+
+  vector<uint64> keys;
+  vector<map<string, int>::const_iterator> entries;
+  for (map<string, int>::const_iterator iter = names.begin();
+       iter != names.end(); ++iter) {
+    keys.push_back(HashName(iter->first.data(), iter->first.size()));
+    entries.push_back(iter);
+  }
+
+  vector<uint32> displacements;
+  vector<int> slots;  // Index into keys, or -1.
+  BuildPerfectHash(keys, &BucketOf, &SlotOf, &displacements, &slots);
+  uint32 bucket_count = displacements.size();
+  uint32 slot_count = slots.size();
+
+  first_buckets_.push_back(displacements_.size());
+  bucket_counts_.push_back(bucket_count);
+  first_slots_.push_back(name_slots_.size());
+  slot_counts_.push_back(slot_count);
+  displacements_.insert(displacements_.end(),
+                        displacements.begin(), displacements.end());
+  for (uint32 i = 0; i < slot_count; i++) {
+    NameSlot slot;
+    slot.field = -1;
+    slot.name_offset = 0;
+    slot.name_size = 0;
+    if (slots[i] != -1) {
+      const pair<const string, int>& entry = *entries[slots[i]];
+      slot.field = entry.second;
+      slot.name_offset = name_chars_.size();
+      slot.name_size = entry.first.size();
+      name_chars_.append(entry.first);
+    }
+    name_slots_.push_back(slot);
+  }
+}
+
+int FlatSchema::FindFieldByJsonName(int message, const char* name,
+                                    int size) const {
+  GOOGLE_DCHECK_LT(message, first_buckets_.size());
+  uint64 hash = HashName(name, size);
+  uint32 displacement = displacements_[
+      first_buckets_[message] + BucketOf(hash, bucket_counts_[message])];
+  const NameSlot& slot = name_slots_[
+      first_slots_[message] + SlotOf(hash, displacement, slot_counts_[message])];
+  if (slot.field == -1 || slot.name_size != size ||
+      memcmp(name_chars_.data() + slot.name_offset, name, size) != 0) {
+    return -1;
+  }
+  return slot.field;
+}
+
+int FlatSchema::FindFieldByNumber(int message, int number) const {
+  vector<int>::const_iterator begin =
+    sorted_numbers_.begin() + first_fields_[message];
+  vector<int>::const_iterator end = begin + field_counts_[message];
+  vector<int>::const_iterator iter = lower_bound(begin, end, number);
+  if (iter == end || *iter != number) return -1;
+  return by_number_[iter - sorted_numbers_.begin()];
+}
+
+}  // namespace protobuf
+
+}  // namespace google
@@ -0,0 +1,190 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// A FlatSchema is a set of message types flattened into arrays indexed by
+// number, for code which walks the same types over and over.  Following
+// Descriptor and FieldDescriptor pointers touches a scattered object for
+// every field, and whatever is derived from them, such as JSON names, has to
+// be derived again or looked up in a hash table.  Here each property of the
+// fields is kept in its own array, with the fields of a message type next to
+// each other, and the derived values are computed once when the type is
+// added.  Message types and fields refer to each other by index.
+//
+// On request, each message type also gets a perfect hash table of the names
+// of its fields, both as in the .proto file and as JSON names, so that
+// parsing JSON can look a member name up where it lies in the input, with
+// one hash and one comparison.
+
+#ifndef GOOGLE_PROTOBUF_FLAT_SCHEMA_H__
+#define GOOGLE_PROTOBUF_FLAT_SCHEMA_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+// Example:
+//   FlatSchema schema;
+//   int type = schema.AddMessage(CgiF2FPaySucPageResp::descriptor());
+//   int end = schema.first_field(type) + schema.field_count(type);
+//   for (int i = schema.first_field(type); i < end; i++) {
+//     if (schema.message_type(i) != -1) { ... }
+//   }
+class LIBPROTOBUF_EXPORT FlatSchema {
+ public:
+  FlatSchema();
+  ~FlatSchema();
+
+  // Adds the message type and every message type reachable through its
+  // fields, unless already added, and returns its index.  Extensions are not
+  // included.  The descriptors must outlive the FlatSchema.
+  int AddMessage(const Descriptor* type);
+
+  // Returns the index of the message type, or -1 if it hasn't been added.
+  int FindMessage(const Descriptor* type) const;
+
+  // Message types ---------------------------------------------------
+
+  int message_count() const { return message_descriptors_.size(); }
+  const Descriptor* message_descriptor(int message) const {
+    return message_descriptors_[message];
+  }
+
+  // The fields of a message type are numbered consecutively from
+  // first_field(), in the order they are declared, so that a field's
+  // FieldDescriptor::index() is its number minus first_field().
+  int first_field(int message) const { return first_fields_[message]; }
+  int field_count(int message) const { return field_counts_[message]; }
+
+  // Returns the field of the message type with the given field number, or
+  // -1 if there is none.
+  int FindFieldByNumber(int message, int number) const;
+
+  // Builds the name tables of the message types added since the last call,
+  // for FindFieldByJsonName().  AddMessage() leaves them out because only
+  // code parsing JSON needs them, and they cost more to build than the rest
+  // of the schema.
+  void BuildNameTables();
+
+  // Returns the field of the message type with the given name, either as
+  // in the .proto file or as json_name(), or -1 if there is none.  The name
+  // need not be NUL-terminated.  If two fields share a name, the one
+  // declared last wins, as in the generated JsonCodecs.  BuildNameTables()
+  // must have been called since the message type was added.
+  int FindFieldByJsonName(int message, const char* name, int size) const;
+
+  // Fields ----------------------------------------------------------
+
+  int total_field_count() const { return field_descriptors_.size(); }
+  const FieldDescriptor* field_descriptor(int field) const {
+    return field_descriptors_[field];
+  }
+  const string& name(int field) const {
+    return field_descriptors_[field]->name();
+  }
+  int number(int field) const { return numbers_[field]; }
+  FieldDescriptor::Type type(int field) const {
+    return static_cast<FieldDescriptor::Type>(types_[field]);
+  }
+  bool is_repeated(int field) const { return is_repeated_[field] != 0; }
+
+  // The tag a value of the field has when it isn't packed.
+  uint32 tag(int field) const { return tags_[field]; }
+
+  // The index of the message type of a message or group field, or -1 for
+  // any other field.
+  int message_type(int field) const { return message_types_[field]; }
+
+  // The name JsonTranscoder gives the field.
+  const string& json_name(int field) const { return json_names_[field]; }
+
+  // Computes the name json_name() returns for the field, for code which
+  // has only the descriptor.
+  static string JsonName(const FieldDescriptor* field);
+
+ private:
+  // Per message type.
+  vector<const Descriptor*> message_descriptors_;
+  vector<int> first_fields_;
+  vector<int> field_counts_;
+
+  // Per field.
+  vector<const FieldDescriptor*> field_descriptors_;
+  vector<int> numbers_;
+  vector<uint32> tags_;
+  vector<uint8> types_;
+  vector<uint8> is_repeated_;
+  vector<int> message_types_;
+  vector<string> json_names_;
+
+  // The fields of each message type again, from first_field() on, sorted by
+  // number for FindFieldByNumber().  sorted_numbers_[i] is the number of
+  // field by_number_[i].
+  vector<int> by_number_;
+  vector<int> sorted_numbers_;
+
+  // The name tables, built with "hash and displace" as for mock bundles:
+  // a name hashes to a bucket of its message type, and the bucket's
+  // displacement picks its slot.  Per message type, the first bucket and
+  // slot, the bucket count and the slot count, which is a power of two.
+  // Only the first first_buckets_.size() message types have tables.
+  struct NameSlot {
+    int field;        // -1 if the slot is empty.
+    int name_offset;  // Into name_chars_.
+    int name_size;
+  };
+  vector<int> first_buckets_;
+  vector<int> bucket_counts_;
+  vector<int> first_slots_;
+  vector<int> slot_counts_;
+  vector<uint32> displacements_;
+  vector<NameSlot> name_slots_;
+  string name_chars_;
+
+  // Builds the name table of the message type, whose fields must already
+  // have been added.
+  void BuildNameTable(int message);
+
+  struct MessageMap;
+  scoped_ptr<MessageMap> message_map_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FlatSchema);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_FLAT_SCHEMA_H__
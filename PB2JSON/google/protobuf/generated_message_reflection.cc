@@ -395,6 +395,98 @@ void GeneratedMessageReflection::Swap(
 
 // -------------------------------------------------------------------
 
+int GeneratedMessageReflection::SpaceUsedByField(
+    const Message& message, const FieldDescriptor* field, int* slack) const {
+  USAGE_CHECK_MESSAGE_TYPE(SpaceUsedByField);
+  // Extensions live in the ExtensionSet, whose arrays we can't see.
+  if (field->is_extension()) {
+    return Reflection::SpaceUsedByField(message, field, slack);
+  }
+
+  // Like SpaceUsed(), but only for this field, and noting what is allocated
+  // beyond the field's current size.
+  int total_size = 0;
+  int unused = 0;
+
+  if (field->is_repeated()) {
+    switch (field->cpp_type()) {
+#define HANDLE_TYPE(UPPERCASE, LOWERCASE)                                     \
+      case FieldDescriptor::CPPTYPE_##UPPERCASE : {                           \
+        const RepeatedField<LOWERCASE>& repeated =                            \
+            GetRaw<RepeatedField<LOWERCASE> >(message, field);                \
+        total_size = repeated.SpaceUsedExcludingSelf();                       \
+        if (total_size > 0) {                                                 \
+          unused = total_size - repeated.size() * sizeof(LOWERCASE);          \
+        }                                                                     \
+        break;                                                                \
+      }
+
+      HANDLE_TYPE( INT32,  int32);
+      HANDLE_TYPE( INT64,  int64);
+      HANDLE_TYPE(UINT32, uint32);
+      HANDLE_TYPE(UINT64, uint64);
+      HANDLE_TYPE(DOUBLE, double);
+      HANDLE_TYPE( FLOAT,  float);
+      HANDLE_TYPE(  BOOL,   bool);
+      HANDLE_TYPE(  ENUM,    int);
+#undef HANDLE_TYPE
+
+      case FieldDescriptor::CPPTYPE_STRING:
+      case FieldDescriptor::CPPTYPE_MESSAGE: {
+        // Elements past size() have been cleared and are kept for reuse, so
+        // they are all slack.  Elements in use which are messages are left
+        // to their own SpaceUsed().
+        const RepeatedPtrFieldBase& repeated =
+            GetRaw<RepeatedPtrFieldBase>(message, field);
+        int size = repeated.size();
+        total_size = repeated.SpaceUsedByArray();
+        if (total_size > 0) unused = total_size - size * sizeof(void*);
+
+        void* const* elements = repeated.raw_data();
+        for (int i = 0; i < size + repeated.ClearedCount(); i++) {
+          int element_size;
+          if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+            const string& value = *reinterpret_cast<const string*>(elements[i]);
+            int buffer_size = StringSpaceUsedExcludingSelf(value);
+            element_size = sizeof(value) + buffer_size;
+            if (i < size && buffer_size > 0) {
+              unused += buffer_size - value.size();
+            }
+          } else if (i < size) {
+            continue;
+          } else {
+            element_size =
+                reinterpret_cast<const Message*>(elements[i])->SpaceUsed();
+          }
+          total_size += element_size;
+          if (i >= size) unused += element_size;
+        }
+        break;
+      }
+    }
+  } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+    // As in SpaceUsed(), the string only takes space once it no longer
+    // points at the default value.
+    const string* ptr = GetField<const string*>(message, field);
+    if (ptr != DefaultRaw<const string*>(field)) {
+      int buffer_size = StringSpaceUsedExcludingSelf(*ptr);
+      total_size = sizeof(*ptr) + buffer_size;
+      if (buffer_size > 0) unused = buffer_size - ptr->size();
+    }
+  } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    // A sub-message outlives Clear() to be reused, but then it isn't in use.
+    const Message* sub_message = GetRaw<const Message*>(message, field);
+    if (&message != default_instance_ && sub_message != NULL &&
+        !HasBit(message, field)) {
+      total_size = sub_message->SpaceUsed();
+      unused = total_size;
+    }
+  }
+
+  if (slack != NULL) *slack = unused;
+  return total_size;
+}
+
 bool GeneratedMessageReflection::HasField(const Message& message,
                                           const FieldDescriptor* field) const {
   USAGE_CHECK_MESSAGE_TYPE(HasField);
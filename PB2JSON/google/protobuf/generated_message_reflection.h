@@ -136,6 +136,8 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
   UnknownFieldSet* MutableUnknownFields(Message* message) const;
 
   int SpaceUsed(const Message& message) const;
+  int SpaceUsedByField(const Message& message, const FieldDescriptor* field,
+                       int* slack) const;
 
   bool HasField(const Message& message, const FieldDescriptor* field) const;
   int FieldSize(const Message& message, const FieldDescriptor* field) const;
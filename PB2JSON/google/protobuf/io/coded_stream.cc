@@ -42,6 +42,7 @@
 #include <limits.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/stats.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/stl_util-inl.h>
 
@@ -79,7 +80,8 @@ CodedInputStream::CodedInputStream(ZeroCopyInputStream* input)
     total_bytes_limit_(kDefaultTotalBytesLimit),
     total_bytes_warning_threshold_(kDefaultTotalBytesWarningThreshold),
     recursion_depth_(0),
-    recursion_limit_(kDefaultRecursionLimit) {
+    recursion_limit_(kDefaultRecursionLimit),
+    lazy_unknown_fields_(false) {
   // Eagerly Refresh() so buffer space is immediately available.
   Refresh();
 }
@@ -98,12 +100,15 @@ CodedInputStream::CodedInputStream(const uint8* buffer, int size)
     total_bytes_limit_(kDefaultTotalBytesLimit),
     total_bytes_warning_threshold_(kDefaultTotalBytesWarningThreshold),
     recursion_depth_(0),
-    recursion_limit_(kDefaultRecursionLimit) {
+    recursion_limit_(kDefaultRecursionLimit),
+    lazy_unknown_fields_(false) {
   // Note that setting current_limit_ == size is important to prevent some
   // code paths from trying to access input_ and segfaulting.
 }
 
 CodedInputStream::~CodedInputStream() {
+  CountStat(STAT_CODED_INPUT_BYTES_READ,
+            total_bytes_read_ - (buffer_size_ + buffer_size_after_limit_));
   if (input_ != NULL) {
     BackUpInputToCurrentPosition();
   }
@@ -137,6 +142,8 @@ inline void CodedInputStream::RecomputeBufferLimits() {
 }
 
 CodedInputStream::Limit CodedInputStream::PushLimit(int byte_limit) {
+  CountStat(STAT_CODED_INPUT_LIMIT_PUSHES);
+
   // Current position relative to the beginning of the stream.
   int current_position = total_bytes_read_ -
       (buffer_size_ + buffer_size_after_limit_);
@@ -477,6 +484,7 @@ bool CodedInputStream::ReadVarint64(uint64* value) {
 
 bool CodedInputStream::Refresh() {
   GOOGLE_DCHECK_EQ(buffer_size_, 0);
+  CountStat(STAT_CODED_INPUT_REFRESHES);
 
   if (buffer_size_after_limit_ > 0 || overflow_bytes_ > 0 ||
       total_bytes_read_ == current_limit_) {
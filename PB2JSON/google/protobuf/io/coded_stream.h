@@ -318,6 +318,22 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Decrements the recursion depth.
   void DecrementRecursionDepth();
 
+  // Unknown Fields --------------------------------------------------
+  // By default, the parser decodes each unknown field it encounters into its
+  // own UnknownField, allocating a string for every length-delimited one.
+  // When lazy unknown fields are enabled, the parser instead appends the
+  // fields' wire bytes to UnknownFieldSet's raw buffer, and they are only
+  // decoded if somebody actually looks at them.  Re-serializing the message
+  // copies the bytes out unchanged.  This is worthwhile when reading data
+  // written with a newer schema, where most unknown fields are never
+  // inspected.
+
+  // Enables or disables lazy unknown fields.  The default is disabled.
+  void SetLazyUnknownFields(bool enabled);
+
+  // Returns whether lazy unknown fields are enabled.
+  bool lazy_unknown_fields() const;
+
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(CodedInputStream);
 
@@ -365,6 +381,9 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Recursion depth limit, set by SetRecursionLimit().
   int recursion_limit_;
 
+  // See SetLazyUnknownFields().
+  bool lazy_unknown_fields_;
+
   // Advance the buffer by a given number of bytes.
   void Advance(int amount);
 
@@ -780,6 +799,14 @@ inline void CodedInputStream::DecrementRecursionDepth() {
   if (recursion_depth_ > 0) --recursion_depth_;
 }
 
+inline void CodedInputStream::SetLazyUnknownFields(bool enabled) {
+  lazy_unknown_fields_ = enabled;
+}
+
+inline bool CodedInputStream::lazy_unknown_fields() const {
+  return lazy_unknown_fields_;
+}
+
 }  // namespace io
 }  // namespace protobuf
 
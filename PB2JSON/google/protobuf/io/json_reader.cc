@@ -0,0 +1,601 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <float.h>
+#include <math.h>
+#include <limits>
+
+#include <google/protobuf/io/json_reader.h>
+#include <google/protobuf/io/json_simd.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/stl_util-inl.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+namespace {
+
+inline bool IsWhitespace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool IsNumberChar(char c) {
+  return ('0' <= c && c <= '9') || c == '-' || c == '+' ||
+         c == '.' || c == 'e' || c == 'E';
+}
+
+int HexValue(char c) {
+  if ('0' <= c && c <= '9') return c - '0';
+  if ('a' <= c && c <= 'f') return c - 'a' + 10;
+  if ('A' <= c && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+void AppendUtf8(uint32 code_point, string* output) {
+  if (code_point < 0x80) {
+    output->push_back(code_point);
+  } else if (code_point < 0x800) {
+    output->push_back(0xc0 | (code_point >> 6));
+    output->push_back(0x80 | (code_point & 0x3f));
+  } else if (code_point < 0x10000) {
+    output->push_back(0xe0 | (code_point >> 12));
+    output->push_back(0x80 | ((code_point >> 6) & 0x3f));
+    output->push_back(0x80 | (code_point & 0x3f));
+  } else {
+    output->push_back(0xf0 | (code_point >> 18));
+    output->push_back(0x80 | ((code_point >> 12) & 0x3f));
+    output->push_back(0x80 | ((code_point >> 6) & 0x3f));
+    output->push_back(0x80 | (code_point & 0x3f));
+  }
+}
+
+// Accepts both the standard and the web-safe alphabets.
+int Base64Value(char c) {
+  if ('A' <= c && c <= 'Z') return c - 'A';
+  if ('a' <= c && c <= 'z') return c - 'a' + 26;
+  if ('0' <= c && c <= '9') return c - '0' + 52;
+  if (c == '+' || c == '-') return 62;
+  if (c == '/' || c == '_') return 63;
+  return -1;
+}
+
+}  // namespace
+
+JsonReader::JsonReader(const char* data, int size)
+  : begin_(data),
+    ptr_(data),
+    end_(data + size),
+    failed_(false),
+    structural_skip_(false) {
+}
+
+JsonReader::~JsonReader() {}
+
+bool JsonReader::Fail(const string& message) {
+  if (!failed_) {
+    failed_ = true;
+
+    int line = 0;
+    int column = 0;
+    for (const char* p = begin_; p < ptr_; p++) {
+      if (*p == '\n') {
+        ++line;
+        column = 0;
+      } else {
+        ++column;
+      }
+    }
+    // Like the text format parser, report 1-based positions.
+    error_ = SimpleItoa(line + 1) + ":" + SimpleItoa(column + 1) + ": " +
+             message;
+  }
+  return false;
+}
+
+char JsonReader::Peek() {
+  while (ptr_ < end_ && IsWhitespace(*ptr_)) ++ptr_;
+  return ptr_ < end_ ? *ptr_ : '\0';
+}
+
+bool JsonReader::ConsumeLiteral(const char* text, int size) {
+  if (end_ - ptr_ < size || memcmp(ptr_, text, size) != 0) return false;
+  ptr_ += size;
+  return true;
+}
+
+int JsonReader::NumberTokenLength() const {
+  const char* p = ptr_;
+  while (p < end_ && IsNumberChar(*p)) ++p;
+  return p - ptr_;
+}
+
+// -------------------------------------------------------------------
+
+bool JsonReader::BeginObject() {
+  if (failed_) return false;
+  if (Peek() != '{') return Fail("Expected \"{\".");
+  ++ptr_;
+  open_.push_back('{');
+  has_members_.push_back(false);
+  return true;
+}
+
+bool JsonReader::BeginArray() {
+  if (failed_) return false;
+  if (Peek() != '[') return Fail("Expected \"[\".");
+  ++ptr_;
+  open_.push_back('[');
+  has_members_.push_back(false);
+  return true;
+}
+
+bool JsonReader::NextName(const char** name, int* size) {
+  if (failed_) return false;
+  GOOGLE_DCHECK(!open_.empty() && open_[open_.size() - 1] == '{');
+
+  char c = Peek();
+  if (c == '}') {
+    ++ptr_;
+    open_.erase(open_.size() - 1);
+    has_members_.pop_back();
+    return false;
+  }
+  if (has_members_.back()) {
+    if (c != ',') return Fail("Expected \",\" or \"}\".");
+    ++ptr_;
+    Peek();
+  }
+  has_members_.back() = true;
+
+  if (!ReadStringToken(&scratch_, name, size)) return false;
+  if (Peek() != ':') return Fail("Expected \":\".");
+  ++ptr_;
+  return true;
+}
+
+bool JsonReader::NextElement() {
+  if (failed_) return false;
+  GOOGLE_DCHECK(!open_.empty() && open_[open_.size() - 1] == '[');
+
+  char c = Peek();
+  if (c == ']') {
+    ++ptr_;
+    open_.erase(open_.size() - 1);
+    has_members_.pop_back();
+    return false;
+  }
+  if (has_members_.back()) {
+    if (c != ',') return Fail("Expected \",\" or \"]\".");
+    ++ptr_;
+  }
+  has_members_.back() = true;
+  return true;
+}
+
+bool JsonReader::ReadNull() {
+  if (failed_) return false;
+  return Peek() == 'n' && ConsumeLiteral("null", 4);
+}
+
+bool JsonReader::ReadBool(bool* value) {
+  if (failed_) return false;
+  Peek();
+  if (ConsumeLiteral("true", 4)) {
+    *value = true;
+  } else if (ConsumeLiteral("false", 5)) {
+    *value = false;
+  } else {
+    return Fail("Expected true or false.");
+  }
+  return true;
+}
+
+// -------------------------------------------------------------------
+
+bool JsonReader::ReadString(string* value) {
+  if (failed_) return false;
+  Peek();
+  return ReadStringToken(value, NULL, NULL);
+}
+
+bool JsonReader::ReadStringToken(string* value, const char** value_data,
+                                 int* value_size) {
+  if (ptr_ >= end_ || *ptr_ != '"') return Fail("Expected string.");
+  ++ptr_;
+
+  // Find the end of the run which needs no unescaping.  Usually that's the
+  // whole string.
+  const char* start = ptr_;
+  ptr_ += JsonUnescapedPrefixLength(ptr_, end_ - ptr_);
+  if (ptr_ < end_ && *ptr_ == '"') {
+    if (value_data != NULL) {
+      *value_data = start;
+      *value_size = ptr_ - start;
+    } else {
+      value->assign(start, ptr_ - start);
+    }
+    ++ptr_;
+    return true;
+  }
+
+  value->assign(start, ptr_ - start);
+  while (true) {
+    if (ptr_ >= end_) return Fail("String not terminated.");
+    char c = *ptr_;
+    if (c == '"') {
+      ++ptr_;
+      break;
+    } else if (static_cast<uint8>(c) < 0x20) {
+      return Fail("Control characters must be escaped in strings.");
+    } else if (c != '\\') {
+      int run = JsonUnescapedPrefixLength(ptr_, end_ - ptr_);
+      value->append(ptr_, run);
+      ptr_ += run;
+      continue;
+    }
+
+    if (end_ - ptr_ < 2) return Fail("String not terminated.");
+    c = ptr_[1];
+    ptr_ += 2;
+    switch (c) {
+      case '"':  value->push_back('"');  break;
+      case '\\': value->push_back('\\'); break;
+      case '/':  value->push_back('/');  break;
+      case 'b':  value->push_back('\b'); break;
+      case 'f':  value->push_back('\f'); break;
+      case 'n':  value->push_back('\n'); break;
+      case 'r':  value->push_back('\r'); break;
+      case 't':  value->push_back('\t'); break;
+      case 'u': {
+        uint32 code_point = 0;
+        for (int units = 0; ; units++) {
+          if (end_ - ptr_ < 4) return Fail("Invalid \\u escape.");
+          uint32 unit = 0;
+          for (int i = 0; i < 4; i++) {
+            int digit = HexValue(ptr_[i]);
+            if (digit < 0) return Fail("Invalid \\u escape.");
+            unit = (unit << 4) | digit;
+          }
+          ptr_ += 4;
+
+          if (units == 0 && unit >= 0xd800 && unit < 0xdc00) {
+            // A high surrogate, which must be followed by a low one.
+            code_point = unit;
+            if (!ConsumeLiteral("\\u", 2)) {
+              return Fail("Unpaired surrogate in \\u escape.");
+            }
+          } else if (units == 1) {
+            if (unit < 0xdc00 || unit >= 0xe000) {
+              return Fail("Unpaired surrogate in \\u escape.");
+            }
+            code_point = 0x10000 + ((code_point - 0xd800) << 10) +
+                         (unit - 0xdc00);
+            break;
+          } else if (unit >= 0xdc00 && unit < 0xe000) {
+            return Fail("Unpaired surrogate in \\u escape.");
+          } else {
+            code_point = unit;
+            break;
+          }
+        }
+        AppendUtf8(code_point, value);
+        break;
+      }
+      default:
+        ptr_ -= 2;
+        return Fail("Invalid escape sequence in string.");
+    }
+  }
+
+  if (value_data != NULL) {
+    *value_data = value->data();
+    *value_size = value->size();
+  }
+  return true;
+}
+
+bool JsonReader::ReadBytes(string* value) {
+  if (failed_) return false;
+  Peek();
+  const char* start = ptr_;
+  const char* data;
+  int size;
+  if (!ReadStringToken(&scratch_, &data, &size)) return false;
+
+  // Padding is optional, so just strip it.
+  while (size > 0 && data[size - 1] == '=') --size;
+
+  // Decode the whole groups in bulk, then whatever is left (an invalid
+  // character or the final partial group) a character at a time.
+  value->resize(size / 4 * 3 + 3);
+  char* output = string_as_array(value);
+  int groups = Base64DecodeGroups(data, size / 4, output);
+  int output_size = groups * 3;
+
+  uint32 bits = 0;
+  int bit_count = 0;
+  for (int i = groups * 4; i < size; i++) {
+    int digit = Base64Value(data[i]);
+    if (digit < 0) {
+      ptr_ = start;
+      return Fail("Invalid base64 data.");
+    }
+    bits = (bits << 6) | digit;
+    bit_count += 6;
+    if (bit_count >= 8) {
+      bit_count -= 8;
+      output[output_size++] = static_cast<char>(bits >> bit_count);
+    }
+  }
+  if (bit_count >= 6) {
+    // One character left over, which can't encode a whole byte.
+    ptr_ = start;
+    return Fail("Invalid base64 data.");
+  }
+  value->resize(output_size);
+  return true;
+}
+
+// -------------------------------------------------------------------
+
+bool JsonReader::ReadInteger(bool* negative, uint64* magnitude) {
+  if (failed_) return false;
+  char c = Peek();
+  const char* start = ptr_;
+  bool quoted = (c == '"');
+  if (quoted) ++ptr_;
+
+  int length = NumberTokenLength();
+  if (length == 0) return Fail("Expected integer.");
+
+  const char* p = ptr_;
+  const char* token_end = ptr_ + length;
+  *negative = (*p == '-');
+  if (*negative) ++p;
+
+  uint64 result = 0;
+  const char* digits_start = p;
+  while (p < token_end && '0' <= *p && *p <= '9') ++p;
+
+  if (p == digits_start) {
+    ptr_ = start;
+    return Fail("Expected integer.");
+  } else if (p == token_end) {
+    if (!ParseUnsignedDigits(digits_start, p, 10, kuint64max, &result)) {
+      ptr_ = start;
+      return Fail("Integer out of range.");
+    }
+  } else {
+    // Something like 1.0 or 1e3, which is fine if it is integral.
+    double value;
+    if (ParseDouble(ptr_, token_end, &value) != token_end ||
+        value != floor(value)) {
+      ptr_ = start;
+      return Fail("Expected integer.");
+    }
+    if (fabs(value) >= 18446744073709551616.0) {
+      ptr_ = start;
+      return Fail("Integer out of range.");
+    }
+    result = static_cast<uint64>(fabs(value));
+  }
+
+  ptr_ = token_end;
+  if (quoted) {
+    if (ptr_ >= end_ || *ptr_ != '"') {
+      ptr_ = start;
+      return Fail("Expected integer.");
+    }
+    ++ptr_;
+  }
+  *magnitude = result;
+  return true;
+}
+
+bool JsonReader::ReadInt32(int32* value) {
+  bool negative;
+  uint64 magnitude;
+  if (!ReadInteger(&negative, &magnitude)) return false;
+  if (magnitude > (negative ? static_cast<uint64>(kint32max) + 1 : kint32max)) {
+    return Fail("Integer out of range.");
+  }
+  *value = negative ? static_cast<int32>(0 - magnitude)
+                    : static_cast<int32>(magnitude);
+  return true;
+}
+
+bool JsonReader::ReadInt64(int64* value) {
+  bool negative;
+  uint64 magnitude;
+  if (!ReadInteger(&negative, &magnitude)) return false;
+  if (magnitude > (negative ? static_cast<uint64>(kint64max) + 1 : kint64max)) {
+    return Fail("Integer out of range.");
+  }
+  *value = negative ? static_cast<int64>(0 - magnitude)
+                    : static_cast<int64>(magnitude);
+  return true;
+}
+
+bool JsonReader::ReadUInt32(uint32* value) {
+  bool negative;
+  uint64 magnitude;
+  if (!ReadInteger(&negative, &magnitude)) return false;
+  if ((negative && magnitude != 0) || magnitude > kuint32max) {
+    return Fail("Integer out of range.");
+  }
+  *value = static_cast<uint32>(magnitude);
+  return true;
+}
+
+bool JsonReader::ReadUInt64(uint64* value) {
+  bool negative;
+  uint64 magnitude;
+  if (!ReadInteger(&negative, &magnitude)) return false;
+  if (negative && magnitude != 0) {
+    return Fail("Integer out of range.");
+  }
+  *value = magnitude;
+  return true;
+}
+
+bool JsonReader::ReadDouble(double* value) {
+  if (failed_) return false;
+  char c = Peek();
+  const char* start = ptr_;
+
+  if (c == '"') {
+    ++ptr_;
+    if (ConsumeLiteral("NaN\"", 4)) {
+      *value = numeric_limits<double>::quiet_NaN();
+      return true;
+    } else if (ConsumeLiteral("Infinity\"", 9)) {
+      *value = numeric_limits<double>::infinity();
+      return true;
+    } else if (ConsumeLiteral("-Infinity\"", 10)) {
+      *value = -numeric_limits<double>::infinity();
+      return true;
+    }
+  }
+
+  int length = NumberTokenLength();
+  if (length == 0) {
+    ptr_ = start;
+    return Fail("Expected number.");
+  }
+  if (ParseDouble(ptr_, ptr_ + length, value) != ptr_ + length) {
+    ptr_ = start;
+    return Fail("Expected number.");
+  }
+  ptr_ += length;
+
+  if (c == '"') {
+    if (ptr_ >= end_ || *ptr_ != '"') {
+      ptr_ = start;
+      return Fail("Expected number.");
+    }
+    ++ptr_;
+  }
+  return true;
+}
+
+bool JsonReader::ReadFloat(float* value) {
+  double double_value;
+  if (!ReadDouble(&double_value)) return false;
+  // Doubles a little above FLT_MAX, such as the 3.4028235e+38 JsonWriter
+  // writes for it, still round to it; only reject what rounds to infinity.
+  float float_value = static_cast<float>(double_value);
+  if ((float_value > FLT_MAX || float_value < -FLT_MAX) &&
+      (double_value < HUGE_VAL && double_value > -HUGE_VAL)) {
+    return Fail("Number out of range for float.");
+  }
+  *value = float_value;
+  return true;
+}
+
+// -------------------------------------------------------------------
+
+bool JsonReader::SkipScalar() {
+  char c = Peek();
+  if (c == '"') {
+    const char* data;
+    int size;
+    return ReadStringToken(&scratch_, &data, &size);
+  } else if (c == 't') {
+    if (ConsumeLiteral("true", 4)) return true;
+  } else if (c == 'f') {
+    if (ConsumeLiteral("false", 5)) return true;
+  } else if (c == 'n') {
+    if (ConsumeLiteral("null", 4)) return true;
+  } else if (c == '-' || ('0' <= c && c <= '9')) {
+    ptr_ += NumberTokenLength();
+    return true;
+  }
+  return Fail("Expected value.");
+}
+
+bool JsonReader::SkipValue() {
+  if (failed_) return false;
+
+  char c = Peek();
+  if (structural_skip_ && (c == '{' || c == '[')) {
+    int size = FindJsonContainerEnd(ptr_, end_ - ptr_);
+    if (size > 0) {
+      ptr_ += size;
+      return true;
+    }
+    // Read it properly to find the error.
+  }
+
+  // Nesting is tracked by open_, so this needs no recursion.
+  int depth = open_.size();
+  while (true) {
+    char c = Peek();
+    if (c == '{') {
+      BeginObject();
+    } else if (c == '[') {
+      BeginArray();
+    } else if (!SkipScalar()) {
+      return false;
+    }
+
+    // Find the next value to skip, closing containers on the way.
+    while (open_.size() > depth) {
+      const char* name;
+      int size;
+      bool more = open_[open_.size() - 1] == '{' ? NextName(&name, &size)
+                                                  : NextElement();
+      if (more) break;
+      if (failed_) return false;
+    }
+    if (open_.size() == depth) return true;
+  }
+}
+
+bool JsonReader::AtEnd() {
+  if (failed_) return false;
+  Peek();
+  return ptr_ == end_;
+}
+
+bool JsonReader::ExpectAtEnd() {
+  if (failed_) return false;
+  Peek();
+  if (ptr_ != end_) return Fail("Expected end of input.");
+  return true;
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
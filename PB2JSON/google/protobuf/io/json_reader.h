@@ -0,0 +1,183 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Utility class for reading JSON from a buffer.
+
+#ifndef GOOGLE_PROTOBUF_IO_JSON_READER_H__
+#define GOOGLE_PROTOBUF_IO_JSON_READER_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+// A pull parser for a JSON document held in memory.  The caller says what
+// it expects next, and JsonReader checks the input against that, so it is a
+// natural match for code which knows the schema in advance.  Example usage:
+//
+//   JsonReader reader(data, size);
+//   if (!reader.BeginObject()) return false;
+//   const char* name;
+//   int name_size;
+//   while (reader.NextName(&name, &name_size)) {
+//     if (string(name, name_size) == "ret") {
+//       if (!reader.ReadInt32(&ret)) return false;
+//     } else {
+//       if (!reader.SkipValue()) return false;
+//     }
+//   }
+//   if (reader.failed()) return false;
+//
+// All methods return false on error, after which failed() is true, error()
+// describes the problem and every later call fails too.
+//
+// The input may also hold a sequence of values separated by whitespace, such
+// as newline-delimited JSON:  read one after the other until AtEnd().
+class LIBPROTOBUF_EXPORT JsonReader {
+ public:
+  // The data must outlive the JsonReader.
+  JsonReader(const char* data, int size);
+  ~JsonReader();
+
+  // Consumes the '{' or '[' starting an object or array.
+  bool BeginObject();
+  bool BeginArray();
+
+  // Reads the name of the next member of the current object, and the ':'
+  // after it.  The name is valid until the next call.  Returns false at the
+  // end of the object, after consuming the closing '}', or on error; use
+  // failed() to tell which.
+  bool NextName(const char** name, int* size);
+
+  // Moves to the next element of the current array.  Returns false at the
+  // end of the array, after consuming the closing ']', or on error.
+  bool NextElement();
+
+  // If the next value is null, consumes it and returns true.  Otherwise,
+  // returns false without consuming anything (this is not an error).
+  bool ReadNull();
+
+  // Numbers may also be given as strings, as JsonWriter does for non-finite
+  // values and as is usual for 64-bit integers.  Integers must be exact and
+  // in range.
+  bool ReadInt32 (int32*  value);
+  bool ReadInt64 (int64*  value);
+  bool ReadUInt32(uint32* value);
+  bool ReadUInt64(uint64* value);
+  bool ReadDouble(double* value);
+  bool ReadFloat (float*  value);
+  bool ReadBool  (bool*   value);
+
+  // Reads a string, replacing the contents of *value.
+  bool ReadString(string* value);
+
+  // Reads a base64-encoded string (standard or web-safe alphabet, padding
+  // optional), replacing the contents of *value with the decoded bytes.
+  bool ReadBytes(string* value);
+
+  // Skips the next value, however deeply nested, checking that it is valid
+  // JSON.
+  bool SkipValue();
+
+  // If enabled, SkipValue() skips an object or array by finding its closing
+  // bracket with FindJsonContainerEnd(), which is several times faster but
+  // doesn't check what is inside it:  '{1 2 3}' is skipped like any other
+  // object.  For bulk input where that trade is acceptable.  Default is
+  // false.
+  void SetStructuralSkip(bool enabled) { structural_skip_ = enabled; }
+
+  // Returns true if nothing but whitespace remains.
+  bool AtEnd();
+
+  // Checks that nothing but whitespace remains.
+  bool ExpectAtEnd();
+
+  bool failed() const { return failed_; }
+  const string& error() const { return error_; }
+
+ private:
+  // Skips whitespace and returns the next character without consuming it,
+  // or '\0' at the end of the input.
+  char Peek();
+
+  // If the input continues with the given text, consumes it and returns
+  // true.
+  bool ConsumeLiteral(const char* text, int size);
+
+  // Returns the length of the number token starting at ptr_, or 0 if there
+  // is none.  Checks only which characters appear, not their order.
+  int NumberTokenLength() const;
+
+  // Skips a string, number, true, false or null.
+  bool SkipScalar();
+
+  // Reads a string token into *value, or, if the string has no escapes and
+  // value_data is not NULL, points *value_data/*value_size at it in the
+  // input instead.
+  bool ReadStringToken(string* value, const char** value_data,
+                       int* value_size);
+
+  // Reads an integer, quoted or not, as a sign and a magnitude.
+  bool ReadInteger(bool* negative, uint64* magnitude);
+
+  // Records an error and returns false.
+  bool Fail(const string& message);
+
+  const char* const begin_;
+  const char* ptr_;
+  const char* const end_;
+
+  bool failed_;
+  string error_;
+
+  bool structural_skip_;
+
+  // One entry per open object or array:  '{' or '[', and whether it has
+  // had any members yet.
+  string open_;
+  vector<bool> has_members_;
+
+  // Holds names and strings which contained escapes.
+  string scratch_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(JsonReader);
+};
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_JSON_READER_H__
@@ -0,0 +1,529 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// The base64 kernels follow Wojciech Muła and Daniel Lemire, "Faster Base64
+// Encoding and Decoding using AVX2 Instructions" (2018), cut down to 128-bit
+// vectors.  FindJsonContainerEnd() uses the structural scan of Geoff Langdale
+// and Daniel Lemire, "Parsing Gigabytes of JSON per Second" (2019).
+
+#include <google/protobuf/io/json_simd.h>
+
+#if !defined(GOOGLE_PROTOBUF_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64)
+#define GOOGLE_PROTOBUF_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#define GOOGLE_PROTOBUF_JSON_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define GOOGLE_PROTOBUF_JSON_NEON 1
+#include <arm_neon.h>
+#endif
+#endif  // !GOOGLE_PROTOBUF_NO_SIMD
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+namespace {
+
+const char kBase64Chars[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// For each character, its value in either base64 alphabet, or -1.
+class Base64DecodeTable {
+ public:
+  Base64DecodeTable() {
+    for (int i = 0; i < 256; i++) table_[i] = -1;
+    for (int i = 0; i < 64; i++) {
+      table_[static_cast<uint8>(kBase64Chars[i])] = i;
+    }
+    table_[static_cast<uint8>('-')] = 62;
+    table_[static_cast<uint8>('_')] = 63;
+  }
+
+  inline int operator[](uint8 c) const { return table_[c]; }
+
+ private:
+  int8 table_[256];
+};
+
+const Base64DecodeTable kBase64DecodeTable;
+
+inline bool NeedsEscaping(char c) {
+  return c == '"' || c == '\\' || static_cast<uint8>(c) < 0x20;
+}
+
+#if defined(GOOGLE_PROTOBUF_JSON_SSE2)
+inline int CountTrailingZeros32(uint32 value) {
+#if defined(__GNUC__)
+  return __builtin_ctz(value);
+#else
+  int count = 0;
+  while ((value & 1) == 0) {
+    value >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+#endif
+
+#if defined(GOOGLE_PROTOBUF_JSON_SSE2) || defined(GOOGLE_PROTOBUF_JSON_NEON)
+inline int CountTrailingZeros64(uint64 value) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(value);
+#else
+  int count = 0;
+  while ((value & 1) == 0) {
+    value >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// Sets bit i of the result to the XOR of bits 0 to i of value, which turns
+// the quotes of a block into a mask of the strings they delimit:  from each
+// opening quote up to, but not including, its closing quote.
+inline uint64 PrefixXor(uint64 value) {
+  value ^= value << 1;
+  value ^= value << 2;
+  value ^= value << 4;
+  value ^= value << 8;
+  value ^= value << 16;
+  value ^= value << 32;
+  return value;
+}
+
+// Returns the characters of a block which follow a backslash that isn't
+// itself escaped.  *carry is 1 if the first character of the block is
+// escaped, and is set to whether the first of the next one is.  Backslashes
+// are rare, so they are simply visited in turn.
+inline uint64 FindEscapedChars(uint64 backslashes, uint64* carry) {
+  uint64 escaped = *carry;
+  *carry = 0;
+  while (backslashes != 0) {
+    int i = CountTrailingZeros64(backslashes);
+    backslashes &= backslashes - 1;
+    if ((escaped >> i) & 1) continue;
+    if (i == 63) {
+      *carry = 1;
+    } else {
+      escaped |= GOOGLE_ULONGLONG(1) << (i + 1);
+    }
+  }
+  return escaped;
+}
+#endif
+
+// MoveMask64() gathers four comparisons of 16 bytes into a 64-bit mask, and
+// ClassifyBlock() sets bit i of each mask if data[i] is a '"', a '\\', a
+// '{' or '[', or a '}' or ']'.
+#if defined(GOOGLE_PROTOBUF_JSON_SSE2)
+inline uint64 MoveMask64(const __m128i* matches) {
+  uint64 mask = 0;
+  for (int i = 0; i < 4; i++) {
+    mask |= static_cast<uint64>(static_cast<uint32>(
+        _mm_movemask_epi8(matches[i]))) << (16 * i);
+  }
+  return mask;
+}
+
+inline void ClassifyBlock(const char* data, uint64* quotes,
+                          uint64* backslashes, uint64* opens,
+                          uint64* closes) {
+  __m128i quote_matches[4];
+  __m128i backslash_matches[4];
+  __m128i open_matches[4];
+  __m128i close_matches[4];
+  for (int i = 0; i < 4; i++) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i));
+    // '[' and ']' differ from '{' and '}' only in bit 0x20.
+    __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    quote_matches[i] = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+    backslash_matches[i] = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+    open_matches[i] = _mm_cmpeq_epi8(folded, _mm_set1_epi8('{'));
+    close_matches[i] = _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'));
+  }
+  *quotes = MoveMask64(quote_matches);
+  *backslashes = MoveMask64(backslash_matches);
+  *opens = MoveMask64(open_matches);
+  *closes = MoveMask64(close_matches);
+}
+#elif defined(GOOGLE_PROTOBUF_JSON_NEON)
+// NEON has no movemask, so weight each byte of the comparisons by its bit
+// and add neighbouring bytes together until each of the four vectors is
+// down to two bytes.
+inline uint64 MoveMask64(const uint8x16_t* matches) {
+  static const uint8 kBitWeights[16] = {
+    1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+  };
+  const uint8x16_t weights = vld1q_u8(kBitWeights);
+  uint8x16_t sum0 = vpaddq_u8(vandq_u8(matches[0], weights),
+                              vandq_u8(matches[1], weights));
+  uint8x16_t sum1 = vpaddq_u8(vandq_u8(matches[2], weights),
+                              vandq_u8(matches[3], weights));
+  sum0 = vpaddq_u8(sum0, sum1);
+  sum0 = vpaddq_u8(sum0, sum0);
+  return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+inline void ClassifyBlock(const char* data, uint64* quotes,
+                          uint64* backslashes, uint64* opens,
+                          uint64* closes) {
+  uint8x16_t quote_matches[4];
+  uint8x16_t backslash_matches[4];
+  uint8x16_t open_matches[4];
+  uint8x16_t close_matches[4];
+  for (int i = 0; i < 4; i++) {
+    uint8x16_t chunk =
+        vld1q_u8(reinterpret_cast<const uint8*>(data) + 16 * i);
+    uint8x16_t folded = vorrq_u8(chunk, vdupq_n_u8(0x20));
+    quote_matches[i] = vceqq_u8(chunk, vdupq_n_u8('"'));
+    backslash_matches[i] = vceqq_u8(chunk, vdupq_n_u8('\\'));
+    open_matches[i] = vceqq_u8(folded, vdupq_n_u8('{'));
+    close_matches[i] = vceqq_u8(folded, vdupq_n_u8('}'));
+  }
+  *quotes = MoveMask64(quote_matches);
+  *backslashes = MoveMask64(backslash_matches);
+  *opens = MoveMask64(open_matches);
+  *closes = MoveMask64(close_matches);
+}
+#endif
+
+}  // namespace
+
+// ===================================================================
+
+int JsonUnescapedPrefixLength(const char* data, int size) {
+  int i = 0;
+
+#if defined(GOOGLE_PROTOBUF_JSON_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i max_control = _mm_set1_epi8(0x1f);
+  for (; i + 16 <= size; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                   _mm_cmpeq_epi8(chunk, backslash));
+    // max(c, 0x1f) == 0x1f exactly when c <= 0x1f, unsigned.
+    special = _mm_or_si128(
+        special,
+        _mm_cmpeq_epi8(_mm_max_epu8(chunk, max_control), max_control));
+    int mask = _mm_movemask_epi8(special);
+    if (mask != 0) return i + CountTrailingZeros32(mask);
+  }
+#elif defined(GOOGLE_PROTOBUF_JSON_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t min_printable = vdupq_n_u8(0x20);
+  for (; i + 16 <= size; i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8*>(data + i));
+    uint8x16_t special = vorrq_u8(vceqq_u8(chunk, quote),
+                                  vceqq_u8(chunk, backslash));
+    special = vorrq_u8(special, vcltq_u8(chunk, min_printable));
+    // Let the plain loop below find which byte it was.
+    if (vmaxvq_u8(special) != 0) break;
+  }
+#endif
+
+  while (i < size && !NeedsEscaping(data[i])) ++i;
+  return i;
+}
+
+// ===================================================================
+
+void Base64EncodeGroups(const char* input, int groups, char* output) {
+  const uint8* in = reinterpret_cast<const uint8*>(input);
+
+#if defined(GOOGLE_PROTOBUF_JSON_SSSE3)
+  // Each step reads 16 bytes but only encodes the first 12, so stop while
+  // there are still two groups to spare.
+  const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                      4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i shift_table = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0);
+  while (groups >= 6) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+
+    // Move each group of three bytes into its own 32-bit lane, then shift
+    // the four 6-bit indices into separate bytes.
+    chunk = _mm_shuffle_epi8(chunk, spread);
+    __m128i high = _mm_mulhi_epu16(
+        _mm_and_si128(chunk, _mm_set1_epi32(0x0fc0fc00)),
+        _mm_set1_epi32(0x04000040));
+    __m128i low = _mm_mullo_epi16(
+        _mm_and_si128(chunk, _mm_set1_epi32(0x003f03f0)),
+        _mm_set1_epi32(0x01000010));
+    __m128i indices = _mm_or_si128(high, low);
+
+    // Map each index to the offset which turns it into its character:
+    // 0-25 to 13, 26-51 to 0, 52-61 to 1-10, 62 to 11 and 63 to 12.
+    __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    reduced = _mm_or_si128(reduced,
+                           _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+    __m128i encoded = _mm_add_epi8(_mm_shuffle_epi8(shift_table, reduced),
+                                   indices);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), encoded);
+    in += 12;
+    output += 16;
+    groups -= 4;
+  }
+#elif defined(GOOGLE_PROTOBUF_JSON_NEON)
+  uint8x16x4_t table;
+  for (int i = 0; i < 4; i++) {
+    table.val[i] =
+        vld1q_u8(reinterpret_cast<const uint8*>(kBase64Chars) + 16 * i);
+  }
+  const uint8x16_t low_six = vdupq_n_u8(0x3f);
+  while (groups >= 16) {
+    uint8x16x3_t bytes = vld3q_u8(in);
+    uint8x16x4_t indices;
+    indices.val[0] = vshrq_n_u8(bytes.val[0], 2);
+    indices.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[0], 4),
+                                       vshrq_n_u8(bytes.val[1], 4)),
+                              low_six);
+    indices.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[1], 2),
+                                       vshrq_n_u8(bytes.val[2], 6)),
+                              low_six);
+    indices.val[3] = vandq_u8(bytes.val[2], low_six);
+
+    uint8x16x4_t encoded;
+    for (int i = 0; i < 4; i++) {
+      encoded.val[i] = vqtbl4q_u8(table, indices.val[i]);
+    }
+    vst4q_u8(reinterpret_cast<uint8*>(output), encoded);
+    in += 48;
+    output += 64;
+    groups -= 16;
+  }
+#endif
+
+  for (; groups > 0; groups--) {
+    output[0] = kBase64Chars[in[0] >> 2];
+    output[1] = kBase64Chars[((in[0] & 0x03) << 4) | (in[1] >> 4)];
+    output[2] = kBase64Chars[((in[1] & 0x0f) << 2) | (in[2] >> 6)];
+    output[3] = kBase64Chars[in[2] & 0x3f];
+    in += 3;
+    output += 4;
+  }
+}
+
+// -------------------------------------------------------------------
+
+int Base64DecodeGroups(const char* input, int groups, char* output) {
+  const uint8* in = reinterpret_cast<const uint8*>(input);
+  uint8* out = reinterpret_cast<uint8*>(output);
+  int decoded = 0;
+
+#if defined(GOOGLE_PROTOBUF_JSON_SSSE3)
+  // Each step writes 16 bytes but only decodes 12, so stop while there are
+  // still two groups to spare.
+  const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                     14, 13, 12, -1, -1, -1, -1);
+  while (groups - decoded >= 6) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+
+    // Work out which range each character is in.  Bytes >= 0x80 are
+    // negative, so they are in none of them.
+    __m128i is_upper = _mm_and_si128(
+        _mm_cmpgt_epi8(chunk, _mm_set1_epi8('A' - 1)),
+        _mm_cmplt_epi8(chunk, _mm_set1_epi8('Z' + 1)));
+    __m128i is_lower = _mm_and_si128(
+        _mm_cmpgt_epi8(chunk, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(chunk, _mm_set1_epi8('z' + 1)));
+    __m128i is_digit = _mm_and_si128(
+        _mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+        _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1)));
+    __m128i is_62 = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('+')),
+                                 _mm_cmpeq_epi8(chunk, _mm_set1_epi8('-')));
+    __m128i is_63 = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('/')),
+                                 _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+    __m128i valid = _mm_or_si128(
+        _mm_or_si128(is_upper, is_lower),
+        _mm_or_si128(is_digit, _mm_or_si128(is_62, is_63)));
+    if (_mm_movemask_epi8(valid) != 0xffff) break;
+
+    __m128i shift = _mm_and_si128(is_upper, _mm_set1_epi8(-'A'));
+    shift = _mm_or_si128(shift,
+                         _mm_and_si128(is_lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift,
+                         _mm_and_si128(is_digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(
+        is_62, _mm_sub_epi8(_mm_set1_epi8(62), chunk)));
+    shift = _mm_or_si128(shift, _mm_and_si128(
+        is_63, _mm_sub_epi8(_mm_set1_epi8(63), chunk)));
+    __m128i values = _mm_add_epi8(chunk, shift);
+
+    // Merge pairs of 6-bit values into 12 bits, then pairs of those into
+    // 24, and gather the three bytes of each lane in big-endian order.
+    __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    merged = _mm_shuffle_epi8(merged, pack);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), merged);
+    in += 16;
+    out += 12;
+    decoded += 4;
+  }
+#elif defined(GOOGLE_PROTOBUF_JSON_NEON)
+  while (groups - decoded >= 16) {
+    uint8x16x4_t chars = vld4q_u8(in);
+    uint8x16_t values[4];
+    uint8x16_t any_invalid = vdupq_n_u8(0);
+    for (int i = 0; i < 4; i++) {
+      uint8x16_t c = chars.val[i];
+      uint8x16_t upper = vsubq_u8(c, vdupq_n_u8('A'));
+      uint8x16_t lower = vsubq_u8(c, vdupq_n_u8('a'));
+      uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+
+      // Start with 0xff, which no valid character maps to.
+      uint8x16_t value = vdupq_n_u8(0xff);
+      value = vbslq_u8(vcltq_u8(digit, vdupq_n_u8(10)),
+                       vaddq_u8(digit, vdupq_n_u8(52)), value);
+      value = vbslq_u8(vcltq_u8(lower, vdupq_n_u8(26)),
+                       vaddq_u8(lower, vdupq_n_u8(26)), value);
+      value = vbslq_u8(vcltq_u8(upper, vdupq_n_u8(26)), upper, value);
+      value = vbslq_u8(vorrq_u8(vceqq_u8(c, vdupq_n_u8('+')),
+                                vceqq_u8(c, vdupq_n_u8('-'))),
+                       vdupq_n_u8(62), value);
+      value = vbslq_u8(vorrq_u8(vceqq_u8(c, vdupq_n_u8('/')),
+                                vceqq_u8(c, vdupq_n_u8('_'))),
+                       vdupq_n_u8(63), value);
+      values[i] = value;
+      any_invalid = vorrq_u8(any_invalid, value);
+    }
+    if (vmaxvq_u8(any_invalid) >= 64) break;
+
+    uint8x16x3_t bytes;
+    bytes.val[0] = vorrq_u8(vshlq_n_u8(values[0], 2),
+                            vshrq_n_u8(values[1], 4));
+    bytes.val[1] = vorrq_u8(vshlq_n_u8(values[1], 4),
+                            vshrq_n_u8(values[2], 2));
+    bytes.val[2] = vorrq_u8(vshlq_n_u8(values[2], 6), values[3]);
+    vst3q_u8(out, bytes);
+    in += 64;
+    out += 48;
+    decoded += 16;
+  }
+#endif
+
+  for (; decoded < groups; decoded++) {
+    int a = kBase64DecodeTable[in[0]];
+    int b = kBase64DecodeTable[in[1]];
+    int c = kBase64DecodeTable[in[2]];
+    int d = kBase64DecodeTable[in[3]];
+    if ((a | b | c | d) < 0) break;
+    out[0] = static_cast<uint8>((a << 2) | (b >> 4));
+    out[1] = static_cast<uint8>((b << 4) | (c >> 2));
+    out[2] = static_cast<uint8>((c << 6) | d);
+    in += 4;
+    out += 3;
+  }
+  return decoded;
+}
+
+// -------------------------------------------------------------------
+
+int FindJsonContainerEnd(const char* data, int size) {
+  GOOGLE_DCHECK(size > 0 && (data[0] == '{' || data[0] == '['));
+  int i = 0;
+  int depth = 0;
+
+  // Whether data[i] is escaped, and whether it is inside a string (all ones
+  // if so).  A backslash escapes the next character even outside strings,
+  // where it is invalid anyway, so that both versions agree on any input.
+  uint64 escape_carry = 0;
+  uint64 string_carry = 0;
+
+#if defined(GOOGLE_PROTOBUF_JSON_SSE2) || defined(GOOGLE_PROTOBUF_JSON_NEON)
+  for (; i + 64 <= size; i += 64) {
+    uint64 quotes, backslashes, opens, closes;
+    ClassifyBlock(data + i, &quotes, &backslashes, &opens, &closes);
+    if (backslashes != 0 || escape_carry != 0) {
+      quotes &= ~FindEscapedChars(backslashes, &escape_carry);
+    }
+    uint64 in_string = PrefixXor(quotes) ^ string_carry;
+    string_carry = static_cast<uint64>(static_cast<int64>(in_string) >> 63);
+
+    // Brackets are few, so visit each in turn.
+    uint64 brackets = (opens | closes) & ~in_string;
+    while (brackets != 0) {
+      uint64 bit = brackets & (0 - brackets);
+      brackets ^= bit;
+      if ((opens & bit) != 0) {
+        ++depth;
+      } else if (--depth == 0) {
+        int end = i + CountTrailingZeros64(bit);
+        return (data[end] ^ data[0]) == ('}' ^ '{') ? end + 1 : -1;
+      }
+    }
+  }
+#endif
+
+  bool escaped = escape_carry != 0;
+  bool in_string = string_carry != 0;
+  for (; i < size; i++) {
+    char c = data[i];
+    if (escaped) {
+      escaped = false;
+      if (in_string) continue;
+    } else if (c == '\\') {
+      escaped = true;
+      continue;
+    } else if (c == '"') {
+      in_string = !in_string;
+      continue;
+    }
+    if (in_string) continue;
+    if (c == '{' || c == '[') {
+      ++depth;
+    } else if ((c == '}' || c == ']') && --depth == 0) {
+      return (c ^ data[0]) == ('}' ^ '{') ? i + 1 : -1;
+    }
+  }
+  return -1;
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,79 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// The inner loops of JsonWriter and JsonReader:  finding the characters in
+// a string which need escaping, base64, and finding the end of an object or
+// array.  Each has SSE and NEON versions alongside the plain one.  Define
+// GOOGLE_PROTOBUF_NO_SIMD to build only the plain versions, e.g. to compare
+// them.
+
+#ifndef GOOGLE_PROTOBUF_IO_JSON_SIMD_H__
+#define GOOGLE_PROTOBUF_IO_JSON_SIMD_H__
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+// Returns the number of bytes at the start of [data, data + size) which
+// can be copied into a JSON string as-is, i.e. the offset of the first '"',
+// '\\' or control character, or size if there is none.  Bytes >= 0x80 need
+// no escaping.
+LIBPROTOBUF_EXPORT int JsonUnescapedPrefixLength(const char* data, int size);
+
+// Encodes groups * 3 bytes of input as groups * 4 characters of base64
+// (RFC 4648, standard alphabet).  Partial groups and padding are left to
+// the caller.
+LIBPROTOBUF_EXPORT void Base64EncodeGroups(const char* input, int groups,
+                                           char* output);
+
+// Decodes up to groups groups of four base64 characters into three bytes
+// each.  Both the standard and the web-safe alphabets are accepted.
+// Stops before the first group containing any other character, such as
+// padding, and returns the number of groups decoded.
+LIBPROTOBUF_EXPORT int Base64DecodeGroups(const char* input, int groups,
+                                          char* output);
+
+// Returns the offset just past the '}' or ']' which closes the object or
+// array starting at data[0], or -1 if there is none or it is the wrong kind.
+// Quotes and backslashes are followed to tell which brackets are inside
+// strings, and the others are only counted, so nothing else is checked:  not
+// even that the brackets inside pair up.
+LIBPROTOBUF_EXPORT int FindJsonContainerEnd(const char* data, int size);
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_JSON_SIMD_H__
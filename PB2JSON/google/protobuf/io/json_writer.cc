@@ -0,0 +1,367 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <math.h>
+#include <limits>
+
+#include <google/protobuf/io/json_writer.h>
+#include <google/protobuf/io/json_simd.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+namespace {
+
+// For each byte, the character to write after a backslash to escape it,
+// 'u' if it must be written as \u00XX, or 0 if it needs no escaping.
+// Bytes >= 0x80 are parts of UTF-8 sequences and pass through unchanged.
+class JsonEscapeTable {
+ public:
+  JsonEscapeTable() {
+    memset(table_, 0, sizeof(table_));
+    for (int i = 0; i < 0x20; i++) table_[i] = 'u';
+    table_[static_cast<uint8>('\b')] = 'b';
+    table_[static_cast<uint8>('\f')] = 'f';
+    table_[static_cast<uint8>('\n')] = 'n';
+    table_[static_cast<uint8>('\r')] = 'r';
+    table_[static_cast<uint8>('\t')] = 't';
+    table_[static_cast<uint8>('"')] = '"';
+    table_[static_cast<uint8>('\\')] = '\\';
+  }
+
+  inline char operator[](uint8 c) const { return table_[c]; }
+
+ private:
+  char table_[256];
+};
+
+const JsonEscapeTable kJsonEscapeTable;
+
+const char kBase64Chars[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+const char kHexDigits[] = "0123456789abcdef";
+
+}  // namespace
+
+JsonWriter::JsonWriter(ZeroCopyOutputStream* output)
+  : output_(output),
+    buffer_(NULL),
+    buffer_size_(0),
+    failed_(false),
+    after_name_(false),
+    base64_pending_size_(0) {
+}
+
+JsonWriter::~JsonWriter() {
+  // Only BackUp() if we're sure we've successfully called Next() at least once.
+  if (buffer_size_ > 0) {
+    output_->BackUp(buffer_size_);
+  }
+}
+
+// -------------------------------------------------------------------
+
+void JsonWriter::BeginValue() {
+  if (after_name_) {
+    after_name_ = false;
+  } else if (!has_members_.empty()) {
+    if (has_members_.back()) WriteChar(',');
+    has_members_.back() = true;
+  }
+}
+
+void JsonWriter::BeginObject() {
+  BeginValue();
+  WriteChar('{');
+  has_members_.push_back(false);
+}
+
+void JsonWriter::EndObject() {
+  GOOGLE_DCHECK(!has_members_.empty());
+  GOOGLE_DCHECK(!after_name_) << "Name() without a value.";
+  has_members_.pop_back();
+  WriteChar('}');
+}
+
+void JsonWriter::BeginArray() {
+  BeginValue();
+  WriteChar('[');
+  has_members_.push_back(false);
+}
+
+void JsonWriter::EndArray() {
+  GOOGLE_DCHECK(!has_members_.empty());
+  has_members_.pop_back();
+  WriteChar(']');
+}
+
+void JsonWriter::Name(const string& name) {
+  Name(name.data(), name.size());
+}
+
+void JsonWriter::Name(const char* name, int size) {
+  GOOGLE_DCHECK(!after_name_) << "Name() without a value.";
+  BeginValue();
+  WriteChar('"');
+  WriteEscaped(name, size);
+  Write("\":", 2);
+  after_name_ = true;
+}
+
+// -------------------------------------------------------------------
+
+void JsonWriter::Int32(int32 value) {
+  char buffer[kFastToBufferSize];
+  BeginValue();
+  Write(buffer, FastInt32ToBufferLeft(value, buffer) - buffer);
+}
+
+void JsonWriter::Int64(int64 value) {
+  char buffer[kFastToBufferSize];
+  BeginValue();
+  Write(buffer, FastInt64ToBufferLeft(value, buffer) - buffer);
+}
+
+void JsonWriter::UInt32(uint32 value) {
+  char buffer[kFastToBufferSize];
+  BeginValue();
+  Write(buffer, FastUInt32ToBufferLeft(value, buffer) - buffer);
+}
+
+void JsonWriter::UInt64(uint64 value) {
+  char buffer[kFastToBufferSize];
+  BeginValue();
+  Write(buffer, FastUInt64ToBufferLeft(value, buffer) - buffer);
+}
+
+void JsonWriter::Double(double value) {
+  if (value != value) {
+    String("NaN", 3);
+  } else if (value == numeric_limits<double>::infinity()) {
+    String("Infinity", 8);
+  } else if (value == -numeric_limits<double>::infinity()) {
+    String("-Infinity", 9);
+  } else {
+    char buffer[kDoubleToBufferSize];
+    BeginValue();
+    DoubleToBuffer(value, buffer);
+    Write(buffer, strlen(buffer));
+  }
+}
+
+void JsonWriter::Float(float value) {
+  if (value != value) {
+    String("NaN", 3);
+  } else if (value == numeric_limits<float>::infinity()) {
+    String("Infinity", 8);
+  } else if (value == -numeric_limits<float>::infinity()) {
+    String("-Infinity", 9);
+  } else {
+    char buffer[kFloatToBufferSize];
+    BeginValue();
+    FloatToBuffer(value, buffer);
+    Write(buffer, strlen(buffer));
+  }
+}
+
+void JsonWriter::Bool(bool value) {
+  BeginValue();
+  if (value) {
+    Write("true", 4);
+  } else {
+    Write("false", 5);
+  }
+}
+
+void JsonWriter::Null() {
+  BeginValue();
+  Write("null", 4);
+}
+
+// -------------------------------------------------------------------
+
+void JsonWriter::String(const string& value) {
+  String(value.data(), value.size());
+}
+
+void JsonWriter::String(const char* data, int size) {
+  BeginString();
+  AppendString(data, size);
+  EndString();
+}
+
+void JsonWriter::BeginString() {
+  BeginValue();
+  WriteChar('"');
+}
+
+void JsonWriter::AppendString(const char* data, int size) {
+  WriteEscaped(data, size);
+}
+
+void JsonWriter::EndString() {
+  WriteChar('"');
+}
+
+void JsonWriter::WriteEscaped(const char* data, int size) {
+  int i = 0;
+  while (true) {
+    // Copy the run which needs no escaping in one go.
+    int run = JsonUnescapedPrefixLength(data + i, size - i);
+    Write(data + i, run);
+    i += run;
+    if (i == size) break;
+
+    uint8 c = static_cast<uint8>(data[i++]);
+    char escape = kJsonEscapeTable[c];
+    if (escape == 'u') {
+      char sequence[6] = { '\\', 'u', '0', '0',
+                           kHexDigits[c >> 4], kHexDigits[c & 0xf] };
+      Write(sequence, sizeof(sequence));
+    } else {
+      char sequence[2] = { '\\', escape };
+      Write(sequence, sizeof(sequence));
+    }
+  }
+}
+
+// -------------------------------------------------------------------
+
+void JsonWriter::Bytes(const char* data, int size) {
+  BeginBytes();
+  AppendBytes(data, size);
+  EndBytes();
+}
+
+void JsonWriter::BeginBytes() {
+  BeginValue();
+  WriteChar('"');
+  base64_pending_size_ = 0;
+}
+
+void JsonWriter::AppendBytes(const char* data, int size) {
+  const uint8* input = reinterpret_cast<const uint8*>(data);
+
+  // Complete a group started by an earlier call.
+  while (base64_pending_size_ > 0 && base64_pending_size_ < 3 && size > 0) {
+    if (base64_pending_size_ == 2) {
+      uint8 group[3] = { static_cast<uint8>(base64_pending_[0]),
+                         static_cast<uint8>(base64_pending_[1]),
+                         *input };
+      char encoded[4] = { kBase64Chars[group[0] >> 2],
+                          kBase64Chars[((group[0] & 0x03) << 4) | (group[1] >> 4)],
+                          kBase64Chars[((group[1] & 0x0f) << 2) | (group[2] >> 6)],
+                          kBase64Chars[group[2] & 0x3f] };
+      Write(encoded, 4);
+      base64_pending_size_ = 0;
+    } else {
+      base64_pending_[base64_pending_size_++] = *input;
+    }
+    ++input;
+    --size;
+  }
+
+  char encoded[4 * 256];
+  while (size >= 3) {
+    int groups = min(size / 3, static_cast<int>(sizeof(encoded) / 4));
+    Base64EncodeGroups(reinterpret_cast<const char*>(input), groups, encoded);
+    input += groups * 3;
+    size -= groups * 3;
+    Write(encoded, groups * 4);
+  }
+
+  for (int i = 0; i < size; i++) {
+    base64_pending_[base64_pending_size_++] = input[i];
+  }
+}
+
+void JsonWriter::EndBytes() {
+  const uint8* pending = reinterpret_cast<const uint8*>(base64_pending_);
+  if (base64_pending_size_ == 1) {
+    char encoded[4] = { kBase64Chars[pending[0] >> 2],
+                        kBase64Chars[(pending[0] & 0x03) << 4],
+                        '=', '=' };
+    Write(encoded, 4);
+  } else if (base64_pending_size_ == 2) {
+    char encoded[4] = { kBase64Chars[pending[0] >> 2],
+                        kBase64Chars[((pending[0] & 0x03) << 4) |
+                                     (pending[1] >> 4)],
+                        kBase64Chars[(pending[1] & 0x0f) << 2],
+                        '=' };
+    Write(encoded, 4);
+  }
+  base64_pending_size_ = 0;
+  WriteChar('"');
+}
+
+// -------------------------------------------------------------------
+
+inline void JsonWriter::WriteChar(char c) {
+  if (buffer_size_ > 0) {
+    *buffer_++ = c;
+    --buffer_size_;
+  } else {
+    Write(&c, 1);
+  }
+}
+
+void JsonWriter::Write(const char* data, int size) {
+  if (failed_) return;
+  if (size == 0) return;
+
+  while (size > buffer_size_) {
+    // Data exceeds space in the buffer.  Copy what we can and request a
+    // new buffer.
+    memcpy(buffer_, data, buffer_size_);
+    data += buffer_size_;
+    size -= buffer_size_;
+    void* void_buffer;
+    failed_ = !output_->Next(&void_buffer, &buffer_size_);
+    if (failed_) return;
+    buffer_ = reinterpret_cast<char*>(void_buffer);
+  }
+
+  // Buffer is big enough to receive the data; copy it.
+  memcpy(buffer_, data, size);
+  buffer_ += size;
+  buffer_size_ -= size;
+}
+
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
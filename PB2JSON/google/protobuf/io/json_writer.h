@@ -0,0 +1,153 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Utility class for writing JSON to a ZeroCopyOutputStream.
+
+#ifndef GOOGLE_PROTOBUF_IO_JSON_WRITER_H__
+#define GOOGLE_PROTOBUF_IO_JSON_WRITER_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace io {
+
+class ZeroCopyOutputStream;     // zero_copy_stream.h
+
+// Writes a stream of JSON tokens, taking care of separators and escaping.
+// Output is written directly into the stream's buffers, in the same way as
+// Printer, and is compact (no whitespace).  Example usage:
+//
+//   JsonWriter writer(output);
+//   writer.BeginObject();
+//   writer.Name("ret");
+//   writer.Int32(0);
+//   writer.Name("items");
+//   writer.BeginArray();
+//   writer.String("a");
+//   writer.EndArray();
+//   writer.EndObject();
+//
+// writes {"ret":0,"items":["a"]}.  Calls must form a valid JSON document:
+// like Printer, JsonWriter crashes (in debug builds) rather than emitting
+// malformed output when misused.
+class LIBPROTOBUF_EXPORT JsonWriter {
+ public:
+  // Create a writer that writes JSON to the given output stream.
+  explicit JsonWriter(ZeroCopyOutputStream* output);
+  ~JsonWriter();
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  // Writes the name of the next member of the current object.  The name is
+  // escaped like a string value.
+  void Name(const string& name);
+  void Name(const char* name, int size);
+
+  // Scalar values.  Non-finite doubles and floats, which JSON can't
+  // represent as numbers, are written as the strings "NaN", "Infinity" and
+  // "-Infinity".
+  void Int32 (int32  value);
+  void Int64 (int64  value);
+  void UInt32(uint32 value);
+  void UInt64(uint64 value);
+  void Double(double value);
+  void Float (float  value);
+  void Bool  (bool   value);
+  void Null();
+
+  // Writes a string value.  The bytes are assumed to be UTF-8 and are
+  // copied as-is except for the characters JSON requires to be escaped.
+  void String(const string& value);
+  void String(const char* data, int size);
+
+  // Writes a string value in pieces, for when the whole value is not
+  // available at once.  Pieces may split UTF-8 sequences.
+  void BeginString();
+  void AppendString(const char* data, int size);
+  void EndString();
+
+  // Writes binary data as a base64-encoded string (RFC 4648, with padding).
+  // Like the string methods, the data may be written in pieces.
+  void Bytes(const char* data, int size);
+  void BeginBytes();
+  void AppendBytes(const char* data, int size);
+  void EndBytes();
+
+  // True if any write to the underlying stream failed.  (We don't just
+  // crash in this case because this is an I/O failure, not a programming
+  // error.)
+  bool failed() const { return failed_; }
+
+ private:
+  // Called before writing any value, including objects and arrays, to write
+  // the comma separating it from the previous one if needed.
+  void BeginValue();
+
+  // Write some text to the output buffer.
+  void Write(const char* data, int size);
+  inline void WriteChar(char c);
+
+  // Write string contents with escaping, but without the quotes.
+  void WriteEscaped(const char* data, int size);
+
+  ZeroCopyOutputStream* const output_;
+  char* buffer_;
+  int buffer_size_;
+  bool failed_;
+
+  // One entry per open object or array: whether anything has been written
+  // to it yet.
+  vector<bool> has_members_;
+
+  // Name() was just called, so the next value needs no separator.
+  bool after_name_;
+
+  // Bytes passed to AppendBytes() which don't yet make up a full base64
+  // group of three.
+  char base64_pending_[2];
+  int base64_pending_size_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(JsonWriter);
+};
+
+}  // namespace io
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_IO_JSON_WRITER_H__
@@ -563,14 +563,10 @@ bool Tokenizer::Next() {
 
 bool Tokenizer::ParseInteger(const string& text, uint64 max_value,
                              uint64* output) {
-  // Sadly, we can't just use strtoul() since it is only 32-bit and strtoull()
-  // is non-standard.  I hate the C standard library.  :(
-
-//  return strtoull(text.c_str(), NULL, 0);
-
-  const char* ptr = text.c_str();
+  const char* ptr = text.data();
+  const char* end = ptr + text.size();
   int base = 10;
-  if (ptr[0] == '0') {
+  if (text.size() > 1 && ptr[0] == '0') {
     if (ptr[1] == 'x' || ptr[1] == 'X') {
       // This is hex.
       base = 16;
@@ -581,43 +577,43 @@ bool Tokenizer::ParseInteger(const string& text, uint64 max_value,
     }
   }
 
-  uint64 result = 0;
-  for (; *ptr != '\0'; ptr++) {
+  if (ParseUnsignedDigits(ptr, end, base, max_value, output)) return true;
+
+  // Overflow, unless the text isn't something the tokenizer would produce.
+  for (; ptr < end; ptr++) {
     int digit = DigitValue(*ptr);
-    GOOGLE_LOG_IF(DFATAL, digit < 0 || digit >= base)
-      << " Tokenizer::ParseInteger() passed text that could not have been"
-         " tokenized as an integer: " << CEscape(text);
-    if (digit > max_value || result > (max_value - digit) / base) {
-      // Overflow.
-      return false;
+    if (digit < 0 || digit >= base) {
+      GOOGLE_LOG(DFATAL)
+        << " Tokenizer::ParseInteger() passed text that could not have been"
+           " tokenized as an integer: " << CEscape(text);
+      break;
     }
-    result = result * base + digit;
   }
-
-  *output = result;
-  return true;
+  return false;
 }
 
 double Tokenizer::ParseFloat(const string& text) {
-  const char* start = text.c_str();
-  char* end;
-  double result = NoLocaleStrtod(start, &end);
+  const char* start = text.data();
+  double result = 0.0;
+  const char* end = ParseDouble(start, start + text.size(), &result);
+  if (end == NULL) end = start;
 
   // "1e" is not a valid float, but if the tokenizer reads it, it will
   // report an error but still return it as a valid token.  We need to
   // accept anything the tokenizer could possibly return, error or not.
-  if (*end == 'e' || *end == 'E') {
+  const char* text_end = start + text.size();
+  if (end < text_end && (*end == 'e' || *end == 'E')) {
     ++end;
-    if (*end == '-' || *end == '+') ++end;
+    if (end < text_end && (*end == '-' || *end == '+')) ++end;
   }
 
   // If the Tokenizer had allow_f_after_float_ enabled, the float may be
   // suffixed with the letter 'f'.
-  if (*end == 'f' || *end == 'F') {
+  if (end < text_end && (*end == 'f' || *end == 'F')) {
     ++end;
   }
 
-  GOOGLE_LOG_IF(DFATAL, end - start != text.size() || *start == '-')
+  GOOGLE_LOG_IF(DFATAL, end != text_end || *start == '-' || *start == '+')
     << " Tokenizer::ParseFloat() passed text that could not have been"
        " tokenized as a float: " << CEscape(text);
   return result;
@@ -0,0 +1,96 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Support for the JSON codecs generated with --json_codec_out.
+
+#ifndef GOOGLE_PROTOBUF_JSON_CODEC_H__
+#define GOOGLE_PROTOBUF_JSON_CODEC_H__
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/io/json_reader.h>
+#include <google/protobuf/io/json_writer.h>
+
+namespace google {
+namespace protobuf {
+
+// JsonCodec<MessageType> is specialized by generated code for each message
+// type reachable from a --json_codec_out target, with the members:
+//
+//   static void Write(const MessageType& message, io::JsonWriter* writer);
+//   static bool Read(io::JsonReader* reader, MessageType* message);
+//
+// Write() omits unset fields and uses the lowerCamelCase names of mock
+// cases, exactly as JsonTranscoder does.  Read() merges into the message,
+// accepting either those names or the .proto field names, and skipping
+// members it doesn't know.  Like MergePartialFromCodedStream(), it doesn't
+// check required fields.
+//
+// Everything about the message type is resolved when the generated code is
+// compiled, so unlike JsonTranscoder, no Descriptor is needed at run time.
+template <typename MessageType>
+struct JsonCodec;
+
+// Convenience wrappers, so that the template argument can be deduced.
+template <typename MessageType>
+inline void WriteJson(const MessageType& message, io::JsonWriter* writer) {
+  JsonCodec<MessageType>::Write(message, writer);
+}
+
+template <typename MessageType>
+inline bool ReadJson(io::JsonReader* reader, MessageType* message) {
+  return JsonCodec<MessageType>::Read(reader, message);
+}
+
+namespace internal {
+
+// One entry of a generated table mapping JSON member names to field
+// indices.  Tables are sorted by name, as compared by memcmp() with shorter
+// names first on a tie.
+struct JsonFieldName {
+  const char* name;
+  int size;
+  int index;
+};
+
+// Looks up a member name in a generated table.  Returns the field index, or
+// -1 if the name is not in the table.
+LIBPROTOBUF_EXPORT int FindJsonField(const JsonFieldName* table,
+                                     int table_size,
+                                     const char* name, int name_size);
+
+}  // namespace internal
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_JSON_CODEC_H__
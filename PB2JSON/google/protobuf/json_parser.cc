@@ -0,0 +1,370 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <google/protobuf/json_parser.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/json_reader.h>
+
+namespace google {
+namespace protobuf {
+
+namespace {
+
+// The same as CodedInputStream's default recursion limit.
+const int kMaxDepth = 64;
+
+inline void AppendVarint32(uint32 value, string* output) {
+  uint8 buffer[5];
+  uint8* end = io::CodedOutputStream::WriteVarint32ToArray(value, buffer);
+  output->append(reinterpret_cast<char*>(buffer), end - buffer);
+}
+
+inline void AppendVarint64(uint64 value, string* output) {
+  uint8 buffer[10];
+  uint8* end = io::CodedOutputStream::WriteVarint64ToArray(value, buffer);
+  output->append(reinterpret_cast<char*>(buffer), end - buffer);
+}
+
+inline void AppendLittleEndian32(uint32 value, string* output) {
+  uint8 buffer[4];
+  io::CodedOutputStream::WriteLittleEndian32ToArray(value, buffer);
+  output->append(reinterpret_cast<char*>(buffer), 4);
+}
+
+inline void AppendLittleEndian64(uint64 value, string* output) {
+  uint8 buffer[8];
+  io::CodedOutputStream::WriteLittleEndian64ToArray(value, buffer);
+  output->append(reinterpret_cast<char*>(buffer), 8);
+}
+
+// A length-delimited value's length isn't known until it has been written,
+// so leave one byte for it, which is enough for values shorter than 128
+// bytes, and make room for more afterwards if need be.  Returns the offset
+// of the value.
+inline int BeginLengthDelimited(string* output) {
+  output->push_back('\0');
+  return output->size();
+}
+
+inline void EndLengthDelimited(int start, string* output) {
+  uint8 buffer[5];
+  int length_size = io::CodedOutputStream::WriteVarint32ToArray(
+      output->size() - start, buffer) - buffer;
+  if (length_size > 1) output->insert(start, length_size - 1, '\0');
+  output->replace(start - 1, length_size,
+                  reinterpret_cast<char*>(buffer), length_size);
+}
+
+}  // namespace
+
+JsonParser::JsonParser(const Descriptor* type) {
+  schema_.AddMessage(type);
+  schema_.BuildNameTables();
+}
+
+JsonParser::~JsonParser() {}
+
+bool JsonParser::Parse(io::JsonReader* reader, Message* message) {
+  GOOGLE_CHECK_EQ(message->GetDescriptor(), schema_.message_descriptor(0));
+  error_.clear();
+  if (!ParseMessage(0, reader, message, 0)) {
+    if (error_.empty()) error_ = reader->error();
+    return false;
+  }
+  return true;
+}
+
+bool JsonParser::ParseMessage(int type, io::JsonReader* reader,
+                              Message* message, int depth) {
+  if (depth > kMaxDepth) {
+    error_ = "Messages are nested too deeply.";
+    return false;
+  }
+
+  if (!reader->BeginObject()) return false;
+  const char* name;
+  int name_size;
+  while (reader->NextName(&name, &name_size)) {
+    // A null member is the same as a missing one.
+    if (reader->ReadNull()) continue;
+
+    int field = schema_.FindFieldByJsonName(type, name, name_size);
+    if (field == -1) {
+      if (!reader->SkipValue()) return false;
+    } else if (schema_.is_repeated(field)) {
+      if (!reader->BeginArray()) return false;
+      while (reader->NextElement()) {
+        if (!ParseValue(field, reader, message, depth)) return false;
+      }
+      if (reader->failed()) return false;
+    } else {
+      if (!ParseValue(field, reader, message, depth)) return false;
+    }
+  }
+  return !reader->failed();
+}
+
+bool JsonParser::ParseValue(int field, io::JsonReader* reader,
+                            Message* message, int depth) {
+  const FieldDescriptor* descriptor = schema_.field_descriptor(field);
+  const Reflection* reflection = message->GetReflection();
+  bool is_repeated = schema_.is_repeated(field);
+
+  switch (descriptor->cpp_type()) {
+#define HANDLE_TYPE(CPPTYPE, TYPE, METHOD)                                    \
+    case FieldDescriptor::CPPTYPE_##CPPTYPE: {                                \
+      TYPE value;                                                             \
+      if (!reader->Read##METHOD(&value)) return false;                        \
+      if (is_repeated) {                                                      \
+        reflection->Add##METHOD(message, descriptor, value);                  \
+      } else {                                                                \
+        reflection->Set##METHOD(message, descriptor, value);                  \
+      }                                                                       \
+      return true;                                                            \
+    }
+
+    HANDLE_TYPE( INT32,  int32,  Int32)
+    HANDLE_TYPE( INT64,  int64,  Int64)
+    HANDLE_TYPE(UINT32, uint32, UInt32)
+    HANDLE_TYPE(UINT64, uint64, UInt64)
+    HANDLE_TYPE(DOUBLE, double, Double)
+    HANDLE_TYPE( FLOAT,  float,  Float)
+    HANDLE_TYPE(  BOOL,   bool,   Bool)
+#undef HANDLE_TYPE
+
+    case FieldDescriptor::CPPTYPE_STRING: {
+      bool success = schema_.type(field) == FieldDescriptor::TYPE_BYTES ?
+                     reader->ReadBytes(&scratch_) :
+                     reader->ReadString(&scratch_);
+      if (!success) return false;
+      if (is_repeated) {
+        reflection->AddString(message, descriptor, scratch_);
+      } else {
+        reflection->SetString(message, descriptor, scratch_);
+      }
+      return true;
+    }
+
+    case FieldDescriptor::CPPTYPE_ENUM: {
+      int32 number;
+      if (!reader->ReadInt32(&number)) return false;
+      const EnumValueDescriptor* value =
+        descriptor->enum_type()->FindValueByNumber(number);
+      if (value == NULL) return true;
+      if (is_repeated) {
+        reflection->AddEnum(message, descriptor, value);
+      } else {
+        reflection->SetEnum(message, descriptor, value);
+      }
+      return true;
+    }
+
+    case FieldDescriptor::CPPTYPE_MESSAGE: {
+      Message* sub_message = is_repeated ?
+        reflection->AddMessage(message, descriptor) :
+        reflection->MutableMessage(message, descriptor);
+      return ParseMessage(schema_.message_type(field), reader, sub_message,
+                          depth + 1);
+    }
+  }
+
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return false;
+}
+
+// -------------------------------------------------------------------
+
+bool JsonParser::ParseToWire(io::JsonReader* reader, string* output) {
+  error_.clear();
+  if (!ParseMessageToWire(0, reader, output, 0)) {
+    if (error_.empty()) error_ = reader->error();
+    return false;
+  }
+  return true;
+}
+
+bool JsonParser::ParseMessageToWire(int type, io::JsonReader* reader,
+                                    string* output, int depth) {
+  if (depth > kMaxDepth) {
+    error_ = "Messages are nested too deeply.";
+    return false;
+  }
+
+  if (!reader->BeginObject()) return false;
+  const char* name;
+  int name_size;
+  while (reader->NextName(&name, &name_size)) {
+    if (reader->ReadNull()) continue;
+
+    int field = schema_.FindFieldByJsonName(type, name, name_size);
+    if (field == -1) {
+      if (!reader->SkipValue()) return false;
+    } else if (schema_.is_repeated(field)) {
+      if (!reader->BeginArray()) return false;
+
+      // The parser expects packed fields to be packed, and an empty array
+      // writes nothing.
+      bool packed = schema_.field_descriptor(field)->options().packed();
+      int tag_start = output->size();
+      int start = 0;
+      if (packed) {
+        AppendVarint32(internal::WireFormatLite::MakeTag(
+                           schema_.number(field),
+                           internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED),
+                       output);
+        start = BeginLengthDelimited(output);
+      }
+      while (reader->NextElement()) {
+        if (!ParseValueToWire(field, packed, reader, output, depth)) {
+          return false;
+        }
+      }
+      if (reader->failed()) return false;
+      if (packed) {
+        if (output->size() == start) {
+          output->resize(tag_start);
+        } else {
+          EndLengthDelimited(start, output);
+        }
+      }
+    } else {
+      if (!ParseValueToWire(field, false, reader, output, depth)) {
+        return false;
+      }
+    }
+  }
+  return !reader->failed();
+}
+
+bool JsonParser::ParseValueToWire(int field, bool packed,
+                                  io::JsonReader* reader, string* output,
+                                  int depth) {
+  typedef internal::WireFormatLite WireFormatLite;
+
+  // Enum values the type doesn't define are dropped, tag and all, so each
+  // case appends the tag only once the value has been read.
+  uint32 tag = packed ? 0 : schema_.tag(field);
+
+  switch (schema_.type(field)) {
+#define HANDLE_TYPE(TYPE, CPPTYPE, METHOD, APPEND, ENCODE)                    \
+    case FieldDescriptor::TYPE_##TYPE: {                                      \
+      CPPTYPE value;                                                          \
+      if (!reader->Read##METHOD(&value)) return false;                        \
+      if (tag != 0) AppendVarint32(tag, output);                              \
+      APPEND(ENCODE, output);                                                 \
+      return true;                                                            \
+    }
+
+    HANDLE_TYPE(   INT32,  int32,  Int32, AppendVarint64,
+                static_cast<uint64>(static_cast<int64>(value)))
+    HANDLE_TYPE(   INT64,  int64,  Int64, AppendVarint64,
+                static_cast<uint64>(value))
+    HANDLE_TYPE(  UINT32, uint32, UInt32, AppendVarint32, value)
+    HANDLE_TYPE(  UINT64, uint64, UInt64, AppendVarint64, value)
+    HANDLE_TYPE(  SINT32,  int32,  Int32, AppendVarint32,
+                WireFormatLite::ZigZagEncode32(value))
+    HANDLE_TYPE(  SINT64,  int64,  Int64, AppendVarint64,
+                WireFormatLite::ZigZagEncode64(value))
+    HANDLE_TYPE( FIXED32, uint32, UInt32, AppendLittleEndian32, value)
+    HANDLE_TYPE( FIXED64, uint64, UInt64, AppendLittleEndian64, value)
+    HANDLE_TYPE(SFIXED32,  int32,  Int32, AppendLittleEndian32,
+                static_cast<uint32>(value))
+    HANDLE_TYPE(SFIXED64,  int64,  Int64, AppendLittleEndian64,
+                static_cast<uint64>(value))
+    HANDLE_TYPE(   FLOAT,  float,  Float, AppendLittleEndian32,
+                WireFormatLite::EncodeFloat(value))
+    HANDLE_TYPE(  DOUBLE, double, Double, AppendLittleEndian64,
+                WireFormatLite::EncodeDouble(value))
+    HANDLE_TYPE(    BOOL,   bool,   Bool, AppendVarint32, value ? 1 : 0)
+#undef HANDLE_TYPE
+
+    case FieldDescriptor::TYPE_ENUM: {
+      int32 number;
+      if (!reader->ReadInt32(&number)) return false;
+      if (schema_.field_descriptor(field)->enum_type()
+              ->FindValueByNumber(number) == NULL) {
+        return true;
+      }
+      if (tag != 0) AppendVarint32(tag, output);
+      AppendVarint64(static_cast<uint64>(static_cast<int64>(number)), output);
+      return true;
+    }
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES: {
+      bool success = schema_.type(field) == FieldDescriptor::TYPE_BYTES ?
+                     reader->ReadBytes(&scratch_) :
+                     reader->ReadString(&scratch_);
+      if (!success) return false;
+      AppendVarint32(tag, output);
+      AppendVarint32(scratch_.size(), output);
+      output->append(scratch_);
+      return true;
+    }
+
+    case FieldDescriptor::TYPE_MESSAGE: {
+      AppendVarint32(tag, output);
+      int start = BeginLengthDelimited(output);
+      if (!ParseMessageToWire(schema_.message_type(field), reader, output,
+                              depth + 1)) {
+        return false;
+      }
+      EndLengthDelimited(start, output);
+      return true;
+    }
+
+    case FieldDescriptor::TYPE_GROUP: {
+      AppendVarint32(tag, output);
+      if (!ParseMessageToWire(schema_.message_type(field), reader, output,
+                              depth + 1)) {
+        return false;
+      }
+      AppendVarint32(WireFormatLite::MakeTag(
+                         schema_.number(field),
+                         WireFormatLite::WIRETYPE_END_GROUP),
+                     output);
+      return true;
+    }
+  }
+
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return false;
+}
+
+}  // namespace protobuf
+
+}  // namespace google
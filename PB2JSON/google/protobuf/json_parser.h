@@ -0,0 +1,117 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Parses JSON into messages of types known only at run time.
+
+#ifndef GOOGLE_PROTOBUF_JSON_PARSER_H__
+#define GOOGLE_PROTOBUF_JSON_PARSER_H__
+
+#include <string>
+#include <google/protobuf/flat_schema.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class Message;               // message.h
+namespace io {
+  class JsonReader;            // json_reader.h
+}
+
+// Reads a JSON object into a Message through reflection, accepting what
+// JsonTranscoder writes and the generated JsonCodecs read:  members named
+// as in the .proto file or in lowerCamelCase, 64-bit and non-finite numbers
+// as strings, and bytes in base64.  Unknown and null members are skipped,
+// and enum numbers the enum type doesn't define are dropped, as the wire
+// format parser drops them.  Like JsonCodec<>::Read(), Parse() merges into
+// the message and doesn't check required fields.
+//
+// Member names are looked up where they lie in the input, in the perfect
+// hash tables of a FlatSchema built once by the constructor, so reuse a
+// JsonParser for many messages of the same type.
+//
+// ParseToWire() skips the Message altogether and writes the wire format as
+// it reads, which is what converting JSON to binary in bulk wants.
+//
+// Example:
+//   JsonParser parser(CgiF2FPaySucPageResp::descriptor());
+//   io::JsonReader reader(json.data(), json.size());
+//   if (!parser.Parse(&reader, &message) || !reader.ExpectAtEnd()) { ... }
+class LIBPROTOBUF_EXPORT JsonParser {
+ public:
+  // The given type must outlive the JsonParser.
+  explicit JsonParser(const Descriptor* type);
+  ~JsonParser();
+
+  // Reads one JSON object and merges it into *message, which must be of the
+  // parser's type.  Returns false if the input isn't valid JSON, doesn't
+  // match the type or nests too deeply; error() then says why.  Some fields
+  // may already have been set.
+  bool Parse(io::JsonReader* reader, Message* message);
+
+  // Reads one JSON object and appends its wire format to *output, without
+  // building a message.  Fields are written in the order they appear in the
+  // input, so the output needn't be what serializing the message would give,
+  // but parsing it gives the same message as Parse() would.  Returns false as
+  // Parse() does, in which case part of the message may have been appended.
+  bool ParseToWire(io::JsonReader* reader, string* output);
+
+  const string& error() const { return error_; }
+
+ private:
+  bool ParseMessage(int type, io::JsonReader* reader, Message* message,
+                    int depth);
+
+  // Reads one value of the field and sets or adds it.
+  bool ParseValue(int field, io::JsonReader* reader, Message* message,
+                  int depth);
+
+  bool ParseMessageToWire(int type, io::JsonReader* reader, string* output,
+                          int depth);
+
+  // Reads one value of the field and appends it, preceded by its tag unless
+  // it is part of a packed array.
+  bool ParseValueToWire(int field, bool packed, io::JsonReader* reader,
+                        string* output, int depth);
+
+  FlatSchema schema_;  // The parser's type is message 0.
+  string error_;
+  string scratch_;     // For string and bytes values.
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(JsonParser);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_JSON_PARSER_H__
@@ -0,0 +1,508 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <algorithm>
+
+#include <google/protobuf/json_transcoder.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/field_projection.h>
+#include <google/protobuf/flat_schema.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/json_writer.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+using internal::WireFormat;
+using internal::WireFormatLite;
+
+namespace {
+
+// Reads one value of a field of the given type, which is neither a message
+// nor an enum, and writes it.  Strings and bytes are copied a buffer at a
+// time straight from the input rather than read into a string.
+bool TranscodeScalar(FieldDescriptor::Type type, io::CodedInputStream* input,
+                     io::JsonWriter* writer) {
+  switch (type) {
+#define HANDLE_TYPE(TYPE, CPPTYPE, READ_METHOD, WRITE_METHOD)                 \
+    case FieldDescriptor::TYPE_##TYPE: {                                      \
+      CPPTYPE value;                                                          \
+      if (!WireFormatLite::Read##READ_METHOD(input, &value)) return false;    \
+      writer->WRITE_METHOD(value);                                            \
+      return true;                                                            \
+    }
+
+    HANDLE_TYPE( INT32,  int32,  Int32, Int32)
+    HANDLE_TYPE( INT64,  int64,  Int64, Int64)
+    HANDLE_TYPE(SINT32,  int32, SInt32, Int32)
+    HANDLE_TYPE(SINT64,  int64, SInt64, Int64)
+    HANDLE_TYPE(UINT32, uint32, UInt32, UInt32)
+    HANDLE_TYPE(UINT64, uint64, UInt64, UInt64)
+
+    HANDLE_TYPE( FIXED32, uint32,  Fixed32, UInt32)
+    HANDLE_TYPE( FIXED64, uint64,  Fixed64, UInt64)
+    HANDLE_TYPE(SFIXED32,  int32, SFixed32, Int32)
+    HANDLE_TYPE(SFIXED64,  int64, SFixed64, Int64)
+
+    HANDLE_TYPE(FLOAT , float , Float , Float )
+    HANDLE_TYPE(DOUBLE, double, Double, Double)
+
+    HANDLE_TYPE(BOOL, bool, Bool, Bool)
+#undef HANDLE_TYPE
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES:
+      break;
+
+    case FieldDescriptor::TYPE_ENUM:
+    case FieldDescriptor::TYPE_GROUP:
+    case FieldDescriptor::TYPE_MESSAGE:
+      GOOGLE_LOG(FATAL) << "Can't get here.";
+      return false;
+  }
+
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+
+  bool is_bytes = type == FieldDescriptor::TYPE_BYTES;
+  if (is_bytes) {
+    writer->BeginBytes();
+  } else {
+    writer->BeginString();
+  }
+
+  while (length > 0) {
+    const void* data;
+    int size;
+    if (!input->GetDirectBufferPointer(&data, &size)) return false;
+    int chunk = min(static_cast<uint32>(size), length);
+    if (is_bytes) {
+      writer->AppendBytes(reinterpret_cast<const char*>(data), chunk);
+    } else {
+      writer->AppendString(reinterpret_cast<const char*>(data), chunk);
+    }
+    input->Skip(chunk);
+    length -= chunk;
+  }
+
+  if (is_bytes) {
+    writer->EndBytes();
+  } else {
+    writer->EndString();
+  }
+  return true;
+}
+
+// Whether a field of the given type and label with the given wire type is
+// packed, and if not, whether the wire type is the right one.  The parser
+// treats a field with the wrong wire type as unknown.
+bool CheckWireType(FieldDescriptor::Type type, bool is_repeated,
+                   WireFormatLite::WireType wire_type, bool* is_packed) {
+  WireFormatLite::WireType expected = WireFormat::WireTypeForFieldType(type);
+  *is_packed = is_repeated &&
+               wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED &&
+               expected != WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+  return *is_packed || wire_type == expected;
+}
+
+}  // namespace
+
+JsonTranscoder::JsonTranscoder(const Descriptor* type)
+  : schema_(new FlatSchema),
+    projection_(NULL),
+    preserve_proto_field_names_(false),
+    enums_as_names_(false),
+    out_of_order_(false),
+    input_(NULL),
+    writer_(NULL) {
+  schema_->AddMessage(type);
+}
+
+JsonTranscoder::~JsonTranscoder() {}
+
+// ===================================================================
+
+bool JsonTranscoder::Transcode(io::CodedInputStream* input,
+                               io::ZeroCopyOutputStream* output) {
+  io::JsonWriter writer(output);
+  input_ = input;
+  writer_ = &writer;
+  out_of_order_ = false;
+  stack_.clear();
+  seen_.clear();
+
+  PushFrame(0, projection_, 0, 0);
+
+  bool success = true;
+  while (!stack_.empty()) {
+    uint32 tag = input_->ReadTag();
+    const Frame& frame = stack_.back();
+
+    if (tag == 0) {
+      // End of input, or of the innermost length-delimited message.  (A
+      // literal zero tag is invalid and is caught by
+      // ConsumedEntireMessage().)
+      if (!input_->ConsumedEntireMessage() || frame.group_number != 0) {
+        success = false;
+        break;
+      }
+      if (stack_.size() == 1) {
+        PopFrame();
+      } else {
+        io::CodedInputStream::Limit limit = frame.limit;
+        PopFrame();
+        input_->PopLimit(limit);
+        input_->DecrementRecursionDepth();
+      }
+      continue;
+    }
+
+    if (WireFormatLite::GetTagWireType(tag) ==
+        WireFormatLite::WIRETYPE_END_GROUP) {
+      if (frame.group_number != WireFormatLite::GetTagFieldNumber(tag)) {
+        success = false;
+        break;
+      }
+      PopFrame();
+      input_->DecrementRecursionDepth();
+      continue;
+    }
+
+    // Extensions and unknown fields are not looked up, and so are skipped
+    // like fields outside the projection.
+    int field = schema_->FindFieldByNumber(
+        frame.type, WireFormatLite::GetTagFieldNumber(tag));
+    if (field != -1 && frame.projection != NULL &&
+        !frame.projection->Includes(schema_->field_descriptor(field))) {
+      field = -1;
+    }
+
+    if (!TranscodeField(tag, field)) {
+      success = false;
+      break;
+    }
+  }
+
+  input_ = NULL;
+  writer_ = NULL;
+  return success && !writer.failed();
+}
+
+void JsonTranscoder::PushFrame(int type, const FieldProjection* projection,
+                               io::CodedInputStream::Limit limit,
+                               int group_number) {
+  Frame frame;
+  frame.type = type;
+  frame.projection = projection;
+  frame.limit = limit;
+  frame.group_number = group_number;
+  frame.open_array = -1;
+  frame.seen_start = seen_.size();
+  seen_.resize(seen_.size() + schema_->field_count(type), false);
+  stack_.push_back(frame);
+  writer_->BeginObject();
+}
+
+void JsonTranscoder::PopFrame() {
+  if (stack_.back().open_array != -1) writer_->EndArray();
+  writer_->EndObject();
+  seen_.resize(stack_.back().seen_start);
+  stack_.pop_back();
+}
+
+// -------------------------------------------------------------------
+
+bool JsonTranscoder::TranscodeField(uint32 tag, int field) {
+  // Most fields have their usual wire type, which the precomputed tag
+  // checks at once.
+  bool is_packed = false;
+  if (field == -1 ||
+      (tag != schema_->tag(field) &&
+       !CheckWireType(schema_->type(field), schema_->is_repeated(field),
+                      WireFormatLite::GetTagWireType(tag), &is_packed))) {
+    return WireFormat::SkipField(input_, tag, NULL);
+  }
+
+  Frame& frame = stack_.back();
+  if (field != frame.open_array) {
+    if (frame.open_array != -1) {
+      writer_->EndArray();
+      frame.open_array = -1;
+    }
+
+    int seen_index =
+      frame.seen_start + field - schema_->first_field(frame.type);
+    if (seen_[seen_index]) {
+      // A repeated field which isn't contiguous, or a singular field which
+      // appears twice (and so would need merging).  Neither can be streamed.
+      out_of_order_ = true;
+      return false;
+    }
+    seen_[seen_index] = true;
+
+    writer_->Name(preserve_proto_field_names_ ? schema_->name(field)
+                                              : schema_->json_name(field));
+    if (schema_->is_repeated(field)) {
+      writer_->BeginArray();
+      frame.open_array = field;
+    }
+  }
+
+  if (is_packed) {
+    uint32 length;
+    if (!input_->ReadVarint32(&length)) return false;
+    io::CodedInputStream::Limit limit = input_->PushLimit(length);
+    while (input_->BytesUntilLimit() > 0) {
+      if (!TranscodeValue(field)) return false;
+    }
+    input_->PopLimit(limit);
+    return true;
+  }
+
+  int message_type = schema_->message_type(field);
+  if (message_type == -1) {
+    return TranscodeValue(field);
+  }
+
+  // Messages are read by the main loop in Transcode(), after we push a
+  // frame for them.
+  const FieldProjection* sub_projection =
+    frame.projection == NULL ? NULL :
+    frame.projection->GetSubProjection(schema_->field_descriptor(field));
+  if (!input_->IncrementRecursionDepth()) return false;
+  if (schema_->type(field) == FieldDescriptor::TYPE_GROUP) {
+    PushFrame(message_type, sub_projection, 0, schema_->number(field));
+  } else {
+    uint32 length;
+    if (!input_->ReadVarint32(&length)) return false;
+    PushFrame(message_type, sub_projection, input_->PushLimit(length), 0);
+  }
+  return true;
+}
+
+bool JsonTranscoder::TranscodeValue(int field) {
+  if (schema_->type(field) != FieldDescriptor::TYPE_ENUM) {
+    return TranscodeScalar(schema_->type(field), input_, writer_);
+  }
+
+  int value;
+  if (!WireFormatLite::ReadEnum(input_, &value)) return false;
+  const EnumValueDescriptor* enum_value = enums_as_names_ ?
+    schema_->field_descriptor(field)->enum_type()->FindValueByNumber(value) :
+    NULL;
+  if (enum_value != NULL) {
+    writer_->String(enum_value->name());
+  } else {
+    writer_->Int32(value);
+  }
+  return true;
+}
+
+// ===================================================================
+
+SchemaImageTranscoder::SchemaImageTranscoder(const SchemaImage* image,
+                                             int type)
+  : image_(image),
+    type_(type),
+    preserve_proto_field_names_(false),
+    enums_as_names_(false),
+    out_of_order_(false),
+    input_(NULL),
+    writer_(NULL) {
+}
+
+SchemaImageTranscoder::~SchemaImageTranscoder() {}
+
+// The same as JsonTranscoder::Transcode(), with the fields looked up in the
+// image.
+bool SchemaImageTranscoder::Transcode(io::CodedInputStream* input,
+                                      io::ZeroCopyOutputStream* output) {
+  io::JsonWriter writer(output);
+  input_ = input;
+  writer_ = &writer;
+  out_of_order_ = false;
+  stack_.clear();
+  seen_.clear();
+
+  PushFrame(type_, 0, 0);
+
+  bool success = true;
+  SchemaImage::Field field;
+  while (!stack_.empty()) {
+    uint32 tag = input_->ReadTag();
+    const Frame& frame = stack_.back();
+
+    if (tag == 0) {
+      if (!input_->ConsumedEntireMessage() || frame.group_number != 0) {
+        success = false;
+        break;
+      }
+      if (stack_.size() == 1) {
+        PopFrame();
+      } else {
+        io::CodedInputStream::Limit limit = frame.limit;
+        PopFrame();
+        input_->PopLimit(limit);
+        input_->DecrementRecursionDepth();
+      }
+      continue;
+    }
+
+    if (WireFormatLite::GetTagWireType(tag) ==
+        WireFormatLite::WIRETYPE_END_GROUP) {
+      if (frame.group_number != WireFormatLite::GetTagFieldNumber(tag)) {
+        success = false;
+        break;
+      }
+      PopFrame();
+      input_->DecrementRecursionDepth();
+      continue;
+    }
+
+    bool found = image_->FindFieldByNumber(
+        frame.type, WireFormatLite::GetTagFieldNumber(tag), &field);
+    if (!TranscodeField(tag, found ? &field : NULL)) {
+      success = false;
+      break;
+    }
+  }
+
+  input_ = NULL;
+  writer_ = NULL;
+  return success && !writer.failed();
+}
+
+void SchemaImageTranscoder::PushFrame(int type,
+                                      io::CodedInputStream::Limit limit,
+                                      int group_number) {
+  Frame frame;
+  frame.type = type;
+  frame.limit = limit;
+  frame.group_number = group_number;
+  frame.open_array = 0;
+  frame.seen_start = seen_.size();
+  seen_.resize(seen_.size() + image_->field_count(type), false);
+  stack_.push_back(frame);
+  writer_->BeginObject();
+}
+
+void SchemaImageTranscoder::PopFrame() {
+  if (stack_.back().open_array != 0) writer_->EndArray();
+  writer_->EndObject();
+  seen_.resize(stack_.back().seen_start);
+  stack_.pop_back();
+}
+
+bool SchemaImageTranscoder::TranscodeField(uint32 tag,
+                                           const SchemaImage::Field* field) {
+  bool is_packed;
+  if (field == NULL ||
+      !CheckWireType(field->type, field->is_repeated,
+                     WireFormatLite::GetTagWireType(tag), &is_packed)) {
+    return WireFormat::SkipField(input_, tag, NULL);
+  }
+
+  Frame& frame = stack_.back();
+  if (field->number != frame.open_array) {
+    if (frame.open_array != 0) {
+      writer_->EndArray();
+      frame.open_array = 0;
+    }
+
+    int seen_index = frame.seen_start + field->index;
+    if (seen_[seen_index]) {
+      out_of_order_ = true;
+      return false;
+    }
+    seen_[seen_index] = true;
+
+    if (preserve_proto_field_names_) {
+      writer_->Name(field->name, field->name_size);
+    } else {
+      writer_->Name(field->json_name, field->json_name_size);
+    }
+    if (field->is_repeated) {
+      writer_->BeginArray();
+      frame.open_array = field->number;
+    }
+  }
+
+  if (is_packed) {
+    uint32 length;
+    if (!input_->ReadVarint32(&length)) return false;
+    io::CodedInputStream::Limit limit = input_->PushLimit(length);
+    while (input_->BytesUntilLimit() > 0) {
+      if (!TranscodeValue(*field)) return false;
+    }
+    input_->PopLimit(limit);
+    return true;
+  }
+
+  if (field->message_type < 0) {
+    return TranscodeValue(*field);
+  }
+
+  if (!input_->IncrementRecursionDepth()) return false;
+  if (field->type == FieldDescriptor::TYPE_GROUP) {
+    PushFrame(field->message_type, 0, field->number);
+  } else {
+    uint32 length;
+    if (!input_->ReadVarint32(&length)) return false;
+    PushFrame(field->message_type, input_->PushLimit(length), 0);
+  }
+  return true;
+}
+
+bool SchemaImageTranscoder::TranscodeValue(const SchemaImage::Field& field) {
+  if (field.type != FieldDescriptor::TYPE_ENUM) {
+    return TranscodeScalar(field.type, input_, writer_);
+  }
+
+  int value;
+  if (!WireFormatLite::ReadEnum(input_, &value)) return false;
+  const char* name;
+  int name_size;
+  if (enums_as_names_ &&
+      image_->FindEnumValueName(field.enum_type, value, &name, &name_size)) {
+    writer_->String(name, name_size);
+  } else {
+    writer_->Int32(value);
+  }
+  return true;
+}
+
+}  // namespace protobuf
+}  // namespace google
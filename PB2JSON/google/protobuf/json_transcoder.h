@@ -0,0 +1,221 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Converts protocol messages in wire format directly to JSON, without
+// parsing them into Message objects first.
+
+#ifndef GOOGLE_PROTOBUF_JSON_TRANSCODER_H__
+#define GOOGLE_PROTOBUF_JSON_TRANSCODER_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/schema_image.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/io/coded_stream.h>
+
+namespace google {
+namespace protobuf {
+
+class Descriptor;            // descriptor.h
+class FieldDescriptor;       // descriptor.h
+class FieldProjection;       // field_projection.h
+class FlatSchema;            // flat_schema.h
+namespace io {
+  class ZeroCopyOutputStream;  // zero_copy_stream.h
+  class JsonWriter;            // json_writer.h
+}
+
+// Reads a serialized message of a given type and writes it out as a JSON
+// object as it goes.  Nested messages are tracked on an explicit stack, and
+// strings and bytes are copied straight from the input buffer to the output
+// buffer, so memory use depends only on the nesting depth, not on the size
+// of the message.
+//
+// Field names are converted to lowerCamelCase the same way the mock case
+// generator converts them ("is_show_btn" becomes "isShowBtn"), so keys in
+// the output match the keys of mock cases.  Unknown fields and extensions are
+// skipped.  Unset fields are omitted, not written with default values.
+//
+// Since JSON objects can't repeat a key, streaming requires that each field
+// appear in the input at most once, or, if repeated, in one contiguous run.
+// Every serializer in this library writes fields that way, but the wire
+// format doesn't require it.  When the input breaks that rule, Transcode()
+// fails and out_of_order() returns true; the caller can then parse the
+// input into a Message, re-serialize it, and transcode that instead.
+//
+// Example:
+//   JsonTranscoder transcoder(CgiF2FPaySucPageResp::descriptor());
+//   io::CodedInputStream input(&raw_input);
+//   if (!transcoder.Transcode(&input, &output)) { ... }
+class LIBPROTOBUF_EXPORT JsonTranscoder {
+ public:
+  // The given type must outlive the JsonTranscoder.
+  explicit JsonTranscoder(const Descriptor* type);
+  ~JsonTranscoder();
+
+  // Write field names exactly as they appear in the .proto file instead of
+  // converting them to lowerCamelCase.  Default is false.
+  void SetPreserveProtoFieldNames(bool value) {
+    preserve_proto_field_names_ = value;
+  }
+
+  // Write enum values as their names rather than their numbers.  Values
+  // with no name in the enum type are always written as numbers.  Default
+  // is false, matching the mock case generator.
+  void SetEnumsAsNames(bool value) {
+    enums_as_names_ = value;
+  }
+
+  // Only write the fields selected by the given projection; everything else
+  // is skipped at the wire level.  The projection must be rooted at the
+  // transcoder's type and must outlive any calls to Transcode().  NULL (the
+  // default) writes all fields.
+  void SetProjection(const FieldProjection* projection) {
+    projection_ = projection;
+  }
+
+  // Reads one message from the input, which must contain nothing else, and
+  // writes it to the output.  Returns false if the input is not a valid
+  // message of the transcoder's type, if it is not in the order described
+  // above, or if writing fails.  In all those cases some output may already
+  // have been written.
+  bool Transcode(io::CodedInputStream* input,
+                 io::ZeroCopyOutputStream* output);
+
+  // After Transcode() fails, true if the only problem was field order.
+  bool out_of_order() const { return out_of_order_; }
+
+ private:
+  // A message or group which has been opened in the output but not yet
+  // closed.
+  // Types and fields are indexes into schema_.
+  struct Frame {
+    int type;
+    const FieldProjection* projection;  // NULL = all fields.
+    io::CodedInputStream::Limit limit;  // For length-delimited messages.
+    int group_number;                   // For groups; 0 otherwise.
+    int open_array;                     // Repeated field being written, or
+                                        // -1.
+    int seen_start;                     // This frame's part of seen_.
+  };
+
+  // Opens or closes a frame, writing the braces for it.
+  void PushFrame(int type, const FieldProjection* projection,
+                 io::CodedInputStream::Limit limit, int group_number);
+  void PopFrame();
+
+  // Handles one field of the innermost frame, whose tag has already been
+  // read.  field is -1 for fields to skip.  Message and group fields push a
+  // new frame rather than being read here.
+  bool TranscodeField(uint32 tag, int field);
+
+  // Reads one value of the given non-message field and writes it.
+  bool TranscodeValue(int field);
+
+  // The transcoder's type and everything it contains, with their JSON
+  // names.  The type itself is message 0.
+  scoped_ptr<FlatSchema> schema_;
+  const FieldProjection* projection_;
+  bool preserve_proto_field_names_;
+  bool enums_as_names_;
+  bool out_of_order_;
+
+  // Reused between calls so that Transcode() doesn't allocate once warm.
+  vector<Frame> stack_;
+  vector<bool> seen_;  // Indexed by seen_start + FieldDescriptor::index().
+
+  // Valid only during Transcode().
+  io::CodedInputStream* input_;
+  io::JsonWriter* writer_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(JsonTranscoder);
+};
+
+// Like JsonTranscoder, but for a message type of a SchemaImage, so that
+// transcoding needs neither .proto files nor a DescriptorPool.  The output
+// is the same as JsonTranscoder's for the type the image was written from.
+// Projections aren't supported.
+class LIBPROTOBUF_EXPORT SchemaImageTranscoder {
+ public:
+  // type is an index returned by SchemaImage::FindMessage().  The image must
+  // outlive the SchemaImageTranscoder.
+  SchemaImageTranscoder(const SchemaImage* image, int type);
+  ~SchemaImageTranscoder();
+
+  // See JsonTranscoder.
+  void SetPreserveProtoFieldNames(bool value) {
+    preserve_proto_field_names_ = value;
+  }
+  void SetEnumsAsNames(bool value) {
+    enums_as_names_ = value;
+  }
+  bool Transcode(io::CodedInputStream* input,
+                 io::ZeroCopyOutputStream* output);
+  bool out_of_order() const { return out_of_order_; }
+
+ private:
+  struct Frame {
+    int type;
+    io::CodedInputStream::Limit limit;  // For length-delimited messages.
+    int group_number;                   // For groups; 0 otherwise.
+    int open_array;                     // Number of the repeated field being
+                                        // written; 0 if none.
+    int seen_start;                     // This frame's part of seen_.
+  };
+
+  void PushFrame(int type, io::CodedInputStream::Limit limit,
+                 int group_number);
+  void PopFrame();
+  bool TranscodeField(uint32 tag, const SchemaImage::Field* field);
+  bool TranscodeValue(const SchemaImage::Field& field);
+
+  const SchemaImage* image_;
+  int type_;
+  bool preserve_proto_field_names_;
+  bool enums_as_names_;
+  bool out_of_order_;
+
+  vector<Frame> stack_;
+  vector<bool> seen_;  // Indexed by seen_start + SchemaImage::Field::index.
+
+  // Valid only during Transcode().
+  io::CodedInputStream* input_;
+  io::JsonWriter* writer_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(SchemaImageTranscoder);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_JSON_TRANSCODER_H__
@@ -0,0 +1,391 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <string.h>
+#include <algorithm>
+
+#include <google/protobuf/memory_report.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/unknown_field_set.h>
+#include <google/protobuf/io/json_writer.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/stl_util-inl.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+
+namespace {
+
+bool TypeHoldsMore(const MemoryReport::TypeUsage* a,
+                   const MemoryReport::TypeUsage* b) {
+  if (a->bytes() != b->bytes()) return a->bytes() > b->bytes();
+  return a->type->full_name() < b->type->full_name();
+}
+
+bool FieldHoldsMore(const MemoryReport::FieldUsage* a,
+                    const MemoryReport::FieldUsage* b) {
+  if (a->total_bytes != b->total_bytes) return a->total_bytes > b->total_bytes;
+  return a->field->number() < b->field->number();
+}
+
+// The fields of the type which ever held anything, in report order.
+void GetUsedFields(const MemoryReport::TypeUsage& usage,
+                   vector<const MemoryReport::FieldUsage*>* fields) {
+  for (int i = 0; i < usage.fields.size(); i++) {
+    if (usage.fields[i].present > 0 || usage.fields[i].total_bytes > 0) {
+      fields->push_back(&usage.fields[i]);
+    }
+  }
+  stable_sort(fields->begin(), fields->end(), FieldHoldsMore);
+}
+
+string FieldName(const FieldDescriptor* field) {
+  return field->is_extension() ? "[" + field->full_name() + "]" :
+                                 field->name();
+}
+
+// Formats part / total as a percentage with one decimal.
+string FormatShare(int64 part, int64 total) {
+  int64 tenths = total > 0 ? (part * 1000 + total / 2) / total : 0;
+  return SimpleItoa(tenths / 10) + "." + SimpleItoa(tenths % 10) + "%";
+}
+
+// Appends the columns right-aligned to the given widths, then the name.
+void AppendRow(const string* columns, const int* widths, int count,
+               const string& name, string* output) {
+  for (int i = 0; i < count; i++) {
+    if (columns[i].size() < widths[i]) {
+      output->append(widths[i] - columns[i].size(), ' ');
+    }
+    output->append(columns[i]);
+    output->append("  ");
+  }
+  output->append(name);
+  output->push_back('\n');
+}
+
+const int kColumnCount = 6;
+const int kColumnWidths[kColumnCount] = { 12, 6, 10, 12, 10, 10 };
+
+void WriteInt64(io::JsonWriter* writer, const char* name, int64 value) {
+  writer->Name(name, strlen(name));
+  writer->Int64(value);
+}
+
+}  // namespace
+
+MemoryReport::MemoryReport() : message_count_(0) {
+  pool_usage_.descriptors = 0;
+  pool_usage_.strings = 0;
+  pool_usage_.options = 0;
+  pool_usage_.tables = 0;
+}
+
+MemoryReport::~MemoryReport() {
+  STLDeleteValues(&types_);
+}
+
+void MemoryReport::AddMessage(const Message& message) {
+  ++message_count_;
+  AddMessageTree(message);
+}
+
+void MemoryReport::AddPool(const DescriptorPool* pool) {
+  DescriptorPool::SpaceUsage usage;
+  pool->GetSpaceUsage(&usage);
+  pool_usage_.descriptors += usage.descriptors;
+  pool_usage_.strings += usage.strings;
+  pool_usage_.options += usage.options;
+  pool_usage_.tables += usage.tables;
+}
+
+int64 MemoryReport::message_bytes() const {
+  int64 total = 0;
+  for (TypeMap::const_iterator iter = types_.begin();
+       iter != types_.end(); ++iter) {
+    total += iter->second->bytes();
+  }
+  return total;
+}
+
+int64 MemoryReport::pool_bytes() const {
+  return static_cast<int64>(pool_usage_.descriptors) + pool_usage_.strings +
+         pool_usage_.options + pool_usage_.tables;
+}
+
+void MemoryReport::GetTypes(vector<const TypeUsage*>* types) const {
+  for (TypeMap::const_iterator iter = types_.begin();
+       iter != types_.end(); ++iter) {
+    types->push_back(iter->second);
+  }
+  sort(types->begin(), types->end(), TypeHoldsMore);
+}
+
+// -------------------------------------------------------------------
+
+MemoryReport::TypeUsage* MemoryReport::FindOrAddType(const Message& message) {
+  const Descriptor* type = message.GetDescriptor();
+  TypeUsage*& usage = types_[type];
+  if (usage == NULL) {
+    usage = new TypeUsage;
+    usage->type = type;
+    usage->instances = 0;
+    usage->object_bytes = 0;
+    usage->field_bytes = 0;
+    usage->slack = 0;
+    usage->unknown_field_bytes = 0;
+
+    // A new instance has nothing outside the object, so its SpaceUsed() is
+    // the object alone.
+    scoped_ptr<Message> empty(message.New());
+    usage->object_size = empty->SpaceUsed();
+
+    usage->fields.resize(type->field_count());
+    for (int i = 0; i < type->field_count(); i++) {
+      FieldUsage* field = &usage->fields[i];
+      field->field = type->field(i);
+      field->present = 0;
+      field->bytes = 0;
+      field->slack = 0;
+      field->total_bytes = 0;
+    }
+  }
+  return usage;
+}
+
+int64 MemoryReport::AddMessageTree(const Message& message) {
+  const Reflection* reflection = message.GetReflection();
+  TypeUsage* usage = FindOrAddType(message);
+  const Descriptor* type = usage->type;
+
+  int unknown_field_bytes =
+      reflection->GetUnknownFields(message).SpaceUsedExcludingSelf();
+  ++usage->instances;
+  usage->object_bytes += usage->object_size;
+  usage->unknown_field_bytes += unknown_field_bytes;
+  int64 total = usage->object_size + unknown_field_bytes;
+
+  // Go through every field rather than ListFields(), as a repeated field
+  // which has been emptied can still hold its array.
+  for (int i = 0; i < type->field_count(); i++) {
+    total += AddField(message, type->field(i), usage, i);
+  }
+
+  if (type->extension_range_count() > 0) {
+    vector<const FieldDescriptor*> fields;
+    reflection->ListFields(message, &fields);
+    for (int i = 0; i < fields.size(); i++) {
+      if (!fields[i]->is_extension()) continue;
+      int index = type->field_count();
+      while (index < usage->fields.size() &&
+             usage->fields[index].field != fields[i]) {
+        ++index;
+      }
+      if (index == usage->fields.size()) {
+        FieldUsage field;
+        field.field = fields[i];
+        field.present = 0;
+        field.bytes = 0;
+        field.slack = 0;
+        field.total_bytes = 0;
+        usage->fields.push_back(field);
+      }
+      total += AddField(message, fields[i], usage, index);
+    }
+  }
+
+  return total;
+}
+
+int64 MemoryReport::AddField(const Message& message,
+                             const FieldDescriptor* field,
+                             TypeUsage* usage, int index) {
+  const Reflection* reflection = message.GetReflection();
+  int slack;
+  int bytes = reflection->SpaceUsedByField(message, field, &slack);
+  int64 total = bytes;
+
+  bool present;
+  if (field->is_repeated()) {
+    int size = reflection->FieldSize(message, field);
+    present = size > 0;
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      for (int i = 0; i < size; i++) {
+        total += AddMessageTree(
+            reflection->GetRepeatedMessage(message, field, i));
+      }
+    }
+  } else {
+    present = reflection->HasField(message, field);
+    if (present && field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      total += AddMessageTree(reflection->GetMessage(message, field));
+    }
+  }
+  if (!present && total == 0) return 0;
+
+  // AddMessageTree() may have added extensions to usage->fields, so only
+  // look the field up now.
+  FieldUsage* field_usage = &usage->fields[index];
+  if (present) ++field_usage->present;
+  field_usage->bytes += bytes;
+  field_usage->slack += slack;
+  field_usage->total_bytes += total;
+  usage->field_bytes += bytes;
+  usage->slack += slack;
+  return total;
+}
+
+// -------------------------------------------------------------------
+
+void MemoryReport::ToText(string* output) const {
+  int64 total_bytes = message_bytes();
+  int64 slack = 0;
+  int64 unknown_field_bytes = 0;
+  for (TypeMap::const_iterator iter = types_.begin();
+       iter != types_.end(); ++iter) {
+    slack += iter->second->slack;
+    unknown_field_bytes += iter->second->unknown_field_bytes;
+  }
+
+  output->append("messages: " + SimpleItoa(message_count_) + "\n");
+  output->append("message bytes: " + SimpleItoa(total_bytes) +
+                 " (slack " + SimpleItoa(slack) +
+                 ", unknown fields " + SimpleItoa(unknown_field_bytes) +
+                 ")\n");
+  output->append("descriptor bytes: " + SimpleItoa(pool_bytes()) +
+                 " (descriptors " + SimpleItoa(pool_usage_.descriptors) +
+                 ", strings " + SimpleItoa(pool_usage_.strings) +
+                 ", options " + SimpleItoa(pool_usage_.options) +
+                 ", tables " + SimpleItoa(pool_usage_.tables) + ")\n");
+  if (types_.empty()) return;
+
+  // One row per type, then one per field under it.  A field's "count" is the
+  // number of instances in which it was present, and for message fields its
+  // "total" includes the sub-messages.
+  output->push_back('\n');
+  const string kHeaders[kColumnCount] = {
+    "bytes", "share", "count", "total", "slack", "unknown"
+  };
+  AppendRow(kHeaders, kColumnWidths, kColumnCount, "type / .field", output);
+
+  vector<const TypeUsage*> types;
+  GetTypes(&types);
+  for (int i = 0; i < types.size(); i++) {
+    const TypeUsage& usage = *types[i];
+    string columns[kColumnCount] = {
+      SimpleItoa(usage.bytes()),
+      FormatShare(usage.bytes(), total_bytes),
+      SimpleItoa(usage.instances),
+      "",
+      SimpleItoa(usage.slack),
+      SimpleItoa(usage.unknown_field_bytes)
+    };
+    AppendRow(columns, kColumnWidths, kColumnCount,
+              usage.type->full_name(), output);
+
+    vector<const FieldUsage*> fields;
+    GetUsedFields(usage, &fields);
+    for (int j = 0; j < fields.size(); j++) {
+      const FieldUsage& field = *fields[j];
+      string columns[kColumnCount] = {
+        SimpleItoa(field.bytes),
+        FormatShare(field.bytes, total_bytes),
+        SimpleItoa(field.present),
+        field.field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE ?
+            SimpleItoa(field.total_bytes) : "",
+        SimpleItoa(field.slack),
+        ""
+      };
+      AppendRow(columns, kColumnWidths, kColumnCount,
+                "  ." + FieldName(field.field), output);
+    }
+  }
+}
+
+void MemoryReport::ToJson(string* output) const {
+  io::StringOutputStream stream(output);
+  io::JsonWriter writer(&stream);
+  writer.BeginObject();
+  WriteInt64(&writer, "messages", message_count_);
+  WriteInt64(&writer, "messageBytes", message_bytes());
+
+  writer.Name("descriptorPool");
+  writer.BeginObject();
+  WriteInt64(&writer, "bytes", pool_bytes());
+  WriteInt64(&writer, "descriptors", pool_usage_.descriptors);
+  WriteInt64(&writer, "strings", pool_usage_.strings);
+  WriteInt64(&writer, "options", pool_usage_.options);
+  WriteInt64(&writer, "tables", pool_usage_.tables);
+  writer.EndObject();
+
+  writer.Name("types");
+  writer.BeginArray();
+  vector<const TypeUsage*> types;
+  GetTypes(&types);
+  for (int i = 0; i < types.size(); i++) {
+    const TypeUsage& usage = *types[i];
+    writer.BeginObject();
+    writer.Name("type");
+    writer.String(usage.type->full_name());
+    WriteInt64(&writer, "instances", usage.instances);
+    WriteInt64(&writer, "bytes", usage.bytes());
+    WriteInt64(&writer, "objectBytes", usage.object_bytes);
+    WriteInt64(&writer, "fieldBytes", usage.field_bytes);
+    WriteInt64(&writer, "slack", usage.slack);
+    WriteInt64(&writer, "unknownFieldBytes", usage.unknown_field_bytes);
+
+    writer.Name("fields");
+    writer.BeginArray();
+    vector<const FieldUsage*> fields;
+    GetUsedFields(usage, &fields);
+    for (int j = 0; j < fields.size(); j++) {
+      const FieldUsage& field = *fields[j];
+      writer.BeginObject();
+      writer.Name("field");
+      writer.String(FieldName(field.field));
+      WriteInt64(&writer, "present", field.present);
+      WriteInt64(&writer, "bytes", field.bytes);
+      WriteInt64(&writer, "slack", field.slack);
+      WriteInt64(&writer, "totalBytes", field.total_bytes);
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+}
+
+}  // namespace protobuf
+}  // namespace google
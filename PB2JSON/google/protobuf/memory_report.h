@@ -0,0 +1,141 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Attributes the memory held by messages to their types and fields, to find
+// out what a cache full of decoded responses is really spending its memory
+// on.  A MemoryReport walks each message added to it, with all of its
+// sub-messages, and sums per type the message objects, unknown fields and,
+// per field, string contents and repeated arrays.  What is allocated but not
+// in use (capacity past the end of strings and arrays, cleared elements) is
+// counted separately as slack.  The descriptors the messages were built from
+// can be added too.
+//
+// The numbers come from Reflection::SpaceUsed() and SpaceUsedByField(), so
+// they are estimates:  they don't include malloc's own overhead.
+
+#ifndef GOOGLE_PROTOBUF_MEMORY_REPORT_H__
+#define GOOGLE_PROTOBUF_MEMORY_REPORT_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/stubs/hash.h>
+
+namespace google {
+namespace protobuf {
+
+class Message;
+
+// Not thread-safe.
+class LIBPROTOBUF_EXPORT MemoryReport {
+ public:
+  MemoryReport();
+  ~MemoryReport();
+
+  // What one field of a message type held, over all instances of the type.
+  struct FieldUsage {
+    const FieldDescriptor* field;
+    int64 present;  // Instances in which the field was set or non-empty.
+    int64 bytes;    // Strings and arrays; see Reflection::SpaceUsedByField().
+    int64 slack;    // The part of bytes which is allocated but unused.
+
+    // bytes, plus everything held by the sub-messages in the field.
+    int64 total_bytes;
+  };
+
+  // What the instances of one message type held.  Their sub-messages are
+  // counted under the sub-messages' own types.
+  struct TypeUsage {
+    const Descriptor* type;
+    int object_size;            // Of one instance, as SpaceUsed() sees it.
+    int64 instances;
+    int64 object_bytes;         // instances * object_size.
+    int64 field_bytes;          // The sum of fields[i].bytes.
+    int64 slack;                // The sum of fields[i].slack.
+    int64 unknown_field_bytes;  // Fields the type doesn't know.
+
+    // The type's fields in order, then the extensions seen.
+    vector<FieldUsage> fields;
+
+    int64 bytes() const {
+      return object_bytes + field_bytes + unknown_field_bytes;
+    }
+  };
+
+  // Adds the message and everything reachable from it.
+  void AddMessage(const Message& message);
+
+  // Adds the memory held by the pool's descriptors.  See
+  // DescriptorPool::GetSpaceUsage().
+  void AddPool(const DescriptorPool* pool);
+
+  int64 message_count() const { return message_count_; }  // AddMessage() calls.
+  int64 message_bytes() const;
+  int64 pool_bytes() const;
+  const DescriptorPool::SpaceUsage& pool_usage() const { return pool_usage_; }
+
+  // Gets every type seen, those holding the most bytes first.
+  void GetTypes(vector<const TypeUsage*>* types) const;
+
+  // Appends the report to *output, as a table for reading or as a JSON
+  // object.  Within each type, the fields holding the most bytes including
+  // their sub-messages come first, and fields which never held anything are
+  // left out.
+  void ToText(string* output) const;
+  void ToJson(string* output) const;
+
+ private:
+  typedef hash_map<const Descriptor*, TypeUsage*> TypeMap;
+  TypeMap types_;
+  int64 message_count_;
+  DescriptorPool::SpaceUsage pool_usage_;
+
+  // Adds a message reached from one of those passed to AddMessage(), and
+  // returns the bytes held by it and its sub-messages.
+  int64 AddMessageTree(const Message& message);
+
+  // Adds field index of the message's TypeUsage, returning the bytes it holds
+  // including sub-messages.  The index is used rather than a pointer into
+  // the fields because adding sub-messages may add extensions.
+  int64 AddField(const Message& message, const FieldDescriptor* field,
+                 TypeUsage* usage, int index);
+
+  TypeUsage* FindOrAddType(const Message& message);
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MemoryReport);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_MEMORY_REPORT_H__
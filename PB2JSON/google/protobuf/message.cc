@@ -45,6 +45,7 @@
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/repeated_field.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/map-util.h>
@@ -181,6 +182,63 @@ bool Message::SerializePartialToOstream(ostream* output) const {
 
 Reflection::~Reflection() {}
 
+namespace {
+
+// The size of one element of a repeated field of the given type, as stored
+// in its array.
+int ElementSize(FieldDescriptor::CppType type) {
+  switch (type) {
+    case FieldDescriptor::CPPTYPE_INT32 : return sizeof(int32 );
+    case FieldDescriptor::CPPTYPE_INT64 : return sizeof(int64 );
+    case FieldDescriptor::CPPTYPE_UINT32: return sizeof(uint32);
+    case FieldDescriptor::CPPTYPE_UINT64: return sizeof(uint64);
+    case FieldDescriptor::CPPTYPE_DOUBLE: return sizeof(double);
+    case FieldDescriptor::CPPTYPE_FLOAT : return sizeof(float );
+    case FieldDescriptor::CPPTYPE_BOOL  : return sizeof(bool  );
+    case FieldDescriptor::CPPTYPE_ENUM  : return sizeof(int   );
+    case FieldDescriptor::CPPTYPE_STRING:
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return sizeof(void*);
+  }
+  return 0;
+}
+
+// The space used by a string which a message points at, adding the unused
+// part of its buffer to *slack.
+int OwnedStringSpaceUsed(const string& value, int* slack) {
+  int buffer_size = internal::StringSpaceUsedExcludingSelf(value);
+  if (buffer_size > 0) *slack += buffer_size - value.size();
+  return sizeof(value) + buffer_size;
+}
+
+}  // namespace
+
+int Reflection::SpaceUsedByField(const Message& message,
+                                 const FieldDescriptor* field,
+                                 int* slack) const {
+  int total_size = 0;
+  int unused = 0;
+  string scratch;
+
+  if (field->is_repeated()) {
+    int size = FieldSize(message, field);
+    total_size += size * ElementSize(field->cpp_type());
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+      for (int i = 0; i < size; i++) {
+        total_size += OwnedStringSpaceUsed(
+            GetRepeatedStringReference(message, field, i, &scratch), &unused);
+      }
+    }
+  } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING &&
+             HasField(message, field)) {
+    total_size += OwnedStringSpaceUsed(
+        GetStringReference(message, field, &scratch), &unused);
+  }
+
+  if (slack != NULL) *slack = unused;
+  return total_size;
+}
+
 // ===================================================================
 // MessageFactory
 
@@ -391,6 +391,18 @@ class LIBPROTOBUF_EXPORT Reflection {
   // Estimate the amount of memory used by the message object.
   virtual int SpaceUsed(const Message& message) const = 0;
 
+  // Estimate the memory used by one field of the message beyond the field's
+  // slot in the message object itself:  string contents and the arrays of
+  // repeated fields, but not the sub-messages in use, which have their own
+  // SpaceUsed().  If slack is not NULL, it is set to the part of that which
+  // is allocated but not holding the field's value:  capacity past the end
+  // of strings and arrays, and cleared elements and sub-messages kept for
+  // reuse.  The default implementation only has the accessors to go on, so
+  // it sees neither the capacity of arrays nor cleared objects.
+  virtual int SpaceUsedByField(const Message& message,
+                               const FieldDescriptor* field,
+                               int* slack) const;
+
   // Check if the given non-repeated field is set.
   virtual bool HasField(const Message& message,
                         const FieldDescriptor* field) const = 0;
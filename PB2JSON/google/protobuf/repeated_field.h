@@ -203,6 +203,7 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
 
   template <typename TypeHandler>
   int SpaceUsedExcludingSelf() const;
+  int SpaceUsedByArray() const;
 
   // Advanced memory management --------------------------------------
 
@@ -215,7 +216,7 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   template <typename TypeHandler>
   typename TypeHandler::Type* ReleaseLast();
 
-  int ClearedCount();
+  int ClearedCount() const;
   template <typename TypeHandler>
   void AddCleared(typename TypeHandler::Type* value);
   template <typename TypeHandler>
@@ -632,14 +633,17 @@ inline void RepeatedPtrFieldBase::SwapElements(int index1, int index2) {
 
 template <typename TypeHandler>
 inline int RepeatedPtrFieldBase::SpaceUsedExcludingSelf() const {
-  int allocated_bytes =
-      (elements_ != initial_space_) ? total_size_ * sizeof(elements_[0]) : 0;
+  int allocated_bytes = SpaceUsedByArray();
   for (int i = 0; i < allocated_size_; ++i) {
     allocated_bytes += TypeHandler::SpaceUsed(*cast<TypeHandler>(elements_[i]));
   }
   return allocated_bytes;
 }
 
+inline int RepeatedPtrFieldBase::SpaceUsedByArray() const {
+  return (elements_ != initial_space_) ? total_size_ * sizeof(elements_[0]) : 0;
+}
+
 template <typename TypeHandler>
 inline typename TypeHandler::Type* RepeatedPtrFieldBase::AddFromCleared() {
   if (current_size_ < allocated_size_) {
@@ -677,7 +681,7 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseLast() {
 }
 
 
-inline int RepeatedPtrFieldBase::ClearedCount() {
+inline int RepeatedPtrFieldBase::ClearedCount() const {
   return allocated_size_ - current_size_;
 }
 
@@ -790,6 +794,11 @@ inline int RepeatedPtrField<Element>::SpaceUsedExcludingSelf() const {
   return RepeatedPtrFieldBase::SpaceUsedExcludingSelf<TypeHandler>();
 }
 
+template <typename Element>
+inline int RepeatedPtrField<Element>::SpaceUsedByArray() const {
+  return RepeatedPtrFieldBase::SpaceUsedByArray();
+}
+
 template <typename Element>
 inline void RepeatedPtrField<Element>::AddAllocated(Element* value) {
   RepeatedPtrFieldBase::AddAllocated<TypeHandler>(value);
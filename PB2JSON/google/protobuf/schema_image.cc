@@ -0,0 +1,624 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#include <algorithm>
+#include <map>
+
+#include <google/protobuf/schema_image.h>
+#include <google/protobuf/flat_schema.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+
+namespace google {
+namespace protobuf {
+
+#ifndef O_BINARY
+#ifdef _O_BINARY
+#define O_BINARY _O_BINARY
+#else
+#define O_BINARY 0     // If this isn't defined, the platform doesn't need it.
+#endif
+#endif
+
+namespace {
+
+// The layout of an image:
+//
+//   header    kHeaderSize bytes:  kMagic, then as uint32s the version, the
+//             number of messages, fields, enums and enum values, and the
+//             size of the strings
+//   messages  kMessageSize bytes each, sorted by full name:  as uint32s the
+//             offset and size of the full name, the index of the first
+//             field and the number of fields
+//   fields    kFieldSize bytes each, those of each message together and
+//             sorted by number:  as uint32s the number, the type (the
+//             FieldDescriptor::Type, plus kRepeatedFlag if repeated), the
+//             index of the message or enum type or kNoType, and the offsets
+//             and sizes of the name and the JSON name
+//   enums     kEnumSize bytes each, sorted by full name:  as uint32s the
+//             offset and size of the full name, the index of the first
+//             value and the number of values
+//   values    kValueSize bytes each, those of each enum together and sorted
+//             by number:  as uint32s the number and the offset and size of
+//             the name
+//   strings   the names, each offset being from the start of the strings
+//
+// Only the first of several enum values with the same number is kept, as
+// it is the one EnumDescriptor::FindValueByNumber() returns.
+const char kMagic[8] = { 'P', 'B', '2', 'J', 'S', 'C', 'H', 'M' };
+const uint32 kVersion = 1;
+const int kHeaderSize = 32;
+const int kMessageSize = 16;
+const int kFieldSize = 28;
+const int kEnumSize = 16;
+const int kValueSize = 12;
+const uint32 kRepeatedFlag = 0x100;
+const uint32 kNoType = ~0u;
+
+inline uint32 ReadLittleEndian32(const char* ptr) {
+  const uint8* bytes = reinterpret_cast<const uint8*>(ptr);
+  return static_cast<uint32>(bytes[0]) |
+         (static_cast<uint32>(bytes[1]) << 8) |
+         (static_cast<uint32>(bytes[2]) << 16) |
+         (static_cast<uint32>(bytes[3]) << 24);
+}
+
+bool FieldNumberLess(const FieldDescriptor* a, const FieldDescriptor* b) {
+  return a->number() < b->number();
+}
+
+bool ValueNumberLess(const EnumValueDescriptor* a,
+                     const EnumValueDescriptor* b) {
+  return a->number() < b->number();
+}
+
+// The strings of an image being written, each stored once.
+class StringTable {
+ public:
+  StringTable() {}
+
+  uint32 Add(const string& value) {
+    map<string, uint32>::iterator iter = offsets_.find(value);
+    if (iter != offsets_.end()) return iter->second;
+    uint32 offset = data_.size();
+    data_.append(value);
+    offsets_[value] = offset;
+    return offset;
+  }
+
+  // Writes the offset and size of the string.
+  void WriteReference(const string& value, io::CodedOutputStream* output) {
+    output->WriteLittleEndian32(Add(value));
+    output->WriteLittleEndian32(value.size());
+  }
+
+  const string& data() const { return data_; }
+
+ private:
+  string data_;
+  map<string, uint32> offsets_;
+};
+
+}  // namespace
+
+SchemaImageWriter::SchemaImageWriter() {}
+SchemaImageWriter::~SchemaImageWriter() {}
+
+void SchemaImageWriter::AddFile(const FileDescriptor* file) {
+  for (int i = 0; i < file->message_type_count(); i++) {
+    AddMessage(file->message_type(i));
+  }
+  for (int i = 0; i < file->enum_type_count(); i++) {
+    AddEnum(file->enum_type(i));
+  }
+}
+
+void SchemaImageWriter::AddMessage(const Descriptor* type) {
+  if (!messages_.insert(type).second) return;
+  for (int i = 0; i < type->nested_type_count(); i++) {
+    AddMessage(type->nested_type(i));
+  }
+  for (int i = 0; i < type->enum_type_count(); i++) {
+    AddEnum(type->enum_type(i));
+  }
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    if (field->message_type() != NULL) AddMessage(field->message_type());
+    if (field->enum_type() != NULL) AddEnum(field->enum_type());
+  }
+}
+
+void SchemaImageWriter::AddEnum(const EnumDescriptor* type) {
+  enums_.insert(type);
+}
+
+bool SchemaImageWriter::Write(const string& filename, string* error) const {
+  // Number the types in the order they are written.
+  map<string, uint32> message_indices;
+  map<string, uint32> enum_indices;
+  for (set<const Descriptor*, NameLess>::const_iterator iter =
+         messages_.begin(); iter != messages_.end(); ++iter) {
+    uint32 index = message_indices.size();
+    message_indices[(*iter)->full_name()] = index;
+  }
+  for (set<const EnumDescriptor*, NameLess>::const_iterator iter =
+         enums_.begin(); iter != enums_.end(); ++iter) {
+    uint32 index = enum_indices.size();
+    enum_indices[(*iter)->full_name()] = index;
+  }
+
+  // Sort each message's fields and each enum's values, and lay out the
+  // records and the strings they refer to.
+  StringTable strings;
+  string records;
+  uint32 field_count = 0;
+  uint32 value_count = 0;
+  {
+    io::StringOutputStream records_output(&records);
+    io::CodedOutputStream output(&records_output);
+
+    vector<vector<const FieldDescriptor*> > fields;
+    for (set<const Descriptor*, NameLess>::const_iterator iter =
+           messages_.begin(); iter != messages_.end(); ++iter) {
+      const Descriptor* type = *iter;
+      fields.push_back(vector<const FieldDescriptor*>());
+      for (int i = 0; i < type->field_count(); i++) {
+        fields.back().push_back(type->field(i));
+      }
+      sort(fields.back().begin(), fields.back().end(), FieldNumberLess);
+
+      strings.WriteReference(type->full_name(), &output);
+      output.WriteLittleEndian32(field_count);
+      output.WriteLittleEndian32(type->field_count());
+      field_count += type->field_count();
+    }
+
+    for (int i = 0; i < fields.size(); i++) {
+      for (int j = 0; j < fields[i].size(); j++) {
+        const FieldDescriptor* field = fields[i][j];
+        uint32 type_index = kNoType;
+        if (field->message_type() != NULL) {
+          type_index = message_indices[field->message_type()->full_name()];
+        } else if (field->enum_type() != NULL) {
+          type_index = enum_indices[field->enum_type()->full_name()];
+        }
+        output.WriteLittleEndian32(field->number());
+        output.WriteLittleEndian32(field->type() |
+                                   (field->is_repeated() ? kRepeatedFlag : 0));
+        output.WriteLittleEndian32(type_index);
+        strings.WriteReference(field->name(), &output);
+        strings.WriteReference(FlatSchema::JsonName(field), &output);
+      }
+    }
+
+    vector<vector<const EnumValueDescriptor*> > values;
+    for (set<const EnumDescriptor*, NameLess>::const_iterator iter =
+           enums_.begin(); iter != enums_.end(); ++iter) {
+      const EnumDescriptor* type = *iter;
+      values.push_back(vector<const EnumValueDescriptor*>());
+      vector<const EnumValueDescriptor*>* enum_values = &values.back();
+      for (int i = 0; i < type->value_count(); i++) {
+        enum_values->push_back(type->value(i));
+      }
+      stable_sort(enum_values->begin(), enum_values->end(), ValueNumberLess);
+      int unique = 0;
+      for (int i = 0; i < enum_values->size(); i++) {
+        if (unique == 0 ||
+            (*enum_values)[i]->number() != (*enum_values)[unique - 1]->number()) {
+          (*enum_values)[unique++] = (*enum_values)[i];
+        }
+      }
+      enum_values->resize(unique);
+
+      strings.WriteReference(type->full_name(), &output);
+      output.WriteLittleEndian32(value_count);
+      output.WriteLittleEndian32(unique);
+      value_count += unique;
+    }
+
+    for (int i = 0; i < values.size(); i++) {
+      for (int j = 0; j < values[i].size(); j++) {
+        output.WriteLittleEndian32(values[i][j]->number());
+        strings.WriteReference(values[i][j]->name(), &output);
+      }
+    }
+  }
+
+  if (kHeaderSize + static_cast<uint64>(records.size()) +
+      strings.data().size() > kuint32max) {
+    *error = filename + ": schema images are limited to 4GB.";
+    return false;
+  }
+
+  // Write to a temporary file and rename it, so that processes which have
+  // the old image mapped keep seeing it whole.
+  string temp_filename = filename + ".tmp";
+  int fd;
+  do {
+    fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,
+              0666);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    *error = temp_filename + ": " + strerror(errno);
+    return false;
+  }
+
+  io::FileOutputStream file_output(fd);
+  bool ok;
+  {
+    io::CodedOutputStream output(&file_output);
+    output.WriteRaw(kMagic, sizeof(kMagic));
+    output.WriteLittleEndian32(kVersion);
+    output.WriteLittleEndian32(messages_.size());
+    output.WriteLittleEndian32(field_count);
+    output.WriteLittleEndian32(enums_.size());
+    output.WriteLittleEndian32(value_count);
+    output.WriteLittleEndian32(strings.data().size());
+    output.WriteString(records);
+    output.WriteString(strings.data());
+    ok = !output.HadError();
+  }
+  if (!file_output.Close() || !ok) {
+    *error = temp_filename + ": " + strerror(file_output.GetErrno());
+    ok = false;
+  }
+  if (ok) {
+#ifdef _WIN32
+    // rename() won't replace an existing file on Windows.
+    remove(filename.c_str());
+#endif
+    if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+      *error = filename + ": " + strerror(errno);
+      ok = false;
+    }
+  }
+  if (!ok) remove(temp_filename.c_str());
+  return ok;
+}
+
+// ===================================================================
+
+SchemaImage::SchemaImage()
+  : data_(NULL),
+    size_(0),
+    mapped_(false),
+    message_count_(0),
+    field_count_(0),
+    enum_count_(0),
+    value_count_(0),
+    messages_(NULL),
+    fields_(NULL),
+    enums_(NULL),
+    values_(NULL),
+    strings_(NULL) {
+}
+
+SchemaImage::~SchemaImage() {
+  Close();
+}
+
+void SchemaImage::Close() {
+  if (data_ != NULL) {
+#ifndef _WIN32
+    if (mapped_) {
+      munmap(const_cast<char*>(data_), size_);
+    } else {
+      delete [] data_;
+    }
+#else
+    delete [] data_;
+#endif
+  }
+  data_ = NULL;
+  size_ = 0;
+  mapped_ = false;
+  message_count_ = 0;
+  field_count_ = 0;
+  enum_count_ = 0;
+  value_count_ = 0;
+  messages_ = NULL;
+  fields_ = NULL;
+  enums_ = NULL;
+  values_ = NULL;
+  strings_ = NULL;
+}
+
+bool SchemaImage::Open(const string& filename, string* error) {
+  Close();
+
+  int fd;
+  do {
+    fd = open(filename.c_str(), O_RDONLY | O_BINARY);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0) {
+    *error = filename + ": " + strerror(errno);
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    *error = filename + ": " + strerror(errno);
+    close(fd);
+    return false;
+  }
+  size_ = info.st_size;
+  if (size_ < kHeaderSize) {
+    *error = filename + ": not a schema image.";
+    close(fd);
+    return false;
+  }
+
+#ifndef _WIN32
+  void* mapped = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapped != MAP_FAILED) {
+    data_ = static_cast<const char*>(mapped);
+    mapped_ = true;
+  }
+#endif
+  if (data_ == NULL) {
+    // No mmap(); read it instead.
+    char* buffer = new char[size_];
+    data_ = buffer;
+    for (int64 done = 0; done < size_; ) {
+      int bytes = read(fd, buffer + done, min<int64>(size_ - done, 1 << 20));
+      if (bytes <= 0 && !(bytes < 0 && errno == EINTR)) {
+        *error = filename + ": " +
+                 (bytes < 0 ? strerror(errno) : "unexpected end of file");
+        close(fd);
+        Close();
+        return false;
+      }
+      if (bytes > 0) done += bytes;
+    }
+  }
+  close(fd);
+
+  bool valid = memcmp(data_, kMagic, sizeof(kMagic)) == 0 &&
+               ReadLittleEndian32(data_ + 8) == kVersion;
+  if (valid) {
+    uint64 message_count = ReadLittleEndian32(data_ + 12);
+    uint64 field_count = ReadLittleEndian32(data_ + 16);
+    uint64 enum_count = ReadLittleEndian32(data_ + 20);
+    uint64 value_count = ReadLittleEndian32(data_ + 24);
+    uint64 strings_size = ReadLittleEndian32(data_ + 28);
+    valid = kHeaderSize + message_count * kMessageSize +
+            field_count * kFieldSize + enum_count * kEnumSize +
+            value_count * kValueSize + strings_size == size_;
+    if (valid) {
+      message_count_ = message_count;
+      field_count_ = field_count;
+      enum_count_ = enum_count;
+      value_count_ = value_count;
+      messages_ = data_ + kHeaderSize;
+      fields_ = messages_ + message_count * kMessageSize;
+      enums_ = fields_ + field_count * kFieldSize;
+      values_ = enums_ + enum_count * kEnumSize;
+      strings_ = values_ + value_count * kValueSize;
+      valid = Validate();
+    }
+  }
+  if (!valid) {
+    *error = filename + ": not a schema image, or damaged.";
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool SchemaImage::Validate() const {
+  uint64 strings_size = size_ - (strings_ - data_);
+
+  // Checks that the string referred to at RECORD, by its offset and size,
+  // lies within the strings.
+#define CHECK_STRING(RECORD)                                                  \
+  if (static_cast<uint64>(ReadLittleEndian32(RECORD)) +                      \
+      ReadLittleEndian32((RECORD) + 4) > strings_size) {                      \
+    return false;                                                             \
+  }
+
+  string last_name;
+  for (int i = 0; i < message_count_; i++) {
+    const char* record = messages_ + i * kMessageSize;
+    CHECK_STRING(record);
+    string name = message_name(i);
+    if (i > 0 && !(last_name < name)) return false;
+    last_name.swap(name);
+
+    uint64 first = ReadLittleEndian32(record + 8);
+    uint64 count = ReadLittleEndian32(record + 12);
+    if (first + count > field_count_) return false;
+    for (uint64 j = first; j < first + count; j++) {
+      const char* field = fields_ + j * kFieldSize;
+      uint32 type = ReadLittleEndian32(field + 4) & ~kRepeatedFlag;
+      uint32 type_index = ReadLittleEndian32(field + 8);
+      if (j > first &&
+          static_cast<int32>(ReadLittleEndian32(field)) <=
+          static_cast<int32>(ReadLittleEndian32(field - kFieldSize))) {
+        return false;
+      }
+      if (type < 1 || type > FieldDescriptor::MAX_TYPE) return false;
+      if (type == FieldDescriptor::TYPE_MESSAGE ||
+          type == FieldDescriptor::TYPE_GROUP) {
+        if (type_index >= message_count_) return false;
+      } else if (type == FieldDescriptor::TYPE_ENUM) {
+        if (type_index >= enum_count_) return false;
+      } else if (type_index != kNoType) {
+        return false;
+      }
+      CHECK_STRING(field + 12);
+      CHECK_STRING(field + 20);
+    }
+  }
+
+  for (int i = 0; i < enum_count_; i++) {
+    const char* record = enums_ + i * kEnumSize;
+    CHECK_STRING(record);
+    uint64 first = ReadLittleEndian32(record + 8);
+    uint64 count = ReadLittleEndian32(record + 12);
+    if (first + count > value_count_) return false;
+    for (uint64 j = first; j < first + count; j++) {
+      const char* value = values_ + j * kValueSize;
+      if (j > first &&
+          static_cast<int32>(ReadLittleEndian32(value)) <=
+          static_cast<int32>(ReadLittleEndian32(value - kValueSize))) {
+        return false;
+      }
+      CHECK_STRING(value + 4);
+    }
+  }
+#undef CHECK_STRING
+
+  return true;
+}
+
+// -------------------------------------------------------------------
+
+int SchemaImage::FindMessage(const string& full_name) const {
+  // Binary search, comparing names in place.
+  int low = 0;
+  int high = message_count_;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    const char* record = messages_ + middle * kMessageSize;
+    const char* name = strings_ + ReadLittleEndian32(record);
+    int name_size = ReadLittleEndian32(record + 4);
+    int compare = full_name.compare(0, string::npos, name, name_size);
+    if (compare == 0) return middle;
+    if (compare < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return -1;
+}
+
+string SchemaImage::message_name(int type) const {
+  const char* record = messages_ + type * kMessageSize;
+  return string(strings_ + ReadLittleEndian32(record),
+                ReadLittleEndian32(record + 4));
+}
+
+int SchemaImage::field_count(int type) const {
+  return ReadLittleEndian32(messages_ + type * kMessageSize + 12);
+}
+
+void SchemaImage::GetField(int type, int index, Field* field) const {
+  const char* record = fields_ +
+      (ReadLittleEndian32(messages_ + type * kMessageSize + 8) + index) *
+      kFieldSize;
+  uint32 type_and_label = ReadLittleEndian32(record + 4);
+  uint32 type_index = ReadLittleEndian32(record + 8);
+
+  field->number = ReadLittleEndian32(record);
+  field->type =
+      static_cast<FieldDescriptor::Type>(type_and_label & ~kRepeatedFlag);
+  field->is_repeated = (type_and_label & kRepeatedFlag) != 0;
+  field->index = index;
+  field->message_type = -1;
+  field->enum_type = -1;
+  if (field->type == FieldDescriptor::TYPE_MESSAGE ||
+      field->type == FieldDescriptor::TYPE_GROUP) {
+    field->message_type = type_index;
+  } else if (field->type == FieldDescriptor::TYPE_ENUM) {
+    field->enum_type = type_index;
+  }
+  field->name = strings_ + ReadLittleEndian32(record + 12);
+  field->name_size = ReadLittleEndian32(record + 16);
+  field->json_name = strings_ + ReadLittleEndian32(record + 20);
+  field->json_name_size = ReadLittleEndian32(record + 24);
+}
+
+bool SchemaImage::FindFieldByNumber(int type, int number,
+                                    Field* field) const {
+  const char* record = messages_ + type * kMessageSize;
+  const char* first = fields_ + ReadLittleEndian32(record + 8) * kFieldSize;
+  int low = 0;
+  int high = ReadLittleEndian32(record + 12);
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    int middle_number =
+        static_cast<int32>(ReadLittleEndian32(first + middle * kFieldSize));
+    if (middle_number == number) {
+      GetField(type, middle, field);
+      return true;
+    }
+    if (number < middle_number) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return false;
+}
+
+bool SchemaImage::FindEnumValueName(int type, int number,
+                                    const char** name, int* name_size) const {
+  const char* record = enums_ + type * kEnumSize;
+  const char* first = values_ + ReadLittleEndian32(record + 8) * kValueSize;
+  int low = 0;
+  int high = ReadLittleEndian32(record + 12);
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    const char* value = first + middle * kValueSize;
+    int middle_number = static_cast<int32>(ReadLittleEndian32(value));
+    if (middle_number == number) {
+      *name = strings_ + ReadLittleEndian32(value + 4);
+      *name_size = ReadLittleEndian32(value + 8);
+      return true;
+    }
+    if (number < middle_number) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return false;
+}
+
+}  // namespace protobuf
+}  // namespace google
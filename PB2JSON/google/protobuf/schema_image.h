@@ -0,0 +1,168 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// A schema image is a file holding what the transcoder needs to know about
+// a set of message types, already resolved:  names, field numbers, types,
+// labels and the types fields refer to, plus enum values.  It is made of
+// fixed-size records in flat arrays which refer to each other by index and
+// to their names by offset, so it holds no pointers and can be used straight
+// from a read-only mmap().  A process which loads one skips parsing .proto
+// files and building a DescriptorPool, and every process mapping the same
+// image shares its pages.
+
+#ifndef GOOGLE_PROTOBUF_SCHEMA_IMAGE_H__
+#define GOOGLE_PROTOBUF_SCHEMA_IMAGE_H__
+
+#include <set>
+#include <string>
+#include <vector>
+#include <google/protobuf/descriptor.h>
+
+namespace google {
+namespace protobuf {
+
+// Collects message types and writes them as a schema image.  All numbers in
+// the image are little-endian, and the image is the same whatever order the
+// types were added in.
+class LIBPROTOBUF_EXPORT SchemaImageWriter {
+ public:
+  SchemaImageWriter();
+  ~SchemaImageWriter();
+
+  // Adds every message and enum type defined in the file, including nested
+  // ones, and everything they refer to.  The descriptors must outlive the
+  // writer.
+  void AddFile(const FileDescriptor* file);
+
+  // Adds the message type, its nested types and everything it refers to.
+  void AddMessage(const Descriptor* type);
+
+  // Writes the image.  Returns false and sets *error on I/O errors, or if
+  // the image would exceed 4GB.
+  bool Write(const string& filename, string* error) const;
+
+ private:
+  void AddEnum(const EnumDescriptor* type);
+
+  // Sorted by full name, so that the image is canonical and can be searched.
+  struct NameLess {
+    template <typename Type>
+    bool operator()(const Type* a, const Type* b) const {
+      return a->full_name() < b->full_name();
+    }
+  };
+  set<const Descriptor*, NameLess> messages_;
+  set<const EnumDescriptor*, NameLess> enums_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(SchemaImageWriter);
+};
+
+// A schema image written by SchemaImageWriter, mapped into memory.  Types
+// are numbered from 0 in order of full name, and the fields of each type
+// from 0 in order of field number.
+class LIBPROTOBUF_EXPORT SchemaImage {
+ public:
+  SchemaImage();
+  ~SchemaImage();
+
+  // A field of a message type.  The names point into the mapped file and
+  // stay valid until the image is closed.
+  struct Field {
+    int number;
+    FieldDescriptor::Type type;
+    bool is_repeated;
+    int index;          // Among the fields of its message type.
+    int message_type;   // For message and group fields; otherwise -1.
+    int enum_type;      // For enum fields; otherwise -1.
+    const char* name;   // As in the .proto file.
+    int name_size;
+
+    // The name JsonTranscoder gives the field.
+    const char* json_name;
+    int json_name_size;
+  };
+
+  // Maps the given image, closing the current one if any.  Returns false and
+  // sets *error if the file can't be mapped or isn't a valid image, in which
+  // case the image is left closed.
+  bool Open(const string& filename, string* error);
+  void Close();
+
+  int message_count() const { return message_count_; }
+
+  // Returns the index of the message type with the given full name, or -1.
+  int FindMessage(const string& full_name) const;
+
+  // The full name of the message type.
+  string message_name(int type) const;
+
+  int field_count(int type) const;
+
+  // Fills in *field with field index of the message type.
+  void GetField(int type, int index, Field* field) const;
+
+  // Looks up a field of the message type by number.  Returns false if there
+  // is none.
+  bool FindFieldByNumber(int type, int number, Field* field) const;
+
+  // Looks up the name of a value of the enum type.  Returns false if no
+  // value has the number.
+  bool FindEnumValueName(int type, int number,
+                         const char** name, int* name_size) const;
+
+ private:
+  const char* data_;
+  int64 size_;
+  bool mapped_;  // False if data_ was read into memory instead.
+
+  int message_count_;
+  int field_count_;
+  int enum_count_;
+  int value_count_;
+  const char* messages_;
+  const char* fields_;
+  const char* enums_;
+  const char* values_;
+  const char* strings_;
+
+  // Checks the records, so that a damaged file can't make the accessors
+  // read outside the mapping.
+  bool Validate() const;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(SchemaImage);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_SCHEMA_IMAGE_H__
@@ -0,0 +1,204 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include <string.h>
+#include <vector>
+
+#include <google/protobuf/stats.h>
+#include <google/protobuf/io/json_writer.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/once.h>
+#include <google/protobuf/stubs/strutil.h>
+
+namespace google {
+namespace protobuf {
+
+namespace internal {
+
+bool stats_enabled = false;
+GOOGLE_PROTOBUF_THREAD_LOCAL StatsBlock* thread_stats = NULL;
+
+}  // namespace internal
+
+namespace {
+
+const char* const kCounterNames[STAT_COUNTER_COUNT] = {
+  "coded_input.bytes_read",
+  "coded_input.refreshes",
+  "coded_input.limit_pushes",
+  "wire_format.double_fields",
+  "wire_format.float_fields",
+  "wire_format.int64_fields",
+  "wire_format.uint64_fields",
+  "wire_format.int32_fields",
+  "wire_format.fixed64_fields",
+  "wire_format.fixed32_fields",
+  "wire_format.bool_fields",
+  "wire_format.string_fields",
+  "wire_format.group_fields",
+  "wire_format.message_fields",
+  "wire_format.bytes_fields",
+  "wire_format.uint32_fields",
+  "wire_format.enum_fields",
+  "wire_format.sfixed32_fields",
+  "wire_format.sfixed64_fields",
+  "wire_format.sint32_fields",
+  "wire_format.sint64_fields",
+  "wire_format.unknown_fields",
+  "dynamic_message.types_built",
+  "dynamic_message.instances",
+  "descriptor_pool.lookups",
+  "descriptor_pool.locks",
+};
+
+// The blocks of running threads, and the totals of exited ones.  Blocks are
+// only added and removed under stats_mutex; their counts are written
+// without it by their own threads.
+Mutex* stats_mutex = NULL;
+vector<internal::StatsBlock*>* live_blocks = NULL;
+internal::StatsBlock* retired_counts = NULL;
+#ifndef _WIN32
+pthread_key_t stats_key;
+#endif
+
+GOOGLE_PROTOBUF_DECLARE_ONCE(stats_init_once);
+
+#ifndef _WIN32
+// Runs when a thread which counted exits.
+void RetireThreadStats(void* arg) {
+  internal::StatsBlock* block = static_cast<internal::StatsBlock*>(arg);
+  MutexLock lock(stats_mutex);
+  for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+    retired_counts->counts[i] += block->counts[i];
+  }
+  for (int i = 0; i < live_blocks->size(); i++) {
+    if ((*live_blocks)[i] == block) {
+      (*live_blocks)[i] = live_blocks->back();
+      live_blocks->pop_back();
+      break;
+    }
+  }
+  delete block;
+  // Other keys' destructors may still count, into a new block.
+  internal::thread_stats = NULL;
+}
+#endif
+
+void InitStats() {
+  stats_mutex = new Mutex;
+  live_blocks = new vector<internal::StatsBlock*>;
+  retired_counts = new internal::StatsBlock;
+  memset(retired_counts->counts, 0, sizeof(retired_counts->counts));
+#ifndef _WIN32
+  pthread_key_create(&stats_key, &RetireThreadStats);
+#endif
+}
+
+}  // namespace
+
+namespace internal {
+
+StatsBlock* NewThreadStats() {
+  GoogleOnceInit(&stats_init_once, &InitStats);
+  StatsBlock* block = new StatsBlock;
+  memset(block->counts, 0, sizeof(block->counts));
+  {
+    MutexLock lock(stats_mutex);
+    live_blocks->push_back(block);
+  }
+#ifndef _WIN32
+  // On Windows the blocks of exited threads stay in live_blocks instead.
+  pthread_setspecific(stats_key, block);
+#endif
+  thread_stats = block;
+  return block;
+}
+
+}  // namespace internal
+
+void EnableStats(bool enabled) {
+#ifndef GOOGLE_PROTOBUF_NO_STATS
+  internal::stats_enabled = enabled;
+#endif
+}
+
+void ResetStats() {
+  GoogleOnceInit(&stats_init_once, &InitStats);
+  MutexLock lock(stats_mutex);
+  memset(retired_counts->counts, 0, sizeof(retired_counts->counts));
+  for (int i = 0; i < live_blocks->size(); i++) {
+    memset((*live_blocks)[i]->counts, 0, sizeof((*live_blocks)[i]->counts));
+  }
+}
+
+void SnapshotStats(StatsSnapshot* snapshot) {
+  GoogleOnceInit(&stats_init_once, &InitStats);
+  MutexLock lock(stats_mutex);
+  memcpy(snapshot->counts, retired_counts->counts, sizeof(snapshot->counts));
+  for (int i = 0; i < live_blocks->size(); i++) {
+    for (int j = 0; j < STAT_COUNTER_COUNT; j++) {
+      snapshot->counts[j] += (*live_blocks)[i]->counts[j];
+    }
+  }
+}
+
+const char* StatsCounterName(StatsCounter counter) {
+  return kCounterNames[counter];
+}
+
+void StatsToText(const StatsSnapshot& snapshot, string* output) {
+  for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+    if (snapshot.counts[i] == 0) continue;
+    output->append(kCounterNames[i]);
+    output->push_back(' ');
+    output->append(SimpleItoa(snapshot.counts[i]));
+    output->push_back('\n');
+  }
+}
+
+void StatsToJson(const StatsSnapshot& snapshot, string* output) {
+  io::StringOutputStream stream(output);
+  io::JsonWriter writer(&stream);
+  writer.BeginObject();
+  for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+    writer.Name(kCounterNames[i], strlen(kCounterNames[i]));
+    writer.Int64(snapshot.counts[i]);
+  }
+  writer.EndObject();
+}
+
+}  // namespace protobuf
+}  // namespace google
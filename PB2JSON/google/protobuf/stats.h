@@ -0,0 +1,153 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Counters on the parsing hot paths, for seeing where the time goes in a
+// running process without attaching a profiler.  Counting is off until
+// EnableStats(true) is called, and until then a counting point costs a test
+// of a global flag.  Building with GOOGLE_PROTOBUF_NO_STATS defined removes
+// the counting points altogether.
+//
+// Each thread counts into a block of its own, so counting takes no lock and
+// shares no cache lines.  SnapshotStats() adds up the blocks of all
+// threads, including threads which have exited.
+
+#ifndef GOOGLE_PROTOBUF_STATS_H__
+#define GOOGLE_PROTOBUF_STATS_H__
+
+#include <string>
+#include <google/protobuf/stubs/common.h>
+
+#if defined(_MSC_VER)
+#define GOOGLE_PROTOBUF_THREAD_LOCAL __declspec(thread)
+#else
+#define GOOGLE_PROTOBUF_THREAD_LOCAL __thread
+#endif
+
+namespace google {
+namespace protobuf {
+
+enum StatsCounter {
+  // CodedInputStream.
+  STAT_CODED_INPUT_BYTES_READ,     // Bytes consumed, counted on destruction.
+  STAT_CODED_INPUT_REFRESHES,      // Refresh() calls.
+  STAT_CODED_INPUT_LIMIT_PUSHES,   // PushLimit() calls.
+
+  // Fields parsed by WireFormat or DynamicMessage, by FieldDescriptor::Type,
+  // in that enum's order.  A packed field counts once however many elements
+  // it has.
+  STAT_WIRE_FORMAT_DOUBLE_FIELDS,
+  STAT_WIRE_FORMAT_FLOAT_FIELDS,
+  STAT_WIRE_FORMAT_INT64_FIELDS,
+  STAT_WIRE_FORMAT_UINT64_FIELDS,
+  STAT_WIRE_FORMAT_INT32_FIELDS,
+  STAT_WIRE_FORMAT_FIXED64_FIELDS,
+  STAT_WIRE_FORMAT_FIXED32_FIELDS,
+  STAT_WIRE_FORMAT_BOOL_FIELDS,
+  STAT_WIRE_FORMAT_STRING_FIELDS,
+  STAT_WIRE_FORMAT_GROUP_FIELDS,
+  STAT_WIRE_FORMAT_MESSAGE_FIELDS,
+  STAT_WIRE_FORMAT_BYTES_FIELDS,
+  STAT_WIRE_FORMAT_UINT32_FIELDS,
+  STAT_WIRE_FORMAT_ENUM_FIELDS,
+  STAT_WIRE_FORMAT_SFIXED32_FIELDS,
+  STAT_WIRE_FORMAT_SFIXED64_FIELDS,
+  STAT_WIRE_FORMAT_SINT32_FIELDS,
+  STAT_WIRE_FORMAT_SINT64_FIELDS,
+  STAT_WIRE_FORMAT_UNKNOWN_FIELDS, // Unknown numbers or wrong wire types.
+
+  // DynamicMessageFactory.
+  STAT_DYNAMIC_TYPES_BUILT,        // Prototypes built by GetPrototype().
+  STAT_DYNAMIC_INSTANCES,          // DynamicMessages constructed.
+
+  // DescriptorPool.
+  STAT_DESCRIPTOR_POOL_LOOKUPS,    // Find*() calls.
+  STAT_DESCRIPTOR_POOL_LOCKS,      // Acquisitions of a pool's mutex.
+
+  STAT_COUNTER_COUNT
+};
+
+// The totals of every counter.
+struct StatsSnapshot {
+  int64 counts[STAT_COUNTER_COUNT];
+};
+
+namespace internal {
+
+struct StatsBlock {
+  int64 counts[STAT_COUNTER_COUNT];
+};
+
+extern LIBPROTOBUF_EXPORT bool stats_enabled;
+extern GOOGLE_PROTOBUF_THREAD_LOCAL StatsBlock* thread_stats;
+
+// Allocates and registers the calling thread's block.
+LIBPROTOBUF_EXPORT StatsBlock* NewThreadStats();
+
+}  // namespace internal
+
+// Adds to a counter, if counting is on.
+inline void CountStat(StatsCounter counter, int64 count = 1) {
+#ifndef GOOGLE_PROTOBUF_NO_STATS
+  if (internal::stats_enabled) {
+    internal::StatsBlock* block = internal::thread_stats;
+    if (block == NULL) block = internal::NewThreadStats();
+    block->counts[counter] += count;
+  }
+#endif
+}
+
+// Turns counting on or off.  Counts are kept while it's off.
+LIBPROTOBUF_EXPORT void EnableStats(bool enabled);
+
+// Zeroes every counter.
+LIBPROTOBUF_EXPORT void ResetStats();
+
+// Adds up the counts of all threads.  Counts that threads are adding while
+// it runs may or may not be included.
+LIBPROTOBUF_EXPORT void SnapshotStats(StatsSnapshot* snapshot);
+
+// The counter's name, like "coded_input.bytes_read".
+LIBPROTOBUF_EXPORT const char* StatsCounterName(StatsCounter counter);
+
+// Appends one "name value" line per counter that isn't zero.
+LIBPROTOBUF_EXPORT void StatsToText(const StatsSnapshot& snapshot,
+                                    string* output);
+
+// Appends a JSON object mapping the names of all counters to their values.
+LIBPROTOBUF_EXPORT void StatsToJson(const StatsSnapshot& snapshot,
+                                    string* output);
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_STATS_H__
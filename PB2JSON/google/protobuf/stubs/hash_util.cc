@@ -0,0 +1,99 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#include <algorithm>
+
+#include <google/protobuf/stubs/hash_util.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+void BuildPerfectHash(
+    const vector<uint64>& keys,
+    uint32 (*bucket_of)(uint64 key, uint32 bucket_count),
+    uint32 (*slot_of)(uint64 key, uint32 displacement, uint32 slot_count),
+    vector<uint32>* displacements, vector<int>* slots) {
+  uint32 key_count = keys.size();
+  uint32 bucket_count = max<uint32>(1, (key_count + 3) / 4);
+  uint32 slot_count = 1;
+  while (slot_count < key_count + key_count / 4 + 1) slot_count *= 2;
+
+  vector<vector<int> > buckets(bucket_count);
+  for (int i = 0; i < keys.size(); i++) {
+    buckets[bucket_of(keys[i], bucket_count)].push_back(i);
+  }
+  vector<pair<int, uint32> > order;  // (-size, bucket)
+  for (uint32 i = 0; i < bucket_count; i++) {
+    order.push_back(make_pair(-static_cast<int>(buckets[i].size()), i));
+  }
+  sort(order.begin(), order.end());
+
+  vector<uint32> candidate;
+  while (true) {
+    displacements->assign(bucket_count, 0);
+    slots->assign(slot_count, -1);
+    bool placed_all = true;
+    for (int i = 0; i < order.size() && order[i].first < 0; i++) {
+      const vector<int>& bucket = buckets[order[i].second];
+      bool placed = false;
+      for (uint32 d = 0; d < slot_count && !placed; d++) {
+        candidate.clear();
+        placed = true;
+        for (int j = 0; j < bucket.size() && placed; j++) {
+          uint32 slot = slot_of(keys[bucket[j]], d, slot_count);
+          placed = (*slots)[slot] == -1 &&
+                   find(candidate.begin(), candidate.end(), slot) ==
+                       candidate.end();
+          candidate.push_back(slot);
+        }
+        if (placed) {
+          (*displacements)[order[i].second] = d;
+          for (int j = 0; j < bucket.size(); j++) {
+            (*slots)[candidate[j]] = bucket[j];
+          }
+        }
+      }
+      if (!placed) {
+        placed_all = false;
+        break;
+      }
+    }
+    if (placed_all) break;
+    slot_count *= 2;
+  }
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
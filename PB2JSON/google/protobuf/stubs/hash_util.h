@@ -0,0 +1,95 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Hash functions whose results must not depend on the platform or the
+// build, and a builder for perfect hash tables.
+//
+// This header is intended to be included only by internal .cc files.  Users
+// should not use this directly.
+
+#ifndef GOOGLE_PROTOBUF_STUBS_HASH_UTIL_H__
+#define GOOGLE_PROTOBUF_STUBS_HASH_UTIL_H__
+
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// The splitmix64 finalizer.  Every bit of the result depends on every bit
+// of x.
+inline uint64 SplitMix64(uint64 x) {
+  x ^= x >> 30;
+  x *= GOOGLE_ULONGLONG(0xbf58476d1ce4e5b9);
+  x ^= x >> 27;
+  x *= GOOGLE_ULONGLONG(0x94d049bb133111eb);
+  x ^= x >> 31;
+  return x;
+}
+
+// 64-bit FNV-1a.
+inline uint64 Fnv1a64(const char* data, int size) {
+  uint64 hash = GOOGLE_ULONGLONG(0xcbf29ce484222325);
+  for (int i = 0; i < size; i++) {
+    hash ^= static_cast<uint8>(data[i]);
+    hash *= GOOGLE_ULONGLONG(0x100000001b3);
+  }
+  return hash;
+}
+
+// Builds a perfect hash table of keys with "hash and displace":  each key
+// hashes to a bucket with bucket_of(), and slot_of() combines it with its
+// bucket's displacement to pick its slot.  The buckets are placed biggest
+// first, each with the first displacement for which all its keys land in
+// free slots.  An average of four keys per bucket and a table at most 80%
+// full keeps the search short; if it fails anyway, it is retried with a
+// bigger table.
+//
+// The keys must be distinct.  The slot count is a power of two, and as the
+// displacement goes from 0 to the slot count - 1, slot_of() must visit
+// every slot.
+//
+// On return, *displacements holds the displacement of each bucket, and
+// *slots the index into keys of the key in each slot, or -1.
+LIBPROTOBUF_EXPORT void BuildPerfectHash(
+    const vector<uint64>& keys,
+    uint32 (*bucket_of)(uint64 key, uint32 bucket_count),
+    uint32 (*slot_of)(uint64 key, uint32 displacement, uint32 slot_count),
+    vector<uint32>* displacements, vector<int>* slots);
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#endif  // GOOGLE_PROTOBUF_STUBS_HASH_UTIL_H__
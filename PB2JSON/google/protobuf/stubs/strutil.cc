@@ -35,7 +35,10 @@
 #include <float.h>    // FLT_DIG and DBL_DIG
 #include <limits>
 #include <limits.h>
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #ifdef _WIN32
 // MSVC has only _snprintf, not snprintf.
@@ -911,30 +914,22 @@ string SimpleItoa(unsigned long long i) {
 //    It turns out there is no precision value that does the right thing
 //    for all numbers.
 //
-//    Our strategy is to first try printing with a precision that is never
-//    over-precise, then parse the result with strtod() to see if it
-//    matches.  If not, we print again with a precision that will always
-//    give a precise result, but may use more digits than necessary.
+//    We used to print with a precision that is never over-precise, parse
+//    the result with strtod() to see if it matched, and if not print again
+//    with a precision that always is.  That is up to two snprintf()s and a
+//    strtod() per value, which dominates printing float-heavy messages.
 //
-//    An arguably better strategy would be to use the algorithm described
-//    in "How to Print Floating-Point Numbers Accurately" by Steele &
-//    White, e.g. as implemented by David M. Gay's dtoa().  It turns out,
-//    however, that the following implementation is about as fast as
-//    DMG's code.  Furthermore, DMG's code locks mutexes, which means it
-//    will not scale well on multi-core machines.  DMG's code is slightly
-//    more accurate (in that it will never use more digits than
-//    necessary), but this is probably irrelevant for most users.
+//    Instead we now generate the shortest digit string which parses back to
+//    the same value directly, using Florian Loitsch's Grisu3 algorithm
+//    ("Printing Floating-Point Numbers Quickly and Accurately with
+//    Integers", PLDI 2010).  It works with 64-bit integers only, and can
+//    tell when its result might not be the shortest or might not round
+//    trip.  That happens for about 0.5% of doubles; for those we fall back
+//    to snprintf() and strtod(), trying increasing precisions.
 //
-//    Rob Pike and Ken Thompson also have an implementation of dtoa() in
-//    third_party/fmt/fltfmt.cc.  Their implementation is similar to this
-//    one in that it makes guesses and then uses strtod() to check them.
-//    Their implementation is faster because they use their own code to
-//    generate the digits in the first place rather than use snprintf(),
-//    thus avoiding format string parsing overhead.  However, this makes
-//    it considerably more complicated than the following implementation,
-//    and it is embedded in a larger library.  If speed turns out to be
-//    an issue, we could re-implement this in terms of their
-//    implementation.
+//    Either way, the digits are then laid out the way "%g" would lay them
+//    out, so that the output looks the same as before, just shorter where
+//    a shorter string suffices.
 // ----------------------------------------------------------------------
 
 string SimpleDtoa(double value) {
@@ -947,39 +942,399 @@ string SimpleFtoa(float value) {
   return FloatToBuffer(value, buffer);
 }
 
-static inline bool IsValidFloatChar(char c) {
-  return ('0' <= c && c <= '9') ||
-         c == 'e' || c == 'E' ||
-         c == '+' || c == '-';
+namespace {
+
+// A floating-point number f * 2^e with a 64-bit significand, as in the
+// Grisu paper ("do-it-yourself floating point").
+struct DiyFp {
+  uint64 f;
+  int e;
+
+  DiyFp() {}
+  DiyFp(uint64 f_value, int e_value) : f(f_value), e(e_value) {}
+};
+
+inline DiyFp Subtract(const DiyFp& a, const DiyFp& b) {
+  GOOGLE_DCHECK_EQ(a.e, b.e);
+  GOOGLE_DCHECK_GE(a.f, b.f);
+  return DiyFp(a.f - b.f, a.e);
 }
 
-void DelocalizeRadix(char* buffer) {
-  // Fast check:  if the buffer has a normal decimal point, assume no
-  // translation is needed.
-  if (strchr(buffer, '.') != NULL) return;
+// Returns the upper 64 bits of the 128-bit product, rounded.
+inline DiyFp Multiply(const DiyFp& a, const DiyFp& b) {
+  const uint64 kM32 = 0xFFFFFFFFu;
+  uint64 a_high = a.f >> 32;
+  uint64 a_low = a.f & kM32;
+  uint64 b_high = b.f >> 32;
+  uint64 b_low = b.f & kM32;
+  uint64 high_high = a_high * b_high;
+  uint64 low_high = a_low * b_high;
+  uint64 high_low = a_high * b_low;
+  uint64 low_low = a_low * b_low;
+  uint64 middle = (low_low >> 32) + (high_low & kM32) + (low_high & kM32);
+  middle += GOOGLE_ULONGLONG(1) << 31;  // Round.
+  return DiyFp(high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32),
+               a.e + b.e + 64);
+}
 
-  // Find the first unknown character.
-  while (IsValidFloatChar(*buffer)) ++buffer;
+inline DiyFp Normalize(DiyFp value) {
+  GOOGLE_DCHECK_NE(value.f, 0);
+  while ((value.f & GOOGLE_ULONGLONG(0xFFC0000000000000)) == 0) {
+    value.f <<= 10;
+    value.e -= 10;
+  }
+  while ((value.f & GOOGLE_ULONGLONG(0x8000000000000000)) == 0) {
+    value.f <<= 1;
+    value.e -= 1;
+  }
+  return value;
+}
 
-  if (*buffer == '\0') {
-    // No radix character found.
+// Normalized approximations of 10^k for k = kFirstCachedPower,
+// kFirstCachedPower + kCachedPowerStep, ..., rounded to nearest.
+struct CachedPower {
+  uint64 significand;
+  int binary_exponent;
+};
+
+const CachedPower kCachedPowers[] = {
+  { GOOGLE_ULONGLONG(0xfa8fd5a0081c0288), -1220 },  // 1e-348
+  { GOOGLE_ULONGLONG(0xbaaee17fa23ebf76), -1193 },  // 1e-340
+  { GOOGLE_ULONGLONG(0x8b16fb203055ac76), -1166 },  // 1e-332
+  { GOOGLE_ULONGLONG(0xcf42894a5dce35ea), -1140 },  // 1e-324
+  { GOOGLE_ULONGLONG(0x9a6bb0aa55653b2d), -1113 },  // 1e-316
+  { GOOGLE_ULONGLONG(0xe61acf033d1a45df), -1087 },  // 1e-308
+  { GOOGLE_ULONGLONG(0xab70fe17c79ac6ca), -1060 },  // 1e-300
+  { GOOGLE_ULONGLONG(0xff77b1fcbebcdc4f), -1034 },  // 1e-292
+  { GOOGLE_ULONGLONG(0xbe5691ef416bd60c), -1007 },  // 1e-284
+  { GOOGLE_ULONGLONG(0x8dd01fad907ffc3c),  -980 },  // 1e-276
+  { GOOGLE_ULONGLONG(0xd3515c2831559a83),  -954 },  // 1e-268
+  { GOOGLE_ULONGLONG(0x9d71ac8fada6c9b5),  -927 },  // 1e-260
+  { GOOGLE_ULONGLONG(0xea9c227723ee8bcb),  -901 },  // 1e-252
+  { GOOGLE_ULONGLONG(0xaecc49914078536d),  -874 },  // 1e-244
+  { GOOGLE_ULONGLONG(0x823c12795db6ce57),  -847 },  // 1e-236
+  { GOOGLE_ULONGLONG(0xc21094364dfb5637),  -821 },  // 1e-228
+  { GOOGLE_ULONGLONG(0x9096ea6f3848984f),  -794 },  // 1e-220
+  { GOOGLE_ULONGLONG(0xd77485cb25823ac7),  -768 },  // 1e-212
+  { GOOGLE_ULONGLONG(0xa086cfcd97bf97f4),  -741 },  // 1e-204
+  { GOOGLE_ULONGLONG(0xef340a98172aace5),  -715 },  // 1e-196
+  { GOOGLE_ULONGLONG(0xb23867fb2a35b28e),  -688 },  // 1e-188
+  { GOOGLE_ULONGLONG(0x84c8d4dfd2c63f3b),  -661 },  // 1e-180
+  { GOOGLE_ULONGLONG(0xc5dd44271ad3cdba),  -635 },  // 1e-172
+  { GOOGLE_ULONGLONG(0x936b9fcebb25c996),  -608 },  // 1e-164
+  { GOOGLE_ULONGLONG(0xdbac6c247d62a584),  -582 },  // 1e-156
+  { GOOGLE_ULONGLONG(0xa3ab66580d5fdaf6),  -555 },  // 1e-148
+  { GOOGLE_ULONGLONG(0xf3e2f893dec3f126),  -529 },  // 1e-140
+  { GOOGLE_ULONGLONG(0xb5b5ada8aaff80b8),  -502 },  // 1e-132
+  { GOOGLE_ULONGLONG(0x87625f056c7c4a8b),  -475 },  // 1e-124
+  { GOOGLE_ULONGLONG(0xc9bcff6034c13053),  -449 },  // 1e-116
+  { GOOGLE_ULONGLONG(0x964e858c91ba2655),  -422 },  // 1e-108
+  { GOOGLE_ULONGLONG(0xdff9772470297ebd),  -396 },  // 1e-100
+  { GOOGLE_ULONGLONG(0xa6dfbd9fb8e5b88f),  -369 },  // 1e-92
+  { GOOGLE_ULONGLONG(0xf8a95fcf88747d94),  -343 },  // 1e-84
+  { GOOGLE_ULONGLONG(0xb94470938fa89bcf),  -316 },  // 1e-76
+  { GOOGLE_ULONGLONG(0x8a08f0f8bf0f156b),  -289 },  // 1e-68
+  { GOOGLE_ULONGLONG(0xcdb02555653131b6),  -263 },  // 1e-60
+  { GOOGLE_ULONGLONG(0x993fe2c6d07b7fac),  -236 },  // 1e-52
+  { GOOGLE_ULONGLONG(0xe45c10c42a2b3b06),  -210 },  // 1e-44
+  { GOOGLE_ULONGLONG(0xaa242499697392d3),  -183 },  // 1e-36
+  { GOOGLE_ULONGLONG(0xfd87b5f28300ca0e),  -157 },  // 1e-28
+  { GOOGLE_ULONGLONG(0xbce5086492111aeb),  -130 },  // 1e-20
+  { GOOGLE_ULONGLONG(0x8cbccc096f5088cc),  -103 },  // 1e-12
+  { GOOGLE_ULONGLONG(0xd1b71758e219652c),   -77 },  // 1e-4
+  { GOOGLE_ULONGLONG(0x9c40000000000000),   -50 },  // 1e4
+  { GOOGLE_ULONGLONG(0xe8d4a51000000000),   -24 },  // 1e12
+  { GOOGLE_ULONGLONG(0xad78ebc5ac620000),     3 },  // 1e20
+  { GOOGLE_ULONGLONG(0x813f3978f8940984),    30 },  // 1e28
+  { GOOGLE_ULONGLONG(0xc097ce7bc90715b3),    56 },  // 1e36
+  { GOOGLE_ULONGLONG(0x8f7e32ce7bea5c70),    83 },  // 1e44
+  { GOOGLE_ULONGLONG(0xd5d238a4abe98068),   109 },  // 1e52
+  { GOOGLE_ULONGLONG(0x9f4f2726179a2245),   136 },  // 1e60
+  { GOOGLE_ULONGLONG(0xed63a231d4c4fb27),   162 },  // 1e68
+  { GOOGLE_ULONGLONG(0xb0de65388cc8ada8),   189 },  // 1e76
+  { GOOGLE_ULONGLONG(0x83c7088e1aab65db),   216 },  // 1e84
+  { GOOGLE_ULONGLONG(0xc45d1df942711d9a),   242 },  // 1e92
+  { GOOGLE_ULONGLONG(0x924d692ca61be758),   269 },  // 1e100
+  { GOOGLE_ULONGLONG(0xda01ee641a708dea),   295 },  // 1e108
+  { GOOGLE_ULONGLONG(0xa26da3999aef774a),   322 },  // 1e116
+  { GOOGLE_ULONGLONG(0xf209787bb47d6b85),   348 },  // 1e124
+  { GOOGLE_ULONGLONG(0xb454e4a179dd1877),   375 },  // 1e132
+  { GOOGLE_ULONGLONG(0x865b86925b9bc5c2),   402 },  // 1e140
+  { GOOGLE_ULONGLONG(0xc83553c5c8965d3d),   428 },  // 1e148
+  { GOOGLE_ULONGLONG(0x952ab45cfa97a0b3),   455 },  // 1e156
+  { GOOGLE_ULONGLONG(0xde469fbd99a05fe3),   481 },  // 1e164
+  { GOOGLE_ULONGLONG(0xa59bc234db398c25),   508 },  // 1e172
+  { GOOGLE_ULONGLONG(0xf6c69a72a3989f5c),   534 },  // 1e180
+  { GOOGLE_ULONGLONG(0xb7dcbf5354e9bece),   561 },  // 1e188
+  { GOOGLE_ULONGLONG(0x88fcf317f22241e2),   588 },  // 1e196
+  { GOOGLE_ULONGLONG(0xcc20ce9bd35c78a5),   614 },  // 1e204
+  { GOOGLE_ULONGLONG(0x98165af37b2153df),   641 },  // 1e212
+  { GOOGLE_ULONGLONG(0xe2a0b5dc971f303a),   667 },  // 1e220
+  { GOOGLE_ULONGLONG(0xa8d9d1535ce3b396),   694 },  // 1e228
+  { GOOGLE_ULONGLONG(0xfb9b7cd9a4a7443c),   720 },  // 1e236
+  { GOOGLE_ULONGLONG(0xbb764c4ca7a44410),   747 },  // 1e244
+  { GOOGLE_ULONGLONG(0x8bab8eefb6409c1a),   774 },  // 1e252
+  { GOOGLE_ULONGLONG(0xd01fef10a657842c),   800 },  // 1e260
+  { GOOGLE_ULONGLONG(0x9b10a4e5e9913129),   827 },  // 1e268
+  { GOOGLE_ULONGLONG(0xe7109bfba19c0c9d),   853 },  // 1e276
+  { GOOGLE_ULONGLONG(0xac2820d9623bf429),   880 },  // 1e284
+  { GOOGLE_ULONGLONG(0x80444b5e7aa7cf85),   907 },  // 1e292
+  { GOOGLE_ULONGLONG(0xbf21e44003acdd2d),   933 },  // 1e300
+  { GOOGLE_ULONGLONG(0x8e679c2f5e44ff8f),   960 },  // 1e308
+  { GOOGLE_ULONGLONG(0xd433179d9c8cb841),   986 },  // 1e316
+  { GOOGLE_ULONGLONG(0x9e19db92b4e31ba9),  1013 },  // 1e324
+  { GOOGLE_ULONGLONG(0xeb96bf6ebadf77d9),  1039 },  // 1e332
+  { GOOGLE_ULONGLONG(0xaf87023b9bf0ee6b),  1066 },  // 1e340
+};
+
+const int kFirstCachedPower = -348;
+const int kCachedPowerStep = 8;
+
+// Grisu3 needs the scaled value's exponent to be in this range, so that
+// its integral part fits in 32 bits and its fractional part can be
+// multiplied by ten without overflow.
+const int kMinimalTargetExponent = -60;
+const int kMaximalTargetExponent = -32;
+
+// Returns a cached power of ten c = 10^decimal_exponent such that
+// multiplying a normalized DiyFp with exponent e by it gives an exponent in
+// [kMinimalTargetExponent, kMaximalTargetExponent].
+DiyFp GetCachedPower(int e, int* decimal_exponent) {
+  // 1 / log2(10)
+  const double kD_1_LOG2_10 = 0.30102999566398114;
+  int min_exponent = kMinimalTargetExponent - (e + 64);
+  int k = static_cast<int>(ceil((min_exponent + 63) * kD_1_LOG2_10));
+  int index = (-kFirstCachedPower + k - 1) / kCachedPowerStep + 1;
+
+  // The estimate is good, but make sure.
+  const int kCachedPowersSize = GOOGLE_ARRAYSIZE(kCachedPowers);
+  if (index < 0) index = 0;
+  if (index >= kCachedPowersSize) index = kCachedPowersSize - 1;
+  while (index > 0 && e + kCachedPowers[index].binary_exponent + 64 >
+                      kMaximalTargetExponent) {
+    --index;
+  }
+  while (index + 1 < kCachedPowersSize &&
+         e + kCachedPowers[index].binary_exponent + 64 <
+         kMinimalTargetExponent) {
+    ++index;
+  }
+
+  *decimal_exponent = kFirstCachedPower + index * kCachedPowerStep;
+  return DiyFp(kCachedPowers[index].significand,
+               kCachedPowers[index].binary_exponent);
+}
+
+// Returns the biggest power of ten which is at most number, and its
+// exponent plus one.  Both are zero if number is zero.
+void BiggestPowerTen(uint32 number, uint32* power, int* exponent_plus_one) {
+  if (number == 0) {
+    *power = 0;
+    *exponent_plus_one = 0;
     return;
   }
+  *power = 1;
+  *exponent_plus_one = 1;
+  while (*exponent_plus_one < 10 && number / 10 >= *power) {
+    *power *= 10;
+    ++*exponent_plus_one;
+  }
+}
+
+// Moves the last digit of the buffer down while that brings it closer to
+// w, then checks that the result is safely inside the rounding interval.
+// distance_too_high_w is the distance from the widened upper boundary to w,
+// unsafe_interval the size of the widened interval, rest the distance from
+// the upper boundary to the digits, ten_kappa the value of one unit of the
+// last digit, and unit the size of the error.  See the paper for details.
+bool RoundWeed(char* buffer, int length, uint64 distance_too_high_w,
+               uint64 unsafe_interval, uint64 rest, uint64 ten_kappa,
+               uint64 unit) {
+  uint64 small_distance = distance_too_high_w - unit;
+  uint64 big_distance = distance_too_high_w + unit;
+
+  while (rest < small_distance &&
+         unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_distance ||
+          small_distance - rest >= rest + ten_kappa - small_distance)) {
+    buffer[length - 1]--;
+    rest += ten_kappa;
+  }
+
+  // If the digits would be closer to the far end of w's error bounds after
+  // another decrement, we can't tell which candidate is right.
+  if (rest < big_distance &&
+      unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_distance ||
+       big_distance - rest > rest + ten_kappa - big_distance)) {
+    return false;
+  }
+
+  return (2 * unit <= rest) && (rest <= unsafe_interval - 4 * unit);
+}
+
+// Generates the shortest digits for w, whose rounding interval is
+// (low, high), all scaled by a cached power of ten.  On return, the value
+// is approximately buffer * 10^*kappa.  Returns false if the digits might
+// not be the shortest or might not round-trip.
+bool DigitGen(const DiyFp& low, const DiyFp& w, const DiyFp& high,
+              char* buffer, int* length, int* kappa) {
+  // low, w and high are each off by less than one unit, so widen the
+  // interval by that much here and check the result against the narrow one
+  // in RoundWeed().
+  uint64 unit = 1;
+  DiyFp too_low(low.f - unit, low.e);
+  DiyFp too_high(high.f + unit, high.e);
+  DiyFp unsafe_interval = Subtract(too_high, too_low);
+
+  // Split too_high into integral and fractional parts.
+  DiyFp one(GOOGLE_ULONGLONG(1) << -w.e, w.e);
+  uint32 integrals = static_cast<uint32>(too_high.f >> -one.e);
+  uint64 fractionals = too_high.f & (one.f - 1);
+
+  uint32 divisor;
+  int divisor_exponent_plus_one;
+  BiggestPowerTen(integrals, &divisor, &divisor_exponent_plus_one);
+  *kappa = divisor_exponent_plus_one;
+  *length = 0;
+
+  while (*kappa > 0) {
+    int digit = integrals / divisor;
+    buffer[(*length)++] = '0' + digit;
+    integrals %= divisor;
+    --*kappa;
+    uint64 rest = (static_cast<uint64>(integrals) << -one.e) + fractionals;
+    if (rest < unsafe_interval.f) {
+      return RoundWeed(buffer, *length, Subtract(too_high, w).f,
+                       unsafe_interval.f, rest,
+                       static_cast<uint64>(divisor) << -one.e, unit);
+    }
+    divisor /= 10;
+  }
+
+  while (true) {
+    fractionals *= 10;
+    unit *= 10;
+    unsafe_interval.f *= 10;
+    int digit = static_cast<int>(fractionals >> -one.e);
+    buffer[(*length)++] = '0' + digit;
+    fractionals &= one.f - 1;
+    --*kappa;
+    if (fractionals < unsafe_interval.f) {
+      return RoundWeed(buffer, *length, Subtract(too_high, w).f * unit,
+                       unsafe_interval.f, fractionals, one.f, unit);
+    }
+  }
+}
+
+// Runs Grisu3 on the value significand * 2^exponent.  lower_boundary_is_closer
+// is true if the next smaller value is only half as far away as the next
+// larger one, i.e. the significand is a power of two.  On success, the value
+// prints as digits * 10^*decimal_exponent.
+bool Grisu3(uint64 significand, int exponent, bool lower_boundary_is_closer,
+            char* digits, int* length, int* decimal_exponent) {
+  DiyFp w = Normalize(DiyFp(significand, exponent));
+
+  // The boundaries are halfway to the neighboring values.
+  DiyFp boundary_plus = Normalize(DiyFp((significand << 1) + 1, exponent - 1));
+  DiyFp boundary_minus =
+    lower_boundary_is_closer ? DiyFp((significand << 2) - 1, exponent - 2)
+                             : DiyFp((significand << 1) - 1, exponent - 1);
+  boundary_minus.f <<= boundary_minus.e - boundary_plus.e;
+  boundary_minus.e = boundary_plus.e;
+
+  int cached_exponent;
+  DiyFp cached_power = GetCachedPower(w.e, &cached_exponent);
+
+  int kappa;
+  bool result = DigitGen(Multiply(boundary_minus, cached_power),
+                         Multiply(w, cached_power),
+                         Multiply(boundary_plus, cached_power),
+                         digits, length, &kappa);
+  *decimal_exponent = kappa - cached_exponent;
+  return result;
+}
+
+// Fallback for when Grisu3 fails:  the shortest "%.*e" output which parses
+// back to the same value, as digits * 10^*decimal_exponent.  The value must
+// be positive.
+template <typename FloatType>
+void PrintfDigits(FloatType value, int min_precision, int max_precision,
+                  char* digits, int* length, int* decimal_exponent) {
+  char buffer[kDoubleToBufferSize];
+  for (int precision = min_precision; ; precision++) {
+    snprintf(buffer, sizeof(buffer), "%.*e", precision - 1,
+             static_cast<double>(value));
+    if (precision == max_precision) break;
+    volatile FloatType parsed_value =
+      static_cast<FloatType>(NoLocaleStrtod(buffer, NULL));
+    if (parsed_value == value) break;
+  }
+
+  // Pick out the digits, skipping the radix (whatever it is in the current
+  // locale), up to the exponent.
+  const char* ptr = buffer;
+  *length = 0;
+  for (; *ptr != 'e'; ptr++) {
+    if ('0' <= *ptr && *ptr <= '9') digits[(*length)++] = *ptr;
+  }
+  *decimal_exponent = atoi(ptr + 1) - (*length - 1);
+}
 
-  // We are now pointing at the locale-specific radix character.  Replace it
-  // with '.'.
-  *buffer = '.';
-  ++buffer;
-
-  if (!IsValidFloatChar(*buffer) && *buffer != '\0') {
-    // It appears the radix was a multi-byte character.  We need to remove the
-    // extra bytes.
-    char* target = buffer;
-    do { ++buffer; } while (!IsValidFloatChar(*buffer) && *buffer != '\0');
-    memmove(target, buffer, strlen(buffer) + 1);
+// Lays out the digits the way "%.*g" does with the given precision:  in
+// fixed notation if the exponent is at least -4 and less than the
+// precision, and in exponential notation otherwise.  Trailing zeros are
+// dropped either way.
+char* FormatDigits(bool negative, const char* digits, int length,
+                   int decimal_exponent, int precision, char* buffer) {
+  while (length > 1 && digits[length - 1] == '0') {
+    --length;
+    ++decimal_exponent;
   }
+
+  char* out = buffer;
+  if (negative) *out++ = '-';
+
+  int exponent = length + decimal_exponent - 1;  // Of the first digit.
+  if (exponent < -4 || exponent >= precision) {
+    *out++ = digits[0];
+    if (length > 1) {
+      *out++ = '.';
+      memcpy(out, digits + 1, length - 1);
+      out += length - 1;
+    }
+    *out++ = 'e';
+    if (exponent < 0) {
+      *out++ = '-';
+      exponent = -exponent;
+    } else {
+      *out++ = '+';
+    }
+    if (exponent < 10) *out++ = '0';
+    FastInt32ToBufferLeft(exponent, out);
+  } else if (exponent < 0) {
+    *out++ = '0';
+    *out++ = '.';
+    for (int i = -1; i > exponent; i--) *out++ = '0';
+    memcpy(out, digits, length);
+    out[length] = '\0';
+  } else if (length <= exponent + 1) {
+    memcpy(out, digits, length);
+    out += length;
+    for (int i = length; i <= exponent; i++) *out++ = '0';
+    *out = '\0';
+  } else {
+    memcpy(out, digits, exponent + 1);
+    out += exponent + 1;
+    *out++ = '.';
+    memcpy(out, digits + exponent + 1, length - exponent - 1);
+    out[length - exponent - 1] = '\0';
+  }
+  return buffer;
 }
 
+}  // namespace
+
 char* DoubleToBuffer(double value, char* buffer) {
   // DBL_DIG is 15 for IEEE-754 doubles, which are used on almost all
   // platforms these days.  Just in case some system exists where DBL_DIG
@@ -998,30 +1353,43 @@ char* DoubleToBuffer(double value, char* buffer) {
     return buffer;
   }
 
-  int snprintf_result =
-    snprintf(buffer, kDoubleToBufferSize, "%.*g", DBL_DIG, value);
-
-  // The snprintf should never overflow because the buffer is significantly
-  // larger than the precision we asked for.
-  GOOGLE_DCHECK(snprintf_result > 0 && snprintf_result < kDoubleToBufferSize);
-
-  // We need to make parsed_value volatile in order to force the compiler to
-  // write it out to the stack.  Otherwise, it may keep the value in a
-  // register, and if it does that, it may keep it as a long double instead
-  // of a double.  This long double may have extra bits that make it compare
-  // unequal to "value" even though it would be exactly equal if it were
-  // truncated to a double.
-  volatile double parsed_value = strtod(buffer, NULL);
-  if (parsed_value != value) {
-    int snprintf_result =
-      snprintf(buffer, kDoubleToBufferSize, "%.*g", DBL_DIG+2, value);
-
-    // Should never overflow; see above.
-    GOOGLE_DCHECK(snprintf_result > 0 && snprintf_result < kDoubleToBufferSize);
+  uint64 bits;
+  GOOGLE_COMPILE_ASSERT(sizeof(bits) == sizeof(value), double_is_not_64_bits);
+  memcpy(&bits, &value, sizeof(bits));
+  bool negative = (bits >> 63) != 0;
+  int biased_exponent = static_cast<int>((bits >> 52) & 0x7FF);
+  uint64 fraction = bits & ((GOOGLE_ULONGLONG(1) << 52) - 1);
+
+  if (biased_exponent == 0 && fraction == 0) {
+    strcpy(buffer, negative ? "-0" : "0");
+    return buffer;
   }
 
-  DelocalizeRadix(buffer);
-  return buffer;
+  uint64 significand;
+  int exponent;
+  if (biased_exponent == 0) {
+    // Denormal.
+    significand = fraction;
+    exponent = 1 - 1075;
+  } else {
+    significand = fraction | (GOOGLE_ULONGLONG(1) << 52);
+    exponent = biased_exponent - 1075;
+  }
+
+  // 17 digits always suffice for a double.
+  char digits[kDoubleToBufferSize];
+  int length;
+  int decimal_exponent;
+  if (!Grisu3(significand, exponent, fraction == 0 && biased_exponent > 1,
+              digits, &length, &decimal_exponent)) {
+    PrintfDigits(negative ? -value : value, DBL_DIG, DBL_DIG + 2,
+                 digits, &length, &decimal_exponent);
+  }
+
+  // Switch to exponential notation where "%.*g" with the precision the old
+  // strategy would have needed for this many digits would have.
+  return FormatDigits(negative, digits, length, decimal_exponent,
+                      length > DBL_DIG ? DBL_DIG + 2 : DBL_DIG, buffer);
 }
 
 bool safe_strtof(const char* str, float* value) {
@@ -1053,24 +1421,42 @@ char* FloatToBuffer(float value, char* buffer) {
     return buffer;
   }
 
-  int snprintf_result =
-    snprintf(buffer, kFloatToBufferSize, "%.*g", FLT_DIG, value);
+  uint32 bits;
+  GOOGLE_COMPILE_ASSERT(sizeof(bits) == sizeof(value), float_is_not_32_bits);
+  memcpy(&bits, &value, sizeof(bits));
+  bool negative = (bits >> 31) != 0;
+  int biased_exponent = static_cast<int>((bits >> 23) & 0xFF);
+  uint32 fraction = bits & ((1u << 23) - 1);
 
-  // The snprintf should never overflow because the buffer is significantly
-  // larger than the precision we asked for.
-  GOOGLE_DCHECK(snprintf_result > 0 && snprintf_result < kFloatToBufferSize);
+  if (biased_exponent == 0 && fraction == 0) {
+    strcpy(buffer, negative ? "-0" : "0");
+    return buffer;
+  }
 
-  float parsed_value;
-  if (!safe_strtof(buffer, &parsed_value) || parsed_value != value) {
-    int snprintf_result =
-      snprintf(buffer, kFloatToBufferSize, "%.*g", FLT_DIG+2, value);
+  uint64 significand;
+  int exponent;
+  if (biased_exponent == 0) {
+    // Denormal.
+    significand = fraction;
+    exponent = 1 - 150;
+  } else {
+    significand = fraction | (1u << 23);
+    exponent = biased_exponent - 150;
+  }
 
-    // Should never overflow; see above.
-    GOOGLE_DCHECK(snprintf_result > 0 && snprintf_result < kFloatToBufferSize);
+  // 9 digits always suffice for a float.
+  char digits[kDoubleToBufferSize];
+  int length;
+  int decimal_exponent;
+  if (!Grisu3(significand, exponent, fraction == 0 && biased_exponent > 1,
+              digits, &length, &decimal_exponent)) {
+    PrintfDigits(negative ? -value : value, FLT_DIG, FLT_DIG + 3,
+                 digits, &length, &decimal_exponent);
   }
 
-  DelocalizeRadix(buffer);
-  return buffer;
+  // As for doubles.
+  return FormatDigits(negative, digits, length, decimal_exponent,
+                      length > FLT_DIG ? FLT_DIG + 2 : FLT_DIG, buffer);
 }
 
 // ----------------------------------------------------------------------
@@ -1137,5 +1523,1004 @@ double NoLocaleStrtod(const char* text, char** original_endptr) {
   return result;
 }
 
+// ----------------------------------------------------------------------
+// ParseDouble()
+// ParseUnsignedDigits()
+//    The double parser first tries Clinger's fast path, which is exact
+//    when both the significand and the power of ten are exactly
+//    representable as doubles.  Otherwise it uses the Eisel-Lemire
+//    algorithm (Daniel Lemire, "Number Parsing at a Gigabyte per Second",
+//    2021), which multiplies the significand by a 128-bit approximation of
+//    the power of ten and can tell when the truncated product is too close
+//    to a rounding boundary to decide.  Those rare cases go to strtod().
+// ----------------------------------------------------------------------
+
+namespace {
+
+// Truncated 128-bit approximations of 10^k for k = kMinParsePower, ...,
+// kMaxParsePower, normalized so that the top bit is set.  Each entry is
+// { low 64 bits, high 64 bits }.
+const int kMinParsePower = -348;
+const int kMaxParsePower = 347;
+
+const uint64 kParsePowers[][2] = {
+  { GOOGLE_ULONGLONG(0x1732c869cd60e453), GOOGLE_ULONGLONG(0xfa8fd5a0081c0288) },  // 1e-348
+  { GOOGLE_ULONGLONG(0x0e7fbd42205c8eb4), GOOGLE_ULONGLONG(0x9c99e58405118195) },  // 1e-347
+  { GOOGLE_ULONGLONG(0x521fac92a873b261), GOOGLE_ULONGLONG(0xc3c05ee50655e1fa) },  // 1e-346
+  { GOOGLE_ULONGLONG(0xe6a797b752909ef9), GOOGLE_ULONGLONG(0xf4b0769e47eb5a78) },  // 1e-345
+  { GOOGLE_ULONGLONG(0x9028bed2939a635c), GOOGLE_ULONGLONG(0x98ee4a22ecf3188b) },  // 1e-344
+  { GOOGLE_ULONGLONG(0x7432ee873880fc33), GOOGLE_ULONGLONG(0xbf29dcaba82fdeae) },  // 1e-343
+  { GOOGLE_ULONGLONG(0x113faa2906a13b3f), GOOGLE_ULONGLONG(0xeef453d6923bd65a) },  // 1e-342
+  { GOOGLE_ULONGLONG(0x4ac7ca59a424c507), GOOGLE_ULONGLONG(0x9558b4661b6565f8) },  // 1e-341
+  { GOOGLE_ULONGLONG(0x5d79bcf00d2df649), GOOGLE_ULONGLONG(0xbaaee17fa23ebf76) },  // 1e-340
+  { GOOGLE_ULONGLONG(0xf4d82c2c107973dc), GOOGLE_ULONGLONG(0xe95a99df8ace6f53) },  // 1e-339
+  { GOOGLE_ULONGLONG(0x79071b9b8a4be869), GOOGLE_ULONGLONG(0x91d8a02bb6c10594) },  // 1e-338
+  { GOOGLE_ULONGLONG(0x9748e2826cdee284), GOOGLE_ULONGLONG(0xb64ec836a47146f9) },  // 1e-337
+  { GOOGLE_ULONGLONG(0xfd1b1b2308169b25), GOOGLE_ULONGLONG(0xe3e27a444d8d98b7) },  // 1e-336
+  { GOOGLE_ULONGLONG(0xfe30f0f5e50e20f7), GOOGLE_ULONGLONG(0x8e6d8c6ab0787f72) },  // 1e-335
+  { GOOGLE_ULONGLONG(0xbdbd2d335e51a935), GOOGLE_ULONGLONG(0xb208ef855c969f4f) },  // 1e-334
+  { GOOGLE_ULONGLONG(0xad2c788035e61382), GOOGLE_ULONGLONG(0xde8b2b66b3bc4723) },  // 1e-333
+  { GOOGLE_ULONGLONG(0x4c3bcb5021afcc31), GOOGLE_ULONGLONG(0x8b16fb203055ac76) },  // 1e-332
+  { GOOGLE_ULONGLONG(0xdf4abe242a1bbf3d), GOOGLE_ULONGLONG(0xaddcb9e83c6b1793) },  // 1e-331
+  { GOOGLE_ULONGLONG(0xd71d6dad34a2af0d), GOOGLE_ULONGLONG(0xd953e8624b85dd78) },  // 1e-330
+  { GOOGLE_ULONGLONG(0x8672648c40e5ad68), GOOGLE_ULONGLONG(0x87d4713d6f33aa6b) },  // 1e-329
+  { GOOGLE_ULONGLONG(0x680efdaf511f18c2), GOOGLE_ULONGLONG(0xa9c98d8ccb009506) },  // 1e-328
+  { GOOGLE_ULONGLONG(0x0212bd1b2566def2), GOOGLE_ULONGLONG(0xd43bf0effdc0ba48) },  // 1e-327
+  { GOOGLE_ULONGLONG(0x014bb630f7604b57), GOOGLE_ULONGLONG(0x84a57695fe98746d) },  // 1e-326
+  { GOOGLE_ULONGLONG(0x419ea3bd35385e2d), GOOGLE_ULONGLONG(0xa5ced43b7e3e9188) },  // 1e-325
+  { GOOGLE_ULONGLONG(0x52064cac828675b9), GOOGLE_ULONGLONG(0xcf42894a5dce35ea) },  // 1e-324
+  { GOOGLE_ULONGLONG(0x7343efebd1940993), GOOGLE_ULONGLONG(0x818995ce7aa0e1b2) },  // 1e-323
+  { GOOGLE_ULONGLONG(0x1014ebe6c5f90bf8), GOOGLE_ULONGLONG(0xa1ebfb4219491a1f) },  // 1e-322
+  { GOOGLE_ULONGLONG(0xd41a26e077774ef6), GOOGLE_ULONGLONG(0xca66fa129f9b60a6) },  // 1e-321
+  { GOOGLE_ULONGLONG(0x8920b098955522b4), GOOGLE_ULONGLONG(0xfd00b897478238d0) },  // 1e-320
+  { GOOGLE_ULONGLONG(0x55b46e5f5d5535b0), GOOGLE_ULONGLONG(0x9e20735e8cb16382) },  // 1e-319
+  { GOOGLE_ULONGLONG(0xeb2189f734aa831d), GOOGLE_ULONGLONG(0xc5a890362fddbc62) },  // 1e-318
+  { GOOGLE_ULONGLONG(0xa5e9ec7501d523e4), GOOGLE_ULONGLONG(0xf712b443bbd52b7b) },  // 1e-317
+  { GOOGLE_ULONGLONG(0x47b233c92125366e), GOOGLE_ULONGLONG(0x9a6bb0aa55653b2d) },  // 1e-316
+  { GOOGLE_ULONGLONG(0x999ec0bb696e840a), GOOGLE_ULONGLONG(0xc1069cd4eabe89f8) },  // 1e-315
+  { GOOGLE_ULONGLONG(0xc00670ea43ca250d), GOOGLE_ULONGLONG(0xf148440a256e2c76) },  // 1e-314
+  { GOOGLE_ULONGLONG(0x380406926a5e5728), GOOGLE_ULONGLONG(0x96cd2a865764dbca) },  // 1e-313
+  { GOOGLE_ULONGLONG(0xc605083704f5ecf2), GOOGLE_ULONGLONG(0xbc807527ed3e12bc) },  // 1e-312
+  { GOOGLE_ULONGLONG(0xf7864a44c633682e), GOOGLE_ULONGLONG(0xeba09271e88d976b) },  // 1e-311
+  { GOOGLE_ULONGLONG(0x7ab3ee6afbe0211d), GOOGLE_ULONGLONG(0x93445b8731587ea3) },  // 1e-310
+  { GOOGLE_ULONGLONG(0x5960ea05bad82964), GOOGLE_ULONGLONG(0xb8157268fdae9e4c) },  // 1e-309
+  { GOOGLE_ULONGLONG(0x6fb92487298e33bd), GOOGLE_ULONGLONG(0xe61acf033d1a45df) },  // 1e-308
+  { GOOGLE_ULONGLONG(0xa5d3b6d479f8e056), GOOGLE_ULONGLONG(0x8fd0c16206306bab) },  // 1e-307
+  { GOOGLE_ULONGLONG(0x8f48a4899877186c), GOOGLE_ULONGLONG(0xb3c4f1ba87bc8696) },  // 1e-306
+  { GOOGLE_ULONGLONG(0x331acdabfe94de87), GOOGLE_ULONGLONG(0xe0b62e2929aba83c) },  // 1e-305
+  { GOOGLE_ULONGLONG(0x9ff0c08b7f1d0b14), GOOGLE_ULONGLONG(0x8c71dcd9ba0b4925) },  // 1e-304
+  { GOOGLE_ULONGLONG(0x07ecf0ae5ee44dd9), GOOGLE_ULONGLONG(0xaf8e5410288e1b6f) },  // 1e-303
+  { GOOGLE_ULONGLONG(0xc9e82cd9f69d6150), GOOGLE_ULONGLONG(0xdb71e91432b1a24a) },  // 1e-302
+  { GOOGLE_ULONGLONG(0xbe311c083a225cd2), GOOGLE_ULONGLONG(0x892731ac9faf056e) },  // 1e-301
+  { GOOGLE_ULONGLONG(0x6dbd630a48aaf406), GOOGLE_ULONGLONG(0xab70fe17c79ac6ca) },  // 1e-300
+  { GOOGLE_ULONGLONG(0x092cbbccdad5b108), GOOGLE_ULONGLONG(0xd64d3d9db981787d) },  // 1e-299
+  { GOOGLE_ULONGLONG(0x25bbf56008c58ea5), GOOGLE_ULONGLONG(0x85f0468293f0eb4e) },  // 1e-298
+  { GOOGLE_ULONGLONG(0xaf2af2b80af6f24e), GOOGLE_ULONGLONG(0xa76c582338ed2621) },  // 1e-297
+  { GOOGLE_ULONGLONG(0x1af5af660db4aee1), GOOGLE_ULONGLONG(0xd1476e2c07286faa) },  // 1e-296
+  { GOOGLE_ULONGLONG(0x50d98d9fc890ed4d), GOOGLE_ULONGLONG(0x82cca4db847945ca) },  // 1e-295
+  { GOOGLE_ULONGLONG(0xe50ff107bab528a0), GOOGLE_ULONGLONG(0xa37fce126597973c) },  // 1e-294
+  { GOOGLE_ULONGLONG(0x1e53ed49a96272c8), GOOGLE_ULONGLONG(0xcc5fc196fefd7d0c) },  // 1e-293
+  { GOOGLE_ULONGLONG(0x25e8e89c13bb0f7a), GOOGLE_ULONGLONG(0xff77b1fcbebcdc4f) },  // 1e-292
+  { GOOGLE_ULONGLONG(0x77b191618c54e9ac), GOOGLE_ULONGLONG(0x9faacf3df73609b1) },  // 1e-291
+  { GOOGLE_ULONGLONG(0xd59df5b9ef6a2417), GOOGLE_ULONGLONG(0xc795830d75038c1d) },  // 1e-290
+  { GOOGLE_ULONGLONG(0x4b0573286b44ad1d), GOOGLE_ULONGLONG(0xf97ae3d0d2446f25) },  // 1e-289
+  { GOOGLE_ULONGLONG(0x4ee367f9430aec32), GOOGLE_ULONGLONG(0x9becce62836ac577) },  // 1e-288
+  { GOOGLE_ULONGLONG(0x229c41f793cda73f), GOOGLE_ULONGLONG(0xc2e801fb244576d5) },  // 1e-287
+  { GOOGLE_ULONGLONG(0x6b43527578c1110f), GOOGLE_ULONGLONG(0xf3a20279ed56d48a) },  // 1e-286
+  { GOOGLE_ULONGLONG(0x830a13896b78aaa9), GOOGLE_ULONGLONG(0x9845418c345644d6) },  // 1e-285
+  { GOOGLE_ULONGLONG(0x23cc986bc656d553), GOOGLE_ULONGLONG(0xbe5691ef416bd60c) },  // 1e-284
+  { GOOGLE_ULONGLONG(0x2cbfbe86b7ec8aa8), GOOGLE_ULONGLONG(0xedec366b11c6cb8f) },  // 1e-283
+  { GOOGLE_ULONGLONG(0x7bf7d71432f3d6a9), GOOGLE_ULONGLONG(0x94b3a202eb1c3f39) },  // 1e-282
+  { GOOGLE_ULONGLONG(0xdaf5ccd93fb0cc53), GOOGLE_ULONGLONG(0xb9e08a83a5e34f07) },  // 1e-281
+  { GOOGLE_ULONGLONG(0xd1b3400f8f9cff68), GOOGLE_ULONGLONG(0xe858ad248f5c22c9) },  // 1e-280
+  { GOOGLE_ULONGLONG(0x23100809b9c21fa1), GOOGLE_ULONGLONG(0x91376c36d99995be) },  // 1e-279
+  { GOOGLE_ULONGLONG(0xabd40a0c2832a78a), GOOGLE_ULONGLONG(0xb58547448ffffb2d) },  // 1e-278
+  { GOOGLE_ULONGLONG(0x16c90c8f323f516c), GOOGLE_ULONGLONG(0xe2e69915b3fff9f9) },  // 1e-277
+  { GOOGLE_ULONGLONG(0xae3da7d97f6792e3), GOOGLE_ULONGLONG(0x8dd01fad907ffc3b) },  // 1e-276
+  { GOOGLE_ULONGLONG(0x99cd11cfdf41779c), GOOGLE_ULONGLONG(0xb1442798f49ffb4a) },  // 1e-275
+  { GOOGLE_ULONGLONG(0x40405643d711d583), GOOGLE_ULONGLONG(0xdd95317f31c7fa1d) },  // 1e-274
+  { GOOGLE_ULONGLONG(0x482835ea666b2572), GOOGLE_ULONGLONG(0x8a7d3eef7f1cfc52) },  // 1e-273
+  { GOOGLE_ULONGLONG(0xda3243650005eecf), GOOGLE_ULONGLONG(0xad1c8eab5ee43b66) },  // 1e-272
+  { GOOGLE_ULONGLONG(0x90bed43e40076a82), GOOGLE_ULONGLONG(0xd863b256369d4a40) },  // 1e-271
+  { GOOGLE_ULONGLONG(0x5a7744a6e804a291), GOOGLE_ULONGLONG(0x873e4f75e2224e68) },  // 1e-270
+  { GOOGLE_ULONGLONG(0x711515d0a205cb36), GOOGLE_ULONGLONG(0xa90de3535aaae202) },  // 1e-269
+  { GOOGLE_ULONGLONG(0x0d5a5b44ca873e03), GOOGLE_ULONGLONG(0xd3515c2831559a83) },  // 1e-268
+  { GOOGLE_ULONGLONG(0xe858790afe9486c2), GOOGLE_ULONGLONG(0x8412d9991ed58091) },  // 1e-267
+  { GOOGLE_ULONGLONG(0x626e974dbe39a872), GOOGLE_ULONGLONG(0xa5178fff668ae0b6) },  // 1e-266
+  { GOOGLE_ULONGLONG(0xfb0a3d212dc8128f), GOOGLE_ULONGLONG(0xce5d73ff402d98e3) },  // 1e-265
+  { GOOGLE_ULONGLONG(0x7ce66634bc9d0b99), GOOGLE_ULONGLONG(0x80fa687f881c7f8e) },  // 1e-264
+  { GOOGLE_ULONGLONG(0x1c1fffc1ebc44e80), GOOGLE_ULONGLONG(0xa139029f6a239f72) },  // 1e-263
+  { GOOGLE_ULONGLONG(0xa327ffb266b56220), GOOGLE_ULONGLONG(0xc987434744ac874e) },  // 1e-262
+  { GOOGLE_ULONGLONG(0x4bf1ff9f0062baa8), GOOGLE_ULONGLONG(0xfbe9141915d7a922) },  // 1e-261
+  { GOOGLE_ULONGLONG(0x6f773fc3603db4a9), GOOGLE_ULONGLONG(0x9d71ac8fada6c9b5) },  // 1e-260
+  { GOOGLE_ULONGLONG(0xcb550fb4384d21d3), GOOGLE_ULONGLONG(0xc4ce17b399107c22) },  // 1e-259
+  { GOOGLE_ULONGLONG(0x7e2a53a146606a48), GOOGLE_ULONGLONG(0xf6019da07f549b2b) },  // 1e-258
+  { GOOGLE_ULONGLONG(0x2eda7444cbfc426d), GOOGLE_ULONGLONG(0x99c102844f94e0fb) },  // 1e-257
+  { GOOGLE_ULONGLONG(0xfa911155fefb5308), GOOGLE_ULONGLONG(0xc0314325637a1939) },  // 1e-256
+  { GOOGLE_ULONGLONG(0x793555ab7eba27ca), GOOGLE_ULONGLONG(0xf03d93eebc589f88) },  // 1e-255
+  { GOOGLE_ULONGLONG(0x4bc1558b2f3458de), GOOGLE_ULONGLONG(0x96267c7535b763b5) },  // 1e-254
+  { GOOGLE_ULONGLONG(0x9eb1aaedfb016f16), GOOGLE_ULONGLONG(0xbbb01b9283253ca2) },  // 1e-253
+  { GOOGLE_ULONGLONG(0x465e15a979c1cadc), GOOGLE_ULONGLONG(0xea9c227723ee8bcb) },  // 1e-252
+  { GOOGLE_ULONGLONG(0x0bfacd89ec191ec9), GOOGLE_ULONGLONG(0x92a1958a7675175f) },  // 1e-251
+  { GOOGLE_ULONGLONG(0xcef980ec671f667b), GOOGLE_ULONGLONG(0xb749faed14125d36) },  // 1e-250
+  { GOOGLE_ULONGLONG(0x82b7e12780e7401a), GOOGLE_ULONGLONG(0xe51c79a85916f484) },  // 1e-249
+  { GOOGLE_ULONGLONG(0xd1b2ecb8b0908810), GOOGLE_ULONGLONG(0x8f31cc0937ae58d2) },  // 1e-248
+  { GOOGLE_ULONGLONG(0x861fa7e6dcb4aa15), GOOGLE_ULONGLONG(0xb2fe3f0b8599ef07) },  // 1e-247
+  { GOOGLE_ULONGLONG(0x67a791e093e1d49a), GOOGLE_ULONGLONG(0xdfbdcece67006ac9) },  // 1e-246
+  { GOOGLE_ULONGLONG(0xe0c8bb2c5c6d24e0), GOOGLE_ULONGLONG(0x8bd6a141006042bd) },  // 1e-245
+  { GOOGLE_ULONGLONG(0x58fae9f773886e18), GOOGLE_ULONGLONG(0xaecc49914078536d) },  // 1e-244
+  { GOOGLE_ULONGLONG(0xaf39a475506a899e), GOOGLE_ULONGLONG(0xda7f5bf590966848) },  // 1e-243
+  { GOOGLE_ULONGLONG(0x6d8406c952429603), GOOGLE_ULONGLONG(0x888f99797a5e012d) },  // 1e-242
+  { GOOGLE_ULONGLONG(0xc8e5087ba6d33b83), GOOGLE_ULONGLONG(0xaab37fd7d8f58178) },  // 1e-241
+  { GOOGLE_ULONGLONG(0xfb1e4a9a90880a64), GOOGLE_ULONGLONG(0xd5605fcdcf32e1d6) },  // 1e-240
+  { GOOGLE_ULONGLONG(0x5cf2eea09a55067f), GOOGLE_ULONGLONG(0x855c3be0a17fcd26) },  // 1e-239
+  { GOOGLE_ULONGLONG(0xf42faa48c0ea481e), GOOGLE_ULONGLONG(0xa6b34ad8c9dfc06f) },  // 1e-238
+  { GOOGLE_ULONGLONG(0xf13b94daf124da26), GOOGLE_ULONGLONG(0xd0601d8efc57b08b) },  // 1e-237
+  { GOOGLE_ULONGLONG(0x76c53d08d6b70858), GOOGLE_ULONGLONG(0x823c12795db6ce57) },  // 1e-236
+  { GOOGLE_ULONGLONG(0x54768c4b0c64ca6e), GOOGLE_ULONGLONG(0xa2cb1717b52481ed) },  // 1e-235
+  { GOOGLE_ULONGLONG(0xa9942f5dcf7dfd09), GOOGLE_ULONGLONG(0xcb7ddcdda26da268) },  // 1e-234
+  { GOOGLE_ULONGLONG(0xd3f93b35435d7c4c), GOOGLE_ULONGLONG(0xfe5d54150b090b02) },  // 1e-233
+  { GOOGLE_ULONGLONG(0xc47bc5014a1a6daf), GOOGLE_ULONGLONG(0x9efa548d26e5a6e1) },  // 1e-232
+  { GOOGLE_ULONGLONG(0x359ab6419ca1091b), GOOGLE_ULONGLONG(0xc6b8e9b0709f109a) },  // 1e-231
+  { GOOGLE_ULONGLONG(0xc30163d203c94b62), GOOGLE_ULONGLONG(0xf867241c8cc6d4c0) },  // 1e-230
+  { GOOGLE_ULONGLONG(0x79e0de63425dcf1d), GOOGLE_ULONGLONG(0x9b407691d7fc44f8) },  // 1e-229
+  { GOOGLE_ULONGLONG(0x985915fc12f542e4), GOOGLE_ULONGLONG(0xc21094364dfb5636) },  // 1e-228
+  { GOOGLE_ULONGLONG(0x3e6f5b7b17b2939d), GOOGLE_ULONGLONG(0xf294b943e17a2bc4) },  // 1e-227
+  { GOOGLE_ULONGLONG(0xa705992ceecf9c42), GOOGLE_ULONGLONG(0x979cf3ca6cec5b5a) },  // 1e-226
+  { GOOGLE_ULONGLONG(0x50c6ff782a838353), GOOGLE_ULONGLONG(0xbd8430bd08277231) },  // 1e-225
+  { GOOGLE_ULONGLONG(0xa4f8bf5635246428), GOOGLE_ULONGLONG(0xece53cec4a314ebd) },  // 1e-224
+  { GOOGLE_ULONGLONG(0x871b7795e136be99), GOOGLE_ULONGLONG(0x940f4613ae5ed136) },  // 1e-223
+  { GOOGLE_ULONGLONG(0x28e2557b59846e3f), GOOGLE_ULONGLONG(0xb913179899f68584) },  // 1e-222
+  { GOOGLE_ULONGLONG(0x331aeada2fe589cf), GOOGLE_ULONGLONG(0xe757dd7ec07426e5) },  // 1e-221
+  { GOOGLE_ULONGLONG(0x3ff0d2c85def7621), GOOGLE_ULONGLONG(0x9096ea6f3848984f) },  // 1e-220
+  { GOOGLE_ULONGLONG(0x0fed077a756b53a9), GOOGLE_ULONGLONG(0xb4bca50b065abe63) },  // 1e-219
+  { GOOGLE_ULONGLONG(0xd3e8495912c62894), GOOGLE_ULONGLONG(0xe1ebce4dc7f16dfb) },  // 1e-218
+  { GOOGLE_ULONGLONG(0x64712dd7abbbd95c), GOOGLE_ULONGLONG(0x8d3360f09cf6e4bd) },  // 1e-217
+  { GOOGLE_ULONGLONG(0xbd8d794d96aacfb3), GOOGLE_ULONGLONG(0xb080392cc4349dec) },  // 1e-216
+  { GOOGLE_ULONGLONG(0xecf0d7a0fc5583a0), GOOGLE_ULONGLONG(0xdca04777f541c567) },  // 1e-215
+  { GOOGLE_ULONGLONG(0xf41686c49db57244), GOOGLE_ULONGLONG(0x89e42caaf9491b60) },  // 1e-214
+  { GOOGLE_ULONGLONG(0x311c2875c522ced5), GOOGLE_ULONGLONG(0xac5d37d5b79b6239) },  // 1e-213
+  { GOOGLE_ULONGLONG(0x7d633293366b828b), GOOGLE_ULONGLONG(0xd77485cb25823ac7) },  // 1e-212
+  { GOOGLE_ULONGLONG(0xae5dff9c02033197), GOOGLE_ULONGLONG(0x86a8d39ef77164bc) },  // 1e-211
+  { GOOGLE_ULONGLONG(0xd9f57f830283fdfc), GOOGLE_ULONGLONG(0xa8530886b54dbdeb) },  // 1e-210
+  { GOOGLE_ULONGLONG(0xd072df63c324fd7b), GOOGLE_ULONGLONG(0xd267caa862a12d66) },  // 1e-209
+  { GOOGLE_ULONGLONG(0x4247cb9e59f71e6d), GOOGLE_ULONGLONG(0x8380dea93da4bc60) },  // 1e-208
+  { GOOGLE_ULONGLONG(0x52d9be85f074e608), GOOGLE_ULONGLONG(0xa46116538d0deb78) },  // 1e-207
+  { GOOGLE_ULONGLONG(0x67902e276c921f8b), GOOGLE_ULONGLONG(0xcd795be870516656) },  // 1e-206
+  { GOOGLE_ULONGLONG(0x00ba1cd8a3db53b6), GOOGLE_ULONGLONG(0x806bd9714632dff6) },  // 1e-205
+  { GOOGLE_ULONGLONG(0x80e8a40eccd228a4), GOOGLE_ULONGLONG(0xa086cfcd97bf97f3) },  // 1e-204
+  { GOOGLE_ULONGLONG(0x6122cd128006b2cd), GOOGLE_ULONGLONG(0xc8a883c0fdaf7df0) },  // 1e-203
+  { GOOGLE_ULONGLONG(0x796b805720085f81), GOOGLE_ULONGLONG(0xfad2a4b13d1b5d6c) },  // 1e-202
+  { GOOGLE_ULONGLONG(0xcbe3303674053bb0), GOOGLE_ULONGLONG(0x9cc3a6eec6311a63) },  // 1e-201
+  { GOOGLE_ULONGLONG(0xbedbfc4411068a9c), GOOGLE_ULONGLONG(0xc3f490aa77bd60fc) },  // 1e-200
+  { GOOGLE_ULONGLONG(0xee92fb5515482d44), GOOGLE_ULONGLONG(0xf4f1b4d515acb93b) },  // 1e-199
+  { GOOGLE_ULONGLONG(0x751bdd152d4d1c4a), GOOGLE_ULONGLONG(0x991711052d8bf3c5) },  // 1e-198
+  { GOOGLE_ULONGLONG(0xd262d45a78a0635d), GOOGLE_ULONGLONG(0xbf5cd54678eef0b6) },  // 1e-197
+  { GOOGLE_ULONGLONG(0x86fb897116c87c34), GOOGLE_ULONGLONG(0xef340a98172aace4) },  // 1e-196
+  { GOOGLE_ULONGLONG(0xd45d35e6ae3d4da0), GOOGLE_ULONGLONG(0x9580869f0e7aac0e) },  // 1e-195
+  { GOOGLE_ULONGLONG(0x8974836059cca109), GOOGLE_ULONGLONG(0xbae0a846d2195712) },  // 1e-194
+  { GOOGLE_ULONGLONG(0x2bd1a438703fc94b), GOOGLE_ULONGLONG(0xe998d258869facd7) },  // 1e-193
+  { GOOGLE_ULONGLONG(0x7b6306a34627ddcf), GOOGLE_ULONGLONG(0x91ff83775423cc06) },  // 1e-192
+  { GOOGLE_ULONGLONG(0x1a3bc84c17b1d542), GOOGLE_ULONGLONG(0xb67f6455292cbf08) },  // 1e-191
+  { GOOGLE_ULONGLONG(0x20caba5f1d9e4a93), GOOGLE_ULONGLONG(0xe41f3d6a7377eeca) },  // 1e-190
+  { GOOGLE_ULONGLONG(0x547eb47b7282ee9c), GOOGLE_ULONGLONG(0x8e938662882af53e) },  // 1e-189
+  { GOOGLE_ULONGLONG(0xe99e619a4f23aa43), GOOGLE_ULONGLONG(0xb23867fb2a35b28d) },  // 1e-188
+  { GOOGLE_ULONGLONG(0x6405fa00e2ec94d4), GOOGLE_ULONGLONG(0xdec681f9f4c31f31) },  // 1e-187
+  { GOOGLE_ULONGLONG(0xde83bc408dd3dd04), GOOGLE_ULONGLONG(0x8b3c113c38f9f37e) },  // 1e-186
+  { GOOGLE_ULONGLONG(0x9624ab50b148d445), GOOGLE_ULONGLONG(0xae0b158b4738705e) },  // 1e-185
+  { GOOGLE_ULONGLONG(0x3badd624dd9b0957), GOOGLE_ULONGLONG(0xd98ddaee19068c76) },  // 1e-184
+  { GOOGLE_ULONGLONG(0xe54ca5d70a80e5d6), GOOGLE_ULONGLONG(0x87f8a8d4cfa417c9) },  // 1e-183
+  { GOOGLE_ULONGLONG(0x5e9fcf4ccd211f4c), GOOGLE_ULONGLONG(0xa9f6d30a038d1dbc) },  // 1e-182
+  { GOOGLE_ULONGLONG(0x7647c3200069671f), GOOGLE_ULONGLONG(0xd47487cc8470652b) },  // 1e-181
+  { GOOGLE_ULONGLONG(0x29ecd9f40041e073), GOOGLE_ULONGLONG(0x84c8d4dfd2c63f3b) },  // 1e-180
+  { GOOGLE_ULONGLONG(0xf468107100525890), GOOGLE_ULONGLONG(0xa5fb0a17c777cf09) },  // 1e-179
+  { GOOGLE_ULONGLONG(0x7182148d4066eeb4), GOOGLE_ULONGLONG(0xcf79cc9db955c2cc) },  // 1e-178
+  { GOOGLE_ULONGLONG(0xc6f14cd848405530), GOOGLE_ULONGLONG(0x81ac1fe293d599bf) },  // 1e-177
+  { GOOGLE_ULONGLONG(0xb8ada00e5a506a7c), GOOGLE_ULONGLONG(0xa21727db38cb002f) },  // 1e-176
+  { GOOGLE_ULONGLONG(0xa6d90811f0e4851c), GOOGLE_ULONGLONG(0xca9cf1d206fdc03b) },  // 1e-175
+  { GOOGLE_ULONGLONG(0x908f4a166d1da663), GOOGLE_ULONGLONG(0xfd442e4688bd304a) },  // 1e-174
+  { GOOGLE_ULONGLONG(0x9a598e4e043287fe), GOOGLE_ULONGLONG(0x9e4a9cec15763e2e) },  // 1e-173
+  { GOOGLE_ULONGLONG(0x40eff1e1853f29fd), GOOGLE_ULONGLONG(0xc5dd44271ad3cdba) },  // 1e-172
+  { GOOGLE_ULONGLONG(0xd12bee59e68ef47c), GOOGLE_ULONGLONG(0xf7549530e188c128) },  // 1e-171
+  { GOOGLE_ULONGLONG(0x82bb74f8301958ce), GOOGLE_ULONGLONG(0x9a94dd3e8cf578b9) },  // 1e-170
+  { GOOGLE_ULONGLONG(0xe36a52363c1faf01), GOOGLE_ULONGLONG(0xc13a148e3032d6e7) },  // 1e-169
+  { GOOGLE_ULONGLONG(0xdc44e6c3cb279ac1), GOOGLE_ULONGLONG(0xf18899b1bc3f8ca1) },  // 1e-168
+  { GOOGLE_ULONGLONG(0x29ab103a5ef8c0b9), GOOGLE_ULONGLONG(0x96f5600f15a7b7e5) },  // 1e-167
+  { GOOGLE_ULONGLONG(0x7415d448f6b6f0e7), GOOGLE_ULONGLONG(0xbcb2b812db11a5de) },  // 1e-166
+  { GOOGLE_ULONGLONG(0x111b495b3464ad21), GOOGLE_ULONGLONG(0xebdf661791d60f56) },  // 1e-165
+  { GOOGLE_ULONGLONG(0xcab10dd900beec34), GOOGLE_ULONGLONG(0x936b9fcebb25c995) },  // 1e-164
+  { GOOGLE_ULONGLONG(0x3d5d514f40eea742), GOOGLE_ULONGLONG(0xb84687c269ef3bfb) },  // 1e-163
+  { GOOGLE_ULONGLONG(0x0cb4a5a3112a5112), GOOGLE_ULONGLONG(0xe65829b3046b0afa) },  // 1e-162
+  { GOOGLE_ULONGLONG(0x47f0e785eaba72ab), GOOGLE_ULONGLONG(0x8ff71a0fe2c2e6dc) },  // 1e-161
+  { GOOGLE_ULONGLONG(0x59ed216765690f56), GOOGLE_ULONGLONG(0xb3f4e093db73a093) },  // 1e-160
+  { GOOGLE_ULONGLONG(0x306869c13ec3532c), GOOGLE_ULONGLONG(0xe0f218b8d25088b8) },  // 1e-159
+  { GOOGLE_ULONGLONG(0x1e414218c73a13fb), GOOGLE_ULONGLONG(0x8c974f7383725573) },  // 1e-158
+  { GOOGLE_ULONGLONG(0xe5d1929ef90898fa), GOOGLE_ULONGLONG(0xafbd2350644eeacf) },  // 1e-157
+  { GOOGLE_ULONGLONG(0xdf45f746b74abf39), GOOGLE_ULONGLONG(0xdbac6c247d62a583) },  // 1e-156
+  { GOOGLE_ULONGLONG(0x6b8bba8c328eb783), GOOGLE_ULONGLONG(0x894bc396ce5da772) },  // 1e-155
+  { GOOGLE_ULONGLONG(0x066ea92f3f326564), GOOGLE_ULONGLONG(0xab9eb47c81f5114f) },  // 1e-154
+  { GOOGLE_ULONGLONG(0xc80a537b0efefebd), GOOGLE_ULONGLONG(0xd686619ba27255a2) },  // 1e-153
+  { GOOGLE_ULONGLONG(0xbd06742ce95f5f36), GOOGLE_ULONGLONG(0x8613fd0145877585) },  // 1e-152
+  { GOOGLE_ULONGLONG(0x2c48113823b73704), GOOGLE_ULONGLONG(0xa798fc4196e952e7) },  // 1e-151
+  { GOOGLE_ULONGLONG(0xf75a15862ca504c5), GOOGLE_ULONGLONG(0xd17f3b51fca3a7a0) },  // 1e-150
+  { GOOGLE_ULONGLONG(0x9a984d73dbe722fb), GOOGLE_ULONGLONG(0x82ef85133de648c4) },  // 1e-149
+  { GOOGLE_ULONGLONG(0xc13e60d0d2e0ebba), GOOGLE_ULONGLONG(0xa3ab66580d5fdaf5) },  // 1e-148
+  { GOOGLE_ULONGLONG(0x318df905079926a8), GOOGLE_ULONGLONG(0xcc963fee10b7d1b3) },  // 1e-147
+  { GOOGLE_ULONGLONG(0xfdf17746497f7052), GOOGLE_ULONGLONG(0xffbbcfe994e5c61f) },  // 1e-146
+  { GOOGLE_ULONGLONG(0xfeb6ea8bedefa633), GOOGLE_ULONGLONG(0x9fd561f1fd0f9bd3) },  // 1e-145
+  { GOOGLE_ULONGLONG(0xfe64a52ee96b8fc0), GOOGLE_ULONGLONG(0xc7caba6e7c5382c8) },  // 1e-144
+  { GOOGLE_ULONGLONG(0x3dfdce7aa3c673b0), GOOGLE_ULONGLONG(0xf9bd690a1b68637b) },  // 1e-143
+  { GOOGLE_ULONGLONG(0x06bea10ca65c084e), GOOGLE_ULONGLONG(0x9c1661a651213e2d) },  // 1e-142
+  { GOOGLE_ULONGLONG(0x486e494fcff30a62), GOOGLE_ULONGLONG(0xc31bfa0fe5698db8) },  // 1e-141
+  { GOOGLE_ULONGLONG(0x5a89dba3c3efccfa), GOOGLE_ULONGLONG(0xf3e2f893dec3f126) },  // 1e-140
+  { GOOGLE_ULONGLONG(0xf89629465a75e01c), GOOGLE_ULONGLONG(0x986ddb5c6b3a76b7) },  // 1e-139
+  { GOOGLE_ULONGLONG(0xf6bbb397f1135823), GOOGLE_ULONGLONG(0xbe89523386091465) },  // 1e-138
+  { GOOGLE_ULONGLONG(0x746aa07ded582e2c), GOOGLE_ULONGLONG(0xee2ba6c0678b597f) },  // 1e-137
+  { GOOGLE_ULONGLONG(0xa8c2a44eb4571cdc), GOOGLE_ULONGLONG(0x94db483840b717ef) },  // 1e-136
+  { GOOGLE_ULONGLONG(0x92f34d62616ce413), GOOGLE_ULONGLONG(0xba121a4650e4ddeb) },  // 1e-135
+  { GOOGLE_ULONGLONG(0x77b020baf9c81d17), GOOGLE_ULONGLONG(0xe896a0d7e51e1566) },  // 1e-134
+  { GOOGLE_ULONGLONG(0x0ace1474dc1d122e), GOOGLE_ULONGLONG(0x915e2486ef32cd60) },  // 1e-133
+  { GOOGLE_ULONGLONG(0x0d819992132456ba), GOOGLE_ULONGLONG(0xb5b5ada8aaff80b8) },  // 1e-132
+  { GOOGLE_ULONGLONG(0x10e1fff697ed6c69), GOOGLE_ULONGLONG(0xe3231912d5bf60e6) },  // 1e-131
+  { GOOGLE_ULONGLONG(0xca8d3ffa1ef463c1), GOOGLE_ULONGLONG(0x8df5efabc5979c8f) },  // 1e-130
+  { GOOGLE_ULONGLONG(0xbd308ff8a6b17cb2), GOOGLE_ULONGLONG(0xb1736b96b6fd83b3) },  // 1e-129
+  { GOOGLE_ULONGLONG(0xac7cb3f6d05ddbde), GOOGLE_ULONGLONG(0xddd0467c64bce4a0) },  // 1e-128
+  { GOOGLE_ULONGLONG(0x6bcdf07a423aa96b), GOOGLE_ULONGLONG(0x8aa22c0dbef60ee4) },  // 1e-127
+  { GOOGLE_ULONGLONG(0x86c16c98d2c953c6), GOOGLE_ULONGLONG(0xad4ab7112eb3929d) },  // 1e-126
+  { GOOGLE_ULONGLONG(0xe871c7bf077ba8b7), GOOGLE_ULONGLONG(0xd89d64d57a607744) },  // 1e-125
+  { GOOGLE_ULONGLONG(0x11471cd764ad4972), GOOGLE_ULONGLONG(0x87625f056c7c4a8b) },  // 1e-124
+  { GOOGLE_ULONGLONG(0xd598e40d3dd89bcf), GOOGLE_ULONGLONG(0xa93af6c6c79b5d2d) },  // 1e-123
+  { GOOGLE_ULONGLONG(0x4aff1d108d4ec2c3), GOOGLE_ULONGLONG(0xd389b47879823479) },  // 1e-122
+  { GOOGLE_ULONGLONG(0xcedf722a585139ba), GOOGLE_ULONGLONG(0x843610cb4bf160cb) },  // 1e-121
+  { GOOGLE_ULONGLONG(0xc2974eb4ee658828), GOOGLE_ULONGLONG(0xa54394fe1eedb8fe) },  // 1e-120
+  { GOOGLE_ULONGLONG(0x733d226229feea32), GOOGLE_ULONGLONG(0xce947a3da6a9273e) },  // 1e-119
+  { GOOGLE_ULONGLONG(0x0806357d5a3f525f), GOOGLE_ULONGLONG(0x811ccc668829b887) },  // 1e-118
+  { GOOGLE_ULONGLONG(0xca07c2dcb0cf26f7), GOOGLE_ULONGLONG(0xa163ff802a3426a8) },  // 1e-117
+  { GOOGLE_ULONGLONG(0xfc89b393dd02f0b5), GOOGLE_ULONGLONG(0xc9bcff6034c13052) },  // 1e-116
+  { GOOGLE_ULONGLONG(0xbbac2078d443ace2), GOOGLE_ULONGLONG(0xfc2c3f3841f17c67) },  // 1e-115
+  { GOOGLE_ULONGLONG(0xd54b944b84aa4c0d), GOOGLE_ULONGLONG(0x9d9ba7832936edc0) },  // 1e-114
+  { GOOGLE_ULONGLONG(0x0a9e795e65d4df11), GOOGLE_ULONGLONG(0xc5029163f384a931) },  // 1e-113
+  { GOOGLE_ULONGLONG(0x4d4617b5ff4a16d5), GOOGLE_ULONGLONG(0xf64335bcf065d37d) },  // 1e-112
+  { GOOGLE_ULONGLONG(0x504bced1bf8e4e45), GOOGLE_ULONGLONG(0x99ea0196163fa42e) },  // 1e-111
+  { GOOGLE_ULONGLONG(0xe45ec2862f71e1d6), GOOGLE_ULONGLONG(0xc06481fb9bcf8d39) },  // 1e-110
+  { GOOGLE_ULONGLONG(0x5d767327bb4e5a4c), GOOGLE_ULONGLONG(0xf07da27a82c37088) },  // 1e-109
+  { GOOGLE_ULONGLONG(0x3a6a07f8d510f86f), GOOGLE_ULONGLONG(0x964e858c91ba2655) },  // 1e-108
+  { GOOGLE_ULONGLONG(0x890489f70a55368b), GOOGLE_ULONGLONG(0xbbe226efb628afea) },  // 1e-107
+  { GOOGLE_ULONGLONG(0x2b45ac74ccea842e), GOOGLE_ULONGLONG(0xeadab0aba3b2dbe5) },  // 1e-106
+  { GOOGLE_ULONGLONG(0x3b0b8bc90012929d), GOOGLE_ULONGLONG(0x92c8ae6b464fc96f) },  // 1e-105
+  { GOOGLE_ULONGLONG(0x09ce6ebb40173744), GOOGLE_ULONGLONG(0xb77ada0617e3bbcb) },  // 1e-104
+  { GOOGLE_ULONGLONG(0xcc420a6a101d0515), GOOGLE_ULONGLONG(0xe55990879ddcaabd) },  // 1e-103
+  { GOOGLE_ULONGLONG(0x9fa946824a12232d), GOOGLE_ULONGLONG(0x8f57fa54c2a9eab6) },  // 1e-102
+  { GOOGLE_ULONGLONG(0x47939822dc96abf9), GOOGLE_ULONGLONG(0xb32df8e9f3546564) },  // 1e-101
+  { GOOGLE_ULONGLONG(0x59787e2b93bc56f7), GOOGLE_ULONGLONG(0xdff9772470297ebd) },  // 1e-100
+  { GOOGLE_ULONGLONG(0x57eb4edb3c55b65a), GOOGLE_ULONGLONG(0x8bfbea76c619ef36) },  // 1e-99
+  { GOOGLE_ULONGLONG(0xede622920b6b23f1), GOOGLE_ULONGLONG(0xaefae51477a06b03) },  // 1e-98
+  { GOOGLE_ULONGLONG(0xe95fab368e45eced), GOOGLE_ULONGLONG(0xdab99e59958885c4) },  // 1e-97
+  { GOOGLE_ULONGLONG(0x11dbcb0218ebb414), GOOGLE_ULONGLONG(0x88b402f7fd75539b) },  // 1e-96
+  { GOOGLE_ULONGLONG(0xd652bdc29f26a119), GOOGLE_ULONGLONG(0xaae103b5fcd2a881) },  // 1e-95
+  { GOOGLE_ULONGLONG(0x4be76d3346f0495f), GOOGLE_ULONGLONG(0xd59944a37c0752a2) },  // 1e-94
+  { GOOGLE_ULONGLONG(0x6f70a4400c562ddb), GOOGLE_ULONGLONG(0x857fcae62d8493a5) },  // 1e-93
+  { GOOGLE_ULONGLONG(0xcb4ccd500f6bb952), GOOGLE_ULONGLONG(0xa6dfbd9fb8e5b88e) },  // 1e-92
+  { GOOGLE_ULONGLONG(0x7e2000a41346a7a7), GOOGLE_ULONGLONG(0xd097ad07a71f26b2) },  // 1e-91
+  { GOOGLE_ULONGLONG(0x8ed400668c0c28c8), GOOGLE_ULONGLONG(0x825ecc24c873782f) },  // 1e-90
+  { GOOGLE_ULONGLONG(0x728900802f0f32fa), GOOGLE_ULONGLONG(0xa2f67f2dfa90563b) },  // 1e-89
+  { GOOGLE_ULONGLONG(0x4f2b40a03ad2ffb9), GOOGLE_ULONGLONG(0xcbb41ef979346bca) },  // 1e-88
+  { GOOGLE_ULONGLONG(0xe2f610c84987bfa8), GOOGLE_ULONGLONG(0xfea126b7d78186bc) },  // 1e-87
+  { GOOGLE_ULONGLONG(0x0dd9ca7d2df4d7c9), GOOGLE_ULONGLONG(0x9f24b832e6b0f436) },  // 1e-86
+  { GOOGLE_ULONGLONG(0x91503d1c79720dbb), GOOGLE_ULONGLONG(0xc6ede63fa05d3143) },  // 1e-85
+  { GOOGLE_ULONGLONG(0x75a44c6397ce912a), GOOGLE_ULONGLONG(0xf8a95fcf88747d94) },  // 1e-84
+  { GOOGLE_ULONGLONG(0xc986afbe3ee11aba), GOOGLE_ULONGLONG(0x9b69dbe1b548ce7c) },  // 1e-83
+  { GOOGLE_ULONGLONG(0xfbe85badce996168), GOOGLE_ULONGLONG(0xc24452da229b021b) },  // 1e-82
+  { GOOGLE_ULONGLONG(0xfae27299423fb9c3), GOOGLE_ULONGLONG(0xf2d56790ab41c2a2) },  // 1e-81
+  { GOOGLE_ULONGLONG(0xdccd879fc967d41a), GOOGLE_ULONGLONG(0x97c560ba6b0919a5) },  // 1e-80
+  { GOOGLE_ULONGLONG(0x5400e987bbc1c920), GOOGLE_ULONGLONG(0xbdb6b8e905cb600f) },  // 1e-79
+  { GOOGLE_ULONGLONG(0x290123e9aab23b68), GOOGLE_ULONGLONG(0xed246723473e3813) },  // 1e-78
+  { GOOGLE_ULONGLONG(0xf9a0b6720aaf6521), GOOGLE_ULONGLONG(0x9436c0760c86e30b) },  // 1e-77
+  { GOOGLE_ULONGLONG(0xf808e40e8d5b3e69), GOOGLE_ULONGLONG(0xb94470938fa89bce) },  // 1e-76
+  { GOOGLE_ULONGLONG(0xb60b1d1230b20e04), GOOGLE_ULONGLONG(0xe7958cb87392c2c2) },  // 1e-75
+  { GOOGLE_ULONGLONG(0xb1c6f22b5e6f48c2), GOOGLE_ULONGLONG(0x90bd77f3483bb9b9) },  // 1e-74
+  { GOOGLE_ULONGLONG(0x1e38aeb6360b1af3), GOOGLE_ULONGLONG(0xb4ecd5f01a4aa828) },  // 1e-73
+  { GOOGLE_ULONGLONG(0x25c6da63c38de1b0), GOOGLE_ULONGLONG(0xe2280b6c20dd5232) },  // 1e-72
+  { GOOGLE_ULONGLONG(0x579c487e5a38ad0e), GOOGLE_ULONGLONG(0x8d590723948a535f) },  // 1e-71
+  { GOOGLE_ULONGLONG(0x2d835a9df0c6d851), GOOGLE_ULONGLONG(0xb0af48ec79ace837) },  // 1e-70
+  { GOOGLE_ULONGLONG(0xf8e431456cf88e65), GOOGLE_ULONGLONG(0xdcdb1b2798182244) },  // 1e-69
+  { GOOGLE_ULONGLONG(0x1b8e9ecb641b58ff), GOOGLE_ULONGLONG(0x8a08f0f8bf0f156b) },  // 1e-68
+  { GOOGLE_ULONGLONG(0xe272467e3d222f3f), GOOGLE_ULONGLONG(0xac8b2d36eed2dac5) },  // 1e-67
+  { GOOGLE_ULONGLONG(0x5b0ed81dcc6abb0f), GOOGLE_ULONGLONG(0xd7adf884aa879177) },  // 1e-66
+  { GOOGLE_ULONGLONG(0x98e947129fc2b4e9), GOOGLE_ULONGLONG(0x86ccbb52ea94baea) },  // 1e-65
+  { GOOGLE_ULONGLONG(0x3f2398d747b36224), GOOGLE_ULONGLONG(0xa87fea27a539e9a5) },  // 1e-64
+  { GOOGLE_ULONGLONG(0x8eec7f0d19a03aad), GOOGLE_ULONGLONG(0xd29fe4b18e88640e) },  // 1e-63
+  { GOOGLE_ULONGLONG(0x1953cf68300424ac), GOOGLE_ULONGLONG(0x83a3eeeef9153e89) },  // 1e-62
+  { GOOGLE_ULONGLONG(0x5fa8c3423c052dd7), GOOGLE_ULONGLONG(0xa48ceaaab75a8e2b) },  // 1e-61
+  { GOOGLE_ULONGLONG(0x3792f412cb06794d), GOOGLE_ULONGLONG(0xcdb02555653131b6) },  // 1e-60
+  { GOOGLE_ULONGLONG(0xe2bbd88bbee40bd0), GOOGLE_ULONGLONG(0x808e17555f3ebf11) },  // 1e-59
+  { GOOGLE_ULONGLONG(0x5b6aceaeae9d0ec4), GOOGLE_ULONGLONG(0xa0b19d2ab70e6ed6) },  // 1e-58
+  { GOOGLE_ULONGLONG(0xf245825a5a445275), GOOGLE_ULONGLONG(0xc8de047564d20a8b) },  // 1e-57
+  { GOOGLE_ULONGLONG(0xeed6e2f0f0d56712), GOOGLE_ULONGLONG(0xfb158592be068d2e) },  // 1e-56
+  { GOOGLE_ULONGLONG(0x55464dd69685606b), GOOGLE_ULONGLONG(0x9ced737bb6c4183d) },  // 1e-55
+  { GOOGLE_ULONGLONG(0xaa97e14c3c26b886), GOOGLE_ULONGLONG(0xc428d05aa4751e4c) },  // 1e-54
+  { GOOGLE_ULONGLONG(0xd53dd99f4b3066a8), GOOGLE_ULONGLONG(0xf53304714d9265df) },  // 1e-53
+  { GOOGLE_ULONGLONG(0xe546a8038efe4029), GOOGLE_ULONGLONG(0x993fe2c6d07b7fab) },  // 1e-52
+  { GOOGLE_ULONGLONG(0xde98520472bdd033), GOOGLE_ULONGLONG(0xbf8fdb78849a5f96) },  // 1e-51
+  { GOOGLE_ULONGLONG(0x963e66858f6d4440), GOOGLE_ULONGLONG(0xef73d256a5c0f77c) },  // 1e-50
+  { GOOGLE_ULONGLONG(0xdde7001379a44aa8), GOOGLE_ULONGLONG(0x95a8637627989aad) },  // 1e-49
+  { GOOGLE_ULONGLONG(0x5560c018580d5d52), GOOGLE_ULONGLONG(0xbb127c53b17ec159) },  // 1e-48
+  { GOOGLE_ULONGLONG(0xaab8f01e6e10b4a6), GOOGLE_ULONGLONG(0xe9d71b689dde71af) },  // 1e-47
+  { GOOGLE_ULONGLONG(0xcab3961304ca70e8), GOOGLE_ULONGLONG(0x9226712162ab070d) },  // 1e-46
+  { GOOGLE_ULONGLONG(0x3d607b97c5fd0d22), GOOGLE_ULONGLONG(0xb6b00d69bb55c8d1) },  // 1e-45
+  { GOOGLE_ULONGLONG(0x8cb89a7db77c506a), GOOGLE_ULONGLONG(0xe45c10c42a2b3b05) },  // 1e-44
+  { GOOGLE_ULONGLONG(0x77f3608e92adb242), GOOGLE_ULONGLONG(0x8eb98a7a9a5b04e3) },  // 1e-43
+  { GOOGLE_ULONGLONG(0x55f038b237591ed3), GOOGLE_ULONGLONG(0xb267ed1940f1c61c) },  // 1e-42
+  { GOOGLE_ULONGLONG(0x6b6c46dec52f6688), GOOGLE_ULONGLONG(0xdf01e85f912e37a3) },  // 1e-41
+  { GOOGLE_ULONGLONG(0x2323ac4b3b3da015), GOOGLE_ULONGLONG(0x8b61313bbabce2c6) },  // 1e-40
+  { GOOGLE_ULONGLONG(0xabec975e0a0d081a), GOOGLE_ULONGLONG(0xae397d8aa96c1b77) },  // 1e-39
+  { GOOGLE_ULONGLONG(0x96e7bd358c904a21), GOOGLE_ULONGLONG(0xd9c7dced53c72255) },  // 1e-38
+  { GOOGLE_ULONGLONG(0x7e50d64177da2e54), GOOGLE_ULONGLONG(0x881cea14545c7575) },  // 1e-37
+  { GOOGLE_ULONGLONG(0xdde50bd1d5d0b9e9), GOOGLE_ULONGLONG(0xaa242499697392d2) },  // 1e-36
+  { GOOGLE_ULONGLONG(0x955e4ec64b44e864), GOOGLE_ULONGLONG(0xd4ad2dbfc3d07787) },  // 1e-35
+  { GOOGLE_ULONGLONG(0xbd5af13bef0b113e), GOOGLE_ULONGLONG(0x84ec3c97da624ab4) },  // 1e-34
+  { GOOGLE_ULONGLONG(0xecb1ad8aeacdd58e), GOOGLE_ULONGLONG(0xa6274bbdd0fadd61) },  // 1e-33
+  { GOOGLE_ULONGLONG(0x67de18eda5814af2), GOOGLE_ULONGLONG(0xcfb11ead453994ba) },  // 1e-32
+  { GOOGLE_ULONGLONG(0x80eacf948770ced7), GOOGLE_ULONGLONG(0x81ceb32c4b43fcf4) },  // 1e-31
+  { GOOGLE_ULONGLONG(0xa1258379a94d028d), GOOGLE_ULONGLONG(0xa2425ff75e14fc31) },  // 1e-30
+  { GOOGLE_ULONGLONG(0x096ee45813a04330), GOOGLE_ULONGLONG(0xcad2f7f5359a3b3e) },  // 1e-29
+  { GOOGLE_ULONGLONG(0x8bca9d6e188853fc), GOOGLE_ULONGLONG(0xfd87b5f28300ca0d) },  // 1e-28
+  { GOOGLE_ULONGLONG(0x775ea264cf55347d), GOOGLE_ULONGLONG(0x9e74d1b791e07e48) },  // 1e-27
+  { GOOGLE_ULONGLONG(0x95364afe032a819d), GOOGLE_ULONGLONG(0xc612062576589dda) },  // 1e-26
+  { GOOGLE_ULONGLONG(0x3a83ddbd83f52204), GOOGLE_ULONGLONG(0xf79687aed3eec551) },  // 1e-25
+  { GOOGLE_ULONGLONG(0xc4926a9672793542), GOOGLE_ULONGLONG(0x9abe14cd44753b52) },  // 1e-24
+  { GOOGLE_ULONGLONG(0x75b7053c0f178293), GOOGLE_ULONGLONG(0xc16d9a0095928a27) },  // 1e-23
+  { GOOGLE_ULONGLONG(0x5324c68b12dd6338), GOOGLE_ULONGLONG(0xf1c90080baf72cb1) },  // 1e-22
+  { GOOGLE_ULONGLONG(0xd3f6fc16ebca5e03), GOOGLE_ULONGLONG(0x971da05074da7bee) },  // 1e-21
+  { GOOGLE_ULONGLONG(0x88f4bb1ca6bcf584), GOOGLE_ULONGLONG(0xbce5086492111aea) },  // 1e-20
+  { GOOGLE_ULONGLONG(0x2b31e9e3d06c32e5), GOOGLE_ULONGLONG(0xec1e4a7db69561a5) },  // 1e-19
+  { GOOGLE_ULONGLONG(0x3aff322e62439fcf), GOOGLE_ULONGLONG(0x9392ee8e921d5d07) },  // 1e-18
+  { GOOGLE_ULONGLONG(0x09befeb9fad487c2), GOOGLE_ULONGLONG(0xb877aa3236a4b449) },  // 1e-17
+  { GOOGLE_ULONGLONG(0x4c2ebe687989a9b3), GOOGLE_ULONGLONG(0xe69594bec44de15b) },  // 1e-16
+  { GOOGLE_ULONGLONG(0x0f9d37014bf60a10), GOOGLE_ULONGLONG(0x901d7cf73ab0acd9) },  // 1e-15
+  { GOOGLE_ULONGLONG(0x538484c19ef38c94), GOOGLE_ULONGLONG(0xb424dc35095cd80f) },  // 1e-14
+  { GOOGLE_ULONGLONG(0x2865a5f206b06fb9), GOOGLE_ULONGLONG(0xe12e13424bb40e13) },  // 1e-13
+  { GOOGLE_ULONGLONG(0xf93f87b7442e45d3), GOOGLE_ULONGLONG(0x8cbccc096f5088cb) },  // 1e-12
+  { GOOGLE_ULONGLONG(0xf78f69a51539d748), GOOGLE_ULONGLONG(0xafebff0bcb24aafe) },  // 1e-11
+  { GOOGLE_ULONGLONG(0xb573440e5a884d1b), GOOGLE_ULONGLONG(0xdbe6fecebdedd5be) },  // 1e-10
+  { GOOGLE_ULONGLONG(0x31680a88f8953030), GOOGLE_ULONGLONG(0x89705f4136b4a597) },  // 1e-9
+  { GOOGLE_ULONGLONG(0xfdc20d2b36ba7c3d), GOOGLE_ULONGLONG(0xabcc77118461cefc) },  // 1e-8
+  { GOOGLE_ULONGLONG(0x3d32907604691b4c), GOOGLE_ULONGLONG(0xd6bf94d5e57a42bc) },  // 1e-7
+  { GOOGLE_ULONGLONG(0xa63f9a49c2c1b10f), GOOGLE_ULONGLONG(0x8637bd05af6c69b5) },  // 1e-6
+  { GOOGLE_ULONGLONG(0x0fcf80dc33721d53), GOOGLE_ULONGLONG(0xa7c5ac471b478423) },  // 1e-5
+  { GOOGLE_ULONGLONG(0xd3c36113404ea4a8), GOOGLE_ULONGLONG(0xd1b71758e219652b) },  // 1e-4
+  { GOOGLE_ULONGLONG(0x645a1cac083126e9), GOOGLE_ULONGLONG(0x83126e978d4fdf3b) },  // 1e-3
+  { GOOGLE_ULONGLONG(0x3d70a3d70a3d70a3), GOOGLE_ULONGLONG(0xa3d70a3d70a3d70a) },  // 1e-2
+  { GOOGLE_ULONGLONG(0xcccccccccccccccc), GOOGLE_ULONGLONG(0xcccccccccccccccc) },  // 1e-1
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x8000000000000000) },  // 1e0
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xa000000000000000) },  // 1e1
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xc800000000000000) },  // 1e2
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xfa00000000000000) },  // 1e3
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x9c40000000000000) },  // 1e4
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xc350000000000000) },  // 1e5
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xf424000000000000) },  // 1e6
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x9896800000000000) },  // 1e7
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xbebc200000000000) },  // 1e8
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xee6b280000000000) },  // 1e9
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x9502f90000000000) },  // 1e10
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xba43b74000000000) },  // 1e11
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xe8d4a51000000000) },  // 1e12
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x9184e72a00000000) },  // 1e13
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xb5e620f480000000) },  // 1e14
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xe35fa931a0000000) },  // 1e15
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x8e1bc9bf04000000) },  // 1e16
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xb1a2bc2ec5000000) },  // 1e17
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xde0b6b3a76400000) },  // 1e18
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x8ac7230489e80000) },  // 1e19
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xad78ebc5ac620000) },  // 1e20
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xd8d726b7177a8000) },  // 1e21
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x878678326eac9000) },  // 1e22
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xa968163f0a57b400) },  // 1e23
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xd3c21bcecceda100) },  // 1e24
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0x84595161401484a0) },  // 1e25
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xa56fa5b99019a5c8) },  // 1e26
+  { GOOGLE_ULONGLONG(0x0000000000000000), GOOGLE_ULONGLONG(0xcecb8f27f4200f3a) },  // 1e27
+  { GOOGLE_ULONGLONG(0x4000000000000000), GOOGLE_ULONGLONG(0x813f3978f8940984) },  // 1e28
+  { GOOGLE_ULONGLONG(0x5000000000000000), GOOGLE_ULONGLONG(0xa18f07d736b90be5) },  // 1e29
+  { GOOGLE_ULONGLONG(0xa400000000000000), GOOGLE_ULONGLONG(0xc9f2c9cd04674ede) },  // 1e30
+  { GOOGLE_ULONGLONG(0x4d00000000000000), GOOGLE_ULONGLONG(0xfc6f7c4045812296) },  // 1e31
+  { GOOGLE_ULONGLONG(0xf020000000000000), GOOGLE_ULONGLONG(0x9dc5ada82b70b59d) },  // 1e32
+  { GOOGLE_ULONGLONG(0x6c28000000000000), GOOGLE_ULONGLONG(0xc5371912364ce305) },  // 1e33
+  { GOOGLE_ULONGLONG(0xc732000000000000), GOOGLE_ULONGLONG(0xf684df56c3e01bc6) },  // 1e34
+  { GOOGLE_ULONGLONG(0x3c7f400000000000), GOOGLE_ULONGLONG(0x9a130b963a6c115c) },  // 1e35
+  { GOOGLE_ULONGLONG(0x4b9f100000000000), GOOGLE_ULONGLONG(0xc097ce7bc90715b3) },  // 1e36
+  { GOOGLE_ULONGLONG(0x1e86d40000000000), GOOGLE_ULONGLONG(0xf0bdc21abb48db20) },  // 1e37
+  { GOOGLE_ULONGLONG(0x1314448000000000), GOOGLE_ULONGLONG(0x96769950b50d88f4) },  // 1e38
+  { GOOGLE_ULONGLONG(0x17d955a000000000), GOOGLE_ULONGLONG(0xbc143fa4e250eb31) },  // 1e39
+  { GOOGLE_ULONGLONG(0x5dcfab0800000000), GOOGLE_ULONGLONG(0xeb194f8e1ae525fd) },  // 1e40
+  { GOOGLE_ULONGLONG(0x5aa1cae500000000), GOOGLE_ULONGLONG(0x92efd1b8d0cf37be) },  // 1e41
+  { GOOGLE_ULONGLONG(0xf14a3d9e40000000), GOOGLE_ULONGLONG(0xb7abc627050305ad) },  // 1e42
+  { GOOGLE_ULONGLONG(0x6d9ccd05d0000000), GOOGLE_ULONGLONG(0xe596b7b0c643c719) },  // 1e43
+  { GOOGLE_ULONGLONG(0xe4820023a2000000), GOOGLE_ULONGLONG(0x8f7e32ce7bea5c6f) },  // 1e44
+  { GOOGLE_ULONGLONG(0xdda2802c8a800000), GOOGLE_ULONGLONG(0xb35dbf821ae4f38b) },  // 1e45
+  { GOOGLE_ULONGLONG(0xd50b2037ad200000), GOOGLE_ULONGLONG(0xe0352f62a19e306e) },  // 1e46
+  { GOOGLE_ULONGLONG(0x4526f422cc340000), GOOGLE_ULONGLONG(0x8c213d9da502de45) },  // 1e47
+  { GOOGLE_ULONGLONG(0x9670b12b7f410000), GOOGLE_ULONGLONG(0xaf298d050e4395d6) },  // 1e48
+  { GOOGLE_ULONGLONG(0x3c0cdd765f114000), GOOGLE_ULONGLONG(0xdaf3f04651d47b4c) },  // 1e49
+  { GOOGLE_ULONGLONG(0xa5880a69fb6ac800), GOOGLE_ULONGLONG(0x88d8762bf324cd0f) },  // 1e50
+  { GOOGLE_ULONGLONG(0x8eea0d047a457a00), GOOGLE_ULONGLONG(0xab0e93b6efee0053) },  // 1e51
+  { GOOGLE_ULONGLONG(0x72a4904598d6d880), GOOGLE_ULONGLONG(0xd5d238a4abe98068) },  // 1e52
+  { GOOGLE_ULONGLONG(0x47a6da2b7f864750), GOOGLE_ULONGLONG(0x85a36366eb71f041) },  // 1e53
+  { GOOGLE_ULONGLONG(0x999090b65f67d924), GOOGLE_ULONGLONG(0xa70c3c40a64e6c51) },  // 1e54
+  { GOOGLE_ULONGLONG(0xfff4b4e3f741cf6d), GOOGLE_ULONGLONG(0xd0cf4b50cfe20765) },  // 1e55
+  { GOOGLE_ULONGLONG(0xbff8f10e7a8921a4), GOOGLE_ULONGLONG(0x82818f1281ed449f) },  // 1e56
+  { GOOGLE_ULONGLONG(0xaff72d52192b6a0d), GOOGLE_ULONGLONG(0xa321f2d7226895c7) },  // 1e57
+  { GOOGLE_ULONGLONG(0x9bf4f8a69f764490), GOOGLE_ULONGLONG(0xcbea6f8ceb02bb39) },  // 1e58
+  { GOOGLE_ULONGLONG(0x02f236d04753d5b4), GOOGLE_ULONGLONG(0xfee50b7025c36a08) },  // 1e59
+  { GOOGLE_ULONGLONG(0x01d762422c946590), GOOGLE_ULONGLONG(0x9f4f2726179a2245) },  // 1e60
+  { GOOGLE_ULONGLONG(0x424d3ad2b7b97ef5), GOOGLE_ULONGLONG(0xc722f0ef9d80aad6) },  // 1e61
+  { GOOGLE_ULONGLONG(0xd2e0898765a7deb2), GOOGLE_ULONGLONG(0xf8ebad2b84e0d58b) },  // 1e62
+  { GOOGLE_ULONGLONG(0x63cc55f49f88eb2f), GOOGLE_ULONGLONG(0x9b934c3b330c8577) },  // 1e63
+  { GOOGLE_ULONGLONG(0x3cbf6b71c76b25fb), GOOGLE_ULONGLONG(0xc2781f49ffcfa6d5) },  // 1e64
+  { GOOGLE_ULONGLONG(0x8bef464e3945ef7a), GOOGLE_ULONGLONG(0xf316271c7fc3908a) },  // 1e65
+  { GOOGLE_ULONGLONG(0x97758bf0e3cbb5ac), GOOGLE_ULONGLONG(0x97edd871cfda3a56) },  // 1e66
+  { GOOGLE_ULONGLONG(0x3d52eeed1cbea317), GOOGLE_ULONGLONG(0xbde94e8e43d0c8ec) },  // 1e67
+  { GOOGLE_ULONGLONG(0x4ca7aaa863ee4bdd), GOOGLE_ULONGLONG(0xed63a231d4c4fb27) },  // 1e68
+  { GOOGLE_ULONGLONG(0x8fe8caa93e74ef6a), GOOGLE_ULONGLONG(0x945e455f24fb1cf8) },  // 1e69
+  { GOOGLE_ULONGLONG(0xb3e2fd538e122b44), GOOGLE_ULONGLONG(0xb975d6b6ee39e436) },  // 1e70
+  { GOOGLE_ULONGLONG(0x60dbbca87196b616), GOOGLE_ULONGLONG(0xe7d34c64a9c85d44) },  // 1e71
+  { GOOGLE_ULONGLONG(0xbc8955e946fe31cd), GOOGLE_ULONGLONG(0x90e40fbeea1d3a4a) },  // 1e72
+  { GOOGLE_ULONGLONG(0x6babab6398bdbe41), GOOGLE_ULONGLONG(0xb51d13aea4a488dd) },  // 1e73
+  { GOOGLE_ULONGLONG(0xc696963c7eed2dd1), GOOGLE_ULONGLONG(0xe264589a4dcdab14) },  // 1e74
+  { GOOGLE_ULONGLONG(0xfc1e1de5cf543ca2), GOOGLE_ULONGLONG(0x8d7eb76070a08aec) },  // 1e75
+  { GOOGLE_ULONGLONG(0x3b25a55f43294bcb), GOOGLE_ULONGLONG(0xb0de65388cc8ada8) },  // 1e76
+  { GOOGLE_ULONGLONG(0x49ef0eb713f39ebe), GOOGLE_ULONGLONG(0xdd15fe86affad912) },  // 1e77
+  { GOOGLE_ULONGLONG(0x6e3569326c784337), GOOGLE_ULONGLONG(0x8a2dbf142dfcc7ab) },  // 1e78
+  { GOOGLE_ULONGLONG(0x49c2c37f07965404), GOOGLE_ULONGLONG(0xacb92ed9397bf996) },  // 1e79
+  { GOOGLE_ULONGLONG(0xdc33745ec97be906), GOOGLE_ULONGLONG(0xd7e77a8f87daf7fb) },  // 1e80
+  { GOOGLE_ULONGLONG(0x69a028bb3ded71a3), GOOGLE_ULONGLONG(0x86f0ac99b4e8dafd) },  // 1e81
+  { GOOGLE_ULONGLONG(0xc40832ea0d68ce0c), GOOGLE_ULONGLONG(0xa8acd7c0222311bc) },  // 1e82
+  { GOOGLE_ULONGLONG(0xf50a3fa490c30190), GOOGLE_ULONGLONG(0xd2d80db02aabd62b) },  // 1e83
+  { GOOGLE_ULONGLONG(0x792667c6da79e0fa), GOOGLE_ULONGLONG(0x83c7088e1aab65db) },  // 1e84
+  { GOOGLE_ULONGLONG(0x577001b891185938), GOOGLE_ULONGLONG(0xa4b8cab1a1563f52) },  // 1e85
+  { GOOGLE_ULONGLONG(0xed4c0226b55e6f86), GOOGLE_ULONGLONG(0xcde6fd5e09abcf26) },  // 1e86
+  { GOOGLE_ULONGLONG(0x544f8158315b05b4), GOOGLE_ULONGLONG(0x80b05e5ac60b6178) },  // 1e87
+  { GOOGLE_ULONGLONG(0x696361ae3db1c721), GOOGLE_ULONGLONG(0xa0dc75f1778e39d6) },  // 1e88
+  { GOOGLE_ULONGLONG(0x03bc3a19cd1e38e9), GOOGLE_ULONGLONG(0xc913936dd571c84c) },  // 1e89
+  { GOOGLE_ULONGLONG(0x04ab48a04065c723), GOOGLE_ULONGLONG(0xfb5878494ace3a5f) },  // 1e90
+  { GOOGLE_ULONGLONG(0x62eb0d64283f9c76), GOOGLE_ULONGLONG(0x9d174b2dcec0e47b) },  // 1e91
+  { GOOGLE_ULONGLONG(0x3ba5d0bd324f8394), GOOGLE_ULONGLONG(0xc45d1df942711d9a) },  // 1e92
+  { GOOGLE_ULONGLONG(0xca8f44ec7ee36479), GOOGLE_ULONGLONG(0xf5746577930d6500) },  // 1e93
+  { GOOGLE_ULONGLONG(0x7e998b13cf4e1ecb), GOOGLE_ULONGLONG(0x9968bf6abbe85f20) },  // 1e94
+  { GOOGLE_ULONGLONG(0x9e3fedd8c321a67e), GOOGLE_ULONGLONG(0xbfc2ef456ae276e8) },  // 1e95
+  { GOOGLE_ULONGLONG(0xc5cfe94ef3ea101e), GOOGLE_ULONGLONG(0xefb3ab16c59b14a2) },  // 1e96
+  { GOOGLE_ULONGLONG(0xbba1f1d158724a12), GOOGLE_ULONGLONG(0x95d04aee3b80ece5) },  // 1e97
+  { GOOGLE_ULONGLONG(0x2a8a6e45ae8edc97), GOOGLE_ULONGLONG(0xbb445da9ca61281f) },  // 1e98
+  { GOOGLE_ULONGLONG(0xf52d09d71a3293bd), GOOGLE_ULONGLONG(0xea1575143cf97226) },  // 1e99
+  { GOOGLE_ULONGLONG(0x593c2626705f9c56), GOOGLE_ULONGLONG(0x924d692ca61be758) },  // 1e100
+  { GOOGLE_ULONGLONG(0x6f8b2fb00c77836c), GOOGLE_ULONGLONG(0xb6e0c377cfa2e12e) },  // 1e101
+  { GOOGLE_ULONGLONG(0x0b6dfb9c0f956447), GOOGLE_ULONGLONG(0xe498f455c38b997a) },  // 1e102
+  { GOOGLE_ULONGLONG(0x4724bd4189bd5eac), GOOGLE_ULONGLONG(0x8edf98b59a373fec) },  // 1e103
+  { GOOGLE_ULONGLONG(0x58edec91ec2cb657), GOOGLE_ULONGLONG(0xb2977ee300c50fe7) },  // 1e104
+  { GOOGLE_ULONGLONG(0x2f2967b66737e3ed), GOOGLE_ULONGLONG(0xdf3d5e9bc0f653e1) },  // 1e105
+  { GOOGLE_ULONGLONG(0xbd79e0d20082ee74), GOOGLE_ULONGLONG(0x8b865b215899f46c) },  // 1e106
+  { GOOGLE_ULONGLONG(0xecd8590680a3aa11), GOOGLE_ULONGLONG(0xae67f1e9aec07187) },  // 1e107
+  { GOOGLE_ULONGLONG(0xe80e6f4820cc9495), GOOGLE_ULONGLONG(0xda01ee641a708de9) },  // 1e108
+  { GOOGLE_ULONGLONG(0x3109058d147fdcdd), GOOGLE_ULONGLONG(0x884134fe908658b2) },  // 1e109
+  { GOOGLE_ULONGLONG(0xbd4b46f0599fd415), GOOGLE_ULONGLONG(0xaa51823e34a7eede) },  // 1e110
+  { GOOGLE_ULONGLONG(0x6c9e18ac7007c91a), GOOGLE_ULONGLONG(0xd4e5e2cdc1d1ea96) },  // 1e111
+  { GOOGLE_ULONGLONG(0x03e2cf6bc604ddb0), GOOGLE_ULONGLONG(0x850fadc09923329e) },  // 1e112
+  { GOOGLE_ULONGLONG(0x84db8346b786151c), GOOGLE_ULONGLONG(0xa6539930bf6bff45) },  // 1e113
+  { GOOGLE_ULONGLONG(0xe612641865679a63), GOOGLE_ULONGLONG(0xcfe87f7cef46ff16) },  // 1e114
+  { GOOGLE_ULONGLONG(0x4fcb7e8f3f60c07e), GOOGLE_ULONGLONG(0x81f14fae158c5f6e) },  // 1e115
+  { GOOGLE_ULONGLONG(0xe3be5e330f38f09d), GOOGLE_ULONGLONG(0xa26da3999aef7749) },  // 1e116
+  { GOOGLE_ULONGLONG(0x5cadf5bfd3072cc5), GOOGLE_ULONGLONG(0xcb090c8001ab551c) },  // 1e117
+  { GOOGLE_ULONGLONG(0x73d9732fc7c8f7f6), GOOGLE_ULONGLONG(0xfdcb4fa002162a63) },  // 1e118
+  { GOOGLE_ULONGLONG(0x2867e7fddcdd9afa), GOOGLE_ULONGLONG(0x9e9f11c4014dda7e) },  // 1e119
+  { GOOGLE_ULONGLONG(0xb281e1fd541501b8), GOOGLE_ULONGLONG(0xc646d63501a1511d) },  // 1e120
+  { GOOGLE_ULONGLONG(0x1f225a7ca91a4226), GOOGLE_ULONGLONG(0xf7d88bc24209a565) },  // 1e121
+  { GOOGLE_ULONGLONG(0x3375788de9b06958), GOOGLE_ULONGLONG(0x9ae757596946075f) },  // 1e122
+  { GOOGLE_ULONGLONG(0x0052d6b1641c83ae), GOOGLE_ULONGLONG(0xc1a12d2fc3978937) },  // 1e123
+  { GOOGLE_ULONGLONG(0xc0678c5dbd23a49a), GOOGLE_ULONGLONG(0xf209787bb47d6b84) },  // 1e124
+  { GOOGLE_ULONGLONG(0xf840b7ba963646e0), GOOGLE_ULONGLONG(0x9745eb4d50ce6332) },  // 1e125
+  { GOOGLE_ULONGLONG(0xb650e5a93bc3d898), GOOGLE_ULONGLONG(0xbd176620a501fbff) },  // 1e126
+  { GOOGLE_ULONGLONG(0xa3e51f138ab4cebe), GOOGLE_ULONGLONG(0xec5d3fa8ce427aff) },  // 1e127
+  { GOOGLE_ULONGLONG(0xc66f336c36b10137), GOOGLE_ULONGLONG(0x93ba47c980e98cdf) },  // 1e128
+  { GOOGLE_ULONGLONG(0xb80b0047445d4184), GOOGLE_ULONGLONG(0xb8a8d9bbe123f017) },  // 1e129
+  { GOOGLE_ULONGLONG(0xa60dc059157491e5), GOOGLE_ULONGLONG(0xe6d3102ad96cec1d) },  // 1e130
+  { GOOGLE_ULONGLONG(0x87c89837ad68db2f), GOOGLE_ULONGLONG(0x9043ea1ac7e41392) },  // 1e131
+  { GOOGLE_ULONGLONG(0x29babe4598c311fb), GOOGLE_ULONGLONG(0xb454e4a179dd1877) },  // 1e132
+  { GOOGLE_ULONGLONG(0xf4296dd6fef3d67a), GOOGLE_ULONGLONG(0xe16a1dc9d8545e94) },  // 1e133
+  { GOOGLE_ULONGLONG(0x1899e4a65f58660c), GOOGLE_ULONGLONG(0x8ce2529e2734bb1d) },  // 1e134
+  { GOOGLE_ULONGLONG(0x5ec05dcff72e7f8f), GOOGLE_ULONGLONG(0xb01ae745b101e9e4) },  // 1e135
+  { GOOGLE_ULONGLONG(0x76707543f4fa1f73), GOOGLE_ULONGLONG(0xdc21a1171d42645d) },  // 1e136
+  { GOOGLE_ULONGLONG(0x6a06494a791c53a8), GOOGLE_ULONGLONG(0x899504ae72497eba) },  // 1e137
+  { GOOGLE_ULONGLONG(0x0487db9d17636892), GOOGLE_ULONGLONG(0xabfa45da0edbde69) },  // 1e138
+  { GOOGLE_ULONGLONG(0x45a9d2845d3c42b6), GOOGLE_ULONGLONG(0xd6f8d7509292d603) },  // 1e139
+  { GOOGLE_ULONGLONG(0x0b8a2392ba45a9b2), GOOGLE_ULONGLONG(0x865b86925b9bc5c2) },  // 1e140
+  { GOOGLE_ULONGLONG(0x8e6cac7768d7141e), GOOGLE_ULONGLONG(0xa7f26836f282b732) },  // 1e141
+  { GOOGLE_ULONGLONG(0x3207d795430cd926), GOOGLE_ULONGLONG(0xd1ef0244af2364ff) },  // 1e142
+  { GOOGLE_ULONGLONG(0x7f44e6bd49e807b8), GOOGLE_ULONGLONG(0x8335616aed761f1f) },  // 1e143
+  { GOOGLE_ULONGLONG(0x5f16206c9c6209a6), GOOGLE_ULONGLONG(0xa402b9c5a8d3a6e7) },  // 1e144
+  { GOOGLE_ULONGLONG(0x36dba887c37a8c0f), GOOGLE_ULONGLONG(0xcd036837130890a1) },  // 1e145
+  { GOOGLE_ULONGLONG(0xc2494954da2c9789), GOOGLE_ULONGLONG(0x802221226be55a64) },  // 1e146
+  { GOOGLE_ULONGLONG(0xf2db9baa10b7bd6c), GOOGLE_ULONGLONG(0xa02aa96b06deb0fd) },  // 1e147
+  { GOOGLE_ULONGLONG(0x6f92829494e5acc7), GOOGLE_ULONGLONG(0xc83553c5c8965d3d) },  // 1e148
+  { GOOGLE_ULONGLONG(0xcb772339ba1f17f9), GOOGLE_ULONGLONG(0xfa42a8b73abbf48c) },  // 1e149
+  { GOOGLE_ULONGLONG(0xff2a760414536efb), GOOGLE_ULONGLONG(0x9c69a97284b578d7) },  // 1e150
+  { GOOGLE_ULONGLONG(0xfef5138519684aba), GOOGLE_ULONGLONG(0xc38413cf25e2d70d) },  // 1e151
+  { GOOGLE_ULONGLONG(0x7eb258665fc25d69), GOOGLE_ULONGLONG(0xf46518c2ef5b8cd1) },  // 1e152
+  { GOOGLE_ULONGLONG(0xef2f773ffbd97a61), GOOGLE_ULONGLONG(0x98bf2f79d5993802) },  // 1e153
+  { GOOGLE_ULONGLONG(0xaafb550ffacfd8fa), GOOGLE_ULONGLONG(0xbeeefb584aff8603) },  // 1e154
+  { GOOGLE_ULONGLONG(0x95ba2a53f983cf38), GOOGLE_ULONGLONG(0xeeaaba2e5dbf6784) },  // 1e155
+  { GOOGLE_ULONGLONG(0xdd945a747bf26183), GOOGLE_ULONGLONG(0x952ab45cfa97a0b2) },  // 1e156
+  { GOOGLE_ULONGLONG(0x94f971119aeef9e4), GOOGLE_ULONGLONG(0xba756174393d88df) },  // 1e157
+  { GOOGLE_ULONGLONG(0x7a37cd5601aab85d), GOOGLE_ULONGLONG(0xe912b9d1478ceb17) },  // 1e158
+  { GOOGLE_ULONGLONG(0xac62e055c10ab33a), GOOGLE_ULONGLONG(0x91abb422ccb812ee) },  // 1e159
+  { GOOGLE_ULONGLONG(0x577b986b314d6009), GOOGLE_ULONGLONG(0xb616a12b7fe617aa) },  // 1e160
+  { GOOGLE_ULONGLONG(0xed5a7e85fda0b80b), GOOGLE_ULONGLONG(0xe39c49765fdf9d94) },  // 1e161
+  { GOOGLE_ULONGLONG(0x14588f13be847307), GOOGLE_ULONGLONG(0x8e41ade9fbebc27d) },  // 1e162
+  { GOOGLE_ULONGLONG(0x596eb2d8ae258fc8), GOOGLE_ULONGLONG(0xb1d219647ae6b31c) },  // 1e163
+  { GOOGLE_ULONGLONG(0x6fca5f8ed9aef3bb), GOOGLE_ULONGLONG(0xde469fbd99a05fe3) },  // 1e164
+  { GOOGLE_ULONGLONG(0x25de7bb9480d5854), GOOGLE_ULONGLONG(0x8aec23d680043bee) },  // 1e165
+  { GOOGLE_ULONGLONG(0xaf561aa79a10ae6a), GOOGLE_ULONGLONG(0xada72ccc20054ae9) },  // 1e166
+  { GOOGLE_ULONGLONG(0x1b2ba1518094da04), GOOGLE_ULONGLONG(0xd910f7ff28069da4) },  // 1e167
+  { GOOGLE_ULONGLONG(0x90fb44d2f05d0842), GOOGLE_ULONGLONG(0x87aa9aff79042286) },  // 1e168
+  { GOOGLE_ULONGLONG(0x353a1607ac744a53), GOOGLE_ULONGLONG(0xa99541bf57452b28) },  // 1e169
+  { GOOGLE_ULONGLONG(0x42889b8997915ce8), GOOGLE_ULONGLONG(0xd3fa922f2d1675f2) },  // 1e170
+  { GOOGLE_ULONGLONG(0x69956135febada11), GOOGLE_ULONGLONG(0x847c9b5d7c2e09b7) },  // 1e171
+  { GOOGLE_ULONGLONG(0x43fab9837e699095), GOOGLE_ULONGLONG(0xa59bc234db398c25) },  // 1e172
+  { GOOGLE_ULONGLONG(0x94f967e45e03f4bb), GOOGLE_ULONGLONG(0xcf02b2c21207ef2e) },  // 1e173
+  { GOOGLE_ULONGLONG(0x1d1be0eebac278f5), GOOGLE_ULONGLONG(0x8161afb94b44f57d) },  // 1e174
+  { GOOGLE_ULONGLONG(0x6462d92a69731732), GOOGLE_ULONGLONG(0xa1ba1ba79e1632dc) },  // 1e175
+  { GOOGLE_ULONGLONG(0x7d7b8f7503cfdcfe), GOOGLE_ULONGLONG(0xca28a291859bbf93) },  // 1e176
+  { GOOGLE_ULONGLONG(0x5cda735244c3d43e), GOOGLE_ULONGLONG(0xfcb2cb35e702af78) },  // 1e177
+  { GOOGLE_ULONGLONG(0x3a0888136afa64a7), GOOGLE_ULONGLONG(0x9defbf01b061adab) },  // 1e178
+  { GOOGLE_ULONGLONG(0x088aaa1845b8fdd0), GOOGLE_ULONGLONG(0xc56baec21c7a1916) },  // 1e179
+  { GOOGLE_ULONGLONG(0x8aad549e57273d45), GOOGLE_ULONGLONG(0xf6c69a72a3989f5b) },  // 1e180
+  { GOOGLE_ULONGLONG(0x36ac54e2f678864b), GOOGLE_ULONGLONG(0x9a3c2087a63f6399) },  // 1e181
+  { GOOGLE_ULONGLONG(0x84576a1bb416a7dd), GOOGLE_ULONGLONG(0xc0cb28a98fcf3c7f) },  // 1e182
+  { GOOGLE_ULONGLONG(0x656d44a2a11c51d5), GOOGLE_ULONGLONG(0xf0fdf2d3f3c30b9f) },  // 1e183
+  { GOOGLE_ULONGLONG(0x9f644ae5a4b1b325), GOOGLE_ULONGLONG(0x969eb7c47859e743) },  // 1e184
+  { GOOGLE_ULONGLONG(0x873d5d9f0dde1fee), GOOGLE_ULONGLONG(0xbc4665b596706114) },  // 1e185
+  { GOOGLE_ULONGLONG(0xa90cb506d155a7ea), GOOGLE_ULONGLONG(0xeb57ff22fc0c7959) },  // 1e186
+  { GOOGLE_ULONGLONG(0x09a7f12442d588f2), GOOGLE_ULONGLONG(0x9316ff75dd87cbd8) },  // 1e187
+  { GOOGLE_ULONGLONG(0x0c11ed6d538aeb2f), GOOGLE_ULONGLONG(0xb7dcbf5354e9bece) },  // 1e188
+  { GOOGLE_ULONGLONG(0x8f1668c8a86da5fa), GOOGLE_ULONGLONG(0xe5d3ef282a242e81) },  // 1e189
+  { GOOGLE_ULONGLONG(0xf96e017d694487bc), GOOGLE_ULONGLONG(0x8fa475791a569d10) },  // 1e190
+  { GOOGLE_ULONGLONG(0x37c981dcc395a9ac), GOOGLE_ULONGLONG(0xb38d92d760ec4455) },  // 1e191
+  { GOOGLE_ULONGLONG(0x85bbe253f47b1417), GOOGLE_ULONGLONG(0xe070f78d3927556a) },  // 1e192
+  { GOOGLE_ULONGLONG(0x93956d7478ccec8e), GOOGLE_ULONGLONG(0x8c469ab843b89562) },  // 1e193
+  { GOOGLE_ULONGLONG(0x387ac8d1970027b2), GOOGLE_ULONGLONG(0xaf58416654a6babb) },  // 1e194
+  { GOOGLE_ULONGLONG(0x06997b05fcc0319e), GOOGLE_ULONGLONG(0xdb2e51bfe9d0696a) },  // 1e195
+  { GOOGLE_ULONGLONG(0x441fece3bdf81f03), GOOGLE_ULONGLONG(0x88fcf317f22241e2) },  // 1e196
+  { GOOGLE_ULONGLONG(0xd527e81cad7626c3), GOOGLE_ULONGLONG(0xab3c2fddeeaad25a) },  // 1e197
+  { GOOGLE_ULONGLONG(0x8a71e223d8d3b074), GOOGLE_ULONGLONG(0xd60b3bd56a5586f1) },  // 1e198
+  { GOOGLE_ULONGLONG(0xf6872d5667844e49), GOOGLE_ULONGLONG(0x85c7056562757456) },  // 1e199
+  { GOOGLE_ULONGLONG(0xb428f8ac016561db), GOOGLE_ULONGLONG(0xa738c6bebb12d16c) },  // 1e200
+  { GOOGLE_ULONGLONG(0xe13336d701beba52), GOOGLE_ULONGLONG(0xd106f86e69d785c7) },  // 1e201
+  { GOOGLE_ULONGLONG(0xecc0024661173473), GOOGLE_ULONGLONG(0x82a45b450226b39c) },  // 1e202
+  { GOOGLE_ULONGLONG(0x27f002d7f95d0190), GOOGLE_ULONGLONG(0xa34d721642b06084) },  // 1e203
+  { GOOGLE_ULONGLONG(0x31ec038df7b441f4), GOOGLE_ULONGLONG(0xcc20ce9bd35c78a5) },  // 1e204
+  { GOOGLE_ULONGLONG(0x7e67047175a15271), GOOGLE_ULONGLONG(0xff290242c83396ce) },  // 1e205
+  { GOOGLE_ULONGLONG(0x0f0062c6e984d386), GOOGLE_ULONGLONG(0x9f79a169bd203e41) },  // 1e206
+  { GOOGLE_ULONGLONG(0x52c07b78a3e60868), GOOGLE_ULONGLONG(0xc75809c42c684dd1) },  // 1e207
+  { GOOGLE_ULONGLONG(0xa7709a56ccdf8a82), GOOGLE_ULONGLONG(0xf92e0c3537826145) },  // 1e208
+  { GOOGLE_ULONGLONG(0x88a66076400bb691), GOOGLE_ULONGLONG(0x9bbcc7a142b17ccb) },  // 1e209
+  { GOOGLE_ULONGLONG(0x6acff893d00ea435), GOOGLE_ULONGLONG(0xc2abf989935ddbfe) },  // 1e210
+  { GOOGLE_ULONGLONG(0x0583f6b8c4124d43), GOOGLE_ULONGLONG(0xf356f7ebf83552fe) },  // 1e211
+  { GOOGLE_ULONGLONG(0xc3727a337a8b704a), GOOGLE_ULONGLONG(0x98165af37b2153de) },  // 1e212
+  { GOOGLE_ULONGLONG(0x744f18c0592e4c5c), GOOGLE_ULONGLONG(0xbe1bf1b059e9a8d6) },  // 1e213
+  { GOOGLE_ULONGLONG(0x1162def06f79df73), GOOGLE_ULONGLONG(0xeda2ee1c7064130c) },  // 1e214
+  { GOOGLE_ULONGLONG(0x8addcb5645ac2ba8), GOOGLE_ULONGLONG(0x9485d4d1c63e8be7) },  // 1e215
+  { GOOGLE_ULONGLONG(0x6d953e2bd7173692), GOOGLE_ULONGLONG(0xb9a74a0637ce2ee1) },  // 1e216
+  { GOOGLE_ULONGLONG(0xc8fa8db6ccdd0437), GOOGLE_ULONGLONG(0xe8111c87c5c1ba99) },  // 1e217
+  { GOOGLE_ULONGLONG(0x1d9c9892400a22a2), GOOGLE_ULONGLONG(0x910ab1d4db9914a0) },  // 1e218
+  { GOOGLE_ULONGLONG(0x2503beb6d00cab4b), GOOGLE_ULONGLONG(0xb54d5e4a127f59c8) },  // 1e219
+  { GOOGLE_ULONGLONG(0x2e44ae64840fd61d), GOOGLE_ULONGLONG(0xe2a0b5dc971f303a) },  // 1e220
+  { GOOGLE_ULONGLONG(0x5ceaecfed289e5d2), GOOGLE_ULONGLONG(0x8da471a9de737e24) },  // 1e221
+  { GOOGLE_ULONGLONG(0x7425a83e872c5f47), GOOGLE_ULONGLONG(0xb10d8e1456105dad) },  // 1e222
+  { GOOGLE_ULONGLONG(0xd12f124e28f77719), GOOGLE_ULONGLONG(0xdd50f1996b947518) },  // 1e223
+  { GOOGLE_ULONGLONG(0x82bd6b70d99aaa6f), GOOGLE_ULONGLONG(0x8a5296ffe33cc92f) },  // 1e224
+  { GOOGLE_ULONGLONG(0x636cc64d1001550b), GOOGLE_ULONGLONG(0xace73cbfdc0bfb7b) },  // 1e225
+  { GOOGLE_ULONGLONG(0x3c47f7e05401aa4e), GOOGLE_ULONGLONG(0xd8210befd30efa5a) },  // 1e226
+  { GOOGLE_ULONGLONG(0x65acfaec34810a71), GOOGLE_ULONGLONG(0x8714a775e3e95c78) },  // 1e227
+  { GOOGLE_ULONGLONG(0x7f1839a741a14d0d), GOOGLE_ULONGLONG(0xa8d9d1535ce3b396) },  // 1e228
+  { GOOGLE_ULONGLONG(0x1ede48111209a050), GOOGLE_ULONGLONG(0xd31045a8341ca07c) },  // 1e229
+  { GOOGLE_ULONGLONG(0x934aed0aab460432), GOOGLE_ULONGLONG(0x83ea2b892091e44d) },  // 1e230
+  { GOOGLE_ULONGLONG(0xf81da84d5617853f), GOOGLE_ULONGLONG(0xa4e4b66b68b65d60) },  // 1e231
+  { GOOGLE_ULONGLONG(0x36251260ab9d668e), GOOGLE_ULONGLONG(0xce1de40642e3f4b9) },  // 1e232
+  { GOOGLE_ULONGLONG(0xc1d72b7c6b426019), GOOGLE_ULONGLONG(0x80d2ae83e9ce78f3) },  // 1e233
+  { GOOGLE_ULONGLONG(0xb24cf65b8612f81f), GOOGLE_ULONGLONG(0xa1075a24e4421730) },  // 1e234
+  { GOOGLE_ULONGLONG(0xdee033f26797b627), GOOGLE_ULONGLONG(0xc94930ae1d529cfc) },  // 1e235
+  { GOOGLE_ULONGLONG(0x169840ef017da3b1), GOOGLE_ULONGLONG(0xfb9b7cd9a4a7443c) },  // 1e236
+  { GOOGLE_ULONGLONG(0x8e1f289560ee864e), GOOGLE_ULONGLONG(0x9d412e0806e88aa5) },  // 1e237
+  { GOOGLE_ULONGLONG(0xf1a6f2bab92a27e2), GOOGLE_ULONGLONG(0xc491798a08a2ad4e) },  // 1e238
+  { GOOGLE_ULONGLONG(0xae10af696774b1db), GOOGLE_ULONGLONG(0xf5b5d7ec8acb58a2) },  // 1e239
+  { GOOGLE_ULONGLONG(0xacca6da1e0a8ef29), GOOGLE_ULONGLONG(0x9991a6f3d6bf1765) },  // 1e240
+  { GOOGLE_ULONGLONG(0x17fd090a58d32af3), GOOGLE_ULONGLONG(0xbff610b0cc6edd3f) },  // 1e241
+  { GOOGLE_ULONGLONG(0xddfc4b4cef07f5b0), GOOGLE_ULONGLONG(0xeff394dcff8a948e) },  // 1e242
+  { GOOGLE_ULONGLONG(0x4abdaf101564f98e), GOOGLE_ULONGLONG(0x95f83d0a1fb69cd9) },  // 1e243
+  { GOOGLE_ULONGLONG(0x9d6d1ad41abe37f1), GOOGLE_ULONGLONG(0xbb764c4ca7a4440f) },  // 1e244
+  { GOOGLE_ULONGLONG(0x84c86189216dc5ed), GOOGLE_ULONGLONG(0xea53df5fd18d5513) },  // 1e245
+  { GOOGLE_ULONGLONG(0x32fd3cf5b4e49bb4), GOOGLE_ULONGLONG(0x92746b9be2f8552c) },  // 1e246
+  { GOOGLE_ULONGLONG(0x3fbc8c33221dc2a1), GOOGLE_ULONGLONG(0xb7118682dbb66a77) },  // 1e247
+  { GOOGLE_ULONGLONG(0x0fabaf3feaa5334a), GOOGLE_ULONGLONG(0xe4d5e82392a40515) },  // 1e248
+  { GOOGLE_ULONGLONG(0x29cb4d87f2a7400e), GOOGLE_ULONGLONG(0x8f05b1163ba6832d) },  // 1e249
+  { GOOGLE_ULONGLONG(0x743e20e9ef511012), GOOGLE_ULONGLONG(0xb2c71d5bca9023f8) },  // 1e250
+  { GOOGLE_ULONGLONG(0x914da9246b255416), GOOGLE_ULONGLONG(0xdf78e4b2bd342cf6) },  // 1e251
+  { GOOGLE_ULONGLONG(0x1ad089b6c2f7548e), GOOGLE_ULONGLONG(0x8bab8eefb6409c1a) },  // 1e252
+  { GOOGLE_ULONGLONG(0xa184ac2473b529b1), GOOGLE_ULONGLONG(0xae9672aba3d0c320) },  // 1e253
+  { GOOGLE_ULONGLONG(0xc9e5d72d90a2741e), GOOGLE_ULONGLONG(0xda3c0f568cc4f3e8) },  // 1e254
+  { GOOGLE_ULONGLONG(0x7e2fa67c7a658892), GOOGLE_ULONGLONG(0x8865899617fb1871) },  // 1e255
+  { GOOGLE_ULONGLONG(0xddbb901b98feeab7), GOOGLE_ULONGLONG(0xaa7eebfb9df9de8d) },  // 1e256
+  { GOOGLE_ULONGLONG(0x552a74227f3ea565), GOOGLE_ULONGLONG(0xd51ea6fa85785631) },  // 1e257
+  { GOOGLE_ULONGLONG(0xd53a88958f87275f), GOOGLE_ULONGLONG(0x8533285c936b35de) },  // 1e258
+  { GOOGLE_ULONGLONG(0x8a892abaf368f137), GOOGLE_ULONGLONG(0xa67ff273b8460356) },  // 1e259
+  { GOOGLE_ULONGLONG(0x2d2b7569b0432d85), GOOGLE_ULONGLONG(0xd01fef10a657842c) },  // 1e260
+  { GOOGLE_ULONGLONG(0x9c3b29620e29fc73), GOOGLE_ULONGLONG(0x8213f56a67f6b29b) },  // 1e261
+  { GOOGLE_ULONGLONG(0x8349f3ba91b47b8f), GOOGLE_ULONGLONG(0xa298f2c501f45f42) },  // 1e262
+  { GOOGLE_ULONGLONG(0x241c70a936219a73), GOOGLE_ULONGLONG(0xcb3f2f7642717713) },  // 1e263
+  { GOOGLE_ULONGLONG(0xed238cd383aa0110), GOOGLE_ULONGLONG(0xfe0efb53d30dd4d7) },  // 1e264
+  { GOOGLE_ULONGLONG(0xf4363804324a40aa), GOOGLE_ULONGLONG(0x9ec95d1463e8a506) },  // 1e265
+  { GOOGLE_ULONGLONG(0xb143c6053edcd0d5), GOOGLE_ULONGLONG(0xc67bb4597ce2ce48) },  // 1e266
+  { GOOGLE_ULONGLONG(0xdd94b7868e94050a), GOOGLE_ULONGLONG(0xf81aa16fdc1b81da) },  // 1e267
+  { GOOGLE_ULONGLONG(0xca7cf2b4191c8326), GOOGLE_ULONGLONG(0x9b10a4e5e9913128) },  // 1e268
+  { GOOGLE_ULONGLONG(0xfd1c2f611f63a3f0), GOOGLE_ULONGLONG(0xc1d4ce1f63f57d72) },  // 1e269
+  { GOOGLE_ULONGLONG(0xbc633b39673c8cec), GOOGLE_ULONGLONG(0xf24a01a73cf2dccf) },  // 1e270
+  { GOOGLE_ULONGLONG(0xd5be0503e085d813), GOOGLE_ULONGLONG(0x976e41088617ca01) },  // 1e271
+  { GOOGLE_ULONGLONG(0x4b2d8644d8a74e18), GOOGLE_ULONGLONG(0xbd49d14aa79dbc82) },  // 1e272
+  { GOOGLE_ULONGLONG(0xddf8e7d60ed1219e), GOOGLE_ULONGLONG(0xec9c459d51852ba2) },  // 1e273
+  { GOOGLE_ULONGLONG(0xcabb90e5c942b503), GOOGLE_ULONGLONG(0x93e1ab8252f33b45) },  // 1e274
+  { GOOGLE_ULONGLONG(0x3d6a751f3b936243), GOOGLE_ULONGLONG(0xb8da1662e7b00a17) },  // 1e275
+  { GOOGLE_ULONGLONG(0x0cc512670a783ad4), GOOGLE_ULONGLONG(0xe7109bfba19c0c9d) },  // 1e276
+  { GOOGLE_ULONGLONG(0x27fb2b80668b24c5), GOOGLE_ULONGLONG(0x906a617d450187e2) },  // 1e277
+  { GOOGLE_ULONGLONG(0xb1f9f660802dedf6), GOOGLE_ULONGLONG(0xb484f9dc9641e9da) },  // 1e278
+  { GOOGLE_ULONGLONG(0x5e7873f8a0396973), GOOGLE_ULONGLONG(0xe1a63853bbd26451) },  // 1e279
+  { GOOGLE_ULONGLONG(0xdb0b487b6423e1e8), GOOGLE_ULONGLONG(0x8d07e33455637eb2) },  // 1e280
+  { GOOGLE_ULONGLONG(0x91ce1a9a3d2cda62), GOOGLE_ULONGLONG(0xb049dc016abc5e5f) },  // 1e281
+  { GOOGLE_ULONGLONG(0x7641a140cc7810fb), GOOGLE_ULONGLONG(0xdc5c5301c56b75f7) },  // 1e282
+  { GOOGLE_ULONGLONG(0xa9e904c87fcb0a9d), GOOGLE_ULONGLONG(0x89b9b3e11b6329ba) },  // 1e283
+  { GOOGLE_ULONGLONG(0x546345fa9fbdcd44), GOOGLE_ULONGLONG(0xac2820d9623bf429) },  // 1e284
+  { GOOGLE_ULONGLONG(0xa97c177947ad4095), GOOGLE_ULONGLONG(0xd732290fbacaf133) },  // 1e285
+  { GOOGLE_ULONGLONG(0x49ed8eabcccc485d), GOOGLE_ULONGLONG(0x867f59a9d4bed6c0) },  // 1e286
+  { GOOGLE_ULONGLONG(0x5c68f256bfff5a74), GOOGLE_ULONGLONG(0xa81f301449ee8c70) },  // 1e287
+  { GOOGLE_ULONGLONG(0x73832eec6fff3111), GOOGLE_ULONGLONG(0xd226fc195c6a2f8c) },  // 1e288
+  { GOOGLE_ULONGLONG(0xc831fd53c5ff7eab), GOOGLE_ULONGLONG(0x83585d8fd9c25db7) },  // 1e289
+  { GOOGLE_ULONGLONG(0xba3e7ca8b77f5e55), GOOGLE_ULONGLONG(0xa42e74f3d032f525) },  // 1e290
+  { GOOGLE_ULONGLONG(0x28ce1bd2e55f35eb), GOOGLE_ULONGLONG(0xcd3a1230c43fb26f) },  // 1e291
+  { GOOGLE_ULONGLONG(0x7980d163cf5b81b3), GOOGLE_ULONGLONG(0x80444b5e7aa7cf85) },  // 1e292
+  { GOOGLE_ULONGLONG(0xd7e105bcc332621f), GOOGLE_ULONGLONG(0xa0555e361951c366) },  // 1e293
+  { GOOGLE_ULONGLONG(0x8dd9472bf3fefaa7), GOOGLE_ULONGLONG(0xc86ab5c39fa63440) },  // 1e294
+  { GOOGLE_ULONGLONG(0xb14f98f6f0feb951), GOOGLE_ULONGLONG(0xfa856334878fc150) },  // 1e295
+  { GOOGLE_ULONGLONG(0x6ed1bf9a569f33d3), GOOGLE_ULONGLONG(0x9c935e00d4b9d8d2) },  // 1e296
+  { GOOGLE_ULONGLONG(0x0a862f80ec4700c8), GOOGLE_ULONGLONG(0xc3b8358109e84f07) },  // 1e297
+  { GOOGLE_ULONGLONG(0xcd27bb612758c0fa), GOOGLE_ULONGLONG(0xf4a642e14c6262c8) },  // 1e298
+  { GOOGLE_ULONGLONG(0x8038d51cb897789c), GOOGLE_ULONGLONG(0x98e7e9cccfbd7dbd) },  // 1e299
+  { GOOGLE_ULONGLONG(0xe0470a63e6bd56c3), GOOGLE_ULONGLONG(0xbf21e44003acdd2c) },  // 1e300
+  { GOOGLE_ULONGLONG(0x1858ccfce06cac74), GOOGLE_ULONGLONG(0xeeea5d5004981478) },  // 1e301
+  { GOOGLE_ULONGLONG(0x0f37801e0c43ebc8), GOOGLE_ULONGLONG(0x95527a5202df0ccb) },  // 1e302
+  { GOOGLE_ULONGLONG(0xd30560258f54e6ba), GOOGLE_ULONGLONG(0xbaa718e68396cffd) },  // 1e303
+  { GOOGLE_ULONGLONG(0x47c6b82ef32a2069), GOOGLE_ULONGLONG(0xe950df20247c83fd) },  // 1e304
+  { GOOGLE_ULONGLONG(0x4cdc331d57fa5441), GOOGLE_ULONGLONG(0x91d28b7416cdd27e) },  // 1e305
+  { GOOGLE_ULONGLONG(0xe0133fe4adf8e952), GOOGLE_ULONGLONG(0xb6472e511c81471d) },  // 1e306
+  { GOOGLE_ULONGLONG(0x58180fddd97723a6), GOOGLE_ULONGLONG(0xe3d8f9e563a198e5) },  // 1e307
+  { GOOGLE_ULONGLONG(0x570f09eaa7ea7648), GOOGLE_ULONGLONG(0x8e679c2f5e44ff8f) },  // 1e308
+  { GOOGLE_ULONGLONG(0x2cd2cc6551e513da), GOOGLE_ULONGLONG(0xb201833b35d63f73) },  // 1e309
+  { GOOGLE_ULONGLONG(0xf8077f7ea65e58d1), GOOGLE_ULONGLONG(0xde81e40a034bcf4f) },  // 1e310
+  { GOOGLE_ULONGLONG(0xfb04afaf27faf782), GOOGLE_ULONGLONG(0x8b112e86420f6191) },  // 1e311
+  { GOOGLE_ULONGLONG(0x79c5db9af1f9b563), GOOGLE_ULONGLONG(0xadd57a27d29339f6) },  // 1e312
+  { GOOGLE_ULONGLONG(0x18375281ae7822bc), GOOGLE_ULONGLONG(0xd94ad8b1c7380874) },  // 1e313
+  { GOOGLE_ULONGLONG(0x8f2293910d0b15b5), GOOGLE_ULONGLONG(0x87cec76f1c830548) },  // 1e314
+  { GOOGLE_ULONGLONG(0xb2eb3875504ddb22), GOOGLE_ULONGLONG(0xa9c2794ae3a3c69a) },  // 1e315
+  { GOOGLE_ULONGLONG(0x5fa60692a46151eb), GOOGLE_ULONGLONG(0xd433179d9c8cb841) },  // 1e316
+  { GOOGLE_ULONGLONG(0xdbc7c41ba6bcd333), GOOGLE_ULONGLONG(0x849feec281d7f328) },  // 1e317
+  { GOOGLE_ULONGLONG(0x12b9b522906c0800), GOOGLE_ULONGLONG(0xa5c7ea73224deff3) },  // 1e318
+  { GOOGLE_ULONGLONG(0xd768226b34870a00), GOOGLE_ULONGLONG(0xcf39e50feae16bef) },  // 1e319
+  { GOOGLE_ULONGLONG(0xe6a1158300d46640), GOOGLE_ULONGLONG(0x81842f29f2cce375) },  // 1e320
+  { GOOGLE_ULONGLONG(0x60495ae3c1097fd0), GOOGLE_ULONGLONG(0xa1e53af46f801c53) },  // 1e321
+  { GOOGLE_ULONGLONG(0x385bb19cb14bdfc4), GOOGLE_ULONGLONG(0xca5e89b18b602368) },  // 1e322
+  { GOOGLE_ULONGLONG(0x46729e03dd9ed7b5), GOOGLE_ULONGLONG(0xfcf62c1dee382c42) },  // 1e323
+  { GOOGLE_ULONGLONG(0x6c07a2c26a8346d1), GOOGLE_ULONGLONG(0x9e19db92b4e31ba9) },  // 1e324
+  { GOOGLE_ULONGLONG(0xc7098b7305241885), GOOGLE_ULONGLONG(0xc5a05277621be293) },  // 1e325
+  { GOOGLE_ULONGLONG(0xb8cbee4fc66d1ea7), GOOGLE_ULONGLONG(0xf70867153aa2db38) },  // 1e326
+  { GOOGLE_ULONGLONG(0x737f74f1dc043328), GOOGLE_ULONGLONG(0x9a65406d44a5c903) },  // 1e327
+  { GOOGLE_ULONGLONG(0x505f522e53053ff2), GOOGLE_ULONGLONG(0xc0fe908895cf3b44) },  // 1e328
+  { GOOGLE_ULONGLONG(0x647726b9e7c68fef), GOOGLE_ULONGLONG(0xf13e34aabb430a15) },  // 1e329
+  { GOOGLE_ULONGLONG(0x5eca783430dc19f5), GOOGLE_ULONGLONG(0x96c6e0eab509e64d) },  // 1e330
+  { GOOGLE_ULONGLONG(0xb67d16413d132072), GOOGLE_ULONGLONG(0xbc789925624c5fe0) },  // 1e331
+  { GOOGLE_ULONGLONG(0xe41c5bd18c57e88f), GOOGLE_ULONGLONG(0xeb96bf6ebadf77d8) },  // 1e332
+  { GOOGLE_ULONGLONG(0x8e91b962f7b6f159), GOOGLE_ULONGLONG(0x933e37a534cbaae7) },  // 1e333
+  { GOOGLE_ULONGLONG(0x723627bbb5a4adb0), GOOGLE_ULONGLONG(0xb80dc58e81fe95a1) },  // 1e334
+  { GOOGLE_ULONGLONG(0xcec3b1aaa30dd91c), GOOGLE_ULONGLONG(0xe61136f2227e3b09) },  // 1e335
+  { GOOGLE_ULONGLONG(0x213a4f0aa5e8a7b1), GOOGLE_ULONGLONG(0x8fcac257558ee4e6) },  // 1e336
+  { GOOGLE_ULONGLONG(0xa988e2cd4f62d19d), GOOGLE_ULONGLONG(0xb3bd72ed2af29e1f) },  // 1e337
+  { GOOGLE_ULONGLONG(0x93eb1b80a33b8605), GOOGLE_ULONGLONG(0xe0accfa875af45a7) },  // 1e338
+  { GOOGLE_ULONGLONG(0xbc72f130660533c3), GOOGLE_ULONGLONG(0x8c6c01c9498d8b88) },  // 1e339
+  { GOOGLE_ULONGLONG(0xeb8fad7c7f8680b4), GOOGLE_ULONGLONG(0xaf87023b9bf0ee6a) },  // 1e340
+  { GOOGLE_ULONGLONG(0xa67398db9f6820e1), GOOGLE_ULONGLONG(0xdb68c2ca82ed2a05) },  // 1e341
+  { GOOGLE_ULONGLONG(0x88083f8943a1148c), GOOGLE_ULONGLONG(0x892179be91d43a43) },  // 1e342
+  { GOOGLE_ULONGLONG(0x6a0a4f6b948959b0), GOOGLE_ULONGLONG(0xab69d82e364948d4) },  // 1e343
+  { GOOGLE_ULONGLONG(0x848ce34679abb01c), GOOGLE_ULONGLONG(0xd6444e39c3db9b09) },  // 1e344
+  { GOOGLE_ULONGLONG(0xf2d80e0c0c0b4e11), GOOGLE_ULONGLONG(0x85eab0e41a6940e5) },  // 1e345
+  { GOOGLE_ULONGLONG(0x6f8e118f0f0e2195), GOOGLE_ULONGLONG(0xa7655d1d2103911f) },  // 1e346
+  { GOOGLE_ULONGLONG(0x4b7195f2d2d1a9fb), GOOGLE_ULONGLONG(0xd13eb46469447567) },  // 1e347
+};
+
+// Powers of ten which are exactly representable as doubles.
+const double kExactPowers[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// A uint64 can hold any 19 decimal digits.
+const int kMaxSignificantDigits = 19;
+
+inline int CountLeadingZeros64(uint64 value) {
+#if defined(__GNUC__)
+  return __builtin_clzll(value);
+#else
+  int count = 0;
+  while ((value & GOOGLE_ULONGLONG(0x8000000000000000)) == 0) {
+    value <<= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// Computes the full 128-bit product of a and b.
+inline void Multiply128(uint64 a, uint64 b, uint64* high, uint64* low) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  *high = static_cast<uint64>(product >> 64);
+  *low = static_cast<uint64>(product);
+#else
+  const uint64 kM32 = 0xFFFFFFFFu;
+  uint64 a_high = a >> 32;
+  uint64 a_low = a & kM32;
+  uint64 b_high = b >> 32;
+  uint64 b_low = b & kM32;
+  uint64 low_low = a_low * b_low;
+  uint64 high_low = a_high * b_low;
+  uint64 low_high = a_low * b_high;
+  uint64 middle = (low_low >> 32) + (high_low & kM32) + low_high;
+  *high = a_high * b_high + (high_low >> 32) + (middle >> 32);
+  *low = (middle << 32) | (low_low & kM32);
+#endif
+}
+
+inline double BitsToDouble(uint64 bits) {
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Computes significand * 10^exponent, correctly rounded, for a non-zero
+// significand and an exponent in [kMinParsePower, kMaxParsePower].
+// Returns false if the result can't be decided this way, either because
+// the product is too close to halfway between two doubles or because the
+// result is subnormal or overflows.
+bool EiselLemire(uint64 significand, int exponent, double* value) {
+  int leading_zeros = CountLeadingZeros64(significand);
+  significand <<= leading_zeros;
+
+  // floor(exponent * log2(10)), computed without division.
+  int64 product_exponent = 217706 * static_cast<int64>(exponent);
+  product_exponent = product_exponent >= 0 ? product_exponent >> 16
+                                           : -((-product_exponent + 65535) >> 16);
+  int64 binary_exponent = product_exponent + 64 + 1023 - leading_zeros;
+
+  const uint64* power = kParsePowers[exponent - kMinParsePower];
+  uint64 high, low;
+  Multiply128(significand, power[1], &high, &low);
+
+  // The truncated power is at most one unit too small, so if the low bits
+  // of the product could still carry into the part we keep, bring in the
+  // rest of the power.
+  if ((high & 0x1FF) == 0x1FF && low + significand < significand) {
+    uint64 extra_high, extra_low;
+    Multiply128(significand, power[0], &extra_high, &extra_low);
+    uint64 merged_low = low + extra_high;
+    uint64 merged_high = high + (merged_low < low ? 1 : 0);
+    if ((merged_high & 0x1FF) == 0x1FF && merged_low + 1 == 0 &&
+        extra_low + significand < significand) {
+      return false;
+    }
+    high = merged_high;
+    low = merged_low;
+  }
+
+  // Keep 54 bits:  the 53 of the result and one more to round with.
+  int top_bit = static_cast<int>(high >> 63);
+  uint64 mantissa = high >> (top_bit + 9);
+  binary_exponent -= 1 ^ top_bit;
+
+  // Exactly halfway between two doubles, or too close to tell.
+  if (low == 0 && (high & 0x1FF) == 0 && (mantissa & 3) == 1) return false;
+
+  // Round half to even.
+  mantissa += mantissa & 1;
+  mantissa >>= 1;
+  if (mantissa >> 53 != 0) {
+    mantissa >>= 1;
+    ++binary_exponent;
+  }
+
+  if (binary_exponent <= 0 || binary_exponent >= 0x7FF) return false;
+  *value = BitsToDouble(
+      (static_cast<uint64>(binary_exponent) << 52) |
+      (mantissa & GOOGLE_ULONGLONG(0x000FFFFFFFFFFFFF)));
+  return true;
+}
+
+// Parses [begin, end) with strtod(), for the cases the fast paths can't
+// decide.
+double SlowParseDouble(const char* begin, const char* end) {
+  char buffer[128];
+  string copy;
+  const char* text;
+  if (end - begin < static_cast<int>(sizeof(buffer))) {
+    memcpy(buffer, begin, end - begin);
+    buffer[end - begin] = '\0';
+    text = buffer;
+  } else {
+    copy.assign(begin, end);
+    text = copy.c_str();
+  }
+  return NoLocaleStrtod(text, NULL);
+}
+
+inline bool IsDecimalDigit(char c) {
+  return '0' <= c && c <= '9';
+}
+
+}  // namespace
+
+const char* ParseDouble(const char* begin, const char* end, double* value) {
+  const char* ptr = begin;
+  bool negative = false;
+  if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+    negative = (*ptr == '-');
+    ++ptr;
+  }
+
+  // Collect up to kMaxSignificantDigits significant digits; the value is
+  // significand * 10^exponent, give or take the digits which didn't fit.
+  uint64 significand = 0;
+  int significant_digits = 0;
+  int64 exponent = 0;
+  bool truncated = false;
+  bool any_digits = false;
+
+  for (; ptr < end && IsDecimalDigit(*ptr); ++ptr) {
+    int digit = *ptr - '0';
+    any_digits = true;
+    if (significant_digits < kMaxSignificantDigits) {
+      significand = significand * 10 + digit;
+      if (significand != 0) ++significant_digits;
+    } else {
+      ++exponent;
+      if (digit != 0) truncated = true;
+    }
+  }
+  if (ptr < end && *ptr == '.') {
+    ++ptr;
+    for (; ptr < end && IsDecimalDigit(*ptr); ++ptr) {
+      int digit = *ptr - '0';
+      any_digits = true;
+      if (significant_digits < kMaxSignificantDigits) {
+        significand = significand * 10 + digit;
+        if (significand != 0) ++significant_digits;
+        --exponent;
+      } else if (digit != 0) {
+        truncated = true;
+      }
+    }
+  }
+  if (!any_digits) return NULL;
+
+  // An exponent with no digits isn't part of the number, as with strtod().
+  if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+    const char* exponent_start = ptr + 1;
+    bool exponent_negative = false;
+    if (exponent_start < end &&
+        (*exponent_start == '-' || *exponent_start == '+')) {
+      exponent_negative = (*exponent_start == '-');
+      ++exponent_start;
+    }
+    if (exponent_start < end && IsDecimalDigit(*exponent_start)) {
+      int64 explicit_exponent = 0;
+      for (ptr = exponent_start; ptr < end && IsDecimalDigit(*ptr); ++ptr) {
+        // Anything this big is zero or infinity anyway.
+        if (explicit_exponent < 100000) {
+          explicit_exponent = explicit_exponent * 10 + (*ptr - '0');
+        }
+      }
+      exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+  }
+
+  double result;
+  if (significand == 0) {
+    result = 0.0;
+  } else if (exponent < kMinParsePower) {
+    // Below 10^(19 + kMinParsePower), which rounds to zero.
+    result = 0.0;
+  } else if (exponent > kMaxParsePower) {
+    result = numeric_limits<double>::infinity();
+  } else if (!truncated && significand <= (GOOGLE_ULONGLONG(1) << 53) &&
+             -22 <= exponent && exponent <= 22) {
+    // Both operands are exact, so the single rounding is correct.
+    result = static_cast<double>(significand);
+    if (exponent < 0) {
+      result /= kExactPowers[-exponent];
+    } else {
+      result *= kExactPowers[exponent];
+    }
+  } else {
+    int power = static_cast<int>(exponent);
+    bool ok = EiselLemire(significand, power, &result);
+    if (ok && truncated) {
+      // The true value is between significand and significand + 1, so if
+      // both round the same way, so does it.
+      double upper;
+      ok = significand + 1 != 0 &&
+           EiselLemire(significand + 1, power, &upper) && upper == result;
+    }
+    if (!ok) {
+      result = SlowParseDouble(negative ? begin + 1 : begin, ptr);
+    }
+  }
+
+  *value = negative ? -result : result;
+  return ptr;
+}
+
+bool ParseUnsignedDigits(const char* begin, const char* end, int base,
+                         uint64 max_value, uint64* value) {
+  if (begin == end) return false;
+
+  // This many digits always fit in a uint64, so the loop needn't check for
+  // overflow until the end.
+  int safe_digits = base == 10 ? 19 : base == 16 ? 15 : 21;
+
+  uint64 result = 0;
+  const char* ptr = begin;
+  const char* safe_end = end - begin > safe_digits ? begin + safe_digits : end;
+  for (; ptr < safe_end; ++ptr) {
+    int digit;
+    char c = *ptr;
+    if ('0' <= c && c <= '9') {
+      digit = c - '0';
+    } else if ('a' <= c && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if ('A' <= c && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    if (digit >= base) return false;
+    result = result * base + digit;
+  }
+
+  // Long inputs, which are rare, check every remaining digit.
+  for (; ptr < end; ++ptr) {
+    int digit;
+    char c = *ptr;
+    if ('0' <= c && c <= '9') {
+      digit = c - '0';
+    } else if ('a' <= c && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if ('A' <= c && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    if (digit >= base) return false;
+    if (result > (kuint64max - digit) / base) return false;
+    result = result * base + digit;
+  }
+
+  if (result > max_value) return false;
+  *value = result;
+  return true;
+}
+
 }  // namespace protobuf
 }  // namespace google
@@ -411,8 +411,8 @@ LIBPROTOBUF_EXPORT string SimpleItoa(unsigned long long i);
 //    Description: converts a double or float to a string which, if
 //    passed to NoLocaleStrtod(), will produce the exact same original double
 //    (except in case of NaN; all NaNs are considered the same value).
-//    We try to keep the string short but it's not guaranteed to be as
-//    short as possible.
+//    The string has as few significant digits as possible, and is laid out
+//    like printf("%g") output.
 //
 //    DoubleToBuffer() and FloatToBuffer() write the text to the given
 //    buffer and return it.  The buffer must be at least
@@ -442,6 +442,28 @@ static const int kFloatToBufferSize = 24;
 
 LIBPROTOBUF_EXPORT double NoLocaleStrtod(const char* text, char** endptr);
 
+// ----------------------------------------------------------------------
+// ParseDouble()
+//    Parses the decimal number at the start of [begin, end), which needn't
+//    be NUL-terminated:  an optional sign, digits with an optional '.',
+//    and an optional exponent.  Returns a pointer just past the number, or
+//    NULL if there are no digits.  Unlike strtod(), it ignores the locale,
+//    doesn't skip whitespace or accept "inf", "nan" or hex, and only
+//    allocates for the rare inputs it has to hand to NoLocaleStrtod().
+//    The result is correctly rounded either way.
+//
+// ParseUnsignedDigits()
+//    Parses [begin, end), all of which must be digits in the given base
+//    (8, 10 or 16, without any prefix), as an integer.  Returns false if
+//    any character isn't such a digit or the value exceeds max_value.
+// ----------------------------------------------------------------------
+
+LIBPROTOBUF_EXPORT const char* ParseDouble(const char* begin, const char* end,
+                                           double* value);
+LIBPROTOBUF_EXPORT bool ParseUnsignedDigits(const char* begin,
+                                            const char* end, int base,
+                                            uint64 max_value, uint64* value);
+
 }  // namespace protobuf
 }  // namespace google
 
@@ -0,0 +1,188 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#endif
+#include <string.h>
+#include <vector>
+
+#include <google/protobuf/trace.h>
+#include <google/protobuf/io/json_writer.h>
+
+namespace google {
+namespace protobuf {
+
+namespace internal {
+
+bool tracing = false;
+
+}  // namespace internal
+
+namespace {
+
+struct TraceEvent {
+  const char* name;
+  string detail;
+  int thread;
+  int64 start;
+  int64 duration;
+};
+
+// All set up by StartTracing() and torn down by StopTracing().
+Mutex* trace_mutex = NULL;
+vector<TraceEvent>* trace_events = NULL;
+int64 trace_origin = 0;
+#ifndef _WIN32
+vector<pthread_t>* trace_threads = NULL;
+#endif
+
+int64 NowMicros() {
+#ifdef _WIN32
+  // Millisecond resolution, but good enough to see which phase is slow.
+  return static_cast<int64>(GetTickCount()) * 1000;
+#else
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return static_cast<int64>(now.tv_sec) * 1000000 + now.tv_usec;
+#endif
+}
+
+// Numbers threads 1, 2, ... in the order their first spans end, so that the
+// main thread is usually 1.  Call with trace_mutex held.
+int CurrentThread() {
+#ifdef _WIN32
+  return GetCurrentThreadId();
+#else
+  pthread_t self = pthread_self();
+  for (int i = 0; i < trace_threads->size(); i++) {
+    if (pthread_equal((*trace_threads)[i], self)) return i + 1;
+  }
+  trace_threads->push_back(self);
+  return trace_threads->size();
+#endif
+}
+
+}  // namespace
+
+void StartTracing() {
+  if (internal::tracing) return;
+  trace_mutex = new Mutex;
+  trace_events = new vector<TraceEvent>;
+#ifndef _WIN32
+  trace_threads = new vector<pthread_t>;
+#endif
+  trace_origin = NowMicros();
+  internal::tracing = true;
+}
+
+bool StopTracing(io::ZeroCopyOutputStream* output) {
+  if (!internal::tracing) return true;
+  internal::tracing = false;
+
+  bool success = true;
+  if (output != NULL) {
+    io::JsonWriter writer(output);
+    writer.BeginObject();
+    writer.Name("traceEvents");
+    writer.BeginArray();
+    for (int i = 0; i < trace_events->size(); i++) {
+      const TraceEvent& event = (*trace_events)[i];
+      writer.BeginObject();
+      writer.Name("name");
+      writer.String(event.name, strlen(event.name));
+      writer.Name("cat");
+      writer.String("pb2json", 7);
+      writer.Name("ph");
+      writer.String("X", 1);
+      writer.Name("ts");
+      writer.Int64(event.start);
+      writer.Name("dur");
+      writer.Int64(event.duration);
+      writer.Name("pid");
+      writer.Int32(1);
+      writer.Name("tid");
+      writer.Int32(event.thread);
+      if (!event.detail.empty()) {
+        writer.Name("args");
+        writer.BeginObject();
+        writer.Name("detail");
+        writer.String(event.detail);
+        writer.EndObject();
+      }
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Name("displayTimeUnit");
+    writer.String("ms", 2);
+    writer.EndObject();
+    success = !writer.failed();
+  }
+
+  delete trace_mutex;
+  delete trace_events;
+  trace_mutex = NULL;
+  trace_events = NULL;
+#ifndef _WIN32
+  delete trace_threads;
+  trace_threads = NULL;
+#endif
+  return success;
+}
+
+void TraceSpan::Begin(const char* name, const string* detail) {
+  name_ = name;
+  if (detail != NULL) detail_ = *detail;
+  start_ = NowMicros() - trace_origin;
+}
+
+void TraceSpan::End() {
+  int64 end = NowMicros() - trace_origin;
+  if (!internal::tracing) return;
+
+  MutexLock lock(trace_mutex);
+  trace_events->push_back(TraceEvent());
+  TraceEvent* event = &trace_events->back();
+  event->name = name_;
+  event->detail.swap(detail_);
+  event->thread = CurrentThread();
+  event->start = start_;
+  event->duration = end - start_;
+}
+
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,103 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//  Based on original Protocol Buffers design by
+//  Sanjay Ghemawat, Jeff Dean, and others.
+//
+// Timing spans for finding out where a run of the compiler spends its time.
+// Spans are recorded in memory between StartTracing() and StopTracing(),
+// which writes them in the Chrome trace-event format, for chrome://tracing
+// or Perfetto.  When tracing is off, a span costs a test of a global flag.
+//
+//   const FileDescriptor* Importer::Import(const string& filename) {
+//     TraceSpan span("Import", filename);
+//     ...
+//   }
+
+#ifndef GOOGLE_PROTOBUF_TRACE_H__
+#define GOOGLE_PROTOBUF_TRACE_H__
+
+#include <string>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+namespace io {
+  class ZeroCopyOutputStream;  // zero_copy_stream.h
+}
+
+namespace internal {
+
+// True between StartTracing() and StopTracing().
+extern LIBPROTOBUF_EXPORT bool tracing;
+
+}  // namespace internal
+
+// Starts recording spans.  Call it before starting any threads whose spans
+// should be recorded.
+LIBPROTOBUF_EXPORT void StartTracing();
+
+// Stops recording and writes the spans that ended since StartTracing() to
+// the output as a trace-event JSON object, or discards them if output is
+// NULL.  Spans on other threads must not end while it runs.  Returns false
+// if the output fails.
+LIBPROTOBUF_EXPORT bool StopTracing(io::ZeroCopyOutputStream* output);
+
+// Records the time from its construction to its destruction under the given
+// name, and the detail (a file or message name, say) if given.  The name
+// must be a string literal.
+class LIBPROTOBUF_EXPORT TraceSpan {
+ public:
+  explicit TraceSpan(const char* name) : start_(-1) {
+    if (internal::tracing) Begin(name, NULL);
+  }
+  TraceSpan(const char* name, const string& detail) : start_(-1) {
+    if (internal::tracing) Begin(name, &detail);
+  }
+  ~TraceSpan() {
+    if (start_ >= 0) End();
+  }
+
+ private:
+  void Begin(const char* name, const string* detail);
+  void End();
+
+  const char* name_;
+  string detail_;
+  int64 start_;  // Microseconds since StartTracing(), or -1 if not tracing.
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(TraceSpan);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_TRACE_H__
@@ -43,11 +43,12 @@ namespace google {
 namespace protobuf {
 
 UnknownFieldSet::UnknownFieldSet()
-  : fields_(NULL) {}
+  : fields_(NULL), raw_(NULL) {}
 
 UnknownFieldSet::~UnknownFieldSet() {
   Clear();
   delete fields_;
+  delete raw_;
 }
 
 void UnknownFieldSet::Clear() {
@@ -57,18 +58,30 @@ void UnknownFieldSet::Clear() {
     }
     fields_->clear();
   }
+  if (raw_ != NULL) {
+    raw_->clear();
+  }
 }
 
 void UnknownFieldSet::MergeFrom(const UnknownFieldSet& other) {
-  for (int i = 0; i < other.field_count(); i++) {
-    AddField(other.field(i));
+  // Copy the other set's decoded fields, then its raw bytes, so that the
+  // wire order is preserved without forcing it to decode anything.
+  for (int i = 0; i < other.decoded_field_count(); i++) {
+    AddField(other.decoded_field(i));
+  }
+  if (other.has_raw_fields()) {
+    MutableRawFields()->append(*other.raw_);
   }
 }
 
 int UnknownFieldSet::SpaceUsedExcludingSelf() const {
-  if (fields_ == NULL) return 0;
+  int total_size = 0;
+  if (raw_ != NULL) {
+    total_size += sizeof(*raw_) + internal::StringSpaceUsedExcludingSelf(*raw_);
+  }
+  if (fields_ == NULL) return total_size;
 
-  int total_size = sizeof(*fields_) + sizeof(UnknownField) * fields_->size();
+  total_size += sizeof(*fields_) + sizeof(UnknownField) * fields_->size();
   for (int i = 0; i < fields_->size(); i++) {
     const UnknownField& field = (*fields_)[i];
     switch (field.type()) {
@@ -91,6 +104,7 @@ int UnknownFieldSet::SpaceUsed() const {
 }
 
 void UnknownFieldSet::AddVarint(int number, uint64 value) {
+  DecodeRawFieldsIfNeeded();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -100,6 +114,7 @@ void UnknownFieldSet::AddVarint(int number, uint64 value) {
 }
 
 void UnknownFieldSet::AddFixed32(int number, uint32 value) {
+  DecodeRawFieldsIfNeeded();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -109,6 +124,7 @@ void UnknownFieldSet::AddFixed32(int number, uint32 value) {
 }
 
 void UnknownFieldSet::AddFixed64(int number, uint64 value) {
+  DecodeRawFieldsIfNeeded();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -118,6 +134,7 @@ void UnknownFieldSet::AddFixed64(int number, uint64 value) {
 }
 
 string* UnknownFieldSet::AddLengthDelimited(int number) {
+  DecodeRawFieldsIfNeeded();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -128,6 +145,7 @@ string* UnknownFieldSet::AddLengthDelimited(int number) {
 }
 
 UnknownFieldSet* UnknownFieldSet::AddGroup(int number) {
+  DecodeRawFieldsIfNeeded();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   UnknownField field;
   field.number_ = number;
@@ -138,11 +156,39 @@ UnknownFieldSet* UnknownFieldSet::AddGroup(int number) {
 }
 
 void UnknownFieldSet::AddField(const UnknownField& field) {
+  DecodeRawFieldsIfNeeded();
   if (fields_ == NULL) fields_ = new vector<UnknownField>;
   fields_->push_back(field);
   fields_->back().DeepCopy();
 }
 
+void UnknownFieldSet::AddRawFields(const void* data, int size) {
+  MutableRawFields()->append(reinterpret_cast<const char*>(data), size);
+}
+
+string* UnknownFieldSet::MutableRawFields() {
+  if (raw_ == NULL) raw_ = new string;
+  return raw_;
+}
+
+void UnknownFieldSet::DecodeRawFields() const {
+  // Take the bytes out of raw_ first so that the Add*() calls made while
+  // decoding do not recurse back into here.
+  string raw;
+  raw.swap(*raw_);
+
+  io::CodedInputStream input(reinterpret_cast<const uint8*>(raw.data()),
+                             raw.size());
+  UnknownFieldSet* self = const_cast<UnknownFieldSet*>(this);
+  if (!internal::WireFormat::SkipMessage(&input, self) ||
+      !input.ConsumedEntireMessage()) {
+    // The bytes were produced by WireFormat::SkipField() from fields which
+    // parsed successfully, so this can only happen if someone passed garbage
+    // to AddRawFields().
+    GOOGLE_LOG(DFATAL) << "UnknownFieldSet contained malformed raw field data.";
+  }
+}
+
 bool UnknownFieldSet::MergeFromCodedStream(io::CodedInputStream* input) {
 
   UnknownFieldSet other;
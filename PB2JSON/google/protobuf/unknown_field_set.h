@@ -47,6 +47,9 @@ namespace protobuf {
 
 class Message;                      // message.h
 class UnknownField;                 // below
+namespace internal {
+  class WireFormat;                 // wire_format.h
+}
 
 // An UnknownFieldSet contains fields that were encountered while parsing a
 // message but were not defined by its type.  Keeping track of these can be
@@ -60,6 +63,17 @@ class UnknownField;                 // below
 //
 // This class is necessarily tied to the protocol buffer wire format, unlike
 // the Reflection interface which is independent of any serialization scheme.
+//
+// Unknown fields may also be held as a single buffer of undecoded wire bytes
+// (see AddRawFields()).  Such bytes are decoded into UnknownFields the first
+// time field_count(), field() or any of the Add*() methods need them, and are
+// copied out verbatim if the set is serialized before that happens.  The
+// parser stores unknown fields this way when
+// CodedInputStream::SetLazyUnknownFields(true) has been called, which avoids
+// one allocation per unknown tag when reading data written with a newer
+// schema.  Note that decoding happens inside const methods, so, like
+// Message::GetCachedSize(), a set holding raw bytes must not be read from
+// multiple threads at once without external synchronization.
 class LIBPROTOBUF_EXPORT UnknownFieldSet {
  public:
   UnknownFieldSet();
@@ -107,6 +121,13 @@ class LIBPROTOBUF_EXPORT UnknownFieldSet {
   // Adds an unknown field from another set.
   void AddField(const UnknownField& field);
 
+  // Appends the wire encoding of zero or more complete fields.  The bytes are
+  // kept as-is until one of the accessors above needs them decoded.
+  void AddRawFields(const void* data, int size);
+  // Returns the buffer of undecoded wire bytes so that the caller can append
+  // complete encoded fields to it directly.
+  string* MutableRawFields();
+
   // Parsing helpers -------------------------------------------------
   // These work exactly like the similarly-named methods of Message.
 
@@ -119,7 +140,23 @@ class LIBPROTOBUF_EXPORT UnknownFieldSet {
   }
 
  private:
+  friend class internal::WireFormat;
+
+  // Decodes the contents of raw_ (if any) and appends them to fields_.  This
+  // is logically const: the set's contents do not change, only their
+  // representation.
+  void DecodeRawFields() const;
+  inline void DecodeRawFieldsIfNeeded() const;
+
+  // Fields which have already been decoded, followed (on the wire) by the
+  // contents of raw_.  Only WireFormat uses these; everyone else sees the
+  // decoded view.
+  inline int decoded_field_count() const;
+  inline const UnknownField& decoded_field(int index) const;
+  inline bool has_raw_fields() const;
+
   vector<UnknownField>* fields_;
+  string* raw_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(UnknownFieldSet);
 };
@@ -180,21 +217,40 @@ class LIBPROTOBUF_EXPORT UnknownField {
 // ===================================================================
 // inline implementations
 
+inline bool UnknownFieldSet::has_raw_fields() const {
+  return raw_ != NULL && !raw_->empty();
+}
+
+inline void UnknownFieldSet::DecodeRawFieldsIfNeeded() const {
+  if (has_raw_fields()) DecodeRawFields();
+}
+
+inline int UnknownFieldSet::decoded_field_count() const {
+  return (fields_ == NULL) ? 0 : fields_->size();
+}
+inline const UnknownField& UnknownFieldSet::decoded_field(int index) const {
+  return (*fields_)[index];
+}
+
 inline bool UnknownFieldSet::empty() const {
-  return fields_ == NULL || fields_->empty();
+  return (fields_ == NULL || fields_->empty()) && !has_raw_fields();
 }
 
 inline void UnknownFieldSet::Swap(UnknownFieldSet* x) {
   std::swap(fields_, x->fields_);
+  std::swap(raw_, x->raw_);
 }
 
 inline int UnknownFieldSet::field_count() const {
+  DecodeRawFieldsIfNeeded();
   return (fields_ == NULL) ? 0 : fields_->size();
 }
 inline const UnknownField& UnknownFieldSet::field(int index) const {
+  DecodeRawFieldsIfNeeded();
   return (*fields_)[index];
 }
 inline UnknownField* UnknownFieldSet::mutable_field(int index) {
+  DecodeRawFieldsIfNeeded();
   return &(*fields_)[index];
 }
 
@@ -40,6 +40,8 @@
 
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/field_projection.h>
+#include <google/protobuf/stats.h>
 #include <google/protobuf/wire_format_lite_inl.h>
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/io/coded_stream.h>
@@ -61,6 +63,29 @@ inline int GetEnumNumber(const EnumValueDescriptor* descriptor) {
   return descriptor->number();
 }
 
+inline void AppendVarint(uint64 value, string* output) {
+  uint8 buffer[10];  // Maximum size of a varint.
+  uint8* end = io::CodedOutputStream::WriteVarint64ToArray(value, buffer);
+  output->append(reinterpret_cast<const char*>(buffer), end - buffer);
+}
+
+// Copies the next |size| bytes of input onto the end of *output without
+// going through an intermediate string.  Like CodedInputStream::Skip(),
+// fails if size is negative.
+bool AppendRawBytes(io::CodedInputStream* input, int size, string* output) {
+  if (size < 0) return false;
+  while (size > 0) {
+    const void* data;
+    int available;
+    if (!input->GetDirectBufferPointer(&data, &available)) return false;
+    int chunk = min(size, available);
+    output->append(reinterpret_cast<const char*>(data), chunk);
+    if (!input->Skip(chunk)) return false;
+    size -= chunk;
+  }
+  return true;
+}
+
 }  // anonymous namespace
 
 // ===================================================================
@@ -81,6 +106,10 @@ void UnknownFieldSetFieldSkipper::SkipUnknownEnum(
 
 bool WireFormat::SkipField(io::CodedInputStream* input, uint32 tag,
                            UnknownFieldSet* unknown_fields) {
+  if (unknown_fields != NULL && input->lazy_unknown_fields()) {
+    return SkipFieldToRaw(input, tag, unknown_fields->MutableRawFields());
+  }
+
   int number = WireFormatLite::GetTagFieldNumber(tag);
 
   switch (WireFormatLite::GetTagWireType(tag)) {
@@ -139,6 +168,72 @@ bool WireFormat::SkipField(io::CodedInputStream* input, uint32 tag,
   }
 }
 
+bool WireFormat::SkipFieldToRaw(io::CodedInputStream* input, uint32 tag,
+                                string* raw) {
+  switch (WireFormatLite::GetTagWireType(tag)) {
+    case WireFormatLite::WIRETYPE_VARINT: {
+      uint64 value;
+      if (!input->ReadVarint64(&value)) return false;
+      AppendVarint(tag, raw);
+      AppendVarint(value, raw);
+      return true;
+    }
+    case WireFormatLite::WIRETYPE_FIXED64: {
+      uint64 value;
+      if (!input->ReadLittleEndian64(&value)) return false;
+      uint8 buffer[sizeof(value)];
+      io::CodedOutputStream::WriteLittleEndian64ToArray(value, buffer);
+      AppendVarint(tag, raw);
+      raw->append(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+      return true;
+    }
+    case WireFormatLite::WIRETYPE_LENGTH_DELIMITED: {
+      uint32 length;
+      if (!input->ReadVarint32(&length)) return false;
+      if (length > kint32max) return false;
+      AppendVarint(tag, raw);
+      AppendVarint(length, raw);
+      return AppendRawBytes(input, length, raw);
+    }
+    case WireFormatLite::WIRETYPE_START_GROUP: {
+      uint32 end_tag = WireFormatLite::MakeTag(
+          WireFormatLite::GetTagFieldNumber(tag),
+          WireFormatLite::WIRETYPE_END_GROUP);
+      if (!input->IncrementRecursionDepth()) return false;
+      AppendVarint(tag, raw);
+      while (true) {
+        uint32 inner_tag = input->ReadTag();
+        if (inner_tag == 0) return false;
+        if (WireFormatLite::GetTagWireType(inner_tag) ==
+            WireFormatLite::WIRETYPE_END_GROUP) {
+          // Check that the ending tag matched the starting tag.
+          if (inner_tag != end_tag) return false;
+          break;
+        }
+        if (!SkipFieldToRaw(input, inner_tag, raw)) return false;
+      }
+      input->DecrementRecursionDepth();
+      AppendVarint(end_tag, raw);
+      return true;
+    }
+    case WireFormatLite::WIRETYPE_END_GROUP: {
+      return false;
+    }
+    case WireFormatLite::WIRETYPE_FIXED32: {
+      uint32 value;
+      if (!input->ReadLittleEndian32(&value)) return false;
+      uint8 buffer[sizeof(value)];
+      io::CodedOutputStream::WriteLittleEndian32ToArray(value, buffer);
+      AppendVarint(tag, raw);
+      raw->append(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
 bool WireFormat::SkipMessage(io::CodedInputStream* input,
                              UnknownFieldSet* unknown_fields) {
   while(true) {
@@ -161,8 +256,10 @@ bool WireFormat::SkipMessage(io::CodedInputStream* input,
 
 void WireFormat::SerializeUnknownFields(const UnknownFieldSet& unknown_fields,
                                         io::CodedOutputStream* output) {
-  for (int i = 0; i < unknown_fields.field_count(); i++) {
-    const UnknownField& field = unknown_fields.field(i);
+  // Fields which were never decoded are written back exactly as they were
+  // read, after the decoded ones.
+  for (int i = 0; i < unknown_fields.decoded_field_count(); i++) {
+    const UnknownField& field = unknown_fields.decoded_field(i);
     switch (field.type()) {
       case UnknownField::TYPE_VARINT:
         output->WriteVarint32(WireFormatLite::MakeTag(field.number(),
@@ -194,13 +291,16 @@ void WireFormat::SerializeUnknownFields(const UnknownFieldSet& unknown_fields,
         break;
     }
   }
+  if (unknown_fields.has_raw_fields()) {
+    output->WriteString(*unknown_fields.raw_);
+  }
 }
 
 uint8* WireFormat::SerializeUnknownFieldsToArray(
     const UnknownFieldSet& unknown_fields,
     uint8* target) {
-  for (int i = 0; i < unknown_fields.field_count(); i++) {
-    const UnknownField& field = unknown_fields.field(i);
+  for (int i = 0; i < unknown_fields.decoded_field_count(); i++) {
+    const UnknownField& field = unknown_fields.decoded_field(i);
 
     switch (field.type()) {
       case UnknownField::TYPE_VARINT:
@@ -228,6 +328,10 @@ uint8* WireFormat::SerializeUnknownFieldsToArray(
         break;
     }
   }
+  if (unknown_fields.has_raw_fields()) {
+    target = io::CodedOutputStream::WriteStringToArray(*unknown_fields.raw_,
+                                                       target);
+  }
   return target;
 }
 
@@ -298,8 +402,8 @@ uint8* WireFormat::SerializeUnknownMessageSetItemsToArray(
 int WireFormat::ComputeUnknownFieldsSize(
     const UnknownFieldSet& unknown_fields) {
   int size = 0;
-  for (int i = 0; i < unknown_fields.field_count(); i++) {
-    const UnknownField& field = unknown_fields.field(i);
+  for (int i = 0; i < unknown_fields.decoded_field_count(); i++) {
+    const UnknownField& field = unknown_fields.decoded_field(i);
 
     switch (field.type()) {
       case UnknownField::TYPE_VARINT:
@@ -339,6 +443,9 @@ int WireFormat::ComputeUnknownFieldsSize(
         break;
     }
   }
+  if (unknown_fields.has_raw_fields()) {
+    size += unknown_fields.raw_->size();
+  }
 
   return size;
 }
@@ -412,6 +519,80 @@ bool WireFormat::ParseAndMergePartial(io::CodedInputStream* input,
   }
 }
 
+bool WireFormat::ParseAndMergePartial(io::CodedInputStream* input,
+                                      Message* message,
+                                      const FieldProjection* projection) {
+  if (projection == NULL) return ParseAndMergePartial(input, message);
+
+  const Descriptor* descriptor = message->GetDescriptor();
+  const Reflection* message_reflection = message->GetReflection();
+  GOOGLE_DCHECK_EQ(projection->type(), descriptor);
+
+  while(true) {
+    uint32 tag = input->ReadTag();
+    if (tag == 0) {
+      // End of input.  This is a valid place to end, so return true.
+      return true;
+    }
+
+    if (WireFormatLite::GetTagWireType(tag) ==
+        WireFormatLite::WIRETYPE_END_GROUP) {
+      // Must be the end of the message.
+      return true;
+    }
+
+    const FieldDescriptor* field =
+      descriptor->FindFieldByNumber(WireFormatLite::GetTagFieldNumber(tag));
+
+    if (field == NULL || !projection->Includes(field) ||
+        WireFormatLite::GetTagWireType(tag) != WireTypeForField(field)) {
+      // Not wanted.  Passing a NULL UnknownFieldSet makes SkipField() jump
+      // over length-delimited values with CodedInputStream::Skip().
+      if (!SkipField(input, tag, NULL)) return false;
+      continue;
+    }
+
+    const FieldProjection* sub_projection = projection->GetSubProjection(field);
+    if (sub_projection == NULL) {
+      // Wanted as a whole.
+      if (!ParseAndMergeField(tag, field, message, input)) return false;
+      continue;
+    }
+
+    // Only part of this sub-message is wanted.  This mirrors
+    // WireFormatLite::ReadMessage() and ReadGroup().
+    Message* sub_message;
+    if (field->is_repeated()) {
+      sub_message = message_reflection->AddMessage(message, field);
+    } else {
+      sub_message = message_reflection->MutableMessage(message, field);
+    }
+
+    if (field->type() == FieldDescriptor::TYPE_GROUP) {
+      if (!input->IncrementRecursionDepth()) return false;
+      if (!ParseAndMergePartial(input, sub_message, sub_projection)) {
+        return false;
+      }
+      input->DecrementRecursionDepth();
+      if (!input->LastTagWas(WireFormatLite::MakeTag(
+              field->number(), WireFormatLite::WIRETYPE_END_GROUP))) {
+        return false;
+      }
+    } else {
+      uint32 length;
+      if (!input->ReadVarint32(&length)) return false;
+      if (!input->IncrementRecursionDepth()) return false;
+      io::CodedInputStream::Limit limit = input->PushLimit(length);
+      if (!ParseAndMergePartial(input, sub_message, sub_projection)) {
+        return false;
+      }
+      if (!input->ConsumedEntireMessage()) return false;
+      input->PopLimit(limit);
+      input->DecrementRecursionDepth();
+    }
+  }
+}
+
 bool WireFormat::ParseAndMergeField(
     uint32 tag,
     const FieldDescriptor* field,        // May be NULL for unknown
@@ -423,10 +604,15 @@ bool WireFormat::ParseAndMergeField(
       WireFormatLite::GetTagWireType(tag) != WireTypeForField(field)) {
     // We don't recognize this field.  Either the field number is unknown
     // or the wire type doesn't match.  Put it in our unknown field set.
+    CountStat(STAT_WIRE_FORMAT_UNKNOWN_FIELDS);
     return SkipField(input, tag,
                      message_reflection->MutableUnknownFields(message));
   }
 
+  CountStat(static_cast<StatsCounter>(
+      STAT_WIRE_FORMAT_DOUBLE_FIELDS +
+      (field->type() - FieldDescriptor::TYPE_DOUBLE)));
+
   if (field->options().packed()) {
     uint32 length;
     if (!input->ReadVarint32(&length)) return false;
@@ -57,6 +57,7 @@ namespace protobuf {
     class CodedOutputStream;     // coded_stream.h
   }
   class UnknownFieldSet;         // unknown_field_set.h
+  class FieldProjection;         // field_projection.h
 }
 
 namespace protobuf {
@@ -105,6 +106,15 @@ class LIBPROTOBUF_EXPORT WireFormat {
   static bool ParseAndMergePartial(io::CodedInputStream* input,
                                    Message* message);
 
+  // Like ParseAndMergePartial(), but only fields selected by the projection
+  // are parsed.  Everything else, including unknown fields and extensions,
+  // is skipped without being decoded; skipped sub-messages are never
+  // constructed.  The projection's type must be the message's type.  If
+  // projection is NULL, this is the same as ParseAndMergePartial().
+  static bool ParseAndMergePartial(io::CodedInputStream* input,
+                                   Message* message,
+                                   const FieldProjection* projection);
+
   // Serialize a message in protocol buffer wire format.
   //
   // Any embedded messages within the message must have their correct sizes
@@ -128,7 +138,8 @@ class LIBPROTOBUF_EXPORT WireFormat {
 
   // Skips a field value of the given WireType.  The input should start
   // positioned immediately after the tag.  If unknown_fields is non-NULL,
-  // the contents of the field will be added to it.
+  // the contents of the field will be added to it (as raw wire bytes if
+  // input->lazy_unknown_fields() is set).
   static bool SkipField(io::CodedInputStream* input, uint32 tag,
                         UnknownFieldSet* unknown_fields);
 
@@ -230,6 +241,11 @@ class LIBPROTOBUF_EXPORT WireFormat {
   static void VerifyUTF8String(const char* data, int size, Operation op);
 
  private:
+  // Like SkipField(), but appends the field's tag and value, re-encoded in
+  // wire format, to *raw instead of decoding it into an UnknownFieldSet.
+  static bool SkipFieldToRaw(io::CodedInputStream* input, uint32 tag,
+                             string* raw);
+
   // Verifies that a string field is valid UTF8, logging an error if not.
   static void VerifyUTF8StringFallback(
       const char* data,
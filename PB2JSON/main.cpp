@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <google/protobuf/compiler/command_line_interface.h>
 #include <google/protobuf/compiler/objectivec/objectivec_generator.h>
+#include <google/protobuf/compiler/json_codec/json_codec_generator.h>
 
 
 int main(int argc, char *argv[]) {
@@ -42,6 +43,9 @@ int main(int argc, char *argv[]) {
     
     google::protobuf::compiler::objectivec::ObjectiveCGenerator objc_generator;
     cli.RegisterGenerator("--mockcase_out", &objc_generator, "Generate Mock Case Script File");
+
+    google::protobuf::compiler::json_codec::JsonCodecGenerator json_codec_generator;
+    cli.RegisterGenerator("--json_codec_out", &json_codec_generator, "Generate C++ JSON Codec");
     
     return cli.Run(argc, argv);
 }
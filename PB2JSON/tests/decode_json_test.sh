@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+# Regression tests for pb2json --decode_json.
+#
+# Usage:  decode_json_test.sh PATH_TO_PB2JSON
+
+set -e
+
+PB2JSON=${1:?usage: $0 PATH_TO_PB2JSON}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+cd "$TMP"
+
+cat > m.proto <<'PROTO'
+message M { optional int32 a = 1; repeated string s = 2; }
+PROTO
+
+# An optional field given twice can't be streamed, so --decode_json has to
+# re-order the input.  The fields after the repeat must not be lost:  the
+# transcoder stops reading at the repeat, well before the end of the input.
+S=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+echo "a: 1" > first.txt
+echo "a: 2" > second.txt
+i=0
+while [ $i -lt 200 ]; do
+  echo "s: \"$S\"" >> second.txt
+  i=$((i + 1))
+done
+"$PB2JSON" m.proto --encode=M < first.txt > in.bin
+"$PB2JSON" m.proto --encode=M < second.txt >> in.bin
+"$PB2JSON" m.proto --decode=M < in.bin > expected.txt
+
+check() {
+  "$PB2JSON" m.proto --encode_json=M < out.json |
+    "$PB2JSON" m.proto --decode=M > actual.txt
+  if ! cmp -s expected.txt actual.txt; then
+    echo "FAIL: $1"
+    exit 1
+  fi
+}
+
+"$PB2JSON" m.proto --decode_json=M < in.bin > out.json
+check "out-of-order input from a file"
+cat in.bin | "$PB2JSON" m.proto --decode_json=M > out.json
+check "out-of-order input from a pipe"
+
+echo PASS